@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "plan_executor.h"
+#include <algorithm>
 #include <cassert>
 
 #include "backend/bridge/dml/mapper/mapper.h"
@@ -262,6 +263,14 @@ executor::AbstractExecutor *BuildExecutorTree(
       child_executor = new executor::OrderByExecutor(plan, executor_context);
       break;
 
+    case PLAN_NODE_TYPE_TOPN:
+      child_executor = new executor::TopNExecutor(plan, executor_context);
+      break;
+
+    case PLAN_NODE_TYPE_EXCHANGE:
+      child_executor = new executor::ExchangeExecutor(plan, executor_context);
+      break;
+
     default:
       LOG_ERROR("Unsupported plan node type : %d ", plan_node_type);
       break;
@@ -275,10 +284,20 @@ executor::AbstractExecutor *BuildExecutorTree(
       root = child_executor;
   }
 
+  // An exchange runs one copy of its child subtree per worker
+  oid_t subtree_count = 1;
+  if (plan_node_type == PLAN_NODE_TYPE_EXCHANGE) {
+    auto exchange_plan = static_cast<const planner::ExchangePlan *>(plan);
+    subtree_count = std::max<oid_t>(exchange_plan->GetParallelism(), 1);
+  }
+
   // Recurse
   auto children = plan->GetChildren();
-  for (auto child : children) {
-    child_executor = BuildExecutorTree(child_executor, child, executor_context);
+  for (oid_t subtree_itr = 0; subtree_itr < subtree_count; subtree_itr++) {
+    for (auto child : children) {
+      child_executor =
+          BuildExecutorTree(child_executor, child, executor_context);
+    }
   }
 
   return root;
@@ -292,14 +311,16 @@ executor::AbstractExecutor *BuildExecutorTree(
 void CleanExecutorTree(executor::AbstractExecutor *root) {
   if (root == nullptr) return;
 
-  // Recurse
   auto children = root->GetChildren();
+
+  // Cleanup self first, an exchange stops its workers
+  // before the children they run are gone
+  delete root;
+
+  // Recurse
   for (auto child : children) {
     CleanExecutorTree(child);
   }
-
-  // Cleanup self
-  delete root;
 }
 
 }  // namespace bridge
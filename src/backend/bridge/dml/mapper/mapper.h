@@ -158,6 +158,9 @@ class PlanTransformer {
   static const planner::AbstractPlan *TransformSort(
       const SortPlanState *plan_state);
 
+  static const planner::AbstractPlan *TransformTopN(
+      const SortPlanState *plan_state, size_t limit, size_t offset);
+
   static const planner::AbstractPlan *TransformHash(
       const HashPlanState *plan_state);
 
@@ -33,12 +33,19 @@ const planner::AbstractPlan *PlanTransformer::TransformLimit(
   LOG_INFO("Flags :: Limit: %d, Offset: %d", limit_state->noLimit,
            limit_state->noOffset);
   LOG_INFO("Limit: %ld, Offset: %ld", limit_state->limit, limit_state->offset);
-  auto plan_node =
-      new planner::LimitPlan(limit_state->limit, limit_state->offset);
 
   // Resolve child plan
   AbstractPlanState *subplan_state = outerAbstractPlanState(limit_state);
   assert(subplan_state != nullptr);
+
+  // A limit over a sort only needs the first tuples of the sort
+  if (!limit_state->noLimit && nodeTag(subplan_state) == T_SortState) {
+    return TransformTopN(reinterpret_cast<const SortPlanState *>(subplan_state),
+                         limit_state->limit, limit_state->offset);
+  }
+
+  auto plan_node =
+      new planner::LimitPlan(limit_state->limit, limit_state->offset);
   plan_node->AddChild(TransformPlan(subplan_state));
 
   return plan_node;
@@ -1,22 +1,25 @@
 #include "backend/bridge/dml/mapper/mapper.h"
 #include "backend/bridge/ddl/schema_transformer.h"
 #include "backend/planner/order_by_plan.h"
+#include "backend/planner/top_n_plan.h"
+
+#include "miscadmin.h"
 
 namespace peloton {
 namespace bridge {
 
-const planner::AbstractPlan *PlanTransformer::TransformSort(
-    const SortPlanState *plan_state) {
+/**
+ * @brief Extract the sort keys and their order of a Postgres SortState.
+ */
+static void GetSortKeys(const SortPlanState *plan_state,
+                        std::vector<oid_t> &sort_keys,
+                        std::vector<bool> &descend_flags) {
   auto sort = plan_state->sort;
 
   int numCols = sort->numCols;
   AttrNumber *sortColIdx = sort->sortColIdx;
   bool *reverse_flags = plan_state->reverse_flags;
 
-  std::vector<oid_t> sort_keys;
-  std::vector<bool> descend_flags;
-  std::vector<oid_t> output_col_ids;
-
   for (int i = 0; i < numCols; i++) {
     LOG_INFO("Sort col idx : %u , reverse : %u", sortColIdx[i],
              reverse_flags[i]);
@@ -24,10 +27,43 @@ const planner::AbstractPlan *PlanTransformer::TransformSort(
         static_cast<oid_t>(AttrNumberGetAttrOffset(sortColIdx[i])));
     descend_flags.push_back(reverse_flags[i]);
   }
+}
+
+const planner::AbstractPlan *PlanTransformer::TransformSort(
+    const SortPlanState *plan_state) {
+  std::vector<oid_t> sort_keys;
+  std::vector<bool> descend_flags;
+  std::vector<oid_t> output_col_ids;
+
+  GetSortKeys(plan_state, sort_keys, descend_flags);
 
   auto retval =
       new planner::OrderByPlan(sort_keys, descend_flags, output_col_ids);
 
+  // Spill to disk beyond work_mem, as Postgres sorts do (work_mem is in kB)
+  retval->SetMemoryBudget(static_cast<size_t>(work_mem) * 1024);
+
+  auto lchild = TransformPlan(outerAbstractPlanState(plan_state));
+  retval->AddChild(lchild);
+
+  return retval;
+}
+
+/**
+ * @brief Convert a Postgres SortState under a LimitState into a Peloton
+ *        TopNPlan, which keeps only the first limit + offset tuples.
+ * @return Pointer to the constructed AbstractPlan
+ */
+const planner::AbstractPlan *PlanTransformer::TransformTopN(
+    const SortPlanState *plan_state, size_t limit, size_t offset) {
+  std::vector<oid_t> sort_keys;
+  std::vector<bool> descend_flags;
+
+  GetSortKeys(plan_state, sort_keys, descend_flags);
+
+  auto retval =
+      new planner::TopNPlan(sort_keys, descend_flags, limit, offset);
+
   auto lchild = TransformPlan(outerAbstractPlanState(plan_state));
   retval->AddChild(lchild);
 
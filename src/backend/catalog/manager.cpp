@@ -13,6 +13,7 @@
 #include <cassert>
 #include <string>
 
+#include "backend/common/epoch_manager.h"
 #include "backend/common/exception.h"
 #include "backend/catalog/manager.h"
 #include "backend/storage/database.h"
@@ -30,49 +31,134 @@ Manager &Manager::GetInstance() {
 // OBJECT MAP
 //===--------------------------------------------------------------------===//
 
-void Manager::AddTileGroup(
-    const oid_t oid, const std::shared_ptr<storage::TileGroup> &location) {
-  std::shared_ptr<storage::TileGroup> old_location;
+const oid_t lookup_segment::slot_bits;
+const oid_t lookup_segment::slot_count;
+const oid_t Manager::max_segment_count;
 
-  {
-    std::lock_guard<std::mutex> lock(locator_mutex);
+Manager::Manager()
+    : locator(new std::atomic<lookup_segment *>[max_segment_count]) {
+  // Retired tile groups are freed by the epoch manager, make sure it
+  // outlives the catalog
+  EpochManager::GetInstance();
+
+  for (oid_t segment_itr = 0; segment_itr < max_segment_count;
+       segment_itr++) {
+    locator[segment_itr].store(nullptr, std::memory_order_relaxed);
+  }
+}
 
-    // drop the catalog reference to the old tile group
-    locator.erase(oid);
+Manager::~Manager() {
+  for (oid_t segment_itr = 0; segment_itr < max_segment_count;
+       segment_itr++) {
+    auto segment = locator[segment_itr].load(std::memory_order_relaxed);
+    if (segment == nullptr) continue;
 
-    // add a catalog reference to the tile group
-    locator[oid] = location;
+    for (auto &slot : segment->slots) {
+      delete slot.load(std::memory_order_relaxed);
+    }
+    delete segment;
   }
 }
 
+void Manager::AddTileGroup(
+    const oid_t oid, const std::shared_ptr<storage::TileGroup> &location) {
+  auto slot = GetLookupSlot(oid, true);
+
+  // add a catalog reference to the tile group
+  auto old_location = slot->exchange(
+      new std::shared_ptr<storage::TileGroup>(location),
+      std::memory_order_seq_cst);
+
+  // drop the catalog reference to the old tile group
+  RetireTileGroup(old_location);
+}
+
 void Manager::DropTileGroup(const oid_t oid) {
-  {
-    std::lock_guard<std::mutex> lock(locator_mutex);
-    // drop the catalog reference to the tile group
-    locator.erase(oid);
-  }
+  auto slot = GetLookupSlot(oid, false);
+  if (slot == nullptr) return;
+
+  // drop the catalog reference to the tile group
+  RetireTileGroup(slot->exchange(nullptr, std::memory_order_seq_cst));
 }
 
 std::shared_ptr<storage::TileGroup> Manager::GetTileGroup(const oid_t oid) {
-  std::shared_ptr<storage::TileGroup> location;
+  EpochGuard epoch_guard;
 
-  {
-    std::lock_guard<std::mutex> lock(locator_mutex);
-    // Check if the tile group exists in the lookup directory
-    if (locator.find(oid) != locator.end()) {
-      location = locator.at(oid);
-    }
-  }
+  auto slot = GetLookupSlot(oid, false);
+  if (slot == nullptr) return nullptr;
 
-  return location;
+  // Check if the tile group exists in the lookup directory
+  auto location = slot->load(std::memory_order_acquire);
+  if (location == nullptr) return nullptr;
+
+  return *location;
+}
+
+storage::TileGroup *Manager::LookupTileGroup(const oid_t oid) {
+  auto slot = GetLookupSlot(oid, false);
+  if (slot == nullptr) return nullptr;
+
+  auto location = slot->load(std::memory_order_acquire);
+  if (location == nullptr) return nullptr;
+
+  return location->get();
 }
 
 // used for logging test
 void Manager::ClearTileGroup() {
-  {
-    std::lock_guard<std::mutex> lock(locator_mutex);
-    locator.clear();
+  for (oid_t segment_itr = 0; segment_itr < max_segment_count;
+       segment_itr++) {
+    auto segment = locator[segment_itr].load(std::memory_order_acquire);
+    if (segment == nullptr) continue;
+
+    for (auto &slot : segment->slots) {
+      RetireTileGroup(slot.exchange(nullptr, std::memory_order_seq_cst));
+    }
+  }
+}
+
+/**
+ * @brief Finds the directory slot of a tile group.
+ * @param create Allocate the segment of the slot if it does not exist yet.
+ * @return The slot, nullptr if its segment does not exist and create is
+ *         false.
+ */
+lookup_slot *Manager::GetLookupSlot(const oid_t oid, bool create) {
+  oid_t segment_offset = oid >> lookup_segment::slot_bits;
+  oid_t slot_offset = oid & (lookup_segment::slot_count - 1);
+
+  if (segment_offset >= max_segment_count) {
+    if (create == false) return nullptr;
+    throw CatalogException("Tile group oid out of range : " +
+                           std::to_string(oid));
+  }
+
+  auto &segment_location = locator[segment_offset];
+  auto segment = segment_location.load(std::memory_order_acquire);
+
+  if (segment == nullptr) {
+    if (create == false) return nullptr;
+
+    // Racing writers install a segment once, the loser frees its copy
+    std::unique_ptr<lookup_segment> new_segment(new lookup_segment());
+    for (auto &slot : new_segment->slots) {
+      slot.store(nullptr, std::memory_order_relaxed);
+    }
+
+    if (segment_location.compare_exchange_strong(segment, new_segment.get(),
+                                                 std::memory_order_acq_rel)) {
+      segment = new_segment.release();
+    }
   }
+
+  return &segment->slots[slot_offset];
+}
+
+void Manager::RetireTileGroup(
+    std::shared_ptr<storage::TileGroup> *location) {
+  if (location == nullptr) return;
+
+  EpochManager::GetInstance().Retire([location]() { delete location; });
 }
 
 //===--------------------------------------------------------------------===//
@@ -16,7 +16,6 @@
 #include <utility>
 #include <mutex>
 #include <vector>
-#include <unordered_map>
 #include <memory>
 
 #include "backend/common/types.h"
@@ -38,12 +37,27 @@ namespace catalog {
 // Manager
 //===--------------------------------------------------------------------===//
 
-typedef std::unordered_map<oid_t, std::shared_ptr<storage::TileGroup>>
-    lookup_dir;
+/**
+ * Tile group directory, indexed by tile group oid. Oids are dense, so the
+ * directory is an array of fixed-size segments that are allocated on first
+ * use and never move. A slot points to the catalog's reference to the tile
+ * group; replaced references are freed through the epoch manager, so that
+ * readers only need to be inside an epoch.
+ */
+typedef std::atomic<std::shared_ptr<storage::TileGroup> *> lookup_slot;
+
+struct lookup_segment {
+  static const oid_t slot_bits = 14;
+  static const oid_t slot_count = 1 << slot_bits;
+
+  lookup_slot slots[slot_count];
+};
 
 class Manager {
  public:
-  Manager() {}
+  Manager();
+
+  ~Manager();
 
   // Singleton
   static Manager &GetInstance();
@@ -65,6 +79,10 @@ class Manager {
 
   std::shared_ptr<storage::TileGroup> GetTileGroup(const oid_t oid);
 
+  // Plain loads, no locks or reference counts. The tile group stays valid
+  // while the caller holds an EpochGuard.
+  storage::TileGroup *LookupTileGroup(const oid_t oid);
+
   void ClearTileGroup(void);
 
   //===--------------------------------------------------------------------===//
@@ -105,9 +123,13 @@ class Manager {
 
   std::atomic<oid_t> oid = ATOMIC_VAR_INIT(START_OID);
 
-  lookup_dir locator;
+  lookup_slot *GetLookupSlot(const oid_t oid, bool create);
+
+  void RetireTileGroup(std::shared_ptr<storage::TileGroup> *location);
+
+  static const oid_t max_segment_count = 1 << 18;
 
-  std::mutex locator_mutex;
+  std::unique_ptr<std::atomic<lookup_segment *>[]> locator;
 
   // DATABASES
 
@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// epoch_manager.cpp
+//
+// Identification: src/backend/common/epoch_manager.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/common/epoch_manager.h"
+
+#include <cassert>
+#include <limits>
+
+#include "backend/common/exception.h"
+
+namespace peloton {
+
+const size_t EpochManager::max_thread_count;
+
+/**
+ * @brief Per-thread state, gives the slot back when the thread exits.
+ */
+struct ThreadEpochOwner {
+  EpochManager::ThreadEpoch *thread_epoch = nullptr;
+
+  // Nesting depth of EnterEpoch calls
+  size_t depth = 0;
+
+  ~ThreadEpochOwner() {
+    if (thread_epoch != nullptr) {
+      EpochManager::GetInstance().ReleaseThreadEpoch(thread_epoch);
+    }
+  }
+};
+
+static thread_local ThreadEpochOwner thread_epoch_owner;
+
+EpochManager &EpochManager::GetInstance() {
+  static EpochManager epoch_manager;
+  return epoch_manager;
+}
+
+EpochManager::EpochManager()
+    : global_epoch(1), thread_epochs(new ThreadEpoch[max_thread_count]) {
+  for (size_t thread_itr = 0; thread_itr < max_thread_count; thread_itr++) {
+    thread_epochs[thread_itr].epoch.store(0, std::memory_order_relaxed);
+    thread_epochs[thread_itr].in_use.store(false, std::memory_order_relaxed);
+  }
+}
+
+EpochManager::~EpochManager() {
+  // Nobody reads any more
+  for (auto &retired_object : retired_objects) {
+    retired_object.deleter();
+  }
+}
+
+void EpochManager::EnterEpoch() {
+  if (thread_epoch_owner.depth++ > 0) return;
+
+  auto thread_epoch = GetThreadEpoch();
+  thread_epoch->epoch.store(global_epoch.load(std::memory_order_seq_cst),
+                            std::memory_order_seq_cst);
+
+  // Publish the epoch before reading any shared pointer
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void EpochManager::ExitEpoch() {
+  assert(thread_epoch_owner.depth > 0);
+  if (--thread_epoch_owner.depth > 0) return;
+
+  thread_epoch_owner.thread_epoch->epoch.store(0, std::memory_order_release);
+}
+
+void EpochManager::Retire(std::function<void()> deleter) {
+  {
+    std::lock_guard<std::mutex> lock(retired_mutex);
+
+    // Readers entering from now on cannot find the object any more
+    uint64_t epoch = global_epoch.fetch_add(1, std::memory_order_seq_cst);
+    retired_objects.push_back(RetiredObject{epoch, std::move(deleter)});
+  }
+
+  Reclaim();
+}
+
+void EpochManager::Reclaim() {
+  std::vector<RetiredObject> reclaimed_objects;
+
+  {
+    std::lock_guard<std::mutex> lock(retired_mutex);
+    if (retired_objects.empty()) return;
+
+    // Oldest epoch a thread is still in
+    uint64_t min_epoch = std::numeric_limits<uint64_t>::max();
+    for (size_t thread_itr = 0; thread_itr < max_thread_count; thread_itr++) {
+      uint64_t epoch =
+          thread_epochs[thread_itr].epoch.load(std::memory_order_seq_cst);
+      if (epoch != 0 && epoch < min_epoch) min_epoch = epoch;
+    }
+
+    // Objects retired before that epoch are out of reach
+    size_t retired_count = 0;
+    for (auto &retired_object : retired_objects) {
+      if (retired_object.epoch < min_epoch) {
+        reclaimed_objects.push_back(std::move(retired_object));
+      } else {
+        retired_objects[retired_count++] = std::move(retired_object);
+      }
+    }
+    retired_objects.resize(retired_count);
+  }
+
+  // Free outside the lock, a deleter may retire other objects
+  for (auto &reclaimed_object : reclaimed_objects) {
+    reclaimed_object.deleter();
+  }
+}
+
+size_t EpochManager::GetRetiredCount() {
+  std::lock_guard<std::mutex> lock(retired_mutex);
+  return retired_objects.size();
+}
+
+EpochManager::ThreadEpoch *EpochManager::GetThreadEpoch() {
+  if (thread_epoch_owner.thread_epoch != nullptr) {
+    return thread_epoch_owner.thread_epoch;
+  }
+
+  for (size_t thread_itr = 0; thread_itr < max_thread_count; thread_itr++) {
+    bool in_use = false;
+    if (thread_epochs[thread_itr].in_use.compare_exchange_strong(in_use,
+                                                                 true)) {
+      thread_epoch_owner.thread_epoch = &thread_epochs[thread_itr];
+      return thread_epoch_owner.thread_epoch;
+    }
+  }
+
+  thread_epoch_owner.depth--;
+  throw Exception("Epoch manager is out of thread slots");
+}
+
+void EpochManager::ReleaseThreadEpoch(ThreadEpoch *thread_epoch) {
+  thread_epoch->epoch.store(0, std::memory_order_release);
+  thread_epoch->in_use.store(false, std::memory_order_release);
+}
+
+}  // End peloton namespace
@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// epoch_manager.h
+//
+// Identification: src/backend/common/epoch_manager.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Epoch Manager
+//===--------------------------------------------------------------------===//
+
+/**
+ * Epoch-based reclamation for objects that are read without locks.
+ *
+ * Readers enter an epoch before loading a shared pointer and exit it once
+ * they are done with the object. Writers unlink the object first and then
+ * retire it; it is freed only after every thread that was inside an epoch
+ * at that time has exited it. Entering and exiting are a couple of stores
+ * to a per-thread slot, with no shared counters.
+ */
+class EpochManager {
+ public:
+  EpochManager(EpochManager const &) = delete;
+  EpochManager &operator=(EpochManager const &) = delete;
+
+  // Threads inside an epoch at the same time
+  static const size_t max_thread_count = 1024;
+
+  // Singleton
+  static EpochManager &GetInstance();
+
+  ~EpochManager();
+
+  // Nested calls only count once
+  void EnterEpoch();
+
+  void ExitEpoch();
+
+  // Runs the deleter once no reader can see the unlinked object any more
+  void Retire(std::function<void()> deleter);
+
+  // Frees the retired objects that are safe to free
+  void Reclaim();
+
+  size_t GetRetiredCount();
+
+ private:
+  EpochManager();
+
+  struct ThreadEpoch {
+    // Epoch the thread entered in, 0 when outside an epoch
+    std::atomic<uint64_t> epoch;
+
+    // Set while a thread owns the slot
+    std::atomic<bool> in_use;
+
+    char padding[CACHELINE_SIZE - sizeof(std::atomic<uint64_t>) -
+                 sizeof(std::atomic<bool>)];
+  };
+
+  struct RetiredObject {
+    uint64_t epoch;
+    std::function<void()> deleter;
+  };
+
+  // Slot of the calling thread, claimed on first use
+  ThreadEpoch *GetThreadEpoch();
+
+  friend struct ThreadEpochOwner;
+
+  void ReleaseThreadEpoch(ThreadEpoch *thread_epoch);
+
+  std::atomic<uint64_t> global_epoch;
+
+  std::unique_ptr<ThreadEpoch[]> thread_epochs;
+
+  std::mutex retired_mutex;
+
+  std::vector<RetiredObject> retired_objects;
+};
+
+/**
+ * @brief Keeps the calling thread inside an epoch for its scope.
+ */
+class EpochGuard {
+ public:
+  EpochGuard(EpochGuard const &) = delete;
+  EpochGuard &operator=(EpochGuard const &) = delete;
+
+  EpochGuard() { EpochManager::GetInstance().EnterEpoch(); }
+
+  ~EpochGuard() { EpochManager::GetInstance().ExitEpoch(); }
+};
+
+}  // End peloton namespace
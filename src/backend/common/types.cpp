@@ -180,6 +180,40 @@ BackendType StringToBackendType(std::string str) {
   return BACKEND_TYPE_INVALID;
 }
 
+//===--------------------------------------------------------------------===//
+// HeaderLayoutType <--> String Utilities
+//===--------------------------------------------------------------------===//
+
+std::string HeaderLayoutTypeToString(HeaderLayoutType type) {
+  std::string ret;
+
+  switch (type) {
+    case (HEADER_LAYOUT_TYPE_ROW):
+      return "ROW";
+    case (HEADER_LAYOUT_TYPE_COLUMN):
+      return "COLUMN";
+    case (HEADER_LAYOUT_TYPE_INVALID):
+      return "INVALID";
+    default: {
+      char buffer[32];
+      ::snprintf(buffer, 32, "UNKNOWN[%d] ", type);
+      ret = buffer;
+    }
+  }
+  return (ret);
+}
+
+HeaderLayoutType StringToHeaderLayoutType(std::string str) {
+  if (str == "INVALID") {
+    return HEADER_LAYOUT_TYPE_INVALID;
+  } else if (str == "ROW") {
+    return HEADER_LAYOUT_TYPE_ROW;
+  } else if (str == "COLUMN") {
+    return HEADER_LAYOUT_TYPE_COLUMN;
+  }
+  return HEADER_LAYOUT_TYPE_INVALID;
+}
+
 //===--------------------------------------------------------------------===//
 // Value <--> String Utilities
 //===--------------------------------------------------------------------===//
@@ -657,6 +691,9 @@ std::string PlanNodeTypeToString(PlanNodeType type) {
     case PLAN_NODE_TYPE_PRINT: {
       return "PRINT";
     }
+    case PLAN_NODE_TYPE_EXCHANGE: {
+      return "EXCHANGE";
+    }
     case PLAN_NODE_TYPE_AGGREGATE: {
       return "AGGREGATE";
     }
@@ -687,6 +724,9 @@ std::string PlanNodeTypeToString(PlanNodeType type) {
     case PLAN_NODE_TYPE_APPEND: {
       return "APPEND";
     }
+    case PLAN_NODE_TYPE_TOPN: {
+      return "TOPN";
+    }
     case PLAN_NODE_TYPE_RESULT: {
       return "RESULT";
     }
@@ -728,6 +768,8 @@ PlanNodeType StringToPlanNodeType(std::string str) {
     return PLAN_NODE_TYPE_RECEIVE;
   } else if (str == "PRINT") {
     return PLAN_NODE_TYPE_PRINT;
+  } else if (str == "EXCHANGE") {
+    return PLAN_NODE_TYPE_EXCHANGE;
   } else if (str == "AGGREGATE") {
     return PLAN_NODE_TYPE_AGGREGATE;
   } else if (str == "HASHAGGREGATE") {
@@ -744,6 +786,8 @@ PlanNodeType StringToPlanNodeType(std::string str) {
     return PLAN_NODE_TYPE_LIMIT;
   } else if (str == "DISTINCT") {
     return PLAN_NODE_TYPE_DISTINCT;
+  } else if (str == "TOPN") {
+    return PLAN_NODE_TYPE_TOPN;
   }
   return PLAN_NODE_TYPE_INVALID;
 }
@@ -95,6 +95,14 @@ class Value;
 
 #define DEFAULT_TUPLES_PER_TILEGROUP 1000
 
+// MVCC header layout of new tile groups (can be overridden at build time)
+#ifndef DEFAULT_HEADER_LAYOUT_TYPE
+#define DEFAULT_HEADER_LAYOUT_TYPE peloton::HEADER_LAYOUT_TYPE_ROW
+#endif
+
+// Used to pad shared structures that are written by different threads
+#define CACHELINE_SIZE 64
+
 // Ref count starting point
 #define BASE_REF_COUNT 1
 
@@ -314,6 +322,17 @@ enum BackendType {
   BACKEND_TYPE_FILE = 2  // on mmap file
 };
 
+//===--------------------------------------------------------------------===//
+// Tile Group Header Layout Types
+//===--------------------------------------------------------------------===//
+
+enum HeaderLayoutType {
+  HEADER_LAYOUT_TYPE_INVALID = 0,  // invalid header layout type
+
+  HEADER_LAYOUT_TYPE_ROW = 1,    // MVCC fields interleaved per tuple slot
+  HEADER_LAYOUT_TYPE_COLUMN = 2  // one array per MVCC field
+};
+
 //===--------------------------------------------------------------------===//
 // Index Types
 //===--------------------------------------------------------------------===//
@@ -362,6 +381,7 @@ enum PlanNodeType {
   PLAN_NODE_TYPE_SEND = 40,
   PLAN_NODE_TYPE_RECEIVE = 41,
   PLAN_NODE_TYPE_PRINT = 42,
+  PLAN_NODE_TYPE_EXCHANGE = 43,
 
   // Algebra Nodes
   PLAN_NODE_TYPE_AGGREGATE = 50,
@@ -374,6 +394,7 @@ enum PlanNodeType {
   PLAN_NODE_TYPE_DISTINCT = 57,
   PLAN_NODE_TYPE_SETOP = 58,   // set operation
   PLAN_NODE_TYPE_APPEND = 59,  // append
+  PLAN_NODE_TYPE_TOPN = 60,    // order by with limit
 
   PLAN_NODE_TYPE_AGGREGATE_V2 = 61,
   PLAN_NODE_TYPE_HASH = 62,
@@ -668,6 +689,12 @@ static const cid_t START_CID = 1;
 
 static const cid_t MAX_CID = std::numeric_limits<cid_t>::max();
 
+// For log sequence number
+
+typedef uint64_t lsn_t;
+
+static const lsn_t INVALID_LSN = 0;
+
 //===--------------------------------------------------------------------===//
 // ItemPointer
 //===--------------------------------------------------------------------===//
@@ -715,6 +742,9 @@ bool IsSimilarToPeloton(LoggingType logging_type);
 std::string BackendTypeToString(BackendType type);
 BackendType StringToBackendType(std::string str);
 
+std::string HeaderLayoutTypeToString(HeaderLayoutType type);
+HeaderLayoutType StringToHeaderLayoutType(std::string str);
+
 std::string ValueTypeToString(ValueType type);
 ValueType StringToValueType(std::string str);
 
@@ -22,6 +22,7 @@
 #include "backend/logging/records/transaction_record.h"
 #include "backend/concurrency/transaction.h"
 #include "backend/catalog/manager.h"
+#include "backend/common/epoch_manager.h"
 #include "backend/common/exception.h"
 #include "backend/common/logger.h"
 #include "backend/storage/tile_group.h"
@@ -78,6 +79,11 @@ Transaction *TransactionManager::BeginTransaction() {
   return next_txn;
 }
 
+cid_t TransactionManager::GetMaxCommitId() {
+  std::lock_guard<std::mutex> lock(txn_table_mutex);
+  return last_txn->cid;
+}
+
 bool TransactionManager::IsValid(txn_id_t txn_id) {
   return (txn_id < next_txn_id);
 }
@@ -100,6 +106,19 @@ void TransactionManager::ResetStates(void) {
   txn_table.clear();
 }
 
+/**
+ * @brief Move the commit ids past the given one, so that the txns after
+ * recovery commit after the ones of the log. No txn may be committing.
+ * @param cid
+ */
+void TransactionManager::RestoreLastCommitId(cid_t cid) {
+  std::lock_guard<std::mutex> lock(txn_table_mutex);
+  if (cid > last_txn->cid) {
+    last_txn->cid = cid;
+    last_cid = cid;
+  }
+}
+
 void TransactionManager::EndTransaction(Transaction *txn,
                                         bool sync __attribute__((unused))) {
   // Log the END TXN record
@@ -156,12 +175,13 @@ void TransactionManager::BeginCommitPhase(Transaction *txn) {
 void TransactionManager::CommitModifications(Transaction *txn, bool sync
                                              __attribute__((unused))) {
   auto &manager = catalog::Manager::GetInstance();
+  EpochGuard epoch_guard;
 
   // (A) commit inserts
   auto inserted_tuples = txn->GetInsertedTuples();
   for (auto entry : inserted_tuples) {
     oid_t tile_group_id = entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
+    auto tile_group = manager.LookupTileGroup(tile_group_id);
     for (auto tuple_slot : entry.second)
       tile_group->CommitInsertedTuple(tuple_slot, txn->txn_id, txn->cid);
   }
@@ -170,7 +190,7 @@ void TransactionManager::CommitModifications(Transaction *txn, bool sync
   auto deleted_tuples = txn->GetDeletedTuples();
   for (auto entry : deleted_tuples) {
     oid_t tile_group_id = entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
+    auto tile_group = manager.LookupTileGroup(tile_group_id);
     for (auto tuple_slot : entry.second)
       tile_group->CommitDeletedTuple(tuple_slot, txn->txn_id, txn->cid);
   }
@@ -181,7 +201,7 @@ void TransactionManager::CommitModifications(Transaction *txn, bool sync
     if (log_manager.IsInLoggingMode()) {
       auto logger = log_manager.GetBackendLogger();
       auto record = new logging::TransactionRecord(
-          LOGRECORD_TYPE_TRANSACTION_COMMIT, txn->txn_id);
+          LOGRECORD_TYPE_TRANSACTION_COMMIT, txn->txn_id, txn->cid);
       logger->Log(record);
     }
   }
@@ -288,13 +308,14 @@ void TransactionManager::AbortTransaction() {
   }
 
   auto &manager = catalog::Manager::GetInstance();
+  EpochGuard epoch_guard;
 
   // (A) rollback inserts
   const txn_id_t txn_id = current_txn->GetTransactionId();
   auto inserted_tuples = current_txn->GetInsertedTuples();
   for (auto entry : inserted_tuples) {
     oid_t tile_group_id = entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
+    auto tile_group = manager.LookupTileGroup(tile_group_id);
     for (auto tuple_slot : entry.second)
       tile_group->AbortInsertedTuple(tuple_slot);
   }
@@ -303,7 +324,7 @@ void TransactionManager::AbortTransaction() {
   auto deleted_tuples = current_txn->GetDeletedTuples();
   for (auto entry : current_txn->GetDeletedTuples()) {
     oid_t tile_group_id = entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
+    auto tile_group = manager.LookupTileGroup(tile_group_id);
     for (auto tuple_slot : entry.second)
       tile_group->AbortDeletedTuple(tuple_slot, txn_id);
   }
@@ -45,6 +45,9 @@ class TransactionManager {
   // Get last commit id for visibility checks
   cid_t GetLastCommitId() { return last_cid; }
 
+  // Get the commit id of the last txn which entered its commit phase
+  cid_t GetMaxCommitId();
+
   //===--------------------------------------------------------------------===//
   // Transaction processing
   //===--------------------------------------------------------------------===//
@@ -69,6 +72,9 @@ class TransactionManager {
   // used by recovery testing
   void ResetStates(void);
 
+  // used by recovery to continue after the commit ids of the log
+  void RestoreLastCommitId(cid_t cid);
+
   // COMMIT
 
   void BeginCommitPhase(Transaction *txn);
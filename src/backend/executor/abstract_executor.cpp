@@ -45,6 +45,48 @@ const std::vector<AbstractExecutor *> &AbstractExecutor::GetChildren() const {
   return children_;
 }
 
+/**
+ * @brief Shares a scan cursor with other copies of this subtree.
+ *
+ * Only the outer child is split, so that e.g. every copy of a join still
+ * sees the whole inner input.
+ *
+ * @param scan_cursor Cursor shared by all copies of the subtree.
+ * @return true if the subtree will only process its share of the input.
+ */
+bool AbstractExecutor::SetSharedScanCursor(
+    std::shared_ptr<std::atomic<oid_t>> scan_cursor) {
+  if (children_.empty()) return false;
+
+  return children_[0]->SetSharedScanCursor(scan_cursor);
+}
+
+/**
+ * @brief Hands a join's Bloom filter to the scan producing this output.
+ * @param filter Filter over the key hashes of the build side.
+ * @param column_ids Key columns of the output.
+ * @return true if the tuples will be filtered.
+ */
+bool AbstractExecutor::SetBloomFilter(
+    std::shared_ptr<const JoinBloomFilter> filter __attribute__((unused)),
+    const std::vector<oid_t> &column_ids __attribute__((unused))) {
+  return false;
+}
+
+/**
+ * @brief Makes the scans of this subtree materialize their whole input
+ * before their consumer changes the table they read.
+ * @return true if a scan of the subtree will materialize its input.
+ */
+bool AbstractExecutor::SetMaterializeScan(void) {
+  bool status = false;
+  for (auto child : children_) {
+    if (child->SetMaterializeScan()) status = true;
+  }
+
+  return status;
+}
+
 /**
  * @brief Initializes the executor.
  *
@@ -12,10 +12,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <memory>
 #include <vector>
 
+#include "backend/common/types.h"
 #include "backend/executor/logical_tile.h"
 
 namespace peloton {
@@ -26,6 +28,7 @@ class AbstractPlan;
 
 namespace executor {
 class ExecutorContext;
+class JoinBloomFilter;
 }
 
 namespace executor {
@@ -39,7 +42,9 @@ class AbstractExecutor {
 
   virtual ~AbstractExecutor() {}
 
-  bool Init();
+  // Virtual so that an executor can do its own work around the
+  // initialization of its children
+  virtual bool Init();
 
   bool Execute();
 
@@ -51,6 +56,29 @@ class AbstractExecutor {
 
   const std::vector<AbstractExecutor *> &GetChildren() const;
 
+  //===--------------------------------------------------------------------===//
+  // Parallel Execution
+  //===--------------------------------------------------------------------===//
+
+  // Makes this subtree process only the part of its input handed out by the
+  // shared cursor, so that several copies of it can run side by side under
+  // an exchange. Must be called after Init(). Forwarded to the outer child
+  // by default; returns false if the subtree cannot be split this way.
+  virtual bool SetSharedScanCursor(
+      std::shared_ptr<std::atomic<oid_t>> scan_cursor);
+
+  // Lets a scan drop the tuples whose key, the given columns of its output,
+  // is not in the filter. Only scans accept it, since other operators may
+  // change the columns; returns false if nobody will apply it.
+  virtual bool SetBloomFilter(std::shared_ptr<const JoinBloomFilter> filter,
+                              const std::vector<oid_t> &column_ids);
+
+  // Makes the scans of this subtree read their whole range before returning
+  // anything, so that they never see the tuples their consumer writes to the
+  // table meanwhile (the Halloween problem). Must be called after Init().
+  // Forwarded to every child by default; returns true if some scan will.
+  virtual bool SetMaterializeScan(void);
+
   //===--------------------------------------------------------------------===//
   // Accessors
   //===--------------------------------------------------------------------===//
@@ -0,0 +1,439 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// aggregate_arena.cpp
+//
+// Identification: src/backend/executor/aggregate_arena.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/executor/aggregate_arena.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+
+#include "backend/common/exception.h"
+#include "backend/common/logger.h"
+#include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
+#include "backend/executor/aggregator.h"
+
+namespace peloton {
+namespace executor {
+
+const size_t AggregateArena::block_bits;
+const oid_t AggregateArena::block_mask;
+
+namespace {
+
+inline bool IsCountType(ExpressionType agg_type) {
+  return agg_type == EXPRESSION_TYPE_AGGREGATE_COUNT ||
+         agg_type == EXPRESSION_TYPE_AGGREGATE_COUNT_STAR;
+}
+
+}  // End anonymous namespace
+
+template <typename T>
+struct AggregateArena::Kernels {
+  static T &Get(Slot &slot);
+
+  static T Load(const Slot &slot);
+
+  static T Read(const Value &value);
+
+  static T Add(T lhs, T rhs);
+
+  // Used for SUM and AVG
+  static void AdvanceSum(Slot &slot, const Value &value) {
+    if (value.IsNull()) return;
+    T input = Read(value);
+    if (slot.count++ == 0) {
+      Get(slot) = input;
+    } else {
+      Get(slot) = Add(Get(slot), input);
+    }
+  }
+
+  static void AdvanceMin(Slot &slot, const Value &value) {
+    if (value.IsNull()) return;
+    T input = Read(value);
+    if (slot.count++ == 0 || input < Get(slot)) {
+      Get(slot) = input;
+    }
+  }
+
+  static void AdvanceMax(Slot &slot, const Value &value) {
+    if (value.IsNull()) return;
+    T input = Read(value);
+    if (slot.count++ == 0 || input > Get(slot)) {
+      Get(slot) = input;
+    }
+  }
+
+  static void AdvanceCount(Slot &slot, const Value &value) {
+    if (value.IsNull()) return;
+    slot.count++;
+  }
+
+  static void AdvanceCountStar(Slot &slot,
+                               const Value &value __attribute__((unused))) {
+    slot.count++;
+  }
+
+  // Until an aggregate is bound, it only sees nulls
+  static void AdvanceNull(Slot &slot __attribute__((unused)),
+                          const Value &value __attribute__((unused))) {}
+
+  static void MergeSum(Slot &slot, const Slot &other) {
+    if (other.count == 0) return;
+    if (slot.count == 0) {
+      Get(slot) = Load(other);
+    } else {
+      Get(slot) = Add(Get(slot), Load(other));
+    }
+    slot.count += other.count;
+  }
+
+  static void MergeMin(Slot &slot, const Slot &other) {
+    if (other.count == 0) return;
+    if (slot.count == 0 || Load(other) < Get(slot)) {
+      Get(slot) = Load(other);
+    }
+    slot.count += other.count;
+  }
+
+  static void MergeMax(Slot &slot, const Slot &other) {
+    if (other.count == 0) return;
+    if (slot.count == 0 || Load(other) > Get(slot)) {
+      Get(slot) = Load(other);
+    }
+    slot.count += other.count;
+  }
+
+  static void MergeCount(Slot &slot, const Slot &other) {
+    slot.count += other.count;
+  }
+
+  static void MergeNull(Slot &slot __attribute__((unused)),
+                        const Slot &other __attribute__((unused))) {
+    assert(other.count == 0);
+  }
+};
+
+template <>
+inline int64_t &AggregateArena::Kernels<int64_t>::Get(Slot &slot) {
+  return slot.bigint_value;
+}
+
+template <>
+inline double &AggregateArena::Kernels<double>::Get(Slot &slot) {
+  return slot.double_value;
+}
+
+template <>
+inline int64_t AggregateArena::Kernels<int64_t>::Load(const Slot &slot) {
+  return slot.bigint_value;
+}
+
+template <>
+inline double AggregateArena::Kernels<double>::Load(const Slot &slot) {
+  return slot.double_value;
+}
+
+template <>
+inline int64_t AggregateArena::Kernels<int64_t>::Read(const Value &value) {
+  return ValuePeeker::PeekAsRawInt64(value);
+}
+
+template <>
+inline double AggregateArena::Kernels<double>::Read(const Value &value) {
+  return ValuePeeker::PeekDouble(value);
+}
+
+template <>
+inline int64_t AggregateArena::Kernels<int64_t>::Add(int64_t lhs,
+                                                     int64_t rhs) {
+  if ((rhs > 0 && lhs > INT64_MAX - rhs) ||
+      (rhs < 0 && lhs < INT64_MIN - rhs)) {
+    char message[4096];
+    snprintf(message, 4096, "Adding %jd and %jd will overflow BigInt storage",
+             (intmax_t)lhs, (intmax_t)rhs);
+    throw Exception(message);
+  }
+  return lhs + rhs;
+}
+
+template <>
+inline double AggregateArena::Kernels<double>::Add(double lhs, double rhs) {
+  const double result = lhs + rhs;
+  ThrowDataExceptionIfInfiniteOrNaN(result, "'+' operator");
+  return result;
+}
+
+AggregateArena::AggregateArena(const AggTermList &agg_terms) {
+  assert(IsSupported(agg_terms));
+
+  for (auto &agg_term : agg_terms) {
+    AggregateType aggregate_type;
+    aggregate_type.agg_type = agg_term.aggtype;
+    aggregate_type.value_type = VALUE_TYPE_INVALID;
+
+    switch (agg_term.aggtype) {
+      case EXPRESSION_TYPE_AGGREGATE_COUNT:
+        aggregate_type.advance = &Kernels<int64_t>::AdvanceCount;
+        aggregate_type.merge = &Kernels<int64_t>::MergeCount;
+        break;
+      case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
+        aggregate_type.advance = &Kernels<int64_t>::AdvanceCountStar;
+        aggregate_type.merge = &Kernels<int64_t>::MergeCount;
+        break;
+      default:
+        aggregate_type.advance = &Kernels<int64_t>::AdvanceNull;
+        aggregate_type.merge = &Kernels<int64_t>::MergeNull;
+        break;
+    }
+
+    aggregate_types.push_back(aggregate_type);
+  }
+}
+
+bool AggregateArena::IsSupported(const AggTermList &agg_terms) {
+  for (auto &agg_term : agg_terms) {
+    if (agg_term.distinct) return false;
+
+    switch (agg_term.aggtype) {
+      case EXPRESSION_TYPE_AGGREGATE_COUNT:
+      case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
+      case EXPRESSION_TYPE_AGGREGATE_SUM:
+      case EXPRESSION_TYPE_AGGREGATE_AVG:
+      case EXPRESSION_TYPE_AGGREGATE_MIN:
+      case EXPRESSION_TYPE_AGGREGATE_MAX:
+        break;
+      default:
+        return false;
+    }
+  }
+
+  return true;
+}
+
+oid_t AggregateArena::AddGroup() {
+  oid_t group_offset = group_count++;
+
+  if ((group_offset & block_mask) == 0) {
+    blocks.emplace_back(new Slot[(block_mask + 1) * aggregate_types.size()]);
+  }
+
+  Slot *group = GetGroup(group_offset);
+  for (oid_t agg_offset = 0; agg_offset < aggregate_types.size();
+       agg_offset++) {
+    group[agg_offset].bigint_value = 0;
+    group[agg_offset].count = 0;
+  }
+
+  return group_offset;
+}
+
+bool AggregateArena::Advance(oid_t group_offset,
+                             const std::vector<Value> &values) {
+  assert(group_offset < group_count);
+  assert(values.size() == aggregate_types.size());
+
+  // Check all the values first, so that a group is never half advanced
+  for (oid_t agg_offset = 0; agg_offset < aggregate_types.size();
+       agg_offset++) {
+    auto &aggregate_type = aggregate_types[agg_offset];
+    auto &value = values[agg_offset];
+    if (IsCountType(aggregate_type.agg_type) || value.IsNull()) continue;
+
+    if (aggregate_type.value_type == VALUE_TYPE_INVALID) {
+      if (Bind(aggregate_type, value.GetValueType()) == false) return false;
+    } else if (aggregate_type.value_type != value.GetValueType()) {
+      return false;
+    }
+  }
+
+  Slot *group = GetGroup(group_offset);
+  for (oid_t agg_offset = 0; agg_offset < aggregate_types.size();
+       agg_offset++) {
+    aggregate_types[agg_offset].advance(group[agg_offset], values[agg_offset]);
+  }
+
+  return true;
+}
+
+bool AggregateArena::Bind(AggregateType &aggregate_type,
+                          ValueType value_type) {
+  bool is_integer;
+  switch (value_type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+      is_integer = true;
+      break;
+    case VALUE_TYPE_DOUBLE:
+      is_integer = false;
+      break;
+    default:
+      return false;
+  }
+
+  switch (aggregate_type.agg_type) {
+    case EXPRESSION_TYPE_AGGREGATE_SUM:
+    case EXPRESSION_TYPE_AGGREGATE_AVG:
+      aggregate_type.advance = is_integer ? &Kernels<int64_t>::AdvanceSum
+                                          : &Kernels<double>::AdvanceSum;
+      aggregate_type.merge = is_integer ? &Kernels<int64_t>::MergeSum
+                                        : &Kernels<double>::MergeSum;
+      break;
+    case EXPRESSION_TYPE_AGGREGATE_MIN:
+      aggregate_type.advance = is_integer ? &Kernels<int64_t>::AdvanceMin
+                                          : &Kernels<double>::AdvanceMin;
+      aggregate_type.merge = is_integer ? &Kernels<int64_t>::MergeMin
+                                        : &Kernels<double>::MergeMin;
+      break;
+    case EXPRESSION_TYPE_AGGREGATE_MAX:
+      aggregate_type.advance = is_integer ? &Kernels<int64_t>::AdvanceMax
+                                          : &Kernels<double>::AdvanceMax;
+      aggregate_type.merge = is_integer ? &Kernels<int64_t>::MergeMax
+                                        : &Kernels<double>::MergeMax;
+      break;
+    default:
+      return false;
+  }
+
+  LOG_TRACE("Bound aggregate to value type %d", value_type);
+  aggregate_type.value_type = value_type;
+  return true;
+}
+
+bool AggregateArena::AdoptTypes(const AggregateArena &other) {
+  assert(other.aggregate_types.size() == aggregate_types.size());
+
+  for (oid_t agg_offset = 0; agg_offset < aggregate_types.size();
+       agg_offset++) {
+    auto &aggregate_type = aggregate_types[agg_offset];
+    auto &other_type = other.aggregate_types[agg_offset];
+    if (aggregate_type.value_type != VALUE_TYPE_INVALID &&
+        other_type.value_type != VALUE_TYPE_INVALID &&
+        aggregate_type.value_type != other_type.value_type) {
+      return false;
+    }
+  }
+
+  for (oid_t agg_offset = 0; agg_offset < aggregate_types.size();
+       agg_offset++) {
+    auto &aggregate_type = aggregate_types[agg_offset];
+    if (aggregate_type.value_type == VALUE_TYPE_INVALID) {
+      aggregate_type = other.aggregate_types[agg_offset];
+    }
+  }
+
+  return true;
+}
+
+void AggregateArena::MergeGroup(oid_t group_offset,
+                                const AggregateArena &other,
+                                oid_t other_group_offset) {
+  assert(group_offset < group_count);
+  assert(other_group_offset < other.group_count);
+
+  Slot *group = GetGroup(group_offset);
+  const Slot *other_group = other.GetGroup(other_group_offset);
+  for (oid_t agg_offset = 0; agg_offset < aggregate_types.size();
+       agg_offset++) {
+    assert(other.aggregate_types[agg_offset].value_type == VALUE_TYPE_INVALID ||
+           other.aggregate_types[agg_offset].value_type ==
+               aggregate_types[agg_offset].value_type);
+    aggregate_types[agg_offset].merge(group[agg_offset],
+                                      other_group[agg_offset]);
+  }
+}
+
+Value AggregateArena::GetSlotValue(const AggregateType &aggregate_type,
+                                   const Slot &slot) const {
+  // Sums of integers are kept as BIGINT, like Value::OpAdd does
+  ValueType result_type = aggregate_type.value_type;
+  if (result_type != VALUE_TYPE_DOUBLE &&
+      (aggregate_type.agg_type == EXPRESSION_TYPE_AGGREGATE_SUM ||
+       aggregate_type.agg_type == EXPRESSION_TYPE_AGGREGATE_AVG)) {
+    result_type = VALUE_TYPE_BIGINT;
+  }
+
+  switch (result_type) {
+    case VALUE_TYPE_TINYINT:
+      return ValueFactory::GetTinyIntValue(
+          static_cast<int8_t>(slot.bigint_value));
+    case VALUE_TYPE_SMALLINT:
+      return ValueFactory::GetSmallIntValue(
+          static_cast<int16_t>(slot.bigint_value));
+    case VALUE_TYPE_INTEGER:
+      return ValueFactory::GetIntegerValue(
+          static_cast<int32_t>(slot.bigint_value));
+    case VALUE_TYPE_BIGINT:
+      return ValueFactory::GetBigIntValue(slot.bigint_value);
+    case VALUE_TYPE_DOUBLE:
+      return ValueFactory::GetDoubleValue(slot.double_value);
+    default:
+      throw UnknownTypeException(result_type, "Unbound aggregate slot");
+  }
+}
+
+Value AggregateArena::Finalize(oid_t group_offset, oid_t agg_offset) const {
+  assert(group_offset < group_count);
+  const Slot &slot = GetGroup(group_offset)[agg_offset];
+  auto &aggregate_type = aggregate_types[agg_offset];
+
+  if (IsCountType(aggregate_type.agg_type)) {
+    return ValueFactory::GetBigIntValue(slot.count);
+  }
+
+  if (slot.count == 0) {
+    return ValueFactory::GetNullValue();
+  }
+
+  if (aggregate_type.agg_type == EXPRESSION_TYPE_AGGREGATE_AVG) {
+    double sum = (aggregate_type.value_type == VALUE_TYPE_DOUBLE)
+                     ? slot.double_value
+                     : static_cast<double>(slot.bigint_value);
+    return ValueFactory::GetDoubleValue(sum / static_cast<double>(slot.count));
+  }
+
+  return GetSlotValue(aggregate_type, slot);
+}
+
+Agg *AggregateArena::GetAgg(oid_t group_offset, oid_t agg_offset) const {
+  assert(group_offset < group_count);
+  const Slot &slot = GetGroup(group_offset)[agg_offset];
+  auto &aggregate_type = aggregate_types[agg_offset];
+
+  switch (aggregate_type.agg_type) {
+    case EXPRESSION_TYPE_AGGREGATE_COUNT:
+      return new CountAgg(slot.count);
+    case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
+      return new CountStarAgg(slot.count);
+    case EXPRESSION_TYPE_AGGREGATE_AVG: {
+      AvgAgg *aggregate = new AvgAgg(false);
+      if (slot.count > 0) {
+        aggregate->Resume(GetSlotValue(aggregate_type, slot), slot.count);
+      }
+      return aggregate;
+    }
+    default: {
+      // SUM, MIN and MAX only need the value aggregated so far
+      Agg *aggregate = GetAggInstance(aggregate_type.agg_type);
+      if (slot.count > 0) {
+        aggregate->DAdvance(GetSlotValue(aggregate_type, slot));
+      }
+      return aggregate;
+    }
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// aggregate_arena.h
+//
+// Identification: src/backend/executor/aggregate_arena.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "backend/common/types.h"
+#include "backend/common/value.h"
+#include "backend/planner/aggregate_plan.h"
+
+namespace peloton {
+namespace executor {
+
+class Agg;
+
+//===--------------------------------------------------------------------===//
+// Aggregate Arena
+//===--------------------------------------------------------------------===//
+
+/**
+ * Per-group state of the aggregates of a hash aggregation.
+ *
+ * Every aggregate of a group takes one fixed-width slot, and the slots of a
+ * group follow each other in blocks of an arena, so adding a group does not
+ * allocate and advancing it does not go through a virtual call. Each
+ * aggregate is bound to the type of the first non-null value it sees, which
+ * picks its update kernel : 64-bit integer for the integer types and double
+ * for DOUBLE. Values of any other type, or of a type other than the bound
+ * one, are rejected and the caller moves the groups to Agg objects.
+ */
+class AggregateArena {
+ public:
+  AggregateArena(const AggregateArena &) = delete;
+  AggregateArena &operator=(const AggregateArena &) = delete;
+
+  typedef std::vector<planner::AggregatePlan::AggTerm> AggTermList;
+
+  explicit AggregateArena(const AggTermList &agg_terms);
+
+  // Whether the aggregates can be kept in an arena at all
+  static bool IsSupported(const AggTermList &agg_terms);
+
+  // Returns the offset of the state of the new group
+  oid_t AddGroup();
+
+  // Advances every aggregate of the group with its value, returns false
+  // without touching the group if a value does not fit a slot
+  bool Advance(oid_t group_offset, const std::vector<Value> &values);
+
+  Value Finalize(oid_t group_offset, oid_t agg_offset) const;
+
+  // Binds the unbound aggregates to the types of the other arena, returns
+  // false without binding anything if a bound type differs
+  bool AdoptTypes(const AggregateArena &other);
+
+  // Merges the state of a group of another arena with the same types into
+  // the group
+  void MergeGroup(oid_t group_offset, const AggregateArena &other,
+                  oid_t other_group_offset);
+
+  // Builds an Agg with the same state as the slot
+  Agg *GetAgg(oid_t group_offset, oid_t agg_offset) const;
+
+  size_t GetGroupCount() const { return group_count; }
+
+ private:
+  /** @brief State of one aggregate of a group */
+  struct Slot {
+    union {
+      int64_t bigint_value;
+      double double_value;
+    };
+
+    // values aggregated so far, also tells if the slot holds a value
+    int64_t count;
+  };
+
+  typedef void (*AdvanceFunction)(Slot &slot, const Value &value);
+
+  typedef void (*MergeFunction)(Slot &slot, const Slot &other);
+
+  // Update kernels for slots holding values of type T
+  template <typename T>
+  struct Kernels;
+
+  /** @brief Type of an aggregate, shared by all the groups */
+  struct AggregateType {
+    ExpressionType agg_type;
+
+    // type of the values, VALUE_TYPE_INVALID until the first non-null one
+    ValueType value_type;
+
+    AdvanceFunction advance;
+
+    MergeFunction merge;
+  };
+
+  // Picks the update kernel for values of the given type
+  bool Bind(AggregateType &aggregate_type, ValueType value_type);
+
+  inline Slot *GetGroup(oid_t group_offset) const {
+    return blocks[group_offset >> block_bits].get() +
+           (group_offset & block_mask) * aggregate_types.size();
+  }
+
+  Value GetSlotValue(const AggregateType &aggregate_type,
+                     const Slot &slot) const;
+
+  // Groups per block
+  static const size_t block_bits = 12;
+  static const oid_t block_mask = (oid_t(1) << block_bits) - 1;
+
+  std::vector<AggregateType> aggregate_types;
+
+  std::vector<std::unique_ptr<Slot[]>> blocks;
+
+  size_t group_count = 0;
+};
+
+}  // namespace executor
+}  // namespace peloton
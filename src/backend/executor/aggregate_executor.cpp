@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -18,13 +20,17 @@
 #include "backend/executor/aggregate_executor.h"
 #include "backend/executor/logical_tile_factory.h"
 #include "backend/executor/executor_context.h"
+#include "backend/executor/radix_partitioner.h"
 #include "backend/expression/container_tuple.h"
 #include "backend/planner/aggregate_plan.h"
-#include "backend/storage/table_factory.h"
+#include "backend/storage/temp_table.h"
+#include "backend/storage/tuple.h"
 
 namespace peloton {
 namespace executor {
 
+const size_t AggregateExecutor::partitions_per_worker;
+
 /**
  * @brief Constructor for aggregate executor.
  * @param node Aggregate node corresponding to this executor.
@@ -67,10 +73,7 @@ bool AggregateExecutor::DInit() {
   delete output_table;
 
   bool own_schema = false;
-  bool adapt_table = false;
-  output_table = storage::TableFactory::GetDataTable(
-      INVALID_OID, INVALID_OID, output_table_schema, "aggregate_temp_table",
-      DEFAULT_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
+  output_table = new storage::TempTable(output_table_schema, own_schema);
 
   return true;
 }
@@ -94,85 +97,90 @@ bool AggregateExecutor::DExecute() {
 
   // Grab info from plan node
   const planner::AggregatePlan &node = GetPlanNode<planner::AggregatePlan>();
-  auto transaction = executor_context_->GetTransaction();
-  auto transaction_id = transaction->GetTransactionId();
-
-  // Get an aggregator
-  std::unique_ptr<AbstractAggregator> aggregator(nullptr);
-
-  // Get input tiles and aggregate them
-  while (children_[0]->Execute() == true) {
-    std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
-
-    if (nullptr == aggregator.get()) {
-      // Initialize the aggregator
-      switch (node.GetAggregateStrategy()) {
-        case AGGREGATE_TYPE_HASH:
-          LOG_INFO("Use HashAggregator");
-          aggregator.reset(new HashAggregator(
-              &node, output_table, executor_context_, tile->GetColumnCount()));
-          break;
-        case AGGREGATE_TYPE_SORTED:
-          LOG_INFO("Use SortedAggregator");
-          aggregator.reset(new SortedAggregator(
-              &node, output_table, executor_context_, tile->GetColumnCount()));
-          break;
-        case AGGREGATE_TYPE_PLAIN:
-          LOG_INFO("Use PlainAggregator");
-          aggregator.reset(
-              new PlainAggregator(&node, output_table, executor_context_));
-          break;
-        default:
-          LOG_ERROR("Invalid aggregate type. Return.");
-          return false;
+
+  bool has_input = false;
+  bool finalized = false;
+
+  if (node.GetAggregateStrategy() == AGGREGATE_TYPE_HASH &&
+      node.GetParallelism() > 1) {
+    LOG_INFO("Use parallel HashAggregator");
+    has_input = ParallelHashAggregate(finalized);
+  } else {
+    // Get an aggregator
+    std::unique_ptr<AbstractAggregator> aggregator(nullptr);
+
+    // Get input tiles and aggregate them
+    while (children_[0]->Execute() == true) {
+      std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
+
+      if (nullptr == aggregator.get()) {
+        // Initialize the aggregator
+        switch (node.GetAggregateStrategy()) {
+          case AGGREGATE_TYPE_HASH:
+            LOG_INFO("Use HashAggregator");
+            aggregator.reset(new HashAggregator(&node, output_table,
+                                                executor_context_,
+                                                tile->GetColumnCount()));
+            break;
+          case AGGREGATE_TYPE_SORTED:
+            LOG_INFO("Use SortedAggregator");
+            aggregator.reset(new SortedAggregator(&node, output_table,
+                                                  executor_context_,
+                                                  tile->GetColumnCount()));
+            break;
+          case AGGREGATE_TYPE_PLAIN:
+            LOG_INFO("Use PlainAggregator");
+            aggregator.reset(
+                new PlainAggregator(&node, output_table, executor_context_));
+            break;
+          default:
+            LOG_ERROR("Invalid aggregate type. Return.");
+            return false;
+        }
       }
-    }
 
-    LOG_INFO("Looping over tile..");
+      LOG_INFO("Looping over tile..");
 
-    for (oid_t tuple_id : *tile) {
-      std::unique_ptr<expression::ContainerTuple<LogicalTile>> cur_tuple(
-          new expression::ContainerTuple<LogicalTile>(tile.get(), tuple_id));
+      for (oid_t tuple_id : *tile) {
+        std::unique_ptr<expression::ContainerTuple<LogicalTile>> cur_tuple(
+            new expression::ContainerTuple<LogicalTile>(tile.get(), tuple_id));
 
-      if (aggregator->Advance(cur_tuple.get()) == false) {
-        return false;
+        if (aggregator->Advance(cur_tuple.get()) == false) {
+          return false;
+        }
       }
+      LOG_TRACE("Finished processing logical tile");
     }
-    LOG_TRACE("Finished processing logical tile");
+
+    LOG_INFO("Finalizing..");
+    has_input = (aggregator.get() != nullptr);
+    finalized = has_input && aggregator->Finalize();
   }
 
-  LOG_INFO("Finalizing..");
-  if (!aggregator.get() || !aggregator->Finalize()) {
+  if (!finalized) {
     // If there's no tuples in the table and only if no group-by in the query,
     // we should return a NULL tuple
     // this is required by SQL
-    if (!aggregator.get() && node.GetGroupbyColIds().empty()) {
+    if (!has_input && node.GetGroupbyColIds().empty()) {
       LOG_INFO(
           "No tuples received and no group-by. Should insert a NULL tuple "
           "here.");
       std::unique_ptr<storage::Tuple> tuple(
           new storage::Tuple(output_table->GetSchema(), true));
       tuple->SetAllNulls();
-      output_table->InsertTuple(transaction, tuple.get());
+      output_table->InsertTuple(tuple.get());
     } else {
       done = true;
       return false;
     }
   }
 
-  // Transform output table into result
-  auto tile_group_count = output_table->GetTileGroupCount();
+  // Wrap the tiles of the output table
+  result = LogicalTileFactory::WrapTempTable(output_table);
 
-  if (tile_group_count == 0) return false;
-
-  for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
-       tile_group_itr++) {
-    auto tile_group = output_table->GetTileGroup(tile_group_itr);
-
-    // Get the logical tiles corresponding to the given tile group
-    auto logical_tile = LogicalTileFactory::WrapTileGroup(tile_group, transaction_id);
-
-    result.push_back(logical_tile);
+  if (result.empty()) {
+    done = true;
+    return false;
   }
 
   done = true;
@@ -184,5 +192,101 @@ bool AggregateExecutor::DExecute() {
   return true;
 }
 
+/**
+ * @brief Aggregates the input on the degree of parallelism of the plan.
+ * Workers pull tiles from the child and aggregate them into partial
+ * aggregators of their own. The groups of all partial aggregators are then
+ * merged by partition of the group-by keys, and written out.
+ * @param finalized Set if the results were written to the output table.
+ * @return false if the child produced no tiles.
+ */
+bool AggregateExecutor::ParallelHashAggregate(bool &finalized) {
+  const planner::AggregatePlan &node = GetPlanNode<planner::AggregatePlan>();
+  size_t worker_count = node.GetParallelism();
+  size_t partition_count = worker_count * partitions_per_worker;
+
+  // Phase 1 : partial aggregation per worker
+  std::vector<std::unique_ptr<HashAggregator>> partials(worker_count);
+  std::mutex child_mutex;
+  bool child_done = false;
+  size_t column_count = 0;
+  std::atomic<bool> advance_failed(false);
+
+  finalized = false;
+
+  RadixPartitioner::RunWorkers(worker_count, [&](size_t worker_id) {
+    auto &partial = partials[worker_id];
+
+    while (advance_failed == false) {
+      std::unique_ptr<LogicalTile> tile;
+      {
+        std::lock_guard<std::mutex> lock(child_mutex);
+        if (child_done) break;
+
+        // Stop the other workers too if the child fails
+        child_done = true;
+        if (children_[0]->Execute() == false) break;
+        tile.reset(children_[0]->GetOutput());
+        child_done = false;
+
+        column_count = tile->GetColumnCount();
+      }
+
+      if (partial == nullptr) {
+        partial.reset(new HashAggregator(&node, output_table, executor_context_,
+                                         tile->GetColumnCount()));
+      }
+
+      for (oid_t tuple_id : *tile) {
+        expression::ContainerTuple<LogicalTile> cur_tuple(tile.get(),
+                                                          tuple_id);
+        if (partial->Advance(&cur_tuple) == false) {
+          advance_failed = true;
+          break;
+        }
+      }
+    }
+
+    if (partial != nullptr) {
+      partial->PartitionGroups(partition_count);
+    }
+  });
+
+  std::vector<HashAggregator *> partial_aggregators;
+  for (auto &partial : partials) {
+    if (partial != nullptr) partial_aggregators.push_back(partial.get());
+  }
+
+  if (partial_aggregators.empty()) return false;
+  if (advance_failed) return true;
+
+  // Phase 2 : merge the groups of each partition
+  std::vector<std::unique_ptr<HashAggregator>> finals(partition_count);
+  std::vector<HashAggregator *> aggregators(partial_aggregators);
+  for (auto &final_aggregator : finals) {
+    final_aggregator.reset(new HashAggregator(&node, output_table,
+                                              executor_context_, column_count));
+    aggregators.push_back(final_aggregator.get());
+  }
+
+  HashAggregator::AlignForMerge(aggregators);
+
+  std::atomic<size_t> partition_cursor(0);
+  RadixPartitioner::RunWorkers(worker_count, [&](size_t) {
+    size_t partition;
+    while ((partition = partition_cursor.fetch_add(1)) < partition_count) {
+      finals[partition]->MergePartition(partial_aggregators, partition);
+    }
+  });
+
+  LOG_INFO("Finalizing..");
+  for (auto &final_aggregator : finals) {
+    if (final_aggregator->Finalize() == false) return true;
+  }
+
+  finalized = true;
+  return true;
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -13,7 +13,7 @@
 #pragma once
 
 #include "backend/executor/abstract_executor.h"
-#include "backend/storage/data_table.h"
+#include "backend/storage/temp_table.h"
 #include "backend/common/pool.h"
 
 #include <vector>
@@ -64,7 +64,14 @@ class AggregateExecutor : public AbstractExecutor {
   bool done = false;
 
   /** @brief Output table. */
-  storage::DataTable *output_table = nullptr;
+  storage::TempTable *output_table = nullptr;
+
+ private:
+  // Two-phase hash aggregation, returns false if the child had no input
+  bool ParallelHashAggregate(bool &finalized);
+
+  // Partitions of the groups per worker when merging partial aggregates
+  static const size_t partitions_per_worker = 4;
 };
 
 }  // namespace executor
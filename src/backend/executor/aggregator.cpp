@@ -15,7 +15,8 @@
 #include "backend/executor/aggregator.h"
 #include "backend/executor/executor_context.h"
 #include "backend/common/logger.h"
-#include "backend/storage/data_table.h"
+#include "backend/storage/temp_table.h"
+#include "backend/storage/tuple.h"
 
 namespace peloton {
 namespace executor {
@@ -78,6 +79,17 @@ Value Agg::Finalize() {
   return DFinalize();
 }
 
+void Agg::Merge(const Agg &other) {
+  if (is_distinct_) {
+    // Values in the set are deep copies already
+    for (auto &val : other.distinct_set_) {
+      distinct_set_.insert(val);
+    }
+  } else {
+    DMerge(other);
+  }
+}
+
 /*
  * Helper method responsible for inserting the results of the aggregation
  * into a new tuple in the output tile group as well as passing through any
@@ -88,26 +100,14 @@ Value Agg::Finalize() {
  * used to retrieve pass-through values;
  * Right is the tuple holding all aggregated values.
  */
-bool Helper(const planner::AggregatePlan *node, Agg **aggregates,
-            storage::DataTable *output_table,
+bool Helper(const planner::AggregatePlan *node,
+            std::vector<Value> &aggregate_values,
+            storage::TempTable *output_table,
             const AbstractTuple *delegate_tuple,
             executor::ExecutorContext *econtext) {
   auto schema = output_table->GetSchema();
   std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
 
-  /*
-   * 1) Construct a vector of aggregated values
-   */
-  std::vector<Value> aggregate_values;
-  auto &aggregate_terms = node->GetUniqueAggTerms();
-  for (oid_t column_itr = 0; column_itr < aggregate_terms.size();
-       column_itr++) {
-    if (aggregates[column_itr] != nullptr) {
-      Value final_val = aggregates[column_itr]->Finalize();
-      aggregate_values.push_back(final_val);
-    }
-  }
-
   /*
    * 2) Evaluate filter predicate;
    * if fail, just return
@@ -131,36 +131,60 @@ bool Helper(const planner::AggregatePlan *node, Agg **aggregates,
   LOG_TRACE("Tuple to Output :");
   LOG_TRACE("GROUP TUPLE :: %s", tuple->GetInfo().c_str());
 
-  auto location =
-      output_table->InsertTuple(econtext->GetTransaction(), tuple.get());
-  if (location.block == INVALID_OID) {
-    LOG_ERROR("Failed to insert tuple ");
-    return false;
-  }
+  output_table->InsertTuple(tuple.get());
 
   return true;
 }
 
+bool Helper(const planner::AggregatePlan *node, Agg **aggregates,
+            storage::TempTable *output_table,
+            const AbstractTuple *delegate_tuple,
+            executor::ExecutorContext *econtext) {
+  /*
+   * 1) Construct a vector of aggregated values
+   */
+  std::vector<Value> aggregate_values;
+  auto &aggregate_terms = node->GetUniqueAggTerms();
+  for (oid_t column_itr = 0; column_itr < aggregate_terms.size();
+       column_itr++) {
+    if (aggregates[column_itr] != nullptr) {
+      Value final_val = aggregates[column_itr]->Finalize();
+      aggregate_values.push_back(final_val);
+    }
+  }
+
+  return Helper(node, aggregate_values, output_table, delegate_tuple,
+                econtext);
+}
+
 //===--------------------------------------------------------------------===//
 // Hash Aggregator
 //===--------------------------------------------------------------------===//
 HashAggregator::HashAggregator(const planner::AggregatePlan *node,
-                               storage::DataTable *output_table,
+                               storage::TempTable *output_table,
                                executor::ExecutorContext *econtext,
                                size_t num_input_columns)
     : AbstractAggregator(node, output_table, econtext),
       num_input_columns(num_input_columns) {
   group_by_key_values.resize(node->GetGroupbyColIds().size(),
                              ValueFactory::GetNullValue());
+
+  // Keep the aggregates in an arena while their values allow it
+  if (AggregateArena::IsSupported(node->GetUniqueAggTerms())) {
+    aggregate_arena.reset(new AggregateArena(node->GetUniqueAggTerms()));
+  }
 }
 
 HashAggregator::~HashAggregator() {
   for (auto entry : aggregates_map) {
     // Clean up allocated storage
-    for (size_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
-      delete entry.second->aggregates[aggno];
+    if (entry.second->aggregates != nullptr) {
+      for (size_t aggno = 0; aggno < node->GetUniqueAggTerms().size();
+           aggno++) {
+        delete entry.second->aggregates[aggno];
+      }
+      delete[] entry.second->aggregates;
     }
-    delete[] entry.second->aggregates;
 
     delete entry.second;
   }
@@ -184,22 +208,13 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
   if (map_itr == aggregates_map.end()) {
     LOG_TRACE("Group-by key not found. Start a new group.");
     // Allocate new aggregate list
-    aggregate_list = new AggregateList();
-    aggregate_list->aggregates = new Agg *[node->GetUniqueAggTerms().size()];
+    aggregate_list = NewGroup();
     // Make a deep copy of the first tuple we meet
     for (size_t col_id = 0; col_id < num_input_columns; col_id++) {
       aggregate_list->first_tuple_values.push_back(
           ValueFactory::Clone(cur_tuple->GetValue(col_id), nullptr));
     };
 
-    for (oid_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
-      aggregate_list->aggregates[aggno] =
-          GetAggInstance(node->GetUniqueAggTerms()[aggno].aggtype);
-
-      bool distinct = node->GetUniqueAggTerms()[aggno].distinct;
-      aggregate_list->aggregates[aggno]->SetDistinct(distinct);
-    }
-
     aggregates_map.insert(
         HashAggregateMapType::value_type(group_by_key_values, aggregate_list));
   }
@@ -208,7 +223,8 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
     aggregate_list = map_itr->second;
   }
 
-  // Update the aggregation calculation
+  // Evaluate the values to aggregate
+  aggregate_values.clear();
   for (oid_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
     auto predicate = node->GetUniqueAggTerms()[aggno].expression;
     Value value = ValueFactory::GetIntegerValue(1);
@@ -216,19 +232,83 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
       value = node->GetUniqueAggTerms()[aggno].expression->Evaluate(
           cur_tuple, nullptr, this->executor_context);
     }
-    aggregate_list->aggregates[aggno]->Advance(value);
+    aggregate_values.push_back(value);
+  }
+
+  // Update the aggregation calculation
+  if (aggregate_arena != nullptr) {
+    if (aggregate_arena->Advance(aggregate_list->group_offset,
+                                 aggregate_values)) {
+      return true;
+    }
+
+    // A value does not fit in the arena
+    LeaveArena();
+  }
+
+  for (oid_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
+    aggregate_list->aggregates[aggno]->Advance(aggregate_values[aggno]);
   }
 
   return true;
 }
 
+HashAggregator::AggregateList *HashAggregator::NewGroup() {
+  AggregateList *aggregate_list = new AggregateList();
+
+  if (aggregate_arena != nullptr) {
+    aggregate_list->group_offset = aggregate_arena->AddGroup();
+    return aggregate_list;
+  }
+
+  aggregate_list->aggregates = new Agg *[node->GetUniqueAggTerms().size()];
+  for (oid_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
+    aggregate_list->aggregates[aggno] =
+        GetAggInstance(node->GetUniqueAggTerms()[aggno].aggtype);
+
+    bool distinct = node->GetUniqueAggTerms()[aggno].distinct;
+    aggregate_list->aggregates[aggno]->SetDistinct(distinct);
+  }
+
+  return aggregate_list;
+}
+
+void HashAggregator::LeaveArena() {
+  LOG_TRACE("Moving %lu groups out of the aggregate arena",
+            aggregates_map.size());
+
+  for (auto entry : aggregates_map) {
+    auto aggregate_list = entry.second;
+    aggregate_list->aggregates = new Agg *[node->GetUniqueAggTerms().size()];
+    for (oid_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
+      aggregate_list->aggregates[aggno] =
+          aggregate_arena->GetAgg(aggregate_list->group_offset, aggno);
+    }
+  }
+
+  aggregate_arena.reset();
+}
+
 bool HashAggregator::Finalize() {
   for (auto entry : aggregates_map) {
     // Construct a container for the first tuple
     expression::ContainerTuple<std::vector<Value>> first_tuple(
         &entry.second->first_tuple_values);
-    if (Helper(node, entry.second->aggregates, output_table, &first_tuple,
-               this->executor_context) == false) {
+
+    if (aggregate_arena != nullptr) {
+      aggregate_values.clear();
+      for (oid_t aggno = 0; aggno < node->GetUniqueAggTerms().size();
+           aggno++) {
+        aggregate_values.push_back(
+            aggregate_arena->Finalize(entry.second->group_offset, aggno));
+      }
+
+      if (Helper(node, aggregate_values, output_table, &first_tuple,
+                 this->executor_context) == false) {
+        return false;
+      }
+    } else if (Helper(node, entry.second->aggregates, output_table,
+                      &first_tuple, this->executor_context) == false) {
       return false;
     }
   }
@@ -236,12 +316,93 @@ bool HashAggregator::Finalize() {
   return true;
 }
 
+void HashAggregator::PartitionGroups(size_t partition_count) {
+  partitioned_groups.assign(partition_count, {});
+
+  ValueVectorHasher hasher;
+  for (auto &entry : aggregates_map) {
+    partitioned_groups[hasher(entry.first) % partition_count].push_back(
+        &entry);
+  }
+}
+
+void HashAggregator::AlignForMerge(
+    const std::vector<HashAggregator *> &aggregators) {
+  assert(aggregators.empty() == false);
+
+  bool keep_arena = true;
+  for (auto aggregator : aggregators) {
+    if (aggregator->aggregate_arena == nullptr) keep_arena = false;
+  }
+
+  // Gather the types bound in any arena, then bind all arenas to them
+  if (keep_arena) {
+    auto &arena = *aggregators.front()->aggregate_arena;
+    for (auto aggregator : aggregators) {
+      if (arena.AdoptTypes(*aggregator->aggregate_arena) == false) {
+        keep_arena = false;
+        break;
+      }
+    }
+
+    if (keep_arena) {
+      for (auto aggregator : aggregators) {
+        aggregator->aggregate_arena->AdoptTypes(arena);
+      }
+      return;
+    }
+  }
+
+  // Some aggregator cannot keep its groups in an arena, so none does
+  for (auto aggregator : aggregators) {
+    if (aggregator->aggregate_arena != nullptr) {
+      aggregator->LeaveArena();
+    }
+  }
+}
+
+void HashAggregator::MergePartition(
+    const std::vector<HashAggregator *> &partials, size_t partition) {
+  for (auto partial : partials) {
+    assert(partition < partial->partitioned_groups.size());
+    assert((partial->aggregate_arena == nullptr) ==
+           (aggregate_arena == nullptr));
+
+    for (auto entry : partial->partitioned_groups[partition]) {
+      AggregateList *partial_list = entry->second;
+      AggregateList *aggregate_list;
+
+      auto map_itr = aggregates_map.find(entry->first);
+      if (map_itr == aggregates_map.end()) {
+        aggregate_list = NewGroup();
+        aggregate_list->first_tuple_values = partial_list->first_tuple_values;
+        aggregates_map.insert(
+            HashAggregateMapType::value_type(entry->first, aggregate_list));
+      } else {
+        aggregate_list = map_itr->second;
+      }
+
+      if (aggregate_arena != nullptr) {
+        aggregate_arena->MergeGroup(aggregate_list->group_offset,
+                                    *partial->aggregate_arena,
+                                    partial_list->group_offset);
+      } else {
+        for (oid_t aggno = 0; aggno < node->GetUniqueAggTerms().size();
+             aggno++) {
+          aggregate_list->aggregates[aggno]->Merge(
+              *partial_list->aggregates[aggno]);
+        }
+      }
+    }
+  }
+}
+
 //===--------------------------------------------------------------------===//
 // Sort Aggregator
 //===--------------------------------------------------------------------===//
 
 SortedAggregator::SortedAggregator(const planner::AggregatePlan *node,
-                                   storage::DataTable *output_table,
+                                   storage::TempTable *output_table,
                                    executor::ExecutorContext *econtext,
                                    size_t num_input_columns)
     : AbstractAggregator(node, output_table, econtext),
@@ -348,7 +509,7 @@ bool SortedAggregator::Finalize() {
 // Plain Aggregator
 //===--------------------------------------------------------------------===//
 PlainAggregator::PlainAggregator(const planner::AggregatePlan *node,
-                                 storage::DataTable *output_table,
+                                 storage::TempTable *output_table,
                                  executor::ExecutorContext *econtext)
     : AbstractAggregator(node, output_table, econtext) {
   // allocate aggregators
@@ -17,6 +17,7 @@
 
 #include "backend/common/value_factory.h"
 #include "backend/executor/abstract_executor.h"
+#include "backend/executor/aggregate_arena.h"
 #include "backend/planner/aggregate_plan.h"
 #include "backend/expression/container_tuple.h"
 
@@ -27,7 +28,7 @@
 namespace peloton {
 
 namespace storage {
-class DataTable;
+class TempTable;
 }
 
 namespace executor {
@@ -45,8 +46,12 @@ class Agg {
   void Advance(const Value val);
   Value Finalize();
 
+  // Adds the state of a partial aggregate of the same type
+  void Merge(const Agg &other);
+
   virtual void DAdvance(const Value val) = 0;
   virtual Value DFinalize() = 0;
+  virtual void DMerge(const Agg &other) = 0;
 
  private:
   typedef std::unordered_set<Value, Value::hash, Value::equal_to>
@@ -82,6 +87,13 @@ class SumAgg : public Agg {
     return aggregate;
   }
 
+  void DMerge(const Agg &other) {
+    auto &other_sum = static_cast<const SumAgg &>(other);
+    if (other_sum.have_advanced) {
+      DAdvance(other_sum.aggregate);
+    }
+  }
+
  private:
   Value aggregate;
 
@@ -94,6 +106,12 @@ class AvgAgg : public Agg {
     default_delta = ValueFactory::GetIntegerValue(1);
   }
 
+  // Continue from the sum of count values aggregated elsewhere
+  void Resume(const Value sum, int64_t sum_count) {
+    aggregate = sum;
+    count = sum_count;
+  }
+
   void DAdvance(const Value val) { this->DAdvance(val, default_delta); }
 
   void DAdvance(const Value val, const Value delta) {
@@ -129,6 +147,19 @@ class AvgAgg : public Agg {
     return final_result;
   }
 
+  void DMerge(const Agg &other) {
+    auto &other_avg = static_cast<const AvgAgg &>(other);
+    if (other_avg.count == 0) {
+      return;
+    }
+    if (count == 0) {
+      aggregate = other_avg.aggregate;
+    } else {
+      aggregate = aggregate.OpAdd(other_avg.aggregate);
+    }
+    count += other_avg.count;
+  }
+
  private:
   /** @brief aggregate initialized on first advance. */
   Value aggregate;
@@ -145,7 +176,7 @@ class AvgAgg : public Agg {
 // count always holds integer
 class CountAgg : public Agg {
  public:
-  CountAgg() : count(0) {}
+  explicit CountAgg(int64_t count = 0) : count(count) {}
 
   void DAdvance(const Value val) {
     if (val.IsNull()) {
@@ -156,18 +187,26 @@ class CountAgg : public Agg {
 
   Value DFinalize() { return ValueFactory::GetBigIntValue(count); }
 
+  void DMerge(const Agg &other) {
+    count += static_cast<const CountAgg &>(other).count;
+  }
+
  private:
   int64_t count;
 };
 
 class CountStarAgg : public Agg {
  public:
-  CountStarAgg() : count(0) {}
+  explicit CountStarAgg(int64_t count = 0) : count(count) {}
 
   void DAdvance(const Value val __attribute__((unused))) { ++count; }
 
   Value DFinalize() { return ValueFactory::GetBigIntValue(count); }
 
+  void DMerge(const Agg &other) {
+    count += static_cast<const CountStarAgg &>(other).count;
+  }
+
  private:
   int64_t count;
 };
@@ -195,6 +234,13 @@ class MaxAgg : public Agg {
     return aggregate;
   }
 
+  void DMerge(const Agg &other) {
+    auto &other_max = static_cast<const MaxAgg &>(other);
+    if (other_max.have_advanced) {
+      DAdvance(other_max.aggregate);
+    }
+  }
+
  private:
   Value aggregate;
 
@@ -225,6 +271,13 @@ class MinAgg : public Agg {
     return aggregate;
   }
 
+  void DMerge(const Agg &other) {
+    auto &other_min = static_cast<const MinAgg &>(other);
+    if (other_min.have_advanced) {
+      DAdvance(other_min.aggregate);
+    }
+  }
+
  private:
   Value aggregate;
 
@@ -243,7 +296,7 @@ Agg *GetAggInstance(ExpressionType agg_type);
 class AbstractAggregator {
  public:
   AbstractAggregator(const planner::AggregatePlan *node,
-                     storage::DataTable *output_table,
+                     storage::TempTable *output_table,
                      executor::ExecutorContext *econtext)
       : node(node), output_table(output_table), executor_context(econtext) {}
 
@@ -258,7 +311,7 @@ class AbstractAggregator {
   const planner::AggregatePlan *node;
 
   /** @brief Output table */
-  storage::DataTable *output_table;
+  storage::TempTable *output_table;
 
   /** @brief Executor Context */
   executor::ExecutorContext *executor_context = nullptr;
@@ -271,7 +324,7 @@ class AbstractAggregator {
 class HashAggregator : public AbstractAggregator {
  public:
   HashAggregator(const planner::AggregatePlan *node,
-                 storage::DataTable *output_table,
+                 storage::TempTable *output_table,
                  executor::ExecutorContext *econtext, size_t num_input_columns);
 
   bool Advance(AbstractTuple *next_tuple) override;
@@ -280,6 +333,23 @@ class HashAggregator : public AbstractAggregator {
 
   ~HashAggregator();
 
+  //===--------------------------------------------------------------------===//
+  // Two-phase aggregation
+  //===--------------------------------------------------------------------===//
+
+  // Splits the groups of a partial aggregator by the hash of their
+  // group-by key, once it has seen all its input
+  void PartitionGroups(size_t partition_count);
+
+  // Gives the aggregators the same state layout, so that they can be merged
+  static void AlignForMerge(const std::vector<HashAggregator *> &aggregators);
+
+  // Merges the groups of a partition of every partial aggregator. Groups of
+  // different partitions are disjoint, so each partition can be merged into
+  // its own aggregator concurrently.
+  void MergePartition(const std::vector<HashAggregator *> &partials,
+                      size_t partition);
+
  private:
   const size_t num_input_columns;
 
@@ -288,10 +358,20 @@ class HashAggregator : public AbstractAggregator {
     // Keep a deep copy of the first tuple we met of this group
     std::vector<Value> first_tuple_values;
 
-    // The aggregates for each column for this group
+    // The aggregates for each column for this group,
+    // nullptr while the group is kept in the arena
     Agg **aggregates;
+
+    // Offset of the group in the arena
+    oid_t group_offset;
   };
 
+  // Allocates the aggregates of a new group
+  AggregateList *NewGroup();
+
+  // Moves every group out of the arena into Agg objects
+  void LeaveArena();
+
   /** Hash function of internal hash table */
   struct ValueVectorHasher
       : std::unary_function<std::vector<Value>, std::size_t> {
@@ -314,6 +394,16 @@ class HashAggregator : public AbstractAggregator {
 
   /** @brief Hash table */
   HashAggregateMapType aggregates_map;
+
+  /** @brief Aggregate state of the groups, nullptr when kept in Agg objects */
+  std::unique_ptr<AggregateArena> aggregate_arena;
+
+  /** @brief Values of the aggregates for the current tuple */
+  std::vector<Value> aggregate_values;
+
+  /** @brief Groups of each partition, for merging partial aggregates */
+  std::vector<std::vector<const HashAggregateMapType::value_type *>>
+      partitioned_groups;
 };
 
 /**
@@ -322,7 +412,7 @@ class HashAggregator : public AbstractAggregator {
 class SortedAggregator : public AbstractAggregator {
  public:
   SortedAggregator(const planner::AggregatePlan *node,
-                   storage::DataTable *output_table,
+                   storage::TempTable *output_table,
                    executor::ExecutorContext *econtext,
                    size_t num_input_columns);
 
@@ -346,7 +436,7 @@ class SortedAggregator : public AbstractAggregator {
 class PlainAggregator : public AbstractAggregator {
  public:
   PlainAggregator(const planner::AggregatePlan *node,
-                  storage::DataTable *output_table,
+                  storage::TempTable *output_table,
                   executor::ExecutorContext *econtext);
 
   bool Advance(AbstractTuple *next_tuple) override;
@@ -100,11 +100,9 @@ bool DeleteExecutor::DExecute() {
 
       if (log_manager.IsInLoggingMode()) {
         auto logger = log_manager.GetBackendLogger();
-        auto record = logger->GetTupleRecord(
+        logger->LogTupleRecord(
             LOGRECORD_TYPE_TUPLE_DELETE, transaction_->GetTransactionId(),
             target_table_->GetOid(), INVALID_ITEMPOINTER, delete_location);
-
-        logger->Log(record);
       }
     }
 
@@ -0,0 +1,165 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// exchange_executor.cpp
+//
+// Identification: src/backend/executor/exchange_executor.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/executor/exchange_executor.h"
+
+#include "backend/common/logger.h"
+#include "backend/executor/logical_tile.h"
+
+namespace peloton {
+namespace executor {
+
+/**
+ * @brief Constructor for exchange executor.
+ * @param node Exchange node corresponding to this executor.
+ */
+ExchangeExecutor::ExchangeExecutor(const planner::AbstractPlan *node,
+                                   ExecutorContext *executor_context)
+    : AbstractExecutor(node, executor_context) {}
+
+ExchangeExecutor::~ExchangeExecutor() { StopWorkers(); }
+
+/**
+ * @brief Stops the workers of an earlier run, then initializes the children
+ * and this executor.
+ * @return true on success, false otherwise.
+ */
+bool ExchangeExecutor::Init() {
+  StopWorkers();
+
+  return AbstractExecutor::Init();
+}
+
+/**
+ * @brief Splits the input of the children between them.
+ * @return true on success, false otherwise.
+ */
+bool ExchangeExecutor::DInit() {
+  assert(children_.size() >= 1);
+  assert(workers_.empty());
+
+  const planner::ExchangePlan &node = GetPlanNode<planner::ExchangePlan>();
+
+  // Keep a couple of tiles per worker in flight by default
+  queue_capacity_ = node.GetQueueCapacity();
+  if (queue_capacity_ == 0) queue_capacity_ = children_.size() * 2;
+
+  // A single copy processes its whole input
+  if (children_.size() == 1) return true;
+
+  auto scan_cursor = std::make_shared<std::atomic<oid_t>>(START_OID);
+  for (oid_t child_itr = 0; child_itr < children_.size(); child_itr++) {
+    if (children_[child_itr]->SetSharedScanCursor(scan_cursor) == false) {
+      LOG_ERROR("Exchange child %lu cannot be parallelized", child_itr);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Hands the filter to every copy of the subtree.
+ * @return true if any of the copies will apply it.
+ */
+bool ExchangeExecutor::SetBloomFilter(
+    std::shared_ptr<const JoinBloomFilter> filter,
+    const std::vector<oid_t> &column_ids) {
+  // Too late once the workers are running
+  if (exchange_queue_ != nullptr) return false;
+
+  bool status = false;
+  for (auto child : children_) {
+    if (child->SetBloomFilter(filter, column_ids)) status = true;
+  }
+  return status;
+}
+
+/**
+ * @brief Returns the next tile produced by any of the children.
+ * @return true on success, false once all children are exhausted.
+ */
+bool ExchangeExecutor::DExecute() {
+  if (exchange_queue_ == nullptr) {
+    StartWorkers();
+  }
+
+  LogicalTile *logical_tile = exchange_queue_->Pop();
+
+  {
+    std::lock_guard<std::mutex> lock(worker_error_mutex_);
+    if (worker_error_ != nullptr) {
+      delete logical_tile;
+      auto worker_error = worker_error_;
+      worker_error_ = nullptr;
+      StopWorkers();
+      std::rethrow_exception(worker_error);
+    }
+  }
+
+  if (logical_tile == nullptr) {
+    return false;
+  }
+
+  SetOutput(logical_tile);
+  return true;
+}
+
+void ExchangeExecutor::StartWorkers() {
+  LOG_TRACE("Exchange executor :: starting %lu workers", children_.size());
+
+  exchange_queue_.reset(new ExchangeQueue(queue_capacity_, children_.size()));
+
+  for (auto child : children_) {
+    workers_.push_back(std::thread(&ExchangeExecutor::Worker, this, child));
+  }
+}
+
+/**
+ * @brief Cancels and joins the workers, dropping unconsumed tiles.
+ */
+void ExchangeExecutor::StopWorkers() {
+  if (exchange_queue_ != nullptr) {
+    exchange_queue_->Cancel();
+  }
+
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+
+  workers_.clear();
+  exchange_queue_.reset();
+}
+
+void ExchangeExecutor::Worker(AbstractExecutor *child) {
+  try {
+    while (exchange_queue_->IsCancelled() == false && child->Execute()) {
+      std::unique_ptr<LogicalTile> logical_tile(child->GetOutput());
+      if (logical_tile == nullptr) continue;
+
+      if (exchange_queue_->Push(logical_tile.get()) == false) break;
+      logical_tile.release();
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(worker_error_mutex_);
+      if (worker_error_ == nullptr) worker_error_ = std::current_exception();
+    }
+    // Wakes up the parent and the other workers
+    exchange_queue_->Cancel();
+  }
+
+  exchange_queue_->ProducerDone();
+}
+
+}  // namespace executor
+}  // namespace peloton
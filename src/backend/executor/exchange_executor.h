@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// exchange_executor.h
+//
+// Identification: src/backend/executor/exchange_executor.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "backend/executor/abstract_executor.h"
+#include "backend/executor/exchange_queue.h"
+#include "backend/planner/exchange_plan.h"
+
+namespace peloton {
+namespace executor {
+
+/**
+ * @brief Runs each child, all copies of the same subtree, on its own worker
+ *        thread and returns their output tiles as they arrive.
+ */
+class ExchangeExecutor : public AbstractExecutor {
+ public:
+  ExchangeExecutor(const ExchangeExecutor &) = delete;
+  ExchangeExecutor &operator=(const ExchangeExecutor &) = delete;
+  ExchangeExecutor(ExchangeExecutor &&) = delete;
+  ExchangeExecutor &operator=(ExchangeExecutor &&) = delete;
+
+  explicit ExchangeExecutor(const planner::AbstractPlan *node,
+                            ExecutorContext *executor_context);
+
+  // Cancels and joins the workers, so it must run before the children
+  // are destroyed
+  ~ExchangeExecutor();
+
+  // Joins the workers of an earlier run before the children are
+  // initialized again under them
+  bool Init();
+
+  bool SetBloomFilter(std::shared_ptr<const JoinBloomFilter> filter,
+                      const std::vector<oid_t> &column_ids);
+
+ protected:
+  bool DInit();
+
+  bool DExecute();
+
+ private:
+  void StartWorkers();
+
+  void StopWorkers();
+
+  void Worker(AbstractExecutor *child);
+
+  //===--------------------------------------------------------------------===//
+  // Executor State
+  //===--------------------------------------------------------------------===//
+
+  /** @brief Output tiles of all children. */
+  std::unique_ptr<ExchangeQueue> exchange_queue_;
+
+  std::vector<std::thread> workers_;
+
+  /** @brief First error raised by a worker, rethrown in DExecute. */
+  std::mutex worker_error_mutex_;
+  std::exception_ptr worker_error_;
+
+  //===--------------------------------------------------------------------===//
+  // Plan Info
+  //===--------------------------------------------------------------------===//
+
+  size_t queue_capacity_ = 0;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// exchange_queue.cpp
+//
+// Identification: src/backend/executor/exchange_queue.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/executor/exchange_queue.h"
+
+#include <chrono>
+#include <thread>
+
+#include "backend/executor/logical_tile.h"
+
+namespace peloton {
+namespace executor {
+
+ExchangeQueue::ExchangeQueue(size_t capacity, size_t producer_count)
+    : enqueue_position(0),
+      dequeue_position(0),
+      active_producer_count(producer_count),
+      cancelled(false) {
+  size_t cell_count = 2;
+  while (cell_count < capacity) cell_count <<= 1;
+
+  cells.reset(new Cell[cell_count]);
+  mask = cell_count - 1;
+
+  for (size_t cell_itr = 0; cell_itr < cell_count; cell_itr++) {
+    cells[cell_itr].sequence.store(cell_itr, std::memory_order_relaxed);
+    cells[cell_itr].tile = nullptr;
+  }
+}
+
+ExchangeQueue::~ExchangeQueue() {
+  // Free the tiles nobody consumed
+  LogicalTile *tile = nullptr;
+  while (TryPop(tile)) {
+    delete tile;
+  }
+}
+
+bool ExchangeQueue::Push(LogicalTile *tile) {
+  size_t attempt = 0;
+  while (IsCancelled() == false) {
+    if (TryPush(tile)) return true;
+    Backoff(attempt);
+  }
+
+  return false;
+}
+
+LogicalTile *ExchangeQueue::Pop() {
+  LogicalTile *tile = nullptr;
+  size_t attempt = 0;
+  while (IsCancelled() == false) {
+    if (TryPop(tile)) return tile;
+
+    // A producer may have pushed right before finishing
+    if (active_producer_count.load(std::memory_order_acquire) == 0) {
+      return TryPop(tile) ? tile : nullptr;
+    }
+
+    Backoff(attempt);
+  }
+
+  return nullptr;
+}
+
+void ExchangeQueue::ProducerDone() {
+  active_producer_count.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void ExchangeQueue::Cancel() {
+  cancelled.store(true, std::memory_order_release);
+}
+
+bool ExchangeQueue::TryPush(LogicalTile *tile) {
+  size_t position = enqueue_position.load(std::memory_order_relaxed);
+
+  while (true) {
+    Cell *cell = &cells[position & mask];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+    if (difference == 0) {
+      // Cell is free for this position, claim it
+      if (enqueue_position.compare_exchange_weak(position, position + 1,
+                                                 std::memory_order_relaxed)) {
+        cell->tile = tile;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (difference < 0) {
+      // Queue is full
+      return false;
+    } else {
+      position = enqueue_position.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool ExchangeQueue::TryPop(LogicalTile *&tile) {
+  size_t position = dequeue_position.load(std::memory_order_relaxed);
+
+  while (true) {
+    Cell *cell = &cells[position & mask];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+
+    if (difference == 0) {
+      // Cell holds the tile for this position, claim it
+      if (dequeue_position.compare_exchange_weak(position, position + 1,
+                                                 std::memory_order_relaxed)) {
+        tile = cell->tile;
+        cell->sequence.store(position + mask + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (difference < 0) {
+      // Queue is empty
+      return false;
+    } else {
+      position = dequeue_position.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void ExchangeQueue::Backoff(size_t &attempt) {
+  attempt++;
+  if (attempt < 64) {
+    return;
+  } else if (attempt < 128) {
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
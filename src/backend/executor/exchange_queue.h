@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// exchange_queue.h
+//
+// Identification: src/backend/executor/exchange_queue.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace executor {
+
+class LogicalTile;
+
+//===--------------------------------------------------------------------===//
+// Exchange Queue
+//===--------------------------------------------------------------------===//
+
+/**
+ * Bounded lock-free queue of logical tiles between the worker threads of a
+ * parallel pipeline (producers) and the executor that pulls from them
+ * (consumer). It is an array of sequence-numbered cells, so producers and
+ * consumers only contend on their own position counter.
+ *
+ * Push blocks while the queue is full, which throttles the workers to the
+ * speed of the consumer. Pop blocks until a tile arrives and returns nullptr
+ * once every producer has finished and the queue is drained. Cancel makes
+ * both return right away; tiles still in the queue are freed by the queue.
+ */
+class ExchangeQueue {
+ public:
+  ExchangeQueue(ExchangeQueue const &) = delete;
+  ExchangeQueue &operator=(ExchangeQueue const &) = delete;
+
+  // Capacity is rounded up to a power of two
+  ExchangeQueue(size_t capacity, size_t producer_count);
+
+  ~ExchangeQueue();
+
+  // Returns false if the queue was cancelled, the caller keeps the tile
+  bool Push(LogicalTile *tile);
+
+  // Returns nullptr when all producers are done or the queue was cancelled
+  LogicalTile *Pop();
+
+  // Called by each producer once it has pushed its last tile
+  void ProducerDone();
+
+  void Cancel();
+
+  bool IsCancelled() const { return cancelled.load(std::memory_order_acquire); }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    LogicalTile *tile;
+  };
+
+  bool TryPush(LogicalTile *tile);
+
+  bool TryPop(LogicalTile *&tile);
+
+  // Spin, then yield, then sleep while waiting on the other side
+  static void Backoff(size_t &attempt);
+
+  std::unique_ptr<Cell[]> cells;
+
+  size_t mask;
+
+  // producer and consumer positions live on separate cache lines
+  std::atomic<size_t> enqueue_position;
+  char enqueue_padding[CACHELINE_SIZE - sizeof(std::atomic<size_t>)];
+
+  std::atomic<size_t> dequeue_position;
+  char dequeue_padding[CACHELINE_SIZE - sizeof(std::atomic<size_t>)];
+
+  std::atomic<size_t> active_producer_count;
+
+  std::atomic<bool> cancelled;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -27,6 +27,8 @@
 #include "backend/executor/hash_join_executor.h"
 #include "backend/executor/hash_executor.h"
 #include "backend/executor/order_by_executor.h"
+#include "backend/executor/top_n_executor.h"
 #include "backend/executor/hash_set_op_executor.h"
 #include "backend/executor/append_executor.h"
 #include "backend/executor/projection_executor.h"
+#include "backend/executor/exchange_executor.h"
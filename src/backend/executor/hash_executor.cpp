@@ -17,6 +17,7 @@
 #include "backend/common/value.h"
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/hash_executor.h"
+#include "backend/executor/radix_partitioner.h"
 #include "backend/planner/hash_plan.h"
 #include "backend/expression/tuple_value_expression.h"
 
@@ -39,6 +40,8 @@ bool HashExecutor::DInit() {
 
   // Initialize executor state
   done_ = false;
+  partitioned_ = false;
+  bloom_filter_.reset();
   result_itr = 0;
 
   return true;
@@ -50,9 +53,13 @@ bool HashExecutor::DExecute() {
   if (done_ == false) {
     const planner::HashPlan &node = GetPlanNode<planner::HashPlan>();
 
-    // First, get all the input logical tiles
+    // First, get all the input logical tiles. Empty tiles are never
+    // returned, so they are not kept either, which keeps the tile offsets
+    // in the hash table in line with the tiles the hash join receives.
     while (children_[0]->Execute()) {
-      child_tiles_.emplace_back(children_[0]->GetOutput());
+      std::unique_ptr<LogicalTile> child_tile(children_[0]->GetOutput());
+      if (child_tile->GetTupleCount() == 0) continue;
+      child_tiles_.emplace_back(child_tile.release());
     }
 
     if (child_tiles_.size() == 0) {
@@ -69,6 +76,7 @@ bool HashExecutor::DExecute() {
     auto &hashkeys = node.GetHashKeys();
 
     // Construct a logical tile
+    column_ids_.clear();
     for (auto &hashkey : hashkeys) {
       assert(hashkey->GetExpressionType() == EXPRESSION_TYPE_VALUE_TUPLE);
       auto tuple_value =
@@ -77,18 +85,46 @@ bool HashExecutor::DExecute() {
       column_ids_.push_back(tuple_value->GetColumnId());
     }
 
+    // Size the hash table up front
+    size_t tuple_count = 0;
+    for (auto &child_tile : child_tiles_) {
+      tuple_count += child_tile->GetTupleCount();
+    }
+
+    hash_table_.Clear(column_ids_.size());
+
+    // Leave a build side that does not fit in cache to the partitioned join
+    if (partitioning_enabled_) {
+      size_t build_size =
+          tuple_count * JoinHashTable::GetTupleFootprint(column_ids_.size());
+      partitioned_ = partition_always_ ||
+                     RadixPartitioner::GetPartitionBits(build_size, 1) > 0;
+    }
+
+    if (partitioned_ == false) {
+      hash_table_.Reserve(tuple_count);
+    }
+
+    bloom_filter_ = std::make_shared<JoinBloomFilter>(tuple_count);
+
     // Construct the hash table by going over each child logical tile and
     // hashing
+    std::vector<Value> key(column_ids_.size());
     for (size_t child_tile_itr = 0; child_tile_itr < child_tiles_.size();
          child_tile_itr++) {
       auto tile = child_tiles_[child_tile_itr].get();
 
       // Go over all tuples in the logical tile
       for (oid_t tuple_id : *tile) {
-        // Key : container tuple with a subset of tuple attributes
+        // Key : values of the hash key attributes
         // Value : < child_tile offset, tuple offset >
-        hash_table_[HashMapType::key_type(tile, tuple_id, &column_ids_)].insert(
-            std::make_pair(child_tile_itr, tuple_id));
+        auto hash =
+            JoinHashTable::GetKey(tile, tuple_id, column_ids_, key.data());
+        bloom_filter_->Insert(hash);
+
+        if (partitioned_ == false) {
+          hash_table_.Insert(hash, key.data(), child_tile_itr, tuple_id);
+        }
       }
     }
 
@@ -12,15 +12,13 @@
 
 #pragma once
 
-#include <unordered_map>
-#include <unordered_set>
+#include <memory>
 
 #include "backend/common/types.h"
 #include "backend/executor/abstract_executor.h"
+#include "backend/executor/join_bloom_filter.h"
+#include "backend/executor/join_hash_table.h"
 #include "backend/executor/logical_tile.h"
-#include "backend/expression/container_tuple.h"
-
-#include <boost/functional/hash.hpp>
 
 namespace peloton {
 namespace executor {
@@ -39,20 +37,31 @@ class HashExecutor : public AbstractExecutor {
   explicit HashExecutor(const planner::AbstractPlan *node,
                         ExecutorContext *executor_context);
 
-  /** @brief Type definitions for hash table */
-  typedef std::unordered_map<
-      expression::ContainerTuple<LogicalTile>,
-      std::unordered_set<std::pair<size_t, oid_t>,
-                         boost::hash<std::pair<size_t, oid_t>>>,
-      expression::ContainerTupleHasher<LogicalTile>,
-      expression::ContainerTupleComparator<LogicalTile>> HashMapType;
-
-  inline HashMapType &GetHashTable() { return this->hash_table_; }
+  inline const JoinHashTable &GetHashTable() const {
+    return this->hash_table_;
+  }
 
   inline const std::vector<oid_t> &GetHashKeyIds() const {
     return this->column_ids_;
   }
 
+  /**
+   * @brief Lets the hash join partition the build side itself, always or
+   *        only when the hash table would not fit in cache. The hash table
+   *        is left empty when the build side is partitioned.
+   */
+  inline void EnablePartitioning(bool always) {
+    partitioning_enabled_ = true;
+    partition_always_ = always;
+  }
+
+  inline bool IsPartitioned() const { return partitioned_; }
+
+  // Filter over the key hashes of all build-side tuples
+  inline std::shared_ptr<const JoinBloomFilter> GetBloomFilter() const {
+    return this->bloom_filter_;
+  }
+
  protected:
   bool DInit();
 
@@ -60,13 +69,22 @@ class HashExecutor : public AbstractExecutor {
 
  private:
   /** @brief Hash table */
-  HashMapType hash_table_;
+  JoinHashTable hash_table_;
+
+  /** @brief Bloom filter for the probe-side scan */
+  std::shared_ptr<JoinBloomFilter> bloom_filter_;
 
   /** @brief Input tiles from child node */
   std::vector<std::unique_ptr<LogicalTile>> child_tiles_;
 
   std::vector<oid_t> column_ids_;
 
+  bool partitioning_enabled_ = false;
+
+  bool partition_always_ = false;
+
+  bool partitioned_ = false;
+
   bool done_ = false;
 
   size_t result_itr = 0;
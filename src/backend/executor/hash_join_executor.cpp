@@ -10,8 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
+#include <tuple>
 #include <vector>
-#include <unordered_map>
 
 #include "backend/common/types.h"
 #include "backend/common/logger.h"
@@ -31,6 +33,13 @@ HashJoinExecutor::HashJoinExecutor(const planner::AbstractPlan *node,
                                    ExecutorContext *executor_context)
     : AbstractJoinExecutor(node, executor_context) {}
 
+HashJoinExecutor::~HashJoinExecutor() {
+  // Free the output of a partitioned join nobody asked for
+  for (auto output_tile : buffered_output_tiles) {
+    delete output_tile;
+  }
+}
+
 bool HashJoinExecutor::DInit() {
   assert(children_.size() == 2);
 
@@ -41,6 +50,10 @@ bool HashJoinExecutor::DInit() {
 
   hash_executor_ = reinterpret_cast<HashExecutor *>(children_[1]);
 
+  // Large build sides are partitioned instead of hashed into one table
+  const planner::HashJoinPlan &node = GetPlanNode<planner::HashJoinPlan>();
+  hash_executor_->EnablePartitioning(node.GetParallelism() > 1);
+
   return true;
 }
 
@@ -53,6 +66,13 @@ bool HashJoinExecutor::DExecute() {
   // Loop until we have non-empty result join logical tile or exit
   // Build outer join output when done
   if (left_child_done_ && right_child_done_) {
+    // Output of the partitioned join comes first
+    if (buffered_output_tiles.empty() == false) {
+      SetOutput(buffered_output_tiles.front());
+      buffered_output_tiles.pop_front();
+      return true;
+    }
+
     return BuildOuterJoinOutput();
   }
 
@@ -71,6 +91,30 @@ bool HashJoinExecutor::DExecute() {
     LOG_TRACE("Right child is exhausted.");
     assert(!right_result_tiles_.empty());
     right_child_done_ = true;
+
+    // Left tuples without a match are only needed by left and outer joins,
+    // otherwise let the scan below drop them early
+    if (join_type_ == JOIN_TYPE_INNER || join_type_ == JOIN_TYPE_RIGHT) {
+      if (children_[0]->SetBloomFilter(hash_executor_->GetBloomFilter(),
+                                       hash_executor_->GetHashKeyIds())) {
+        LOG_TRACE("Pushed the Bloom filter down to the left child.");
+      }
+    }
+  }
+
+  // The partitioned join needs the whole left side at once
+  if (hash_executor_->IsPartitioned()) {
+    LOG_TRACE("Retrieve all tiles from Left child.");
+    while (children_[0]->Execute()) {
+      BufferLeftTile(children_[0]->GetOutput());
+    }
+
+    LOG_TRACE("Left child is exhausted.");
+    assert(!left_result_tiles_.empty());
+    left_child_done_ = true;
+
+    ExecutePartitionedJoin();
+    return DExecute();
   }
 
   // Get next logical tile from LEFT child when needed
@@ -80,6 +124,7 @@ bool HashJoinExecutor::DExecute() {
       LOG_TRACE("Retrieve a new title from the left child.");
       BufferLeftTile(children_[0]->GetOutput());
       right_logical_tile_itr_ = 0;
+      ProbeLeftTile(left_result_tiles_.back().get());
     } else {
       LOG_TRACE("Left child is exhausted.");
       assert(!left_result_tiles_.empty());
@@ -103,35 +148,35 @@ bool HashJoinExecutor::DExecute() {
   LogicalTile::PositionListsBuilder pos_lists_builder(left_tile, right_tile);
 
   // Get the hash table from the hash executor
-  const HashExecutor::HashMapType hash_table = hash_executor_->GetHashTable();
-  const std::vector<oid_t> hash_key_ids = hash_executor_->GetHashKeyIds();
+  const JoinHashTable &hash_table = hash_executor_->GetHashTable();
 
-  // Go over the left logical tile
-  // For each tuple, find matching tuples in the hash table built on top of the
-  // right table
+  // Go over the left tuples that found their key in the hash table.
+  // Their chains are ordered by right tile, so each cursor stops at the
+  // first entry of a later right tile and resumes there next time.
+  for (auto &left_probe_cursor : left_probe_cursors_) {
+    oid_t left_tile_row_itr = left_probe_cursor.first;
+    oid_t entry_itr = left_probe_cursor.second;
 
-  // Go over the matching right tuples
-  for (auto left_tile_row_itr : *left_tile) {
-    // tuple with only columns in join clauses.
-    expression::ContainerTuple<executor::LogicalTile> left_tuple(
-        left_tile, left_tile_row_itr, &hash_key_ids);
-
-    if (hash_table.find(left_tuple) == hash_table.end()) {
-      continue;
+    // Skip entries of right tiles without output
+    while (entry_itr != INVALID_OID &&
+           hash_table.GetEntry(entry_itr).tile_offset <
+               right_logical_tile_itr_) {
+      entry_itr = hash_table.GetEntry(entry_itr).next_entry;
     }
 
-    // add full mathcing left tuple to position list.
-    expression::ContainerTuple<executor::LogicalTile> left_tuple_full(
+    expression::ContainerTuple<executor::LogicalTile> left_tuple(
         left_tile, left_tile_row_itr);
-    for (const auto &matching_tuple : hash_table.find(left_tuple)->second) {
-      if (matching_tuple.first != right_logical_tile_itr_) {
-        continue;
-      }
+
+    // Go over the matching right tuples
+    for (; entry_itr != INVALID_OID &&
+               hash_table.GetEntry(entry_itr).tile_offset ==
+                   right_logical_tile_itr_;
+         entry_itr = hash_table.GetEntry(entry_itr).next_entry) {
+      auto &matching_tuple = hash_table.GetEntry(entry_itr);
 
       // construct right tuple
       expression::ContainerTuple<executor::LogicalTile> right_tuple(
-          right_result_tiles_[right_logical_tile_itr_].get(),
-          matching_tuple.second);
+          right_tile, matching_tuple.tuple_offset);
 
       if (predicate_ != nullptr &&
           predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_)
@@ -141,11 +186,14 @@ bool HashJoinExecutor::DExecute() {
       }
 
       // Insert joined tuple into right position list.
-      pos_lists_builder.AddRow(left_tile_row_itr, matching_tuple.second);
+      pos_lists_builder.AddRow(left_tile_row_itr, matching_tuple.tuple_offset);
 
       RecordMatchedLeftRow(left_result_tiles_.size() - 1, left_tile_row_itr);
-      RecordMatchedRightRow(matching_tuple.first, matching_tuple.second);
+      RecordMatchedRightRow(matching_tuple.tile_offset,
+                            matching_tuple.tuple_offset);
     }
+
+    left_probe_cursor.second = entry_itr;
   }
 
   right_logical_tile_itr_++;
@@ -159,5 +207,199 @@ bool HashJoinExecutor::DExecute() {
   }
 }
 
+/**
+ * @brief Looks up every tuple of a new left tile in the hash table once,
+ *        keeping the tuples with a matching key for the right tiles.
+ * @param left_tile Left logical tile.
+ */
+void HashJoinExecutor::ProbeLeftTile(LogicalTile *left_tile) {
+  const JoinHashTable &hash_table = hash_executor_->GetHashTable();
+  const std::vector<oid_t> &hash_key_ids = hash_executor_->GetHashKeyIds();
+
+  left_probe_cursors_.clear();
+
+  // tuple with only columns in join clauses.
+  std::vector<Value> left_key(hash_key_ids.size());
+  for (auto left_tile_row_itr : *left_tile) {
+    auto hash = JoinHashTable::GetKey(left_tile, left_tile_row_itr,
+                                      hash_key_ids, left_key.data());
+    auto entry_itr = hash_table.Find(hash, left_key.data());
+    if (entry_itr != INVALID_OID) {
+      left_probe_cursors_.emplace_back(left_tile_row_itr, entry_itr);
+    }
+  }
+}
+
+/**
+ * @brief Radix-partitions both inputs by the hash of the join key and joins
+ *        the partitions on worker threads. Each partition of the right side
+ *        gets a hash table small enough to stay in cache while the matching
+ *        partition of the left side probes it. The output tiles are kept in
+ *        buffered_output_tiles.
+ */
+void HashJoinExecutor::ExecutePartitionedJoin() {
+  const planner::HashJoinPlan &node = GetPlanNode<planner::HashJoinPlan>();
+  const std::vector<oid_t> &hash_key_ids = hash_executor_->GetHashKeyIds();
+  size_t worker_count = std::max<oid_t>(node.GetParallelism(), 1);
+
+  size_t right_tuple_count = 0;
+  for (auto &right_tile : right_result_tiles_) {
+    right_tuple_count += right_tile->GetTupleCount();
+  }
+
+  // Cache-sized partitions, a few per worker to even out skew
+  size_t build_size = right_tuple_count *
+                      JoinHashTable::GetTupleFootprint(hash_key_ids.size());
+  size_t min_partition_count = (worker_count > 1) ? worker_count * 4 : 1;
+  size_t partition_bits =
+      RadixPartitioner::GetPartitionBits(build_size, min_partition_count);
+
+  LOG_TRACE("Partitioned hash join : %lu partitions, %lu workers",
+            size_t(1) << partition_bits, worker_count);
+
+  RadixPartitioner right_partitions(partition_bits);
+  right_partitions.Partition(right_result_tiles_, hash_key_ids, worker_count);
+
+  RadixPartitioner left_partitions(partition_bits);
+  left_partitions.Partition(left_result_tiles_, hash_key_ids, worker_count);
+
+  // Workers take one partition at a time
+  std::vector<std::vector<JoinMatch>> worker_matches(worker_count);
+  std::vector<std::vector<std::unique_ptr<LogicalTile>>> worker_output_tiles(
+      worker_count);
+  std::atomic<size_t> partition_cursor(0);
+
+  RadixPartitioner::RunWorkers(worker_count, [&](size_t worker_id) {
+    JoinHashTable hash_table;
+    auto &matches = worker_matches[worker_id];
+
+    size_t partition_itr;
+    while ((partition_itr = partition_cursor.fetch_add(1)) <
+           right_partitions.GetPartitionCount()) {
+      JoinPartition(left_partitions, right_partitions, partition_itr,
+                    hash_table, matches);
+    }
+
+    BuildPartitionedOutput(matches, worker_output_tiles[worker_id]);
+  });
+
+  // The row sets of outer joins are not thread-safe, update them here
+  if (join_type_ != JOIN_TYPE_INNER) {
+    for (auto &matches : worker_matches) {
+      for (auto &match : matches) {
+        RecordMatchedLeftRow(match.left_tile_offset, match.left_tuple_offset);
+        RecordMatchedRightRow(match.right_tile_offset,
+                              match.right_tuple_offset);
+      }
+    }
+  }
+
+  for (auto &output_tiles : worker_output_tiles) {
+    for (auto &output_tile : output_tiles) {
+      buffered_output_tiles.push_back(output_tile.release());
+    }
+  }
+}
+
+/**
+ * @brief Builds the hash table of a partition of the right side and probes
+ *        it with the same partition of the left side.
+ */
+void HashJoinExecutor::JoinPartition(const RadixPartitioner &left_partitions,
+                                     const RadixPartitioner &right_partitions,
+                                     size_t partition,
+                                     JoinHashTable &hash_table,
+                                     std::vector<JoinMatch> &matches) {
+  const std::vector<oid_t> &hash_key_ids = hash_executor_->GetHashKeyIds();
+  std::vector<Value> key(hash_key_ids.size());
+
+  if (right_partitions.GetPartitionSize(partition) == 0) return;
+
+  // Build
+  hash_table.Clear(hash_key_ids.size());
+  hash_table.Reserve(right_partitions.GetPartitionSize(partition));
+
+  for (auto right = right_partitions.GetPartitionBegin(partition);
+       right != right_partitions.GetPartitionEnd(partition); right++) {
+    auto right_tile = right_result_tiles_[right->tile_offset].get();
+    JoinHashTable::GetKey(right_tile, right->tuple_offset, hash_key_ids,
+                          key.data());
+    hash_table.Insert(right->hash, key.data(), right->tile_offset,
+                      right->tuple_offset);
+  }
+
+  // Probe
+  for (auto left = left_partitions.GetPartitionBegin(partition);
+       left != left_partitions.GetPartitionEnd(partition); left++) {
+    auto left_tile = left_result_tiles_[left->tile_offset].get();
+    JoinHashTable::GetKey(left_tile, left->tuple_offset, hash_key_ids,
+                          key.data());
+
+    auto entry_itr = hash_table.Find(left->hash, key.data());
+    if (entry_itr == INVALID_OID) continue;
+
+    expression::ContainerTuple<executor::LogicalTile> left_tuple(
+        left_tile, left->tuple_offset);
+
+    for (; entry_itr != INVALID_OID;
+         entry_itr = hash_table.GetEntry(entry_itr).next_entry) {
+      auto &matching_tuple = hash_table.GetEntry(entry_itr);
+
+      expression::ContainerTuple<executor::LogicalTile> right_tuple(
+          right_result_tiles_[matching_tuple.tile_offset].get(),
+          matching_tuple.tuple_offset);
+
+      if (predicate_ != nullptr &&
+          predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_)
+              .IsFalse()) {
+        // Join predicate is false. Skip pair and continue.
+        continue;
+      }
+
+      matches.push_back(JoinMatch{left->tile_offset, left->tuple_offset,
+                                  matching_tuple.tile_offset,
+                                  matching_tuple.tuple_offset});
+    }
+  }
+}
+
+/**
+ * @brief Builds one output tile per pair of input tiles with matches.
+ */
+void HashJoinExecutor::BuildPartitionedOutput(
+    std::vector<JoinMatch> &matches,
+    std::vector<std::unique_ptr<LogicalTile>> &output_tiles) {
+  // Group the matches by their pair of input tiles
+  std::sort(matches.begin(), matches.end(),
+            [](const JoinMatch &a, const JoinMatch &b) {
+    return std::tie(a.left_tile_offset, a.right_tile_offset,
+                    a.left_tuple_offset, a.right_tuple_offset) <
+           std::tie(b.left_tile_offset, b.right_tile_offset,
+                    b.left_tuple_offset, b.right_tuple_offset);
+  });
+
+  size_t match_itr = 0;
+  while (match_itr < matches.size()) {
+    oid_t left_tile_offset = matches[match_itr].left_tile_offset;
+    oid_t right_tile_offset = matches[match_itr].right_tile_offset;
+    LogicalTile *left_tile = left_result_tiles_[left_tile_offset].get();
+    LogicalTile *right_tile = right_result_tiles_[right_tile_offset].get();
+
+    auto output_tile = BuildOutputLogicalTile(left_tile, right_tile);
+    LogicalTile::PositionListsBuilder pos_lists_builder(left_tile, right_tile);
+
+    for (; match_itr < matches.size() &&
+               matches[match_itr].left_tile_offset == left_tile_offset &&
+               matches[match_itr].right_tile_offset == right_tile_offset;
+         match_itr++) {
+      pos_lists_builder.AddRow(matches[match_itr].left_tuple_offset,
+                               matches[match_itr].right_tuple_offset);
+    }
+
+    output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+    output_tiles.push_back(std::move(output_tile));
+  }
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -13,10 +13,14 @@
 #pragma once
 
 #include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include "backend/executor/abstract_join_executor.h"
 #include "backend/planner/hash_join_plan.h"
 #include "backend/executor/hash_executor.h"
+#include "backend/executor/radix_partitioner.h"
 
 namespace peloton {
 namespace executor {
@@ -29,14 +33,46 @@ class HashJoinExecutor : public AbstractJoinExecutor {
   explicit HashJoinExecutor(const planner::AbstractPlan *node,
                             ExecutorContext *executor_context);
 
+  ~HashJoinExecutor();
+
  protected:
   bool DInit();
 
   bool DExecute();
 
  private:
+  /** @brief A joined pair of tuples : < left tile, left tuple,
+   *         right tile, right tuple > */
+  struct JoinMatch {
+    oid_t left_tile_offset;
+    oid_t left_tuple_offset;
+    oid_t right_tile_offset;
+    oid_t right_tuple_offset;
+  };
+
+  void ProbeLeftTile(LogicalTile *left_tile);
+
+  //===--------------------------------------------------------------------===//
+  // Partitioned hash join
+  //===--------------------------------------------------------------------===//
+
+  void ExecutePartitionedJoin();
+
+  void JoinPartition(const RadixPartitioner &left_partitions,
+                     const RadixPartitioner &right_partitions,
+                     size_t partition, JoinHashTable &hash_table,
+                     std::vector<JoinMatch> &matches);
+
+  void BuildPartitionedOutput(
+      std::vector<JoinMatch> &matches,
+      std::vector<std::unique_ptr<LogicalTile>> &output_tiles);
+
   HashExecutor *hash_executor_ = nullptr;
 
+  /** @brief Matching rows of the current left tile :
+   *         < left row, next hash table entry to join it with > */
+  std::vector<std::pair<oid_t, oid_t>> left_probe_cursors_;
+
   std::deque<LogicalTile *> buffered_output_tiles;
 
   // logical tile iterators
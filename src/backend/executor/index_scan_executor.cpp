@@ -12,7 +12,9 @@
 
 #include "backend/executor/index_scan_executor.h"
 
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -39,7 +41,10 @@ IndexScanExecutor::IndexScanExecutor(const planner::AbstractPlan *node,
     : AbstractScanExecutor(node, executor_context) {}
 
 IndexScanExecutor::~IndexScanExecutor() {
-  // Nothing to do here
+  // Tiles of the last batch that were not returned
+  for (; result_itr < result.size(); result_itr++) {
+    delete result[result_itr];
+  }
 }
 
 /**
@@ -59,7 +64,12 @@ bool IndexScanExecutor::DInit() {
   index_ = node.GetIndex();
   assert(index_ != nullptr);
 
+  for (; result_itr < result.size(); result_itr++) {
+    delete result[result_itr];
+  }
+  result.clear();
   result_itr = START_OID;
+  cursor_.reset();
   done_ = false;
 
   column_ids_ = node.GetColumnIds();
@@ -96,35 +106,42 @@ bool IndexScanExecutor::DInit() {
 }
 
 /**
- * @brief Creates logical tile(s) after scanning index.
+ * @brief Reads the whole range in the first batch.
+ * @return true
+ */
+bool IndexScanExecutor::SetMaterializeScan(void) {
+  materialize_ = true;
+  return true;
+}
+
+/**
+ * @brief Creates logical tile(s) from the next batch of index entries.
  * @return true on success, false otherwise.
  */
 bool IndexScanExecutor::DExecute() {
   LOG_INFO("Index Scan executor :: 0 child");
 
-  if (!done_) {
+  while (true) {
+    while (result_itr < result.size()) {  // Avoid returning empty tiles
+      LogicalTile *tile = result[result_itr];
+      result_itr++;
+
+      if (tile->GetTupleCount() == 0) {
+        delete tile;
+        continue;
+      } else {
+        SetOutput(tile);
+        return true;
+      }
+
+    }  // end while
+
+    // Read the next batch of locations
     auto status = ExecIndexLookup();
     if (status == false) return false;
     ExecPredication();
     ExecProjection();
   }
-
-  // Already performed the index lookup
-  assert(done_);
-
-  while (result_itr < result.size()) {  // Avoid returning empty tiles
-    if (result[result_itr]->GetTupleCount() == 0) {
-      result_itr++;
-      continue;
-    } else {
-      SetOutput(result[result_itr]);
-      result_itr++;
-      return true;
-    }
-
-  }  // end while
-
-  return false;
 }
 
 void IndexScanExecutor::ExecPredication() {
@@ -151,30 +168,40 @@ void IndexScanExecutor::ExecProjection() {
 }
 
 bool IndexScanExecutor::ExecIndexLookup() {
-  assert(!done_);
+  if (done_) return false;
 
-  std::vector<ItemPointer> tuple_locations;
-
-  if (0 == key_column_ids_.size()) {
-    tuple_locations = index_->ScanAllKeys();
-  } else {
-    tuple_locations = index_->Scan(values_, key_column_ids_, expr_types_,
-                                   SCAN_DIRECTION_TYPE_FORWARD);
+  // No key column scans all keys
+  if (cursor_.get() == nullptr) {
+    cursor_.reset(index_->GetCursor(values_, key_column_ids_, expr_types_,
+                                    SCAN_DIRECTION_TYPE_FORWARD));
   }
 
-  LOG_INFO("Tuple_locations.size(): %lu", tuple_locations.size());
+  // At most a tile group worth of locations at a time, so that a consumer
+  // which stops early does not pay for the rest of the range. A consumer
+  // writing the table gets the whole range before adding index entries
+  // the later batches could see.
+  size_t batch_size = DEFAULT_TUPLES_PER_TILEGROUP;
+  if (materialize_) batch_size = std::numeric_limits<size_t>::max();
+
+  tuple_locations_.clear();
+  cursor_->NextBatch(tuple_locations_, batch_size);
+
+  LOG_INFO("Tuple_locations.size(): %lu", tuple_locations_.size());
 
-  if (tuple_locations.size() == 0) return false;
+  if (tuple_locations_.size() == 0) {
+    done_ = true;
+    cursor_.reset();
+    return false;
+  }
 
   auto transaction_ = executor_context_->GetTransaction();
   txn_id_t txn_id = transaction_->GetTransactionId();
   cid_t commit_id = transaction_->GetLastCommitId();
 
   // Get the logical tiles corresponding to the given tuple locations
-  result = LogicalTileFactory::WrapTileGroups(tuple_locations, full_column_ids_,
-                                              txn_id, commit_id);
-
-  done_ = true;
+  result = LogicalTileFactory::WrapTileGroups(
+      tuple_locations_, full_column_ids_, txn_id, commit_id);
+  result_itr = START_OID;
 
   LOG_TRACE("Result tiles : %lu", result.size());
 
@@ -12,9 +12,11 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "backend/executor/abstract_scan_executor.h"
+#include "backend/index/index.h"
 #include "backend/planner/index_scan_plan.h"
 
 namespace peloton {
@@ -35,6 +37,8 @@ class IndexScanExecutor : public AbstractScanExecutor {
 
   ~IndexScanExecutor();
 
+  bool SetMaterializeScan(void);
+
  protected:
   bool DInit();
 
@@ -54,15 +58,24 @@ class IndexScanExecutor : public AbstractScanExecutor {
   // Executor State
   //===--------------------------------------------------------------------===//
 
-  /** @brief Result of index scan. */
+  /** @brief Tiles of the last batch of locations. */
   std::vector<LogicalTile *> result;
 
   /** @brief Result itr */
   oid_t result_itr = INVALID_OID;
 
-  /** @brief Computed the result */
+  /** @brief Cursor of the index scan, created on the first lookup */
+  std::unique_ptr<index::IndexCursor> cursor_;
+
+  /** @brief Last batch of locations read from the cursor */
+  std::vector<ItemPointer> tuple_locations_;
+
+  /** @brief The cursor has no location left */
   bool done_ = false;
 
+  /** @brief Read the whole range at once, the consumer writes the table */
+  bool materialize_ = false;
+
   //===--------------------------------------------------------------------===//
   // Plan Info
   //===--------------------------------------------------------------------===//
@@ -43,6 +43,11 @@ bool InsertExecutor::DInit() {
   assert(children_.size() == 0 || children_.size() == 1);
   assert(executor_context_);
 
+  // The tuples inserted must not be read back by the child
+  if (children_.size() == 1) {
+    children_[0]->SetMaterializeScan();
+  }
+
   done_ = false;
   return true;
 }
@@ -145,12 +150,10 @@ bool InsertExecutor::DExecute() {
 
         if (log_manager.IsInLoggingMode()) {
           auto logger = log_manager.GetBackendLogger();
-          auto record = logger->GetTupleRecord(
+          logger->LogTupleRecord(
               LOGRECORD_TYPE_TUPLE_INSERT, transaction_->GetTransactionId(),
               target_table_->GetOid(), location, INVALID_ITEMPOINTER,
               tuple.get());
-
-          logger->Log(record);
         }
       }
     }
@@ -0,0 +1,35 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// join_bloom_filter.cpp
+//
+// Identification: src/backend/executor/join_bloom_filter.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/executor/join_bloom_filter.h"
+
+namespace peloton {
+namespace executor {
+
+namespace {
+
+// Under 1% false positives with four bits per key in a 64-bit word
+const size_t kBitsPerKey = 16;
+
+}  // End anonymous namespace
+
+JoinBloomFilter::JoinBloomFilter(size_t key_count) {
+  // Power-of-two number of words, indexed by the top bits of the hash
+  size_t word_bits = 0;
+  while ((size_t(64) << word_bits) < key_count * kBitsPerKey) word_bits++;
+
+  words.assign(size_t(1) << word_bits, 0);
+  word_shift = sizeof(size_t) * 8 - word_bits;
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// join_bloom_filter.h
+//
+// Identification: src/backend/executor/join_bloom_filter.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace executor {
+
+/**
+ * @brief Bloom filter over the join key hashes of the build side of a hash
+ *        join, handed to the probe-side scan to drop tuples early.
+ *
+ * Register-blocked: all the bits of a key live in one 64-bit word, so a
+ * lookup touches a single cache line. The word comes from the top bits of
+ * the hash and the bits within it from the low bits.
+ */
+class JoinBloomFilter {
+ public:
+  JoinBloomFilter(const JoinBloomFilter &) = delete;
+  JoinBloomFilter &operator=(const JoinBloomFilter &) = delete;
+
+  explicit JoinBloomFilter(size_t key_count);
+
+  inline void Insert(size_t hash) { words[GetWord(hash)] |= GetMask(hash); }
+
+  // No false negatives, a few false positives
+  inline bool MayContain(size_t hash) const {
+    uint64_t mask = GetMask(hash);
+    return (words[GetWord(hash)] & mask) == mask;
+  }
+
+  size_t GetSize() const { return words.size() * sizeof(uint64_t); }
+
+ private:
+  inline size_t GetWord(size_t hash) const {
+    return (word_shift == sizeof(size_t) * 8) ? 0 : hash >> word_shift;
+  }
+
+  // Four bits, six hash bits each
+  static inline uint64_t GetMask(size_t hash) {
+    return (uint64_t(1) << (hash & 63)) | (uint64_t(1) << ((hash >> 6) & 63)) |
+           (uint64_t(1) << ((hash >> 12) & 63)) |
+           (uint64_t(1) << ((hash >> 18) & 63));
+  }
+
+  std::vector<uint64_t> words;
+
+  size_t word_shift;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// join_hash_table.cpp
+//
+// Identification: src/backend/executor/join_hash_table.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/executor/join_hash_table.h"
+
+#include "backend/executor/logical_tile.h"
+
+namespace peloton {
+namespace executor {
+
+namespace {
+
+// Keep the table at most half full
+const size_t kMinimumSlotCount = 16;
+
+size_t GetSlotCount(size_t key_count) {
+  size_t slot_count = kMinimumSlotCount;
+  while (slot_count < key_count * 2) slot_count <<= 1;
+  return slot_count;
+}
+
+}  // End anonymous namespace
+
+const JoinHashTable::Slot JoinHashTable::empty_slot = {0, INVALID_OID,
+                                                       INVALID_OID,
+                                                       INVALID_OID};
+
+JoinHashTable::JoinHashTable() { Clear(0); }
+
+void JoinHashTable::Clear(oid_t column_count) {
+  key_column_count = column_count;
+  key_count = 0;
+
+  slots.assign(kMinimumSlotCount, empty_slot);
+  slot_mask = kMinimumSlotCount - 1;
+
+  key_values.clear();
+  entries.clear();
+}
+
+void JoinHashTable::Reserve(size_t tuple_count) {
+  entries.reserve(tuple_count);
+
+  // Assume every tuple has its own key, which is the common case for
+  // the primary key side of a join
+  while (slots.size() < GetSlotCount(tuple_count)) {
+    Grow();
+  }
+}
+
+void JoinHashTable::Insert(size_t hash, const Value *key, oid_t tile_offset,
+                           oid_t tuple_offset) {
+  oid_t entry_offset = entries.size();
+  entries.push_back(Entry{tile_offset, tuple_offset, INVALID_OID});
+
+  size_t slot_offset = hash & slot_mask;
+  while (true) {
+    Slot &slot = slots[slot_offset];
+
+    // New key
+    if (slot.key_offset == INVALID_OID) {
+      slot.hash = hash;
+      slot.key_offset = key_values.size();
+      slot.first_entry = entry_offset;
+      slot.last_entry = entry_offset;
+      key_values.insert(key_values.end(), key, key + key_column_count);
+      key_count++;
+
+      if (key_count * 2 > slots.size()) {
+        Grow();
+      }
+      return;
+    }
+
+    // Existing key, append to its chain
+    if (slot.hash == hash && KeyEquals(slot.key_offset, key)) {
+      entries[slot.last_entry].next_entry = entry_offset;
+      slot.last_entry = entry_offset;
+      return;
+    }
+
+    slot_offset = (slot_offset + 1) & slot_mask;
+  }
+}
+
+oid_t JoinHashTable::Find(size_t hash, const Value *key) const {
+  size_t slot_offset = hash & slot_mask;
+  while (true) {
+    const Slot &slot = slots[slot_offset];
+
+    if (slot.key_offset == INVALID_OID) {
+      return INVALID_OID;
+    }
+
+    if (slot.hash == hash && KeyEquals(slot.key_offset, key)) {
+      return slot.first_entry;
+    }
+
+    slot_offset = (slot_offset + 1) & slot_mask;
+  }
+}
+
+size_t JoinHashTable::GetKey(LogicalTile *tile, oid_t tuple_id,
+                             const std::vector<oid_t> &column_ids,
+                             Value *key) {
+  for (size_t column_itr = 0; column_itr < column_ids.size(); column_itr++) {
+    key[column_itr] = tile->GetValue(tuple_id, column_ids[column_itr]);
+  }
+
+  return GetHash(key, column_ids.size());
+}
+
+size_t JoinHashTable::GetHash(const Value *key, oid_t column_count) {
+  size_t hash = 0;
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    key[column_itr].HashCombine(hash);
+  }
+
+  // Spread the bits, the combined hash of small integers is poor in the
+  // low bits that pick the slot (MurmurHash3 finalizer)
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+
+  return hash;
+}
+
+bool JoinHashTable::KeyEquals(oid_t key_offset, const Value *key) const {
+  for (oid_t column_itr = 0; column_itr < key_column_count; column_itr++) {
+    if (key_values[key_offset + column_itr].OpNotEquals(key[column_itr])
+            .IsTrue()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void JoinHashTable::Grow() {
+  std::vector<Slot> old_slots(slots.size() * 2, empty_slot);
+  old_slots.swap(slots);
+  slot_mask = slots.size() - 1;
+
+  // Re-insert with the stored hashes, keys are never compared here
+  for (auto &old_slot : old_slots) {
+    if (old_slot.key_offset == INVALID_OID) continue;
+
+    size_t slot_offset = old_slot.hash & slot_mask;
+    while (slots[slot_offset].key_offset != INVALID_OID) {
+      slot_offset = (slot_offset + 1) & slot_mask;
+    }
+    slots[slot_offset] = old_slot;
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
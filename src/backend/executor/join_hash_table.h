@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// join_hash_table.h
+//
+// Identification: src/backend/executor/join_hash_table.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "backend/common/types.h"
+#include "backend/common/value.h"
+
+namespace peloton {
+namespace executor {
+
+class LogicalTile;
+
+/**
+ * @brief Hash table built by the hash executor and probed by the hash join.
+ *
+ * Open addressing with linear probing over an array of slots. Each slot
+ * keeps the full hash of its key, so most mismatches are rejected without
+ * touching the key, and the index of the key in a flat array of
+ * materialized key values. Build-side tuples with the same key are chained
+ * through a separate entry array, in insertion order.
+ */
+class JoinHashTable {
+ public:
+  JoinHashTable(const JoinHashTable &) = delete;
+  JoinHashTable &operator=(const JoinHashTable &) = delete;
+
+  /** @brief A build-side tuple : < child tile offset, tuple offset > */
+  struct Entry {
+    oid_t tile_offset;
+    oid_t tuple_offset;
+
+    // next entry with the same key, INVALID_OID at the end of the chain
+    oid_t next_entry;
+  };
+
+  JoinHashTable();
+
+  void Clear(oid_t column_count);
+
+  // Size the table for the given number of build-side tuples
+  void Reserve(size_t tuple_count);
+
+  void Insert(size_t hash, const Value *key, oid_t tile_offset,
+              oid_t tuple_offset);
+
+  // Returns the first entry with the key, or INVALID_OID
+  oid_t Find(size_t hash, const Value *key) const;
+
+  inline const Entry &GetEntry(oid_t entry_offset) const {
+    return entries[entry_offset];
+  }
+
+  size_t GetKeyCount() const { return key_count; }
+
+  size_t GetEntryCount() const { return entries.size(); }
+
+  // Reads the key columns of a tuple into key and returns their hash
+  static size_t GetKey(LogicalTile *tile, oid_t tuple_id,
+                       const std::vector<oid_t> &column_ids, Value *key);
+
+  static size_t GetHash(const Value *key, oid_t column_count);
+
+  // Bytes taken by one build-side tuple with a key of its own
+  static size_t GetTupleFootprint(oid_t column_count) {
+    return sizeof(Entry) + 2 * sizeof(Slot) + column_count * sizeof(Value);
+  }
+
+ private:
+  struct Slot {
+    size_t hash;
+
+    // offset of the key in key_values, INVALID_OID if the slot is empty
+    oid_t key_offset;
+
+    oid_t first_entry;
+    oid_t last_entry;
+  };
+
+  static const Slot empty_slot;
+
+  bool KeyEquals(oid_t key_offset, const Value *key) const;
+
+  void Grow();
+
+  std::vector<Slot> slots;
+
+  size_t slot_mask = 0;
+
+  // key_column_count values per distinct key
+  std::vector<Value> key_values;
+
+  std::vector<Entry> entries;
+
+  oid_t key_column_count = 0;
+
+  size_t key_count = 0;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -12,6 +12,7 @@
 
 #include "backend/executor/logical_tile_factory.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -21,6 +22,7 @@
 #include "backend/storage/tile_group.h"
 #include "backend/storage/data_table.h"
 #include "backend/storage/tile_group_header.h"
+#include "backend/storage/temp_table.h"
 
 namespace peloton {
 namespace executor {
@@ -109,6 +111,35 @@ LogicalTile *LogicalTileFactory::WrapTileGroup(
   return new_tile.release();
 }
 
+/**
+ * @brief Convenience method to construct logical tiles wrapping the tiles of
+ * a temp table, one per tile.
+ * @param temp_table Temp table to be wrapped.
+ *
+ * @return Logical tiles wrapping the tuples of the temp table.
+ */
+std::vector<LogicalTile *> LogicalTileFactory::WrapTempTable(
+    const storage::TempTable *temp_table) {
+  std::vector<LogicalTile *> logical_tiles;
+
+  for (oid_t tile_itr = 0; tile_itr < temp_table->GetTileCount(); tile_itr++) {
+    auto base_tile = temp_table->GetTile(tile_itr);
+
+    std::unique_ptr<LogicalTile> new_tile(new LogicalTile());
+    const oid_t position_list_idx = 0;
+    new_tile->AddPositionList(CreateIdentityPositionList(
+        temp_table->GetTileTupleCount(tile_itr)));
+
+    for (oid_t col_id = 0; col_id < base_tile->GetColumnCount(); col_id++) {
+      new_tile->AddColumn(base_tile, col_id, position_list_idx);
+    }
+
+    logical_tiles.push_back(new_tile.release());
+  }
+
+  return logical_tiles;
+}
+
 /**
  * @brief Convenience method to construct a set of logical tiles wrapping a
  * given set of tuple locations potentially in multiple tile groups.
@@ -129,7 +160,7 @@ std::vector<LogicalTile *> LogicalTileFactory::WrapTileGroups(
   }
 
   // Construct a logical tile for each block
-  for (auto block : blocks) {
+  for (auto &block : blocks) {
     LogicalTile *logical_tile = LogicalTileFactory::GetTile();
 
     auto &manager = catalog::Manager::GetInstance();
@@ -142,10 +173,22 @@ std::vector<LogicalTile *> LogicalTileFactory::WrapTileGroups(
     // Print tile group visibility
     // tile_group_header->PrintVisibility(txn_id, commit_id);
 
+    // Check the visibility of the slots spanned by the block in one pass
+    auto &tuple_ids = block.second;
+    auto range = std::minmax_element(tuple_ids.begin(), tuple_ids.end());
+    oid_t begin_slot = *range.first;
+    oid_t end_slot = *range.second + 1;
+    std::vector<uint64_t> visibility_bitmap(
+        storage::TileGroupHeader::GetBitmapWordCount(end_slot - begin_slot));
+    tile_group_header->GetVisibilityBitmap(txn_id, commit_id, begin_slot,
+                                           end_slot, visibility_bitmap.data());
+
     // Add visible tuples to logical tile
     std::vector<oid_t> position_list;
-    for (auto tuple_id : block.second) {
-      if (tile_group_header->IsVisible(tuple_id, txn_id, commit_id)) {
+    for (auto tuple_id : tuple_ids) {
+      oid_t bit_offset = tuple_id - begin_slot;
+      if (visibility_bitmap[bit_offset / 64] &
+          (uint64_t(1) << (bit_offset % 64))) {
         position_list.push_back(tuple_id);
       }
     }
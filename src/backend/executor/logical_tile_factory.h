@@ -23,6 +23,7 @@ namespace storage {
 class Tile;
 class TileGroup;
 class AbstractTable;
+class TempTable;
 }
 
 //===--------------------------------------------------------------------===//
@@ -43,6 +44,9 @@ class LogicalTileFactory {
       const std::shared_ptr<storage::TileGroup> &tile_group,
       txn_id_t txn_id);
 
+  static std::vector<LogicalTile *> WrapTempTable(
+      const storage::TempTable *temp_table);
+
   static std::vector<LogicalTile *> WrapTileGroups(
       const std::vector<ItemPointer> tuple_locations,
       const std::vector<oid_t> column_ids, txn_id_t txn_id, cid_t commit_id);
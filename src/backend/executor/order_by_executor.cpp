@@ -10,6 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
+#include "backend/common/exception.h"
 #include "backend/common/logger.h"
 #include "backend/common/pool.h"
 #include "backend/executor/logical_tile.h"
@@ -37,8 +40,19 @@ bool OrderByExecutor::DInit() {
   assert(children_.size() == 1);
 
   sort_done_ = false;
+  num_tuples_ = 0;
   num_tuples_returned_ = 0;
 
+  // Drop whatever an earlier run left behind
+  input_tiles_.clear();
+  input_schema_.reset();
+  sort_buffer_.clear();
+  key_buffer_.clear();
+  buffered_bytes_ = 0;
+  runs_.clear();
+  merger_.reset();
+  merge_pool_.reset();
+
   return true;
 }
 
@@ -47,36 +61,53 @@ bool OrderByExecutor::DExecute() {
 
   if (!sort_done_) DoSort();
 
-  if (!(num_tuples_returned_ < sort_buffer_.size())) {
+  if (!(num_tuples_returned_ < num_tuples_)) {
     return false;
   }
 
   assert(sort_done_);
   assert(input_schema_.get());
-  assert(input_tiles_.size() > 0);
 
   // Returned tiles must be newly created physical tiles,
   // which have the same physical schema as input tiles.
   size_t tile_size = std::min(size_t(DEFAULT_TUPLES_PER_TILEGROUP),
-                              sort_buffer_.size() - num_tuples_returned_);
+                              num_tuples_ - num_tuples_returned_);
 
   std::shared_ptr<storage::Tile> ptile(storage::TileFactory::GetTile(
       BACKEND_TYPE_MM, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
       nullptr, *input_schema_, nullptr, tile_size));
 
+  oid_t column_count = input_schema_->GetColumnCount();
   for (size_t id = 0; id < tile_size; id++) {
-    oid_t source_tile_id =
-        sort_buffer_[num_tuples_returned_ + id].item_pointer.block;
-    oid_t source_tuple_id =
-        sort_buffer_[num_tuples_returned_ + id].item_pointer.offset;
     // Insert a physical tuple into physical tile
-    for (oid_t col = 0; col < input_schema_->GetColumnCount(); col++) {
-      ptile.get()->SetValue(
-          input_tiles_[source_tile_id]->GetValue(source_tuple_id, col), id,
-          col);
+    if (merger_ == nullptr) {
+      auto &item_pointer = sort_buffer_[num_tuples_returned_ + id].item_pointer;
+      auto &source_tile = input_tiles_[item_pointer.block];
+      for (oid_t col = 0; col < column_count; col++) {
+        ptile->SetValue(source_tile->GetValue(item_pointer.offset, col), id,
+                        col);
+      }
+    } else {
+      if (!merger_->Next()) {
+        throw ExecutorException("Sorted runs ended early");
+      }
+
+      auto &payload = merger_->GetCurrent()->GetPayload();
+      ReferenceSerializeInputBE input(payload.data(), payload.size());
+      for (oid_t col = 0; col < column_count; col++) {
+        Value value;
+        value.DeserializeFromAllocateForStorage(input_schema_->GetType(col),
+                                                input, merge_pool_.get());
+        ptile->SetValue(value, id, col);
+      }
     }
   }
 
+  // The tile holds its own copies of the values
+  if (merge_pool_.get() != nullptr) {
+    merge_pool_->Purge();
+  }
+
   // Create an owner wrapper of this physical tile
   std::vector<std::shared_ptr<storage::Tile>> singleton({ptile});
   std::unique_ptr<LogicalTile> ltile(LogicalTileFactory::WrapTiles(singleton));
@@ -86,7 +117,7 @@ bool OrderByExecutor::DExecute() {
 
   num_tuples_returned_ += tile_size;
 
-  assert(num_tuples_returned_ <= sort_buffer_.size());
+  assert(num_tuples_returned_ <= num_tuples_);
 
   return true;
 }
@@ -97,96 +128,144 @@ bool OrderByExecutor::DoSort() {
   assert(!sort_done_);
   assert(executor_context_ != nullptr);
 
-  // Extract all data from child
+  // Grab data from plan node
+  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
+  descend_flags_ = node.GetDescendFlags();
+  key_encoder_.reset(new SortKeyEncoder(node.GetSortKeys(), descend_flags_));
+  size_t memory_budget = node.GetMemoryBudget();
+
+  // Extract all data from child, spill a sorted run when over budget
   while (children_[0]->Execute()) {
-    input_tiles_.emplace_back(children_[0]->GetOutput());
+    std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
+    if (input_schema_.get() == nullptr) {
+      input_schema_.reset(tile->GetPhysicalSchema());
+    }
+
+    BufferTile(std::move(tile));
+
+    if (memory_budget > 0 && buffered_bytes_ > memory_budget) {
+      SpillRun();
+    }
   }
 
-  /** Number of valid tuples to be sorted. */
-  size_t count = 0;
-  for (auto &tile : input_tiles_) {
-    count += tile->GetTupleCount();
+  sort_done_ = true;
+
+  // Everything fit in memory
+  if (runs_.empty()) {
+    SortBuffer();
+    num_tuples_ = sort_buffer_.size();
+    return true;
   }
 
-  if (count == 0) return true;
+  if (!sort_buffer_.empty()) {
+    SpillRun();
+  }
 
-  // Grab data from plan node
-  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
-  descend_flags_ = node.GetDescendFlags();
+  for (auto &run : runs_) {
+    num_tuples_ += run->GetRecordCount();
+  }
 
-  // Extract the schema for sort keys.
-  input_schema_.reset(input_tiles_[0]->GetPhysicalSchema());
-  std::vector<catalog::Column> sort_key_columns;
-  for (auto id : node.GetSortKeys()) {
-    sort_key_columns.push_back(input_schema_->GetColumn(id));
+  // Every run being merged holds a file buffer
+  size_t max_fan_in = std::max(size_t(2), memory_budget / SortRun::buffer_size);
+  ReduceRuns(max_fan_in);
+
+  LOG_INFO("Merging %lu sorted runs of %lu tuples", runs_.size(), num_tuples_);
+  merger_.reset(new SortRunMerger(std::move(runs_)));
+  merge_pool_.reset(new VarlenPool(BACKEND_TYPE_MM));
+  runs_.clear();
+
+  return true;
+}
+
+void OrderByExecutor::BufferTile(std::unique_ptr<LogicalTile> &&tile) {
+  oid_t tile_id = input_tiles_.size();
+  size_t key_bytes = key_buffer_.size();
+
+  for (oid_t tuple_id : *tile) {
+    size_t key_offset = key_buffer_.size();
+    key_encoder_->EncodeTuple(tile.get(), tuple_id, key_buffer_);
+    size_t key_length = key_buffer_.size() - key_offset;
+
+    uint64_t key_prefix = SortKeyEncoder::GetPrefix(
+        key_buffer_.data() + key_offset, key_length);
+    sort_buffer_.push_back(SortEntry{key_prefix, key_offset, key_length,
+                                     ItemPointer(tile_id, tuple_id)});
   }
-  sort_key_tuple_schema_.reset(new catalog::Schema(sort_key_columns));
-  auto executor_pool = executor_context_->GetExecutorContextPool();
-
-  // Extract all valid tuples into a single std::vector (the sort buffer)
-  sort_buffer_.reserve(count);
-  for (oid_t tile_id = 0; tile_id < input_tiles_.size(); tile_id++) {
-    for (oid_t tuple_id : *input_tiles_[tile_id]) {
-      // Extract the sort key tuple
-      std::unique_ptr<storage::Tuple> tuple(
-          new storage::Tuple(sort_key_tuple_schema_.get(), true));
-      for (oid_t id = 0; id < node.GetSortKeys().size(); id++) {
-        tuple->SetValue(id, input_tiles_[tile_id]->GetValue(
-                                tuple_id, node.GetSortKeys()[id]),
-                        executor_pool);
-      }
-      // Inert the sort key tuple into sort buffer
-      sort_buffer_.emplace_back(sort_buffer_entry_t(
-          ItemPointer(tile_id, tuple_id), std::move(tuple)));
-    }
+
+  key_bytes = key_buffer_.size() - key_bytes;
+  buffered_bytes_ += key_bytes + tile->GetTupleCount() *
+                                     (sizeof(SortEntry) +
+                                      input_schema_->GetLength());
+
+  input_tiles_.push_back(std::move(tile));
+}
+
+void OrderByExecutor::SortBuffer() {
+  const char *keys = key_buffer_.data();
+
+  // Finally ... sort it !
+  std::sort(sort_buffer_.begin(), sort_buffer_.end(),
+            [keys](const SortEntry &lhs, const SortEntry &rhs) {
+              if (lhs.key_prefix != rhs.key_prefix) {
+                return lhs.key_prefix < rhs.key_prefix;
+              }
+              return SortKeyEncoder::Compare(keys + lhs.key_offset,
+                                             lhs.key_length,
+                                             keys + rhs.key_offset,
+                                             rhs.key_length) < 0;
+            });
+}
+
+void OrderByExecutor::SpillRun() {
+  SortBuffer();
+
+  if (tuple_output_.get() == nullptr) {
+    tuple_output_.reset(new CopySerializeOutput());
   }
 
-  assert(count == sort_buffer_.size());
-
-  // Prepare the compare function
-  // Note: This is a less-than comparer, NOT an equality comparer.
-  struct TupleComparer {
-    TupleComparer(std::vector<bool> &_descend_flags)
-        : descend_flags(_descend_flags) {}
-
-    bool operator()(const storage::Tuple *ta, const storage::Tuple *tb) {
-      for (oid_t id = 0; id < descend_flags.size(); id++) {
-        if (!descend_flags[id]) {
-          if (ta->GetValue(id).OpLessThan(tb->GetValue(id)).IsTrue()) {
-            return true;
-          } else if (ta->GetValue(id)
-                         .OpGreaterThan(tb->GetValue(id))
-                         .IsTrue()) {
-            return false;
-          }
-        } else {
-          if (tb->GetValue(id).OpLessThan(ta->GetValue(id)).IsTrue()) {
-            return true;
-          } else if (tb->GetValue(id)
-                         .OpGreaterThan(ta->GetValue(id))
-                         .IsTrue()) {
-            return false;
-          }
-        }
-      }
-      return false;  // Will return false if all keys equal
+  std::unique_ptr<SortRun> run(new SortRun());
+  oid_t column_count = input_schema_->GetColumnCount();
+  for (auto &entry : sort_buffer_) {
+    auto &source_tile = input_tiles_[entry.item_pointer.block];
+
+    tuple_output_->Reset();
+    for (oid_t col = 0; col < column_count; col++) {
+      source_tile->GetValue(entry.item_pointer.offset, col)
+          .SerializeTo(*tuple_output_);
     }
 
-    std::vector<bool> descend_flags;
-  };
+    run->Append(key_buffer_.data() + entry.key_offset, entry.key_length,
+                tuple_output_->Data(), tuple_output_->Size());
+  }
 
-  TupleComparer comp(descend_flags_);
+  LOG_TRACE("Spilled a sorted run of %lu tuples", sort_buffer_.size());
+  runs_.push_back(std::move(run));
 
-  // Finally ... sort it !
-  std::sort(
-      sort_buffer_.begin(), sort_buffer_.end(),
-      [&comp](const sort_buffer_entry_t &a, const sort_buffer_entry_t &b) {
-        return comp(a.tuple.get(), b.tuple.get());
-      });
+  // Release the input, keep the buffers for the next run
+  input_tiles_.clear();
+  sort_buffer_.clear();
+  key_buffer_.clear();
+  buffered_bytes_ = 0;
+}
 
-  sort_done_ = true;
+void OrderByExecutor::ReduceRuns(size_t max_fan_in) {
+  while (runs_.size() > max_fan_in) {
+    std::vector<std::unique_ptr<SortRun>> merged_runs;
+    for (size_t run_itr = 0; run_itr < max_fan_in; run_itr++) {
+      merged_runs.push_back(std::move(runs_[run_itr]));
+    }
+    runs_.erase(runs_.begin(), runs_.begin() + max_fan_in);
+
+    SortRunMerger merger(std::move(merged_runs));
+    std::unique_ptr<SortRun> run(new SortRun());
+    while (merger.Next()) {
+      auto &key = merger.GetCurrent()->GetKey();
+      auto &payload = merger.GetCurrent()->GetPayload();
+      run->Append(key.data(), key.size(), payload.data(), payload.size());
+    }
 
-  return true;
+    runs_.push_back(std::move(run));
+  }
 }
 
 } /* namespace executor */
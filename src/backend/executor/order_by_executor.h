@@ -13,7 +13,10 @@
 #pragma once
 
 #include "backend/common/types.h"
+#include "backend/common/serializer.h"
 #include "backend/executor/abstract_executor.h"
+#include "backend/executor/sort_key_encoder.h"
+#include "backend/executor/sort_run.h"
 #include "backend/storage/tuple.h"
 
 namespace peloton {
@@ -25,6 +28,10 @@ namespace executor {
 /**
  * @warning This is a pipeline breaker and a materialization point.
  *
+ * Tuples are sorted by their normalized key. When the input exceeds the
+ * memory budget of the plan, sorted runs are spilled to temporary files
+ * and merged while the output is returned.
+ *
  * TODO Currently, we store all input tiles and sort result in memory
  * until this executor is destroyed, which is sometimes necessary.
  * But can we let it release the RAM earlier as long as the executor
@@ -50,49 +57,63 @@ class OrderByExecutor : public AbstractExecutor {
  private:
   bool DoSort();
 
-  bool sort_done_ = false;
+  // Adds the tuples of an input tile to the sort buffer
+  void BufferTile(std::unique_ptr<LogicalTile> &&tile);
 
-  /**
-   * IMPORTANT This type must be move-constructible and move-assignable
-   * in order to be correctly sorted by STL sort
-   */
-  struct sort_buffer_entry_t {
-    ItemPointer item_pointer;
-    std::unique_ptr<storage::Tuple> tuple;
+  void SortBuffer();
 
-    sort_buffer_entry_t(ItemPointer ipt, std::unique_ptr<storage::Tuple> &&tp)
-        : item_pointer(ipt), tuple(std::move(tp)) {}
+  // Writes the buffered tuples out as a sorted run and releases them
+  void SpillRun();
 
-    sort_buffer_entry_t(sort_buffer_entry_t &&rhs) {
-      item_pointer = rhs.item_pointer;
-      tuple = std::move(rhs.tuple);
-    }
+  // Merges runs until at most max_fan_in are left
+  void ReduceRuns(size_t max_fan_in);
 
-    sort_buffer_entry_t &operator=(sort_buffer_entry_t &&rhs) {
-      item_pointer = rhs.item_pointer;
-      tuple = std::move(rhs.tuple);
-      return *this;
-    }
+  bool sort_done_ = false;
 
-    sort_buffer_entry_t(const sort_buffer_entry_t &) = delete;
-    sort_buffer_entry_t &operator=(const sort_buffer_entry_t &) = delete;
+  /** A buffered tuple with the offset of its normalized key. */
+  struct SortEntry {
+    // First bytes of the key, most comparisons stop there
+    uint64_t key_prefix;
+    size_t key_offset;
+    size_t key_length;
+    ItemPointer item_pointer;
   };
 
-  /** All tiles returned by child. */
+  /** Tiles returned by child, since the last spilled run. */
   std::vector<std::unique_ptr<LogicalTile>> input_tiles_;
 
   /** Physical (not logical) schema of input tiles */
   std::unique_ptr<catalog::Schema> input_schema_;
 
-  /** All valid tuples in sorted order */
-  std::vector<sort_buffer_entry_t> sort_buffer_;
+  /** Buffered tuples, in sorted order once sorted */
+  std::vector<SortEntry> sort_buffer_;
+
+  /** Normalized keys of the buffered tuples */
+  std::vector<char> key_buffer_;
 
-  /** Tuples in sort_buffer only contains the sort keys */
-  std::unique_ptr<catalog::Schema> sort_key_tuple_schema_;
+  std::unique_ptr<SortKeyEncoder> key_encoder_;
 
   /** ASC/DESC flags */
   std::vector<bool> descend_flags_;
 
+  /** Estimated bytes held by the buffered tuples */
+  size_t buffered_bytes_ = 0;
+
+  /** Sorted runs spilled to disk, when the input exceeds the budget */
+  std::vector<std::unique_ptr<SortRun>> runs_;
+
+  std::unique_ptr<SortRunMerger> merger_;
+
+  /** Variable length values read back from the runs, until they are
+   * copied into an output tile */
+  std::unique_ptr<VarlenPool> merge_pool_;
+
+  /** Serialized tuple of a sorted run */
+  std::unique_ptr<CopySerializeOutput> tuple_output_;
+
+  /** Number of tuples to return */
+  size_t num_tuples_ = 0;
+
   /** How many tuples have been returned to parent */
   size_t num_tuples_returned_ = 0;
 };
@@ -0,0 +1,235 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// radix_partitioner.cpp
+//
+// Identification: src/backend/executor/radix_partitioner.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/executor/radix_partitioner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "backend/common/value.h"
+#include "backend/executor/join_hash_table.h"
+#include "backend/executor/logical_tile.h"
+
+namespace peloton {
+namespace executor {
+
+const size_t RadixPartitioner::max_bits_per_pass;
+const size_t RadixPartitioner::max_partition_bits;
+const size_t RadixPartitioner::partition_cache_size;
+
+namespace {
+
+const size_t kHashBits = sizeof(size_t) * 8;
+
+inline size_t GetRadix(size_t hash, size_t shift, size_t mask) {
+  return (hash >> shift) & mask;
+}
+
+}  // End anonymous namespace
+
+RadixPartitioner::RadixPartitioner(size_t partition_bits)
+    : partition_bits(partition_bits) {
+  assert(partition_bits <= max_partition_bits);
+}
+
+void RadixPartitioner::Partition(
+    const std::vector<std::unique_ptr<LogicalTile>> &tiles,
+    const std::vector<oid_t> &column_ids, size_t worker_count) {
+  assert(worker_count > 0);
+
+  // Offset of the first tuple of every tile
+  std::vector<size_t> tile_offsets(tiles.size() + 1, 0);
+  for (size_t tile_itr = 0; tile_itr < tiles.size(); tile_itr++) {
+    tile_offsets[tile_itr + 1] =
+        tile_offsets[tile_itr] + tiles[tile_itr]->GetTupleCount();
+  }
+
+  size_t tuple_count = tile_offsets.back();
+  tuples.resize(tuple_count);
+
+  // Hash the keys, workers take one tile at a time
+  std::atomic<size_t> tile_cursor(0);
+  RunWorkers(worker_count, [&](size_t) {
+    std::vector<Value> key(column_ids.size());
+    size_t tile_itr;
+    while ((tile_itr = tile_cursor.fetch_add(1)) < tiles.size()) {
+      auto tile = tiles[tile_itr].get();
+      Tuple *output = &tuples[tile_offsets[tile_itr]];
+      for (oid_t tuple_id : *tile) {
+        output->hash =
+            JoinHashTable::GetKey(tile, tuple_id, column_ids, key.data());
+        output->tile_offset = tile_itr;
+        output->tuple_offset = tuple_id;
+        output++;
+      }
+    }
+  });
+
+  partition_offsets = {0, tuple_count};
+  if (partition_bits == 0) return;
+
+  // Spread the bits evenly over the passes
+  size_t pass_count =
+      (partition_bits + max_bits_per_pass - 1) / max_bits_per_pass;
+  size_t done_bits = 0;
+
+  std::vector<Tuple> output(tuple_count);
+  for (size_t pass_itr = 0; pass_itr < pass_count; pass_itr++) {
+    size_t pass_bits = (partition_bits - done_bits) / (pass_count - pass_itr);
+    done_bits += pass_bits;
+
+    size_t shift = kHashBits - done_bits;
+    std::vector<size_t> output_offsets(
+        ((partition_offsets.size() - 1) << pass_bits) + 1);
+
+    // The first pass splits a single range over the workers, later passes
+    // hand out whole partitions
+    if (pass_itr == 0) {
+      ScatterFirstPass(shift, pass_bits, worker_count, output, output_offsets);
+    } else {
+      ScatterPartitions(shift, pass_bits, worker_count, output,
+                        output_offsets);
+    }
+
+    tuples.swap(output);
+    partition_offsets.swap(output_offsets);
+  }
+}
+
+void RadixPartitioner::ScatterFirstPass(
+    size_t shift, size_t pass_bits, size_t worker_count,
+    std::vector<Tuple> &output, std::vector<size_t> &output_offsets) const {
+  size_t fanout = size_t(1) << pass_bits;
+  size_t mask = fanout - 1;
+  size_t chunk_size = (tuples.size() + worker_count - 1) / worker_count;
+
+  // Histogram of every worker's chunk
+  std::vector<std::vector<size_t>> cursors(worker_count,
+                                           std::vector<size_t>(fanout, 0));
+  RunWorkers(worker_count, [&](size_t worker_id) {
+    size_t begin = std::min(worker_id * chunk_size, tuples.size());
+    size_t end = std::min(begin + chunk_size, tuples.size());
+    auto &histogram = cursors[worker_id];
+    for (size_t tuple_itr = begin; tuple_itr < end; tuple_itr++) {
+      histogram[GetRadix(tuples[tuple_itr].hash, shift, mask)]++;
+    }
+  });
+
+  // Chunks follow each other inside a partition, which keeps the input order
+  size_t offset = 0;
+  for (size_t radix = 0; radix < fanout; radix++) {
+    output_offsets[radix] = offset;
+    for (auto &worker_cursors : cursors) {
+      size_t count = worker_cursors[radix];
+      worker_cursors[radix] = offset;
+      offset += count;
+    }
+  }
+  output_offsets[fanout] = offset;
+
+  RunWorkers(worker_count, [&](size_t worker_id) {
+    size_t begin = std::min(worker_id * chunk_size, tuples.size());
+    size_t end = std::min(begin + chunk_size, tuples.size());
+    auto &worker_cursors = cursors[worker_id];
+    for (size_t tuple_itr = begin; tuple_itr < end; tuple_itr++) {
+      auto &tuple = tuples[tuple_itr];
+      output[worker_cursors[GetRadix(tuple.hash, shift, mask)]++] = tuple;
+    }
+  });
+}
+
+void RadixPartitioner::ScatterPartitions(
+    size_t shift, size_t pass_bits, size_t worker_count,
+    std::vector<Tuple> &output, std::vector<size_t> &output_offsets) const {
+  size_t fanout = size_t(1) << pass_bits;
+  size_t mask = fanout - 1;
+  size_t partition_count = partition_offsets.size() - 1;
+
+  std::atomic<size_t> partition_cursor(0);
+  RunWorkers(worker_count, [&](size_t) {
+    std::vector<size_t> cursors(fanout);
+    size_t partition_itr;
+    while ((partition_itr = partition_cursor.fetch_add(1)) <
+           partition_count) {
+      size_t begin = partition_offsets[partition_itr];
+      size_t end = partition_offsets[partition_itr + 1];
+
+      std::fill(cursors.begin(), cursors.end(), 0);
+      for (size_t tuple_itr = begin; tuple_itr < end; tuple_itr++) {
+        cursors[GetRadix(tuples[tuple_itr].hash, shift, mask)]++;
+      }
+
+      // Sub-partitions stay inside the range of their partition
+      size_t offset = begin;
+      for (size_t radix = 0; radix < fanout; radix++) {
+        size_t count = cursors[radix];
+        output_offsets[(partition_itr << pass_bits) + radix] = offset;
+        cursors[radix] = offset;
+        offset += count;
+      }
+
+      for (size_t tuple_itr = begin; tuple_itr < end; tuple_itr++) {
+        auto &tuple = tuples[tuple_itr];
+        output[cursors[GetRadix(tuple.hash, shift, mask)]++] = tuple;
+      }
+    }
+  });
+
+  output_offsets[partition_count << pass_bits] = tuples.size();
+}
+
+size_t RadixPartitioner::GetPartitionBits(size_t build_size,
+                                          size_t min_partition_count) {
+  size_t bits = 0;
+  while (bits < max_partition_bits &&
+         ((size_t(1) << bits) < min_partition_count ||
+          (build_size >> bits) > partition_cache_size)) {
+    bits++;
+  }
+  return bits;
+}
+
+void RadixPartitioner::RunWorkers(size_t worker_count,
+                                  const std::function<void(size_t)> &worker) {
+  std::mutex error_mutex;
+  std::exception_ptr error;
+
+  auto run_worker = [&](size_t worker_id) {
+    try {
+      worker(worker_id);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (error == nullptr) error = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t worker_id = 1; worker_id < worker_count; worker_id++) {
+    threads.emplace_back(run_worker, worker_id);
+  }
+  run_worker(0);
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
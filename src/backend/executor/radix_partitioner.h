@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// radix_partitioner.h
+//
+// Identification: src/backend/executor/radix_partitioner.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace executor {
+
+class LogicalTile;
+
+//===--------------------------------------------------------------------===//
+// Radix Partitioner
+//===--------------------------------------------------------------------===//
+
+/**
+ * Splits the tuples of a join input into partitions by the top bits of the
+ * hash of their join key, so that the hash table of one partition of the
+ * build side stays in cache while it is built and probed.
+ *
+ * Each pass scatters on at most max_bits_per_pass bits, which bounds the
+ * number of partitions written to at once; more partitions take more
+ * passes. Tuples keep their input order inside a partition.
+ */
+class RadixPartitioner {
+ public:
+  RadixPartitioner(const RadixPartitioner &) = delete;
+  RadixPartitioner &operator=(const RadixPartitioner &) = delete;
+
+  /** @brief A partitioned tuple : < key hash, tile offset, tuple offset > */
+  struct Tuple {
+    size_t hash;
+    oid_t tile_offset;
+    oid_t tuple_offset;
+  };
+
+  // Fan-out of a single pass
+  static const size_t max_bits_per_pass = 8;
+
+  static const size_t max_partition_bits = 3 * max_bits_per_pass;
+
+  // Budget for the hash table of one partition, about the size of an L2
+  static const size_t partition_cache_size = 256 * 1024;
+
+  explicit RadixPartitioner(size_t partition_bits);
+
+  // Hashes the key columns of every tuple of the tiles and partitions them
+  void Partition(const std::vector<std::unique_ptr<LogicalTile>> &tiles,
+                 const std::vector<oid_t> &column_ids, size_t worker_count);
+
+  size_t GetPartitionCount() const { return partition_offsets.size() - 1; }
+
+  inline const Tuple *GetPartitionBegin(size_t partition) const {
+    return tuples.data() + partition_offsets[partition];
+  }
+
+  inline const Tuple *GetPartitionEnd(size_t partition) const {
+    return tuples.data() + partition_offsets[partition + 1];
+  }
+
+  inline size_t GetPartitionSize(size_t partition) const {
+    return partition_offsets[partition + 1] - partition_offsets[partition];
+  }
+
+  // Number of partition bits that splits a build side of build_size bytes
+  // into cache-sized partitions, and into at least min_partition_count
+  static size_t GetPartitionBits(size_t build_size,
+                                 size_t min_partition_count);
+
+  // Runs the worker on worker_count threads, the caller being worker 0,
+  // and rethrows the first exception thrown by any of them
+  static void RunWorkers(size_t worker_count,
+                         const std::function<void(size_t)> &worker);
+
+ private:
+  void ScatterFirstPass(size_t shift, size_t pass_bits, size_t worker_count,
+                        std::vector<Tuple> &output,
+                        std::vector<size_t> &output_offsets) const;
+
+  void ScatterPartitions(size_t shift, size_t pass_bits, size_t worker_count,
+                         std::vector<Tuple> &output,
+                         std::vector<size_t> &output_offsets) const;
+
+  size_t partition_bits;
+
+  std::vector<Tuple> tuples;
+
+  // tuples of partition i are [partition_offsets[i], partition_offsets[i+1])
+  std::vector<size_t> partition_offsets;
+};
+
+}  // namespace executor
+}  // namespace peloton
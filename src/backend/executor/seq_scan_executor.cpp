@@ -12,6 +12,7 @@
 
 #include "backend/executor/seq_scan_executor.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -20,6 +21,7 @@
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/logical_tile_factory.h"
 #include "backend/executor/executor_context.h"
+#include "backend/executor/join_hash_table.h"
 #include "backend/expression/abstract_expression.h"
 #include "backend/expression/container_tuple.h"
 #include "backend/storage/data_table.h"
@@ -38,6 +40,8 @@ SeqScanExecutor::SeqScanExecutor(const planner::AbstractPlan *node,
                                  ExecutorContext *executor_context)
     : AbstractScanExecutor(node, executor_context) {}
 
+SeqScanExecutor::~SeqScanExecutor() { StopScanWorkers(); }
+
 /**
  * @brief Let base class DInit() first, then do mine.
  * @return true on success, false otherwise.
@@ -52,7 +56,12 @@ bool SeqScanExecutor::DInit() {
 
   target_table_ = node.GetTable();
 
-  current_tile_group_offset_ = START_OID;
+  // Make sure workers of an earlier run are gone
+  StopScanWorkers();
+
+  tile_group_cursor_ = std::make_shared<std::atomic<oid_t>>(START_OID);
+  bloom_filter_.reset();
+  parallelism_ = std::max<oid_t>(node.GetParallelism(), 1);
 
   if (target_table_ != nullptr) {
     table_tile_group_count_ = target_table_->GetTileGroupCount();
@@ -61,6 +70,9 @@ bool SeqScanExecutor::DInit() {
       column_ids_.resize(target_table_->GetSchema()->GetColumnCount());
       std::iota(column_ids_.begin(), column_ids_.end(), 0);
     }
+
+    vectorized_predicate_.reset(expression::VectorizedPredicate::Create(
+        predicate_, executor_context_));
   }
 
   return true;
@@ -111,49 +123,19 @@ bool SeqScanExecutor::DExecute() {
     assert(target_table_ != nullptr);
     assert(column_ids_.size() > 0);
 
-    // Retrieve next tile group.
-    while (current_tile_group_offset_ < table_tile_group_count_) {
-      auto tile_group =
-          target_table_->GetTileGroup(current_tile_group_offset_++);
-
-      storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
-
-      auto transaction_ = executor_context_->GetTransaction();
-      txn_id_t txn_id = transaction_->GetTransactionId();
-      cid_t commit_id = transaction_->GetLastCommitId();
-      oid_t active_tuple_count = tile_group->GetNextTupleSlot();
-
-      // Print tile group visibility
-      // tile_group_header->PrintVisibility(txn_id, commit_id);
-
-      // Construct logical tile.
-      std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
-      logical_tile->AddColumns(tile_group, column_ids_);
-
-      // Construct position list by looping through tile group
-      // and applying the predicate.
-      std::vector<oid_t> position_list;
-      for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
-        if (tile_group_header->IsVisible(tuple_id, txn_id, commit_id) ==
-            false) {
-          continue;
-        }
-
-        expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
-                                                             tuple_id);
-        if (predicate_ == nullptr) {
-          position_list.push_back(tuple_id);
-        } else {
-          auto eval =
-              predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
-          if (eval == true) position_list.push_back(tuple_id);
-        }
-      }
+    if (parallelism_ > 1) {
+      return DExecuteParallel();
+    }
 
-      logical_tile->AddPositionList(std::move(position_list));
+    // Retrieve next tile group.
+    oid_t tile_group_offset;
+    while ((tile_group_offset = tile_group_cursor_->fetch_add(1)) <
+           table_tile_group_count_) {
+      std::unique_ptr<LogicalTile> logical_tile(
+          ScanTileGroup(tile_group_offset));
 
       // Don't return empty tiles
-      if (0 == logical_tile->GetTupleCount()) {
+      if (logical_tile == nullptr) {
         continue;
       }
 
@@ -165,5 +147,208 @@ bool SeqScanExecutor::DExecute() {
   return false;
 }
 
+/**
+ * @brief Scans only the tile groups handed out by the shared cursor.
+ * @return true on success, false otherwise.
+ */
+bool SeqScanExecutor::SetSharedScanCursor(
+    std::shared_ptr<std::atomic<oid_t>> scan_cursor) {
+  // Scanning the output of a child
+  if (target_table_ == nullptr) {
+    return AbstractExecutor::SetSharedScanCursor(scan_cursor);
+  }
+
+  tile_group_cursor_ = scan_cursor;
+  return true;
+}
+
+/**
+ * @brief Keeps the filter of a hash join above, to drop the tuples whose
+ *        key it does not hold while scanning.
+ * @param filter Filter over the key hashes of the build side.
+ * @param column_ids Key columns of the output tiles.
+ * @return true if the scan will apply the filter.
+ */
+bool SeqScanExecutor::SetBloomFilter(
+    std::shared_ptr<const JoinBloomFilter> filter,
+    const std::vector<oid_t> &column_ids) {
+  // Scanning the output of a child, or too late once the workers run
+  if (target_table_ == nullptr || exchange_queue_ != nullptr) {
+    return false;
+  }
+
+  // Output columns to table columns
+  bloom_filter_column_ids_.clear();
+  for (auto column_id : column_ids) {
+    assert(column_id < column_ids_.size());
+    bloom_filter_column_ids_.push_back(column_ids_[column_id]);
+  }
+
+  bloom_filter_ = filter;
+  return true;
+}
+
+/**
+ * @brief Applies visibility and the scan predicate to one tile group.
+ * @return Logical tile over the matching tuples, nullptr if there are none.
+ */
+LogicalTile *SeqScanExecutor::ScanTileGroup(oid_t tile_group_offset) {
+  auto tile_group = target_table_->GetTileGroup(tile_group_offset);
+
+  storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
+
+  auto transaction_ = executor_context_->GetTransaction();
+  txn_id_t txn_id = transaction_->GetTransactionId();
+  cid_t commit_id = transaction_->GetLastCommitId();
+  oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+
+  // Print tile group visibility
+  // tile_group_header->PrintVisibility(txn_id, commit_id);
+
+  // Construct position list by checking the visibility of
+  // the whole tile group in one pass and applying the predicate.
+  std::vector<oid_t> position_list;
+  tile_group_header->GetVisiblePositionList(txn_id, commit_id, START_OID,
+                                            active_tuple_count, position_list);
+
+  if (vectorized_predicate_ != nullptr) {
+    vectorized_predicate_->Filter(tile_group.get(), position_list);
+  } else if (predicate_ != nullptr) {
+    oid_t match_count = 0;
+    for (auto tuple_id : position_list) {
+      expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                           tuple_id);
+      auto eval =
+          predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
+      if (eval == true) position_list[match_count++] = tuple_id;
+    }
+    position_list.resize(match_count);
+  }
+
+  if (bloom_filter_ != nullptr) {
+    ApplyBloomFilter(tile_group.get(), position_list);
+  }
+
+  if (position_list.empty()) {
+    return nullptr;
+  }
+
+  // Construct logical tile.
+  LogicalTile *logical_tile = LogicalTileFactory::GetTile();
+  logical_tile->AddColumns(tile_group, column_ids_);
+  logical_tile->AddPositionList(std::move(position_list));
+
+  return logical_tile;
+}
+
+/**
+ * @brief Drops the tuples whose key hash is not in the Bloom filter. They
+ *        would not find a match in the hash join above.
+ */
+void SeqScanExecutor::ApplyBloomFilter(
+    storage::TileGroup *tile_group, std::vector<oid_t> &position_list) const {
+  std::vector<Value> key(bloom_filter_column_ids_.size());
+
+  oid_t match_count = 0;
+  for (auto tuple_id : position_list) {
+    for (size_t column_itr = 0; column_itr < key.size(); column_itr++) {
+      key[column_itr] =
+          tile_group->GetValue(tuple_id, bloom_filter_column_ids_[column_itr]);
+    }
+
+    auto hash = JoinHashTable::GetHash(key.data(), key.size());
+    if (bloom_filter_->MayContain(hash)) position_list[match_count++] = tuple_id;
+  }
+  position_list.resize(match_count);
+}
+
+/**
+ * @brief Returns the next tile produced by the scan workers. Tiles come
+ *        out in the order the workers finish them, not in table order.
+ * @return true on success, false once the whole table has been scanned.
+ */
+bool SeqScanExecutor::DExecuteParallel() {
+  if (exchange_queue_ == nullptr) {
+    StartScanWorkers();
+  }
+
+  LogicalTile *logical_tile = exchange_queue_->Pop();
+
+  {
+    std::lock_guard<std::mutex> lock(worker_error_mutex_);
+    if (worker_error_ != nullptr) {
+      delete logical_tile;
+      auto worker_error = worker_error_;
+      worker_error_ = nullptr;
+      StopScanWorkers();
+      std::rethrow_exception(worker_error);
+    }
+  }
+
+  if (logical_tile == nullptr) {
+    return false;
+  }
+
+  SetOutput(logical_tile);
+  return true;
+}
+
+/**
+ * @brief Starts the scan workers. The tile groups are handed out one at a
+ *        time through an atomic cursor, so faster workers take more of them.
+ */
+void SeqScanExecutor::StartScanWorkers() {
+  LOG_TRACE("Seq Scan executor :: starting %lu workers", parallelism_);
+
+  // Bounding the queue keeps the workers from running far ahead of
+  // the parent executor
+  exchange_queue_.reset(new ExchangeQueue(parallelism_ * 2, parallelism_));
+
+  for (oid_t worker_itr = 0; worker_itr < parallelism_; worker_itr++) {
+    scan_workers_.push_back(std::thread(&SeqScanExecutor::ScanWorker, this));
+  }
+}
+
+/**
+ * @brief Cancels and joins the scan workers, dropping unconsumed tiles.
+ */
+void SeqScanExecutor::StopScanWorkers() {
+  if (exchange_queue_ != nullptr) {
+    exchange_queue_->Cancel();
+  }
+
+  for (auto &scan_worker : scan_workers_) {
+    scan_worker.join();
+  }
+
+  scan_workers_.clear();
+  exchange_queue_.reset();
+}
+
+void SeqScanExecutor::ScanWorker() {
+  try {
+    while (exchange_queue_->IsCancelled() == false) {
+      oid_t tile_group_offset = tile_group_cursor_->fetch_add(1);
+      if (tile_group_offset >= table_tile_group_count_) break;
+
+      std::unique_ptr<LogicalTile> logical_tile(
+          ScanTileGroup(tile_group_offset));
+      if (logical_tile == nullptr) continue;
+
+      if (exchange_queue_->Push(logical_tile.get()) == false) break;
+      logical_tile.release();
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(worker_error_mutex_);
+      if (worker_error_ == nullptr) worker_error_ = std::current_exception();
+    }
+    // Wakes up the parent and the other workers
+    exchange_queue_->Cancel();
+  }
+
+  exchange_queue_->ProducerDone();
+}
+
 }  // namespace executor
 }  // namespace peloton
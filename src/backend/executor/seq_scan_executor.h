@@ -12,8 +12,18 @@
 
 #pragma once
 
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "backend/planner/seq_scan_plan.h"
 #include "backend/executor/abstract_scan_executor.h"
+#include "backend/executor/exchange_queue.h"
+#include "backend/executor/join_bloom_filter.h"
+#include "backend/expression/vectorized_predicate.h"
 
 namespace peloton {
 namespace executor {
@@ -28,28 +38,74 @@ class SeqScanExecutor : public AbstractScanExecutor {
   explicit SeqScanExecutor(const planner::AbstractPlan *node,
                            ExecutorContext *executor_context);
 
+  ~SeqScanExecutor();
+
+  bool SetSharedScanCursor(std::shared_ptr<std::atomic<oid_t>> scan_cursor);
+
+  bool SetBloomFilter(std::shared_ptr<const JoinBloomFilter> filter,
+                      const std::vector<oid_t> &column_ids);
+
  protected:
   bool DInit();
 
   bool DExecute();
 
  private:
+  LogicalTile *ScanTileGroup(oid_t tile_group_offset);
+
+  void ApplyBloomFilter(storage::TileGroup *tile_group,
+                        std::vector<oid_t> &position_list) const;
+
+  //===--------------------------------------------------------------------===//
+  // Parallel Scan
+  //===--------------------------------------------------------------------===//
+
+  bool DExecuteParallel();
+
+  void StartScanWorkers();
+
+  void StopScanWorkers();
+
+  void ScanWorker();
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
 
-  /** @brief Keeps track of current tile group id being scanned. */
-  oid_t current_tile_group_offset_ = INVALID_OID;
 
   /** @brief Keeps track of the number of tile groups to scan. */
   oid_t table_tile_group_count_ = INVALID_OID;
 
+  /** @brief Next tile group to scan, shared with the scan workers and
+   *         with other copies of this scan under an exchange. */
+  std::shared_ptr<std::atomic<oid_t>> tile_group_cursor_;
+
+  /** @brief Tiles produced by the scan workers. */
+  std::unique_ptr<ExchangeQueue> exchange_queue_;
+
+  std::vector<std::thread> scan_workers_;
+
+  /** @brief First error raised by a scan worker, rethrown in DExecute. */
+  std::mutex worker_error_mutex_;
+  std::exception_ptr worker_error_;
+
+  /** @brief Bloom filter of the hash join above, over the key columns of
+   *         the table. */
+  std::shared_ptr<const JoinBloomFilter> bloom_filter_;
+  std::vector<oid_t> bloom_filter_column_ids_;
+
   //===--------------------------------------------------------------------===//
   // Plan Info
   //===--------------------------------------------------------------------===//
 
   /** @brief Pointer to table to scan from. */
   storage::DataTable *target_table_ = nullptr;
+
+  /** @brief Number of scan workers, 1 scans in the calling thread. */
+  oid_t parallelism_ = 1;
+
+  /** @brief Batch evaluator for the predicate over tile groups. */
+  std::unique_ptr<expression::VectorizedPredicate> vectorized_predicate_;
 };
 
 }  // namespace executor
@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// sort_key_encoder.cpp
+//
+// Identification: src/backend/executor/sort_key_encoder.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/executor/sort_key_encoder.h"
+
+#include <cassert>
+#include <cmath>
+
+#include "backend/common/exception.h"
+#include "backend/common/value_peeker.h"
+#include "backend/executor/logical_tile.h"
+
+namespace peloton {
+namespace executor {
+
+// Null marker, sorts before any value
+static const char null_marker = 0x00;
+static const char value_marker = 0x01;
+
+/**
+ * @brief Appends an unsigned integer in big-endian.
+ */
+static void AppendBigEndian(uint64_t bits, size_t width,
+                            std::vector<char> &buffer) {
+  for (size_t byte_itr = width; byte_itr > 0; byte_itr--) {
+    buffer.push_back(static_cast<char>(bits >> (8 * (byte_itr - 1))));
+  }
+}
+
+/**
+ * @brief Appends a signed integer, whose unsigned order is its signed order
+ * once the sign bit is flipped.
+ */
+static void AppendSigned(int64_t value, size_t width,
+                         std::vector<char> &buffer) {
+  uint64_t sign_bit = uint64_t(1) << (8 * width - 1);
+  AppendBigEndian(static_cast<uint64_t>(value) ^ sign_bit, width, buffer);
+}
+
+SortKeyEncoder::SortKeyEncoder(const std::vector<oid_t> &sort_keys,
+                               const std::vector<bool> &descend_flags)
+    : sort_keys(sort_keys), descend_flags(descend_flags) {
+  assert(sort_keys.size() == descend_flags.size());
+}
+
+void SortKeyEncoder::EncodeTuple(LogicalTile *tile, oid_t tuple_id,
+                                 std::vector<char> &buffer) const {
+  for (size_t key_itr = 0; key_itr < sort_keys.size(); key_itr++) {
+    EncodeValue(tile->GetValue(tuple_id, sort_keys[key_itr]),
+                descend_flags[key_itr], buffer);
+  }
+}
+
+void SortKeyEncoder::EncodeValue(const Value &value, bool descend,
+                                 std::vector<char> &buffer) {
+  size_t begin = buffer.size();
+
+  if (value.IsNull()) {
+    buffer.push_back(null_marker);
+  } else {
+    buffer.push_back(value_marker);
+
+    switch (value.GetValueType()) {
+      case VALUE_TYPE_TINYINT:
+        AppendSigned(ValuePeeker::PeekTinyInt(value), 1, buffer);
+        break;
+      case VALUE_TYPE_SMALLINT:
+        AppendSigned(ValuePeeker::PeekSmallInt(value), 2, buffer);
+        break;
+      case VALUE_TYPE_INTEGER:
+        AppendSigned(ValuePeeker::PeekInteger(value), 4, buffer);
+        break;
+      case VALUE_TYPE_BIGINT:
+        AppendSigned(ValuePeeker::PeekBigInt(value), 8, buffer);
+        break;
+      case VALUE_TYPE_TIMESTAMP:
+        AppendSigned(ValuePeeker::PeekTimestamp(value), 8, buffer);
+        break;
+      case VALUE_TYPE_DOUBLE: {
+        double double_value = ValuePeeker::PeekDouble(value);
+
+        // NaNs are equal and below negative infinity, zeros are equal
+        uint64_t bits = 0;
+        if (!std::isnan(double_value)) {
+          if (double_value == 0) double_value = 0;
+          memcpy(&bits, &double_value, sizeof(bits));
+          uint64_t sign_bit = uint64_t(1) << 63;
+          bits = (bits & sign_bit) ? ~bits : bits ^ sign_bit;
+        }
+        AppendBigEndian(bits, 8, buffer);
+      } break;
+      case VALUE_TYPE_DECIMAL: {
+        // 128-bit two's complement, high word first
+        TTInt decimal_value = ValuePeeker::PeekDecimal(value);
+        AppendSigned(static_cast<int64_t>(decimal_value.table[1]), 8, buffer);
+        AppendBigEndian(decimal_value.table[0], 8, buffer);
+      } break;
+      case VALUE_TYPE_VARCHAR:
+      case VALUE_TYPE_VARBINARY: {
+        const char *data = reinterpret_cast<const char *>(
+            ValuePeeker::PeekObjectValueWithoutNull(value));
+        int32_t length = ValuePeeker::PeekObjectLengthWithoutNull(value);
+        for (int32_t byte_itr = 0; byte_itr < length; byte_itr++) {
+          buffer.push_back(data[byte_itr]);
+          if (data[byte_itr] == 0x00) buffer.push_back(static_cast<char>(0xFF));
+        }
+        buffer.push_back(0x00);
+        buffer.push_back(0x00);
+      } break;
+      default:
+        throw Exception("non comparable type in sort key :: " +
+                        ValueTypeToString(value.GetValueType()));
+    }
+  }
+
+  if (descend) {
+    for (size_t byte_itr = begin; byte_itr < buffer.size(); byte_itr++) {
+      buffer[byte_itr] = ~buffer[byte_itr];
+    }
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
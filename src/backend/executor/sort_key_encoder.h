@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// sort_key_encoder.h
+//
+// Identification: src/backend/executor/sort_key_encoder.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "backend/common/types.h"
+#include "backend/common/value.h"
+
+namespace peloton {
+namespace executor {
+
+class LogicalTile;
+
+//===--------------------------------------------------------------------===//
+// Sort Key Encoder
+//===--------------------------------------------------------------------===//
+
+/**
+ * Encodes the sort keys of a tuple into a normalized key, a byte string
+ * whose memcmp order is the order of the tuples.
+ *
+ * Every key column starts with a byte telling whether it is null, nulls
+ * first as in Value::Compare. Integers follow in big-endian with the sign
+ * bit flipped, doubles in the same form after flipping the bits of the
+ * negative ones, and strings byte by byte with 0x00 escaped as 0x00 0xFF
+ * and a 0x00 0x00 terminator. Since each column ends where its encoding
+ * says, no key is a prefix of another one. The bytes of a descending
+ * column are inverted.
+ */
+class SortKeyEncoder {
+ public:
+  SortKeyEncoder(const std::vector<oid_t> &sort_keys,
+                 const std::vector<bool> &descend_flags);
+
+  // Appends the key of a tuple of the tile to the buffer
+  void EncodeTuple(LogicalTile *tile, oid_t tuple_id,
+                   std::vector<char> &buffer) const;
+
+  // Appends the encoding of a value to the buffer, throws for values that
+  // cannot be compared
+  static void EncodeValue(const Value &value, bool descend,
+                          std::vector<char> &buffer);
+
+  // The first bytes of a key as an integer with the same order, padded with
+  // zeros. Keys with different prefixes compare as their prefixes.
+  static inline uint64_t GetPrefix(const char *key, size_t length) {
+    unsigned char bytes[sizeof(uint64_t)] = {0};
+    memcpy(bytes, key, std::min(length, sizeof(uint64_t)));
+
+    uint64_t prefix = 0;
+    for (size_t byte_itr = 0; byte_itr < sizeof(uint64_t); byte_itr++) {
+      prefix = (prefix << 8) | bytes[byte_itr];
+    }
+    return prefix;
+  }
+
+  // Three-way comparison of two keys
+  static inline int Compare(const char *lhs, size_t lhs_length,
+                            const char *rhs, size_t rhs_length) {
+    int result = memcmp(lhs, rhs, std::min(lhs_length, rhs_length));
+    if (result != 0) return result;
+    return (lhs_length > rhs_length) - (lhs_length < rhs_length);
+  }
+
+ private:
+  const std::vector<oid_t> sort_keys;
+
+  const std::vector<bool> descend_flags;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// sort_run.cpp
+//
+// Identification: src/backend/executor/sort_run.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/executor/sort_run.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "backend/common/exception.h"
+#include "backend/executor/sort_key_encoder.h"
+
+namespace peloton {
+namespace executor {
+
+const size_t SortRun::buffer_size;
+
+/** @brief Lengths of the key and the payload of a record */
+struct SortRunRecordHeader {
+  uint32_t key_length;
+  uint32_t payload_length;
+};
+
+SortRun::SortRun() {
+  file = tmpfile();
+  if (file == nullptr) {
+    throw ExecutorException("Could not create a temporary file for a sort");
+  }
+  setvbuf(file, nullptr, _IOFBF, buffer_size);
+}
+
+SortRun::~SortRun() { fclose(file); }
+
+void SortRun::Append(const char *key, size_t key_length, const char *payload,
+                     size_t payload_length) {
+  SortRunRecordHeader header{static_cast<uint32_t>(key_length),
+                             static_cast<uint32_t>(payload_length)};
+
+  if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+      fwrite(key, 1, key_length, file) != key_length ||
+      fwrite(payload, 1, payload_length, file) != payload_length) {
+    throw ExecutorException("Could not write a sorted run");
+  }
+
+  record_count++;
+}
+
+void SortRun::Rewind() {
+  if (fflush(file) != 0 || fseek(file, 0, SEEK_SET) != 0) {
+    throw ExecutorException("Could not rewind a sorted run");
+  }
+  unread_count = record_count;
+}
+
+bool SortRun::Next() {
+  if (unread_count == 0) return false;
+
+  SortRunRecordHeader header;
+  Read(&header, sizeof(header));
+
+  key.resize(header.key_length);
+  Read(key.data(), header.key_length);
+  payload.resize(header.payload_length);
+  Read(payload.data(), header.payload_length);
+
+  unread_count--;
+  return true;
+}
+
+void SortRun::Read(void *data, size_t length) {
+  if (length > 0 && fread(data, 1, length, file) != length) {
+    throw ExecutorException("Could not read a sorted run");
+  }
+}
+
+/**
+ * @brief Orders the heap so that the run with the smallest key is on top.
+ */
+static bool RunKeyGreater(const SortRun *lhs, const SortRun *rhs) {
+  auto &lhs_key = lhs->GetKey();
+  auto &rhs_key = rhs->GetKey();
+  return SortKeyEncoder::Compare(lhs_key.data(), lhs_key.size(),
+                                 rhs_key.data(), rhs_key.size()) > 0;
+}
+
+SortRunMerger::SortRunMerger(std::vector<std::unique_ptr<SortRun>> &&runs)
+    : runs(std::move(runs)) {
+  for (auto &run : this->runs) {
+    run->Rewind();
+    if (run->Next()) heap.push_back(run.get());
+  }
+  std::make_heap(heap.begin(), heap.end(), RunKeyGreater);
+}
+
+bool SortRunMerger::Next() {
+  // Put back the run of the last record, at its next record
+  if (current != nullptr && current->Next()) {
+    heap.push_back(current);
+    std::push_heap(heap.begin(), heap.end(), RunKeyGreater);
+  }
+  current = nullptr;
+
+  if (heap.empty()) return false;
+
+  std::pop_heap(heap.begin(), heap.end(), RunKeyGreater);
+  current = heap.back();
+  heap.pop_back();
+  return true;
+}
+
+}  // namespace executor
+}  // namespace peloton
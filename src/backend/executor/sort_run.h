@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// sort_run.h
+//
+// Identification: src/backend/executor/sort_run.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace executor {
+
+//===--------------------------------------------------------------------===//
+// Sort Run
+//===--------------------------------------------------------------------===//
+
+/**
+ * A run of records sorted by their normalized key, spilled to a temporary
+ * file by an external sort. A record is a key and an opaque payload. The
+ * run is written once, then rewound and read once.
+ */
+class SortRun {
+ public:
+  SortRun(const SortRun &) = delete;
+  SortRun &operator=(const SortRun &) = delete;
+
+  // Size of the file buffer of a run, bounds the fan-in of a merge
+  static const size_t buffer_size = 64 * 1024;
+
+  // Opens an anonymous temporary file, gone when the run is destroyed
+  SortRun();
+
+  ~SortRun();
+
+  // Appends a record, the records must come in key order
+  void Append(const char *key, size_t key_length, const char *payload,
+              size_t payload_length);
+
+  // Ends the writing, the next record read is the first one
+  void Rewind();
+
+  // Reads the next record, returns false at the end of the run
+  bool Next();
+
+  const std::vector<char> &GetKey() const { return key; }
+
+  const std::vector<char> &GetPayload() const { return payload; }
+
+  size_t GetRecordCount() const { return record_count; }
+
+ private:
+  void Read(void *data, size_t length);
+
+  FILE *file = nullptr;
+
+  size_t record_count = 0;
+
+  // Records not read yet
+  size_t unread_count = 0;
+
+  /** @brief Current record */
+  std::vector<char> key;
+  std::vector<char> payload;
+};
+
+/**
+ * Merges sorted runs into a single stream of records in key order.
+ */
+class SortRunMerger {
+ public:
+  SortRunMerger(const SortRunMerger &) = delete;
+  SortRunMerger &operator=(const SortRunMerger &) = delete;
+
+  explicit SortRunMerger(std::vector<std::unique_ptr<SortRun>> &&runs);
+
+  // Moves to the next record, returns false when all runs are drained
+  bool Next();
+
+  // Run holding the current record
+  const SortRun *GetCurrent() const { return current; }
+
+ private:
+  std::vector<std::unique_ptr<SortRun>> runs;
+
+  // Min-heap of the runs with a record left, by their current key
+  std::vector<SortRun *> heap;
+
+  SortRun *current = nullptr;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,196 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// top_n_executor.cpp
+//
+// Identification: src/backend/executor/top_n_executor.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/executor/top_n_executor.h"
+
+#include <algorithm>
+
+#include "backend/common/logger.h"
+#include "backend/executor/executor_context.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/executor/logical_tile_factory.h"
+#include "backend/planner/top_n_plan.h"
+#include "backend/storage/tile.h"
+
+namespace peloton {
+namespace executor {
+
+/**
+ * @brief Orders two normalized keys, by their prefixes first.
+ */
+static inline bool KeyLess(uint64_t lhs_prefix, const std::vector<char> &lhs,
+                           uint64_t rhs_prefix, const std::vector<char> &rhs) {
+  if (lhs_prefix != rhs_prefix) return lhs_prefix < rhs_prefix;
+  return SortKeyEncoder::Compare(lhs.data(), lhs.size(), rhs.data(),
+                                 rhs.size()) < 0;
+}
+
+/**
+ * @brief Constructor
+ * @param node  TopNPlan plan node corresponding to this executor
+ */
+TopNExecutor::TopNExecutor(const planner::AbstractPlan *node,
+                           ExecutorContext *executor_context)
+    : AbstractExecutor(node, executor_context) {}
+
+bool TopNExecutor::DInit() {
+  assert(children_.size() == 1);
+
+  top_n_done_ = false;
+  heap_.clear();
+  input_tiles_.clear();
+  tile_ref_counts_.clear();
+  input_schema_.reset();
+  next_entry_ = 0;
+
+  return true;
+}
+
+bool TopNExecutor::DExecute() {
+  LOG_TRACE("Top N executor ");
+
+  if (!top_n_done_) DoTopN();
+
+  if (!(next_entry_ < heap_.size())) {
+    return false;
+  }
+
+  assert(input_schema_.get());
+
+  // Returned tiles must be newly created physical tiles,
+  // which have the same physical schema as input tiles.
+  size_t tile_size = std::min(size_t(DEFAULT_TUPLES_PER_TILEGROUP),
+                              heap_.size() - next_entry_);
+
+  std::shared_ptr<storage::Tile> ptile(storage::TileFactory::GetTile(
+      BACKEND_TYPE_MM, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
+      nullptr, *input_schema_, nullptr, tile_size));
+
+  oid_t column_count = input_schema_->GetColumnCount();
+  for (size_t id = 0; id < tile_size; id++) {
+    auto &item_pointer = heap_[next_entry_ + id].item_pointer;
+    auto &source_tile = input_tiles_[item_pointer.block];
+    assert(source_tile.get() != nullptr);
+
+    // Insert a physical tuple into physical tile
+    for (oid_t col = 0; col < column_count; col++) {
+      ptile->SetValue(source_tile->GetValue(item_pointer.offset, col), id,
+                      col);
+    }
+  }
+
+  // Create an owner wrapper of this physical tile
+  std::vector<std::shared_ptr<storage::Tile>> singleton({ptile});
+  std::unique_ptr<LogicalTile> ltile(LogicalTileFactory::WrapTiles(singleton));
+  assert(ltile->GetTupleCount() == tile_size);
+
+  SetOutput(ltile.release());
+
+  next_entry_ += tile_size;
+
+  return true;
+}
+
+void TopNExecutor::DoTopN() {
+  assert(children_.size() == 1);
+  assert(children_[0] != nullptr);
+  assert(!top_n_done_);
+
+  // Grab data from plan node
+  const planner::TopNPlan &node = GetPlanNode<planner::TopNPlan>();
+  heap_size_ = node.GetOffset() + node.GetLimit();
+  key_encoder_.reset(
+      new SortKeyEncoder(node.GetSortKeys(), node.GetDescendFlags()));
+
+  // No tuple to keep, no need to read the input
+  if (heap_size_ > 0) {
+    while (children_[0]->Execute()) {
+      std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
+      if (input_schema_.get() == nullptr) {
+        input_schema_.reset(tile->GetPhysicalSchema());
+      }
+
+      ConsumeTile(std::move(tile));
+    }
+  }
+
+  // Smallest key first
+  std::sort_heap(heap_.begin(), heap_.end(),
+                 [](const HeapEntry &lhs, const HeapEntry &rhs) {
+                   return KeyLess(lhs.key_prefix, lhs.key, rhs.key_prefix,
+                                  rhs.key);
+                 });
+
+  next_entry_ = std::min(node.GetOffset(), heap_.size());
+  top_n_done_ = true;
+
+  LOG_TRACE("Kept %lu tuples of %lu tiles", heap_.size(), input_tiles_.size());
+}
+
+void TopNExecutor::ConsumeTile(std::unique_ptr<LogicalTile> &&tile) {
+  auto entry_less = [](const HeapEntry &lhs, const HeapEntry &rhs) {
+    return KeyLess(lhs.key_prefix, lhs.key, rhs.key_prefix, rhs.key);
+  };
+
+  oid_t tile_id = input_tiles_.size();
+  input_tiles_.push_back(std::move(tile));
+  tile_ref_counts_.push_back(0);
+  LogicalTile *input_tile = input_tiles_.back().get();
+
+  for (oid_t tuple_id : *input_tile) {
+    key_buffer_.clear();
+    key_encoder_->EncodeTuple(input_tile, tuple_id, key_buffer_);
+    uint64_t key_prefix =
+        SortKeyEncoder::GetPrefix(key_buffer_.data(), key_buffer_.size());
+
+    if (heap_.size() < heap_size_) {
+      heap_.push_back(
+          HeapEntry{key_prefix, key_buffer_, ItemPointer(tile_id, tuple_id)});
+      std::push_heap(heap_.begin(), heap_.end(), entry_less);
+      tile_ref_counts_[tile_id]++;
+      continue;
+    }
+
+    // Only a smaller key than the largest kept one gets in, ties keep the
+    // tuple seen first
+    auto &top = heap_.front();
+    if (!KeyLess(key_prefix, key_buffer_, top.key_prefix, top.key)) {
+      continue;
+    }
+
+    // Replace the largest kept tuple, reusing its key buffer
+    std::pop_heap(heap_.begin(), heap_.end(), entry_less);
+    auto &entry = heap_.back();
+    ReleaseTuple(entry.item_pointer.block);
+    entry.key_prefix = key_prefix;
+    entry.key.swap(key_buffer_);
+    entry.item_pointer = ItemPointer(tile_id, tuple_id);
+    tile_ref_counts_[tile_id]++;
+    std::push_heap(heap_.begin(), heap_.end(), entry_less);
+  }
+
+  if (tile_ref_counts_[tile_id] == 0) {
+    input_tiles_[tile_id].reset();
+  }
+}
+
+void TopNExecutor::ReleaseTuple(oid_t tile_id) {
+  assert(tile_ref_counts_[tile_id] > 0);
+
+  // The tile being consumed is released once all its tuples are offered
+  if (--tile_ref_counts_[tile_id] == 0 && tile_id + 1 < input_tiles_.size()) {
+    input_tiles_[tile_id].reset();
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
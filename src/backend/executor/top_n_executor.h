@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// top_n_executor.h
+//
+// Identification: src/backend/executor/top_n_executor.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "backend/catalog/schema.h"
+#include "backend/common/types.h"
+#include "backend/executor/abstract_executor.h"
+#include "backend/executor/sort_key_encoder.h"
+
+namespace peloton {
+namespace executor {
+
+/**
+ * @warning This is a pipeline breaker and a materialization point.
+ *
+ * Returns the offset + limit first tuples of the input in sort order,
+ * skipping the offset first ones. A max-heap holds the normalized keys of
+ * the best tuples seen so far, a tuple that does not beat the top of the
+ * heap is dropped, so the input is read once in O(n log k) time with k
+ * tuples kept. Input tiles are released once no kept tuple comes from them.
+ */
+class TopNExecutor : public AbstractExecutor {
+ public:
+  TopNExecutor(const TopNExecutor &) = delete;
+  TopNExecutor &operator=(const TopNExecutor &) = delete;
+  TopNExecutor(const TopNExecutor &&) = delete;
+  TopNExecutor &operator=(const TopNExecutor &&) = delete;
+
+  explicit TopNExecutor(const planner::AbstractPlan *node,
+                        ExecutorContext *executor_context);
+
+ protected:
+  bool DInit();
+
+  bool DExecute();
+
+ private:
+  void DoTopN();
+
+  // Offers the tuples of an input tile to the heap
+  void ConsumeTile(std::unique_ptr<LogicalTile> &&tile);
+
+  // Drops a reference of a kept tuple to its tile
+  void ReleaseTuple(oid_t tile_id);
+
+  bool top_n_done_ = false;
+
+  /** A kept tuple with its normalized key. */
+  struct HeapEntry {
+    // First bytes of the key, most comparisons stop there
+    uint64_t key_prefix;
+    std::vector<char> key;
+    ItemPointer item_pointer;
+  };
+
+  /** Max-heap of the kept tuples, sorted in order once the input is read */
+  std::vector<HeapEntry> heap_;
+
+  /** Number of tuples to keep, offset + limit */
+  size_t heap_size_ = 0;
+
+  std::unique_ptr<SortKeyEncoder> key_encoder_;
+
+  /** Tiles returned by child, nullptr once released */
+  std::vector<std::unique_ptr<LogicalTile>> input_tiles_;
+
+  /** Kept tuples of each input tile */
+  std::vector<size_t> tile_ref_counts_;
+
+  /** Physical (not logical) schema of input tiles */
+  std::unique_ptr<catalog::Schema> input_schema_;
+
+  /** Key of the tuple being offered */
+  std::vector<char> key_buffer_;
+
+  /** Position in the sorted heap of the next tuple to return */
+  size_t next_entry_ = 0;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -53,6 +53,9 @@ bool UpdateExecutor::DInit() {
   assert(target_table_);
   assert(project_info_);
 
+  // The new versions must not be read back by the child
+  children_[0]->SetMaterializeScan();
+
   return true;
 }
 
@@ -123,11 +126,9 @@ bool UpdateExecutor::DExecute() {
 
       if (log_manager.IsInLoggingMode()) {
         auto logger = log_manager.GetBackendLogger();
-        auto record = logger->GetTupleRecord(
+        logger->LogTupleRecord(
             LOGRECORD_TYPE_TUPLE_UPDATE, transaction_->GetTransactionId(),
             target_table_->GetOid(), location, delete_location, new_tuple);
-
-        logger->Log(record);
       }
     }
 
@@ -0,0 +1,525 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// vectorized_predicate.cpp
+//
+// Identification: src/backend/expression/vectorized_predicate.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/expression/vectorized_predicate.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "backend/common/exception.h"
+#include "backend/common/value_peeker.h"
+#include "backend/expression/abstract_expression.h"
+#include "backend/expression/container_tuple.h"
+#include "backend/expression/tuple_value_expression.h"
+#include "backend/storage/tile.h"
+#include "backend/storage/tile_group.h"
+
+namespace peloton {
+namespace expression {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// Comparison kernels
+//===--------------------------------------------------------------------===//
+
+struct CompareEqual {
+  template <typename V>
+  static inline bool Apply(V left, V right) {
+    return left == right;
+  }
+};
+
+struct CompareNotEqual {
+  template <typename V>
+  static inline bool Apply(V left, V right) {
+    return left != right;
+  }
+};
+
+struct CompareLessThan {
+  template <typename V>
+  static inline bool Apply(V left, V right) {
+    return left < right;
+  }
+};
+
+struct CompareGreaterThan {
+  template <typename V>
+  static inline bool Apply(V left, V right) {
+    return left > right;
+  }
+};
+
+struct CompareLessThanOrEqualTo {
+  template <typename V>
+  static inline bool Apply(V left, V right) {
+    return left <= right;
+  }
+};
+
+struct CompareGreaterThanOrEqualTo {
+  template <typename V>
+  static inline bool Apply(V left, V right) {
+    return left >= right;
+  }
+};
+
+// Same NULL encodings as Value::InitFromTupleStorage
+inline bool IsNullValue(int8_t value) { return value == INT8_NULL; }
+inline bool IsNullValue(int16_t value) { return value == INT16_NULL; }
+inline bool IsNullValue(int32_t value) { return value == INT32_NULL; }
+inline bool IsNullValue(int64_t value) { return value == INT64_NULL; }
+inline bool IsNullValue(double value) { return value <= DOUBLE_NULL; }
+
+// Raw location of a column inside its tile
+struct ColumnData {
+  const char *base;
+  size_t stride;
+  ValueType value_type;
+  bool is_inlined;
+
+  template <typename T>
+  inline T Load(oid_t tuple_id) const {
+    return *reinterpret_cast<const T *>(base + tuple_id * stride);
+  }
+};
+
+ColumnData LocateColumn(storage::TileGroup *tile_group, oid_t column_id) {
+  oid_t tile_offset, tile_column_id;
+  tile_group->LocateTileAndColumn(column_id, tile_offset, tile_column_id);
+
+  auto tile = tile_group->GetTile(tile_offset);
+  auto schema = tile->GetSchema();
+
+  ColumnData column;
+  column.base = tile->GetTupleLocation(0) + schema->GetOffset(tile_column_id);
+  column.stride = schema->GetLength();
+  column.value_type = schema->GetType(tile_column_id);
+  column.is_inlined = schema->IsInlined(tile_column_id);
+  return column;
+}
+
+// The selection vector is compacted in place; the write index never passes
+// the read index, and the write itself is unconditional to avoid a branch.
+template <typename Op, typename T, typename V>
+oid_t SelectColumnConstant(const ColumnData &column, V constant,
+                           oid_t *positions, oid_t position_count) {
+  oid_t match_count = 0;
+  for (oid_t position_itr = 0; position_itr < position_count; position_itr++) {
+    oid_t tuple_id = positions[position_itr];
+    T value = column.Load<T>(tuple_id);
+    positions[match_count] = tuple_id;
+    match_count += (!IsNullValue(value) &&
+                    Op::Apply(static_cast<V>(value), constant));
+  }
+  return match_count;
+}
+
+template <typename Op, typename T>
+oid_t SelectColumnColumn(const ColumnData &left, const ColumnData &right,
+                         oid_t *positions, oid_t position_count) {
+  oid_t match_count = 0;
+  for (oid_t position_itr = 0; position_itr < position_count; position_itr++) {
+    oid_t tuple_id = positions[position_itr];
+    T left_value = left.Load<T>(tuple_id);
+    T right_value = right.Load<T>(tuple_id);
+    positions[match_count] = tuple_id;
+    match_count += (!IsNullValue(left_value) && !IsNullValue(right_value) &&
+                    Op::Apply(left_value, right_value));
+  }
+  return match_count;
+}
+
+template <typename T, typename V>
+oid_t DispatchColumnConstant(ExpressionType compare_type,
+                             const ColumnData &column, V constant,
+                             oid_t *positions, oid_t position_count) {
+  switch (compare_type) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+      return SelectColumnConstant<CompareEqual, T, V>(column, constant,
+                                                      positions,
+                                                      position_count);
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+      return SelectColumnConstant<CompareNotEqual, T, V>(column, constant,
+                                                         positions,
+                                                         position_count);
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      return SelectColumnConstant<CompareLessThan, T, V>(column, constant,
+                                                         positions,
+                                                         position_count);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      return SelectColumnConstant<CompareGreaterThan, T, V>(
+          column, constant, positions, position_count);
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      return SelectColumnConstant<CompareLessThanOrEqualTo, T, V>(
+          column, constant, positions, position_count);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return SelectColumnConstant<CompareGreaterThanOrEqualTo, T, V>(
+          column, constant, positions, position_count);
+    default:
+      throw Exception("Unsupported comparison type : " +
+                      ExpressionTypeToString(compare_type));
+  }
+}
+
+template <typename T>
+oid_t DispatchColumnColumn(ExpressionType compare_type, const ColumnData &left,
+                           const ColumnData &right, oid_t *positions,
+                           oid_t position_count) {
+  switch (compare_type) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+      return SelectColumnColumn<CompareEqual, T>(left, right, positions,
+                                                 position_count);
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+      return SelectColumnColumn<CompareNotEqual, T>(left, right, positions,
+                                                    position_count);
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      return SelectColumnColumn<CompareLessThan, T>(left, right, positions,
+                                                    position_count);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      return SelectColumnColumn<CompareGreaterThan, T>(left, right, positions,
+                                                       position_count);
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      return SelectColumnColumn<CompareLessThanOrEqualTo, T>(
+          left, right, positions, position_count);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return SelectColumnColumn<CompareGreaterThanOrEqualTo, T>(
+          left, right, positions, position_count);
+    default:
+      throw Exception("Unsupported comparison type : " +
+                      ExpressionTypeToString(compare_type));
+  }
+}
+
+// Unlike IsIntegralType(), this does not throw for the remaining types
+inline bool IsIntegerType(ValueType value_type) {
+  switch (value_type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline bool IsFixedWidthType(ValueType value_type) {
+  return IsIntegerType(value_type) || value_type == VALUE_TYPE_DOUBLE ||
+         value_type == VALUE_TYPE_TIMESTAMP;
+}
+
+inline bool IsComparisonType(ExpressionType expression_type) {
+  switch (expression_type) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Rewrite "constant op column" as "column op' constant"
+ExpressionType MirrorComparisonType(ExpressionType compare_type) {
+  switch (compare_type) {
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      return EXPRESSION_TYPE_COMPARE_GREATERTHAN;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      return EXPRESSION_TYPE_COMPARE_LESSTHAN;
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      return EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO;
+    default:
+      return compare_type;
+  }
+}
+
+// Column reference on the outer tuple, which is the only tuple a scan has
+bool GetColumnId(const AbstractExpression *expression, oid_t &column_id) {
+  if (expression->GetExpressionType() != EXPRESSION_TYPE_VALUE_TUPLE)
+    return false;
+
+  auto tuple_value_expression =
+      static_cast<const TupleValueExpression *>(expression);
+  if (tuple_value_expression->GetTupleIdx() != 0) return false;
+
+  column_id = tuple_value_expression->GetColumnId();
+  return true;
+}
+
+// Constants and parameters are fixed for the whole scan
+bool GetConstant(const AbstractExpression *expression,
+                 executor::ExecutorContext *context, Value &constant) {
+  switch (expression->GetExpressionType()) {
+    case EXPRESSION_TYPE_VALUE_CONSTANT:
+    case EXPRESSION_TYPE_VALUE_PARAMETER:
+      constant = expression->Evaluate(nullptr, nullptr, context);
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // End anonymous namespace
+
+VectorizedPredicate::VectorizedPredicate(std::unique_ptr<Node> root,
+                                         executor::ExecutorContext *context)
+    : root(std::move(root)), executor_context(context) {}
+
+VectorizedPredicate *VectorizedPredicate::Create(
+    const AbstractExpression *predicate, executor::ExecutorContext *context) {
+  if (predicate == nullptr) return nullptr;
+
+  auto root = BuildNode(predicate, context);
+
+  // Nothing to gain over evaluating the whole predicate per tuple
+  if (root->node_type == NODE_TYPE_INTERPRETED) return nullptr;
+
+  return new VectorizedPredicate(std::move(root), context);
+}
+
+std::unique_ptr<VectorizedPredicate::Node> VectorizedPredicate::BuildNode(
+    const AbstractExpression *expression, executor::ExecutorContext *context) {
+  std::unique_ptr<Node> node(new Node());
+  node->expression = expression;
+
+  auto expression_type = expression->GetExpressionType();
+  auto left = expression->GetLeft();
+  auto right = expression->GetRight();
+
+  if (expression_type == EXPRESSION_TYPE_CONJUNCTION_AND ||
+      expression_type == EXPRESSION_TYPE_CONJUNCTION_OR) {
+    node->node_type = (expression_type == EXPRESSION_TYPE_CONJUNCTION_AND)
+                          ? NODE_TYPE_CONJUNCTION_AND
+                          : NODE_TYPE_CONJUNCTION_OR;
+    node->left = BuildNode(left, context);
+    node->right = BuildNode(right, context);
+  } else if (expression_type == EXPRESSION_TYPE_VALUE_CONSTANT) {
+    auto constant = expression->Evaluate(nullptr, nullptr, context);
+    if (constant.GetValueType() == VALUE_TYPE_BOOLEAN) {
+      node->node_type = NODE_TYPE_CONSTANT;
+      node->constant = constant;
+    }
+  } else if (IsComparisonType(expression_type)) {
+    Value constant;
+
+    if (GetColumnId(left, node->left_column_id) &&
+        GetColumnId(right, node->right_column_id)) {
+      node->node_type = NODE_TYPE_COMPARE_COLUMN_COLUMN;
+      node->compare_type = expression_type;
+    } else if (GetColumnId(left, node->left_column_id) &&
+               GetConstant(right, context, constant)) {
+      node->node_type = NODE_TYPE_COMPARE_COLUMN_CONSTANT;
+      node->compare_type = expression_type;
+    } else if (GetColumnId(right, node->left_column_id) &&
+               GetConstant(left, context, constant)) {
+      node->node_type = NODE_TYPE_COMPARE_COLUMN_CONSTANT;
+      node->compare_type = MirrorComparisonType(expression_type);
+    }
+
+    // Only numeric constants have a kernel
+    if (node->node_type == NODE_TYPE_COMPARE_COLUMN_CONSTANT) {
+      auto constant_type = constant.GetValueType();
+      if (constant.IsNull() || IsFixedWidthType(constant_type)) {
+        node->constant = constant;
+      } else {
+        node->node_type = NODE_TYPE_INTERPRETED;
+      }
+    }
+  }
+
+  return node;
+}
+
+void VectorizedPredicate::Filter(storage::TileGroup *tile_group,
+                                 std::vector<oid_t> &position_list) const {
+  auto match_count = FilterNode(root.get(), tile_group, position_list.data(),
+                                position_list.size());
+  position_list.resize(match_count);
+}
+
+oid_t VectorizedPredicate::FilterNode(const Node *node,
+                                      storage::TileGroup *tile_group,
+                                      oid_t *positions,
+                                      oid_t position_count) const {
+  if (position_count == 0) return 0;
+
+  switch (node->node_type) {
+    case NODE_TYPE_CONSTANT:
+      return node->constant.IsTrue() ? position_count : 0;
+
+    case NODE_TYPE_CONJUNCTION_AND: {
+      // Right side only looks at what survived the left side
+      auto match_count =
+          FilterNode(node->left.get(), tile_group, positions, position_count);
+      return FilterNode(node->right.get(), tile_group, positions, match_count);
+    }
+
+    case NODE_TYPE_CONJUNCTION_OR: {
+      // Right side only looks at what the left side rejected
+      std::vector<oid_t> left_matches(positions, positions + position_count);
+      auto left_count = FilterNode(node->left.get(), tile_group,
+                                   left_matches.data(), position_count);
+      if (left_count == position_count) return position_count;
+
+      std::vector<oid_t> right_matches;
+      right_matches.reserve(position_count - left_count);
+      std::set_difference(positions, positions + position_count,
+                          left_matches.begin(),
+                          left_matches.begin() + left_count,
+                          std::back_inserter(right_matches));
+      auto right_count =
+          FilterNode(node->right.get(), tile_group, right_matches.data(),
+                     right_matches.size());
+
+      std::merge(left_matches.begin(), left_matches.begin() + left_count,
+                 right_matches.begin(), right_matches.begin() + right_count,
+                 positions);
+      return left_count + right_count;
+    }
+
+    case NODE_TYPE_COMPARE_COLUMN_CONSTANT: {
+      // Comparison with NULL is never true
+      if (node->constant.IsNull()) return 0;
+
+      auto column = LocateColumn(tile_group, node->left_column_id);
+      auto constant_type = node->constant.GetValueType();
+      auto compare_type = node->compare_type;
+
+      if (column.is_inlined && IsIntegerType(column.value_type) &&
+          IsIntegerType(constant_type)) {
+        auto constant = ValuePeeker::PeekAsBigInt(node->constant);
+        switch (column.value_type) {
+          case VALUE_TYPE_TINYINT:
+            return DispatchColumnConstant<int8_t>(compare_type, column,
+                                                  constant, positions,
+                                                  position_count);
+          case VALUE_TYPE_SMALLINT:
+            return DispatchColumnConstant<int16_t>(compare_type, column,
+                                                   constant, positions,
+                                                   position_count);
+          case VALUE_TYPE_INTEGER:
+            return DispatchColumnConstant<int32_t>(compare_type, column,
+                                                   constant, positions,
+                                                   position_count);
+          default:
+            return DispatchColumnConstant<int64_t>(compare_type, column,
+                                                   constant, positions,
+                                                   position_count);
+        }
+      }
+
+      if (column.is_inlined && (IsIntegerType(column.value_type) ||
+                                column.value_type == VALUE_TYPE_DOUBLE) &&
+          (IsIntegerType(constant_type) ||
+           constant_type == VALUE_TYPE_DOUBLE)) {
+        // Mixed integer and double comparisons are done as doubles
+        double constant = (constant_type == VALUE_TYPE_DOUBLE)
+                              ? ValuePeeker::PeekDouble(node->constant)
+                              : ValuePeeker::PeekAsBigInt(node->constant);
+        switch (column.value_type) {
+          case VALUE_TYPE_TINYINT:
+            return DispatchColumnConstant<int8_t>(compare_type, column,
+                                                  constant, positions,
+                                                  position_count);
+          case VALUE_TYPE_SMALLINT:
+            return DispatchColumnConstant<int16_t>(compare_type, column,
+                                                   constant, positions,
+                                                   position_count);
+          case VALUE_TYPE_INTEGER:
+            return DispatchColumnConstant<int32_t>(compare_type, column,
+                                                   constant, positions,
+                                                   position_count);
+          case VALUE_TYPE_BIGINT:
+            return DispatchColumnConstant<int64_t>(compare_type, column,
+                                                   constant, positions,
+                                                   position_count);
+          default:
+            return DispatchColumnConstant<double>(compare_type, column,
+                                                  constant, positions,
+                                                  position_count);
+        }
+      }
+
+      if (column.is_inlined && column.value_type == VALUE_TYPE_TIMESTAMP &&
+          constant_type == VALUE_TYPE_TIMESTAMP) {
+        auto constant = ValuePeeker::PeekTimestamp(node->constant);
+        return DispatchColumnConstant<int64_t>(
+            compare_type, column, constant, positions, position_count);
+      }
+
+      return FilterInterpreted(node, tile_group, positions, position_count);
+    }
+
+    case NODE_TYPE_COMPARE_COLUMN_COLUMN: {
+      auto left = LocateColumn(tile_group, node->left_column_id);
+      auto right = LocateColumn(tile_group, node->right_column_id);
+      auto compare_type = node->compare_type;
+
+      // Only columns of the same fixed-width type have a kernel
+      if (left.is_inlined && right.is_inlined &&
+          left.value_type == right.value_type) {
+        switch (left.value_type) {
+          case VALUE_TYPE_TINYINT:
+            return DispatchColumnColumn<int8_t>(compare_type, left, right,
+                                                positions, position_count);
+          case VALUE_TYPE_SMALLINT:
+            return DispatchColumnColumn<int16_t>(compare_type, left, right,
+                                                 positions, position_count);
+          case VALUE_TYPE_INTEGER:
+            return DispatchColumnColumn<int32_t>(compare_type, left, right,
+                                                 positions, position_count);
+          case VALUE_TYPE_BIGINT:
+          case VALUE_TYPE_TIMESTAMP:
+            return DispatchColumnColumn<int64_t>(compare_type, left, right,
+                                                 positions, position_count);
+          case VALUE_TYPE_DOUBLE:
+            return DispatchColumnColumn<double>(compare_type, left, right,
+                                                positions, position_count);
+          default:
+            break;
+        }
+      }
+
+      return FilterInterpreted(node, tile_group, positions, position_count);
+    }
+
+    case NODE_TYPE_INTERPRETED:
+    default:
+      return FilterInterpreted(node, tile_group, positions, position_count);
+  }
+}
+
+oid_t VectorizedPredicate::FilterInterpreted(const Node *node,
+                                             storage::TileGroup *tile_group,
+                                             oid_t *positions,
+                                             oid_t position_count) const {
+  oid_t match_count = 0;
+  for (oid_t position_itr = 0; position_itr < position_count; position_itr++) {
+    oid_t tuple_id = positions[position_itr];
+    ContainerTuple<storage::TileGroup> tuple(tile_group, tuple_id);
+    if (node->expression->Evaluate(&tuple, nullptr, executor_context)
+            .IsTrue()) {
+      positions[match_count++] = tuple_id;
+    }
+  }
+  return match_count;
+}
+
+}  // End expression namespace
+}  // End peloton namespace
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// vectorized_predicate.h
+//
+// Identification: src/backend/expression/vectorized_predicate.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "backend/common/types.h"
+#include "backend/common/value.h"
+
+namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+}
+
+namespace storage {
+class TileGroup;
+}
+
+namespace expression {
+
+class AbstractExpression;
+
+//===--------------------------------------------------------------------===//
+// Vectorized Predicate
+//===--------------------------------------------------------------------===//
+
+/**
+ * Evaluates a scan predicate over a batch of tuples in a tile group at once.
+ *
+ * Comparisons between fixed-width columns and constants (or parameters) are
+ * run directly over the raw column data in the tiles, and conjunctions are
+ * run by narrowing (AND) or merging (OR) a selection vector of tuple slots.
+ * Every other sub-expression, as well as comparisons whose column types do
+ * not have a fixed-width kernel, falls back to the expression interpreter
+ * for the tuples that are still selected.
+ *
+ * NULL and FALSE are treated alike, which is only correct because the
+ * predicate is used as a filter and NOT is never vectorized.
+ */
+class VectorizedPredicate {
+ public:
+  VectorizedPredicate(VectorizedPredicate const &) = delete;
+  VectorizedPredicate &operator=(VectorizedPredicate const &) = delete;
+
+  // Returns nullptr if no part of the predicate can be vectorized
+  static VectorizedPredicate *Create(const AbstractExpression *predicate,
+                                     executor::ExecutorContext *context);
+
+  // Keep only the tuples in the (sorted) position list that satisfy the
+  // predicate
+  void Filter(storage::TileGroup *tile_group,
+              std::vector<oid_t> &position_list) const;
+
+ private:
+  enum NodeType {
+    NODE_TYPE_INTERPRETED = 0,
+    NODE_TYPE_CONSTANT = 1,
+    NODE_TYPE_COMPARE_COLUMN_CONSTANT = 2,
+    NODE_TYPE_COMPARE_COLUMN_COLUMN = 3,
+    NODE_TYPE_CONJUNCTION_AND = 4,
+    NODE_TYPE_CONJUNCTION_OR = 5
+  };
+
+  struct Node {
+    NodeType node_type = NODE_TYPE_INTERPRETED;
+
+    // original expression, used when falling back to the interpreter
+    const AbstractExpression *expression = nullptr;
+
+    // comparison operator with the column on its left-hand side
+    ExpressionType compare_type = EXPRESSION_TYPE_INVALID;
+
+    oid_t left_column_id = INVALID_OID;
+    oid_t right_column_id = INVALID_OID;
+
+    // constant operand or constant node value
+    Value constant;
+
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> right;
+  };
+
+  VectorizedPredicate(std::unique_ptr<Node> root,
+                      executor::ExecutorContext *context);
+
+  static std::unique_ptr<Node> BuildNode(const AbstractExpression *expression,
+                                         executor::ExecutorContext *context);
+
+  // Filter positions in place, returns the number of positions kept
+  oid_t FilterNode(const Node *node, storage::TileGroup *tile_group,
+                   oid_t *positions, oid_t position_count) const;
+
+  oid_t FilterInterpreted(const Node *node, storage::TileGroup *tile_group,
+                          oid_t *positions, oid_t position_count) const;
+
+  std::unique_ptr<Node> root;
+
+  executor::ExecutorContext *executor_context;
+};
+
+}  // End expression namespace
+}  // End peloton namespace
@@ -12,9 +12,12 @@
 
 #include "backend/index/btree_index.h"
 #include "backend/index/index_key.h"
+#include "backend/common/exception.h"
 #include "backend/common/logger.h"
 #include "backend/storage/tuple.h"
 
+#include <limits>
+
 namespace peloton {
 namespace index {
 
@@ -92,84 +95,177 @@ BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
     const std::vector<ExpressionType> &expr_types,
     const ScanDirectionType& scan_direction) {
   std::vector<ItemPointer> result;
-  KeyType index_key;
 
-  {
-    index_lock.ReadLock();
+  // A single unbounded batch scans the whole range under one lock
+  BTreeIndexCursor cursor(this, values, key_column_ids, expr_types,
+                          scan_direction);
+  cursor.NextBatch(result, std::numeric_limits<size_t>::max());
 
-    // Check if we have leading (leftmost) column equality
-    // refer : http://www.postgresql.org/docs/8.2/static/indexes-multicolumn.html
-    oid_t leading_column_id = 0;
-    auto key_column_ids_itr = std::find(
-        key_column_ids.begin(), key_column_ids.end(), leading_column_id);
-
-    // SPECIAL CASE : leading column id is one of the key column ids
-    // and is involved in a equality constraint
-    bool special_case = false;
-    if (key_column_ids_itr != key_column_ids.end()) {
-      auto offset = std::distance(key_column_ids.begin(), key_column_ids_itr);
-      if (expr_types[offset] == EXPRESSION_TYPE_COMPARE_EQUAL) {
-        special_case = true;
-      }
-    }
+  return result;
+}
 
-    LOG_TRACE("Special case : %d ", special_case);
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+IndexCursor *
+BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::GetCursor(
+    const std::vector<Value> &values,
+    const std::vector<oid_t> &key_column_ids,
+    const std::vector<ExpressionType> &expr_types,
+    const ScanDirectionType &scan_direction) {
+  return new BTreeIndexCursor(this, values, key_column_ids, expr_types,
+                              scan_direction);
+}
 
-    auto scan_begin_itr = container.begin();
-    std::unique_ptr<storage::Tuple> start_key;
-    bool all_constraints_are_equal = false;
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+BTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::
+    BTreeIndexCursor::BTreeIndexCursor(
+        BTreeIndex *index, const std::vector<Value> &values,
+        const std::vector<oid_t> &key_column_ids,
+        const std::vector<ExpressionType> &expr_types,
+        const ScanDirectionType &scan_direction)
+    : index_(index),
+      values_(values),
+      key_column_ids_(key_column_ids),
+      expr_types_(expr_types),
+      scan_direction_(scan_direction) {
+  if (scan_direction_ != SCAN_DIRECTION_TYPE_FORWARD &&
+      scan_direction_ != SCAN_DIRECTION_TYPE_BACKWARD) {
+    throw Exception("Invalid scan direction \n");
+  }
 
-    // If it is a special case, we can figure out the range to scan in the index
-    if (special_case == true) {
+  // Only the keys between the bounds on the leading columns are visited
+  // refer : http://www.postgresql.org/docs/8.2/static/indexes-multicolumn.html
+  index_->ConstructScanBounds(values_, key_column_ids_, expr_types_,
+                              lower_bound_, upper_bound_);
+
+  LOG_TRACE("Lower bound : %lu columns, upper bound : %lu columns",
+            lower_bound_.size(), upper_bound_.size());
+
+  // A backward scan without a largest key at its upper bound starts from
+  // the end and skips the keys past the bound
+  auto &start_bound =
+      (scan_direction_ == SCAN_DIRECTION_TYPE_FORWARD) ? lower_bound_
+                                                       : upper_bound_;
+  if (start_bound.empty() == false) {
+    std::unique_ptr<storage::Tuple> bound_key(
+        new storage::Tuple(index_->metadata->GetKeySchema(), true));
+    has_start_key_ = index_->ConstructBoundTuple(
+        bound_key.get(), start_bound,
+        scan_direction_ == SCAN_DIRECTION_TYPE_BACKWARD);
+    if (has_start_key_) start_key_.SetFromKey(bound_key.get());
+  }
+}
 
-      start_key.reset(new storage::Tuple(metadata->GetKeySchema(), true));
-      index_key.SetFromKey(start_key.get());
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+typename BTreeIndex<KeyType, ValueType, KeyComparator,
+                    KeyEqualityChecker>::BTreeIndexCursor::MapIterator
+BTreeIndex<KeyType, ValueType, KeyComparator,
+           KeyEqualityChecker>::BTreeIndexCursor::Seek() {
+  auto &container = index_->container;
+
+  // Entries with the last key may have been added or removed since, and
+  // duplicates are not kept in any particular order : the whole run of the
+  // last key is visited again, skipping the locations already visited
+  if (scan_direction_ == SCAN_DIRECTION_TYPE_FORWARD) {
+    if (started_ == false) {
+      return has_start_key_ ? container.lower_bound(start_key_)
+                            : container.begin();
+    }
+    return container.lower_bound(last_key_);
+  }
 
-      // Construct the lower bound key tuple
-      all_constraints_are_equal =
-          ConstructLowerBoundTuple(start_key.get(), values, key_column_ids, expr_types);
-      LOG_TRACE("All constraints are equal : %d ", all_constraints_are_equal);
+  if (started_ == false) {
+    return has_start_key_ ? container.upper_bound(start_key_)
+                          : container.end();
+  }
+  return container.upper_bound(last_key_);
+}
 
-      // Set scan begin iterator
-      scan_begin_itr = container.equal_range(index_key).first;
-    }
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+bool BTreeIndex<KeyType, ValueType, KeyComparator,
+                KeyEqualityChecker>::BTreeIndexCursor::Visit(
+    const KeyType &key, const ItemPointer &location) {
+  auto visited_location = std::make_pair(location.block, location.offset);
 
-    switch(scan_direction){
-      case SCAN_DIRECTION_TYPE_FORWARD:
-      case SCAN_DIRECTION_TYPE_BACKWARD: {
-
-        // Scan the index entries in forward direction
-        for (auto scan_itr = scan_begin_itr; scan_itr != container.end(); scan_itr++) {
-          auto scan_current_key = scan_itr->first;
-          auto tuple = scan_current_key.GetTupleForComparison(metadata->GetKeySchema());
-
-          // Compare the current key in the scan with "values" based on "expression types"
-          // For instance, "5" EXPR_GREATER_THAN "2" is true
-          if (Compare(tuple, key_column_ids, expr_types, values) == true) {
-            ItemPointer location = scan_itr->second;
-            result.push_back(location);
-          }
-          else {
-            // We can stop scanning if we know that all constraints are equal
-            if(all_constraints_are_equal == true) {
-              break;
-            }
-          }
-        }
+  if (started_ && index_->equals(key, last_key_)) {
+    return last_key_locations_.insert(visited_location).second;
+  }
+
+  last_key_ = key;
+  last_key_locations_.clear();
+  last_key_locations_.insert(visited_location);
+  started_ = true;
+  return true;
+}
 
+template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
+size_t BTreeIndex<KeyType, ValueType, KeyComparator,
+                  KeyEqualityChecker>::BTreeIndexCursor::NextBatch(
+    std::vector<ItemPointer> &locations, size_t max_count) {
+  size_t count = 0;
+  if (done_ || max_count == 0) return 0;
+
+  auto key_schema = index_->metadata->GetKeySchema();
+  auto &container = index_->container;
+
+  index_->index_lock.ReadLock();
+
+  auto scan_itr = Seek();
+  if (scan_direction_ == SCAN_DIRECTION_TYPE_FORWARD) {
+    for (; count < max_count; scan_itr++) {
+      if (scan_itr == container.end()) {
+        done_ = true;
+        break;
       }
-      break;
 
-      case SCAN_DIRECTION_TYPE_INVALID:
-      default:
-        throw Exception("Invalid scan direction \n");
+      auto tuple = scan_itr->first.GetTupleForComparison(key_schema);
+
+      // Stop past the upper bound
+      if (CompareWithBound(tuple, upper_bound_) > 0) {
+        done_ = true;
         break;
+      }
+
+      if (Visit(scan_itr->first, scan_itr->second) == false) continue;
+
+      // Compare the current key in the scan with "values" based on "expression types"
+      // For instance, "5" EXPR_GREATER_THAN "2" is true
+      if (Compare(tuple, key_column_ids_, expr_types_, values_) == true) {
+        locations.push_back(scan_itr->second);
+        count++;
+      }
     }
+  } else {
+    while (count < max_count) {
+      if (scan_itr == container.begin()) {
+        done_ = true;
+        break;
+      }
 
-    index_lock.Unlock();
+      scan_itr--;
+      auto tuple = scan_itr->first.GetTupleForComparison(key_schema);
+
+      // Stop below the lower bound
+      if (CompareWithBound(tuple, lower_bound_) < 0) {
+        done_ = true;
+        break;
+      }
+
+      if (Visit(scan_itr->first, scan_itr->second) == false) continue;
+
+      if (CompareWithBound(tuple, upper_bound_) > 0) {
+        continue;
+      }
+
+      if (Compare(tuple, key_column_ids_, expr_types_, values_) == true) {
+        locations.push_back(scan_itr->second);
+        count++;
+      }
+    }
   }
 
-  return result;
+  index_->index_lock.Unlock();
+
+  return count;
 }
 
 template <typename KeyType, typename ValueType, class KeyComparator, class KeyEqualityChecker>
@@ -13,7 +13,9 @@
 #pragma once
 
 #include <vector>
+#include <set>
 #include <string>
+#include <utility>
 
 #include "backend/catalog/manager.h"
 #include "backend/common/allocator.h"
@@ -56,6 +58,11 @@ class BTreeIndex : public Index {
 
   std::vector<ItemPointer> ScanKey(const storage::Tuple *key);
 
+  IndexCursor *GetCursor(const std::vector<Value> &values,
+                         const std::vector<oid_t> &key_column_ids,
+                         const std::vector<ExpressionType> &expr_types,
+                         const ScanDirectionType &scan_direction);
+
   std::string GetTypeName() const;
 
   bool Cleanup() {
@@ -67,6 +74,56 @@ class BTreeIndex : public Index {
   }
 
  protected:
+  /**
+   * Cursor taking the index lock for each batch only, so that the consumer
+   * can update the index between batches. Each batch seeks again to the
+   * last key visited, skipping the locations with that key already visited.
+   */
+  class BTreeIndexCursor : public IndexCursor {
+   public:
+    BTreeIndexCursor(BTreeIndex *index, const std::vector<Value> &values,
+                     const std::vector<oid_t> &key_column_ids,
+                     const std::vector<ExpressionType> &expr_types,
+                     const ScanDirectionType &scan_direction);
+
+    size_t NextBatch(std::vector<ItemPointer> &locations, size_t max_count);
+
+   private:
+    typedef typename MapType::iterator MapIterator;
+
+    // Position of the next entry for a forward scan, or past it for a
+    // backward one
+    MapIterator Seek();
+
+    // Records an entry as visited, false if it already was
+    bool Visit(const KeyType &key, const ItemPointer &location);
+
+    BTreeIndex *index_;
+
+    const std::vector<Value> values_;
+
+    const std::vector<oid_t> key_column_ids_;
+
+    const std::vector<ExpressionType> expr_types_;
+
+    const ScanDirectionType scan_direction_;
+
+    std::vector<Value> lower_bound_;
+
+    std::vector<Value> upper_bound_;
+
+    // Key at the bound the scan starts from, if any
+    bool has_start_key_ = false;
+    KeyType start_key_;
+
+    // Last key visited, and the locations visited with it
+    bool started_ = false;
+    KeyType last_key_;
+    std::set<std::pair<oid_t, oid_t>> last_key_locations_;
+
+    bool done_ = false;
+  };
+
   MapType container;
 
   // equality checker and comparator
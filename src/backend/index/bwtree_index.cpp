@@ -74,66 +74,31 @@ BWTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::Scan(
   dbg_msg("BWTreeIndex::Scan being called");
   std::vector<ItemPointer> result;
 
-  // Check if we have leading (leftmost) column equality
-  // refer : http://www.postgresql.org/docs/8.2/static/indexes-multicolumn.html
-  oid_t leading_column_id = 0;
-  auto key_column_ids_itr = std::find(key_column_ids.begin(),
-                                      key_column_ids.end(), leading_column_id);
-
-  // SPECIAL CASE : leading column id is one of the key column ids
-  // and is involved in a equality constraint
-  bool special_case = false;
-  if (key_column_ids_itr != key_column_ids.end()) {
-    auto offset = std::distance(key_column_ids.begin(), key_column_ids_itr);
-    if (expr_types[offset] == EXPRESSION_TYPE_COMPARE_EQUAL) {
-      special_case = true;
-    }
-  }
-
-  LOG_TRACE("Special case : %d ", special_case);
-
-  if (special_case) {
-    // If it is a special case, we can figure out the range to scan in the index
-    std::unique_ptr<storage::Tuple> start_key;
-    start_key.reset(new storage::Tuple(metadata->GetKeySchema(), true));
-    ConstructLowerBoundTuple(start_key.get(), values, key_column_ids,
-                             expr_types);
-    KeyType index_key;
-    index_key.SetFromKey(start_key.get());
-    if (HasUniqueKeys()) {
-      auto iterator = container_unique.GetIterator(index_key);
-      iterator->Register();
-      ExtractAllTuples(values, key_column_ids, expr_types, iterator, result);
-      iterator->Deregister();
-      delete iterator;
-    } else {
-      auto iterator = container_duplicate.GetIterator(index_key);
-      iterator->Register();
-      ExtractAllTuples(values, key_column_ids, expr_types, iterator, result);
-      iterator->Deregister();
-      delete iterator;
-    }
-  } else {
-    if (HasUniqueKeys()) {
-      auto iterator = container_unique.GetIterator();
-      iterator->Register();
-      ExtractAllTuples(values, key_column_ids, expr_types, iterator, result);
-      iterator->Deregister();
-      delete iterator;
-    } else {
-      auto iterator = container_duplicate.GetIterator();
-      iterator->Register();
-      ExtractAllTuples(values, key_column_ids, expr_types, iterator, result);
-      iterator->Deregister();
-      delete iterator;
-    }
-  }
-
-  if (scan_direction == SCAN_DIRECTION_TYPE_BACKWARD)
-    std::reverse(result.begin(), result.end());
+  // A single unbounded batch scans the whole range
+  std::unique_ptr<IndexCursor> cursor(
+      GetCursor(values, key_column_ids, expr_types, scan_direction));
+  cursor->NextBatch(result, std::numeric_limits<size_t>::max());
+
   return result;
 }
 
+template <typename KeyType, typename ValueType, class KeyComparator,
+          class KeyEqualityChecker>
+IndexCursor *
+BWTreeIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker>::GetCursor(
+    const std::vector<Value> &values, const std::vector<oid_t> &key_column_ids,
+    const std::vector<ExpressionType> &expr_types,
+    const ScanDirectionType &scan_direction) {
+  if (HasUniqueKeys())
+    return new BWTreeIndexCursor<MapTypeUnique>(
+        this, container_unique, values, key_column_ids, expr_types,
+        scan_direction);
+  else
+    return new BWTreeIndexCursor<MapTypeDuplicate>(
+        this, container_duplicate, values, key_column_ids, expr_types,
+        scan_direction);
+}
+
 template <typename KeyType, typename ValueType, class KeyComparator,
           class KeyEqualityChecker>
 std::vector<ItemPointer> BWTreeIndex<KeyType, ValueType, KeyComparator,
@@ -14,13 +14,17 @@
 
 #include <vector>
 #include <string>
+#include <limits>
 #include <map>
+#include <memory>
 
 #include "backend/catalog/manager.h"
+#include "backend/common/exception.h"
 #include "backend/common/platform.h"
 #include "backend/common/types.h"
 #include "backend/index/index.h"
 #include "backend/index/bwtree.h"
+#include "backend/storage/tuple.h"
 
 namespace peloton {
 namespace index {
@@ -62,21 +66,10 @@ class BWTreeIndex : public Index {
 
   std::string GetTypeName() const;
 
-  template <class ScanIterator>
-  void ExtractAllTuples(const std::vector<Value> &values,
-                        const std::vector<oid_t> &key_column_ids,
-                        const std::vector<ExpressionType> &expr_types,
-                        ScanIterator *iterator,
-                        std::vector<ItemPointer> &result) {
-    while (iterator->HasNext()) {
-      auto pair = iterator->Next();
-      auto current_key = pair.first;
-      auto tuple = current_key.GetTupleForComparison(metadata->GetKeySchema());
-      if (Compare(tuple, key_column_ids, expr_types, values)) {
-        result.push_back(pair.second);
-      }
-    }
-  }
+  IndexCursor *GetCursor(const std::vector<Value> &values,
+                         const std::vector<oid_t> &key_column_ids,
+                         const std::vector<ExpressionType> &expr_types,
+                         const ScanDirectionType &scan_direction);
 
   bool Cleanup() {
     dbg_msg("BWTreeIndex::Cleanup being called");
@@ -93,6 +86,121 @@ class BWTreeIndex : public Index {
   }
 
  protected:
+  /**
+   * Cursor over a BW tree iterator, which holds an epoch of the garbage
+   * collector until the cursor is destroyed. The tree can only be walked
+   * forward, so a backward scan reads its whole range on the first batch
+   * and returns it last location first.
+   */
+  template <class MapType>
+  class BWTreeIndexCursor : public IndexCursor {
+   public:
+    BWTreeIndexCursor(BWTreeIndex *index, MapType &container,
+                      const std::vector<Value> &values,
+                      const std::vector<oid_t> &key_column_ids,
+                      const std::vector<ExpressionType> &expr_types,
+                      const ScanDirectionType &scan_direction)
+        : index_(index),
+          values_(values),
+          key_column_ids_(key_column_ids),
+          expr_types_(expr_types),
+          scan_direction_(scan_direction) {
+      if (scan_direction_ != SCAN_DIRECTION_TYPE_FORWARD &&
+          scan_direction_ != SCAN_DIRECTION_TYPE_BACKWARD) {
+        throw Exception("Invalid scan direction \n");
+      }
+
+      // Only the keys between the bounds on the leading columns are visited
+      // refer :
+      // http://www.postgresql.org/docs/8.2/static/indexes-multicolumn.html
+      index_->ConstructScanBounds(values_, key_column_ids_, expr_types_,
+                                  lower_bound_, upper_bound_);
+
+      if (lower_bound_.empty()) {
+        iterator_.reset(container.GetIterator());
+      } else {
+        std::unique_ptr<storage::Tuple> start_key(
+            new storage::Tuple(index_->metadata->GetKeySchema(), true));
+        index_->ConstructBoundTuple(start_key.get(), lower_bound_, false);
+        KeyType index_key;
+        index_key.SetFromKey(start_key.get());
+        iterator_.reset(container.GetIterator(index_key));
+      }
+
+      if (scan_direction_ == SCAN_DIRECTION_TYPE_BACKWARD) {
+        ExtractTuples(backward_locations_,
+                      std::numeric_limits<size_t>::max());
+      }
+    }
+
+    size_t NextBatch(std::vector<ItemPointer> &locations, size_t max_count) {
+      if (scan_direction_ == SCAN_DIRECTION_TYPE_FORWARD) {
+        return ExtractTuples(locations, max_count);
+      }
+
+      size_t count = 0;
+      while (count < max_count && backward_locations_.empty() == false) {
+        locations.push_back(backward_locations_.back());
+        backward_locations_.pop_back();
+        count++;
+      }
+      return count;
+    }
+
+   private:
+    // Appends at most max_count matching locations from the iterator,
+    // releasing it once past the upper bound
+    size_t ExtractTuples(std::vector<ItemPointer> &locations,
+                         size_t max_count) {
+      size_t count = 0;
+      if (iterator_.get() == nullptr) return 0;
+
+      while (count < max_count) {
+        if (iterator_->HasNext() == false) {
+          iterator_.reset();
+          break;
+        }
+
+        auto pair = iterator_->Next();
+        auto current_key = pair.first;
+        auto tuple = current_key.GetTupleForComparison(
+            index_->metadata->GetKeySchema());
+
+        // Stop past the upper bound
+        if (CompareWithBound(tuple, upper_bound_) > 0) {
+          iterator_.reset();
+          break;
+        }
+
+        if (Compare(tuple, key_column_ids_, expr_types_, values_)) {
+          locations.push_back(pair.second);
+          count++;
+        }
+      }
+      return count;
+    }
+
+    BWTreeIndex *index_;
+
+    const std::vector<Value> values_;
+
+    const std::vector<oid_t> key_column_ids_;
+
+    const std::vector<ExpressionType> expr_types_;
+
+    const ScanDirectionType scan_direction_;
+
+    std::vector<Value> lower_bound_;
+
+    std::vector<Value> upper_bound_;
+
+    // nullptr once the scan is past its range
+    std::unique_ptr<typename MapType::ScanIterator> iterator_;
+
+    // Range of a backward scan, in forward order
+    std::vector<ItemPointer> backward_locations_;
+  };
+
   // container
   // since the duplicate is given at run time, there is no way to know it at
   // compile time
@@ -14,11 +14,13 @@
 #include "backend/common/exception.h"
 #include "backend/common/logger.h"
 #include "backend/common/pool.h"
+#include "backend/common/value_factory.h"
 #include "backend/catalog/schema.h"
 #include "backend/catalog/manager.h"
 #include "backend/storage/tuple.h"
 
 #include <iostream>
+#include <limits>
 
 namespace peloton {
 namespace index {
@@ -41,6 +43,14 @@ oid_t IndexMetadata::GetColumnCount() const {
   return GetKeySchema()->GetColumnCount();
 }
 
+bool IndexCursor::Next(ItemPointer &location) {
+  next_location_.clear();
+  if (NextBatch(next_location_, 1) == 0) return false;
+
+  location = next_location_[0];
+  return true;
+}
+
 bool Index::Compare(const AbstractTuple &index_key,
                     const std::vector<oid_t> &key_column_ids,
                     const std::vector<ExpressionType> &expr_types,
@@ -131,55 +141,131 @@ bool Index::Compare(const AbstractTuple &index_key,
   return true;
 }
 
-bool Index::ConstructLowerBoundTuple(storage::Tuple *index_key,
-                               const std::vector<peloton::Value> &values,
-                               const std::vector<oid_t> &key_column_ids,
-                               const std::vector<ExpressionType> &expr_types) {
-  auto schema = index_key->GetSchema();
-  auto col_count = schema->GetColumnCount();
-  bool all_constraints_equal = true;
+void Index::ConstructScanBounds(const std::vector<Value> &values,
+                                const std::vector<oid_t> &key_column_ids,
+                                const std::vector<ExpressionType> &expr_types,
+                                std::vector<Value> &lower_bound,
+                                std::vector<Value> &upper_bound) const {
+  auto col_count = GetKeySchema()->GetColumnCount();
 
-  // Go over each column in the key tuple
-  // Setting either the placeholder or the min value
+  // Only leading columns bound the scan : a column after a column without
+  // an equality constraint does not
   for (oid_t column_itr = 0; column_itr < col_count; column_itr++) {
-    auto key_column_itr =
-        std::find(key_column_ids.begin(), key_column_ids.end(), column_itr);
-    bool placeholder = false;
-    Value value;
-
-    // This column is part of the key column ids
-    if (key_column_itr != key_column_ids.end()) {
-      auto offset = std::distance(key_column_ids.begin(), key_column_itr);
-      // Equality constraint
-      if (expr_types[offset] == EXPRESSION_TYPE_COMPARE_EQUAL) {
-        placeholder = true;
-        value = values[offset];
-      }
-      // Not all expressions / constraints are equal
-      else {
-        all_constraints_equal = false;
+    bool has_equal = false, has_lower = false, has_upper = false;
+    Value equal_value, lower_value, upper_value;
+
+    for (oid_t key_itr = 0; key_itr < key_column_ids.size(); key_itr++) {
+      if (key_column_ids[key_itr] != column_itr) continue;
+
+      const Value &value = values[key_itr];
+      switch (expr_types[key_itr]) {
+        case EXPRESSION_TYPE_COMPARE_EQUAL:
+          has_equal = true;
+          equal_value = value;
+          break;
+
+        // Strict inequalities bound the scan too, the keys at the bound
+        // are filtered out by Compare
+        case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+        case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+          if (!has_lower || value.Compare(lower_value) > 0) {
+            has_lower = true;
+            lower_value = value;
+          }
+          break;
+
+        case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+        case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+          if (!has_upper || value.Compare(upper_value) < 0) {
+            has_upper = true;
+            upper_value = value;
+          }
+          break;
+
+        default:
+          break;
       }
     }
 
-    LOG_TRACE("Column itr : %lu  Placeholder : %d ", column_itr, placeholder);
-
-    // Fill in the placeholder
-    if (placeholder == true) {
-      index_key->SetValue(column_itr, value, GetPool());
+    if (has_equal) {
+      lower_bound.push_back(equal_value);
+      upper_bound.push_back(equal_value);
+      continue;
     }
-    // Fill in the min value
-    else {
-      auto value_type = schema->GetType(column_itr);
-      index_key->SetValue(column_itr, Value::GetMinValue(value_type),
+
+    if (has_lower) lower_bound.push_back(lower_value);
+    if (has_upper) upper_bound.push_back(upper_value);
+    break;
+  }
+}
+
+/**
+ * @brief Largest value of a type, if it has one.
+ */
+static bool GetMaxValue(ValueType type, Value &value) {
+  switch (type) {
+    case VALUE_TYPE_TINYINT:
+      value = ValueFactory::GetTinyIntValue(INT8_MAX);
+      return true;
+    case VALUE_TYPE_SMALLINT:
+      value = ValueFactory::GetSmallIntValue(INT16_MAX);
+      return true;
+    case VALUE_TYPE_INTEGER:
+      value = ValueFactory::GetIntegerValue(INT32_MAX);
+      return true;
+    case VALUE_TYPE_BIGINT:
+      value = ValueFactory::GetBigIntValue(INT64_MAX);
+      return true;
+    case VALUE_TYPE_TIMESTAMP:
+      value = ValueFactory::GetTimestampValue(INT64_MAX);
+      return true;
+    case VALUE_TYPE_DOUBLE:
+      // Infinite keys sort last too
+      value = ValueFactory::GetDoubleValue(
+          std::numeric_limits<double>::infinity());
+      return true;
+    case VALUE_TYPE_BOOLEAN:
+      value = ValueFactory::GetBooleanValue(true);
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool Index::ConstructBoundTuple(storage::Tuple *index_key,
+                                const std::vector<Value> &bound,
+                                bool upper_bound) {
+  auto schema = index_key->GetSchema();
+  auto col_count = schema->GetColumnCount();
+
+  for (oid_t column_itr = 0; column_itr < col_count; column_itr++) {
+    auto value_type = schema->GetType(column_itr);
+
+    if (column_itr < bound.size()) {
+      index_key->SetValue(column_itr, bound[column_itr], GetPool());
+    } else if (upper_bound == false) {
+      // Nulls come first in the index
+      index_key->SetValue(column_itr,
+                          ValueFactory::GetNullValueByType(value_type),
                           GetPool());
+    } else {
+      Value max_value;
+      if (GetMaxValue(value_type, max_value) == false) return false;
+      index_key->SetValue(column_itr, max_value, GetPool());
     }
-
   }
 
-  LOG_TRACE("Lower Bound Tuple :: %s", index_key->GetInfo().c_str());
-  if (col_count > values.size()) all_constraints_equal = false;
+  LOG_TRACE("Bound Tuple :: %s", index_key->GetInfo().c_str());
+  return true;
+}
 
-  return all_constraints_equal;
+int Index::CompareWithBound(const AbstractTuple &index_key,
+                            const std::vector<Value> &bound) {
+  for (oid_t column_itr = 0; column_itr < bound.size(); column_itr++) {
+    int diff = index_key.GetValue(column_itr).Compare(bound[column_itr]);
+    if (diff != VALUE_COMPARE_EQUAL) return diff;
+  }
+  return VALUE_COMPARE_EQUAL;
 }
 
 Index::Index(IndexMetadata *metadata) : metadata(metadata) {
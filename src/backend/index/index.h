@@ -90,6 +90,33 @@ class IndexMetadata {
   bool unique_keys;
 };
 
+//===--------------------------------------------------------------------===//
+// IndexCursor
+//===--------------------------------------------------------------------===//
+
+/**
+ * Pull-based scan of an index, returning the locations of the matching
+ * entries in scan order a batch at a time, so that a consumer which stops
+ * early does not pay for the rest of the range. The cursor seeks to the
+ * start of the range when Index::GetCursor creates it, and must not outlive
+ * its index.
+ */
+class IndexCursor {
+ public:
+  virtual ~IndexCursor() {}
+
+  // Appends at most max_count next locations, returns how many were
+  // appended, zero once the scan is over
+  virtual size_t NextBatch(std::vector<ItemPointer> &locations,
+                           size_t max_count) = 0;
+
+  // Sets the next location, returns false once the scan is over
+  bool Next(ItemPointer &location);
+
+ private:
+  std::vector<ItemPointer> next_location_;
+};
+
 //===--------------------------------------------------------------------===//
 // Index
 //===--------------------------------------------------------------------===//
@@ -138,6 +165,14 @@ class Index {
 
   virtual std::vector<ItemPointer> ScanKey(const storage::Tuple *key) = 0;
 
+  // cursor over the keys Scan would return, in the same order, without
+  // materializing them. No key column scans all keys. Owned by the caller.
+  virtual IndexCursor *GetCursor(
+      const std::vector<Value> &values,
+      const std::vector<oid_t> &key_column_ids,
+      const std::vector<ExpressionType> &exprs,
+      const ScanDirectionType &scan_direction) = 0;
+
   //===--------------------------------------------------------------------===//
   // STATS
   //===--------------------------------------------------------------------===//
@@ -201,11 +236,24 @@ class Index {
  protected:
   Index(IndexMetadata *schema);
 
-  // Set the lower bound tuple for index iteration
-  bool ConstructLowerBoundTuple(storage::Tuple *index_key,
-                          const std::vector<Value> &values,
-                          const std::vector<oid_t> &key_column_ids,
-                          const std::vector<ExpressionType> &expr_types);
+  // Values of the leading key columns at the bounds of the keys a scan has
+  // to visit, all but the last value of a bound come from equalities.
+  // An empty bound does not limit the scan.
+  void ConstructScanBounds(const std::vector<Value> &values,
+                           const std::vector<oid_t> &key_column_ids,
+                           const std::vector<ExpressionType> &expr_types,
+                           std::vector<Value> &lower_bound,
+                           std::vector<Value> &upper_bound) const;
+
+  // Set the key tuple to the bound followed by the smallest values (nulls),
+  // or the largest values for an upper bound. Returns false if a column
+  // has no largest value.
+  bool ConstructBoundTuple(storage::Tuple *index_key,
+                           const std::vector<Value> &bound, bool upper_bound);
+
+  // Compares the leading columns of an index key with a bound
+  static int CompareWithBound(const AbstractTuple &index_key,
+                              const std::vector<Value> &bound);
 
   //===--------------------------------------------------------------------===//
   //  Data members
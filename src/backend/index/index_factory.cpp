@@ -13,6 +13,7 @@
 #include <cassert>
 #include <iostream>
 
+#include "backend/catalog/schema.h"
 #include "backend/common/types.h"
 #include "backend/common/logger.h"
 #include "backend/index/index_factory.h"
@@ -25,7 +26,22 @@ namespace peloton {
 namespace index {
 
 Index *IndexFactory::GetInstance(IndexMetadata *metadata) {
-  bool ints_only = false;
+  // Keys made only of integers are packed into integers with the same
+  // order, compared without decoding values
+  bool ints_only = true;
+  auto key_column_count = metadata->key_schema->GetColumnCount();
+  for (oid_t column_itr = 0; column_itr < key_column_count; column_itr++) {
+    switch (metadata->key_schema->GetType(column_itr)) {
+      case VALUE_TYPE_TINYINT:
+      case VALUE_TYPE_SMALLINT:
+      case VALUE_TYPE_INTEGER:
+      case VALUE_TYPE_BIGINT:
+        break;
+      default:
+        ints_only = false;
+        break;
+    }
+  }
 
   LOG_TRACE("Creating index %s", metadata->GetName().c_str());
   const auto key_size = metadata->key_schema->GetLength();
@@ -16,6 +16,7 @@
 #include <iostream>
 #include <sstream>
 
+#include "backend/common/value_factory.h"
 #include "backend/common/value_peeker.h"
 #include "backend/common/logger.h"
 #include "backend/storage/tuple.h"
@@ -164,9 +165,65 @@ class IntsKey {
     return retval;
   }
 
+  /*
+   * Decodes the key into a tuple of the key schema. The tuple lives in a
+   * per-thread buffer, and is only valid until the next call on the thread.
+   */
   const storage::Tuple GetTupleForComparison(
-      __attribute__((unused)) const catalog::Schema *key_schema) {
-    throw IndexException("Tuple conversion not supported");
+      const catalog::Schema *key_schema) const {
+    static thread_local char tuple_data[KeySize * sizeof(uint64_t)];
+    assert(key_schema->GetLength() <= sizeof(tuple_data));
+
+    storage::Tuple tuple(key_schema, tuple_data);
+    int key_offset = 0;
+    int intra_key_offset = sizeof(uint64_t) - 1;
+    const int GetColumnCount = key_schema->GetColumnCount();
+    for (int ii = 0; ii < GetColumnCount; ii++) {
+      switch (key_schema->GetColumn(ii).column_type) {
+        case VALUE_TYPE_BIGINT: {
+          const uint64_t key_value =
+              ExtractKeyValue<uint64_t>(key_offset, intra_key_offset);
+          tuple.SetValue(ii, ValueFactory::GetBigIntValue(
+                                 ConvertUnsignedValueToSignedValue<
+                                     int64_t, INT64_MAX>(key_value)),
+                         nullptr);
+          break;
+        }
+        case VALUE_TYPE_INTEGER: {
+          const uint64_t key_value =
+              ExtractKeyValue<uint32_t>(key_offset, intra_key_offset);
+          tuple.SetValue(ii, ValueFactory::GetIntegerValue(
+                                 ConvertUnsignedValueToSignedValue<
+                                     int32_t, INT32_MAX>(key_value)),
+                         nullptr);
+          break;
+        }
+        case VALUE_TYPE_SMALLINT: {
+          const uint64_t key_value =
+              ExtractKeyValue<uint16_t>(key_offset, intra_key_offset);
+          tuple.SetValue(ii, ValueFactory::GetSmallIntValue(
+                                 ConvertUnsignedValueToSignedValue<
+                                     int16_t, INT16_MAX>(key_value)),
+                         nullptr);
+          break;
+        }
+        case VALUE_TYPE_TINYINT: {
+          const uint64_t key_value =
+              ExtractKeyValue<uint8_t>(key_offset, intra_key_offset);
+          tuple.SetValue(ii, ValueFactory::GetTinyIntValue(
+                                 ConvertUnsignedValueToSignedValue<
+                                     int8_t, INT8_MAX>(key_value)),
+                         nullptr);
+          break;
+        }
+        default:
+          throw IndexException(
+              "We currently only support a specific set of "
+              "column index sizes...");
+          break;
+      }
+    }
+    return tuple;
   }
 
   std::string Debug(const catalog::Schema *key_schema) const {
@@ -38,34 +38,46 @@ BackendLogger *BackendLogger::GetBackendLogger(LoggingType logging_type) {
 }
 
 /**
- * @brief set the wait flush to false
+ * @brief Log a tuple record
+ * Backend loggers which can serialize the record directly override this.
+ */
+void BackendLogger::LogTupleRecord(LogRecordType log_record_type,
+                                   txn_id_t txn_id, oid_t table_oid,
+                                   ItemPointer insert_location,
+                                   ItemPointer delete_location, void *data,
+                                   oid_t db_oid) {
+  auto record = GetTupleRecord(log_record_type, txn_id, table_oid,
+                               insert_location, delete_location, data, db_oid);
+  Log(record);
+}
+
+/**
+ * @brief the log records collected so far are flushed,
+ * wake up the backend if it waits for them
  */
 void BackendLogger::Commit(void) {
   std::lock_guard<std::mutex> lock(flush_notify_mutex);
-  // Only need to commit if they are waiting for us to flush
-  if (wait_for_flushing) {
-    wait_for_flushing = false;
+  // Only need to notify if new log records are flushed
+  if (persistent_lsn != collected_lsn) {
+    persistent_lsn = collected_lsn;
     flush_notify_cv.notify_all();
   }
 }
 
 /**
- * @brief set the wait flush to true and truncate local_queue with commit_offset
+ * @brief truncate local_queue with commit_offset, the truncated log records
+ * are collected by the frontend logger
  * @param offset
  */
 void BackendLogger::TruncateLocalQueue(oid_t offset) {
-  // Lock notify first, make sure is_wait_for_flush will not return premature
-  std::lock_guard<std::mutex> lock(flush_notify_mutex);
-  {
-    std::lock_guard<std::mutex> lock(local_queue_mutex);
+  std::lock_guard<std::mutex> lock(local_queue_mutex);
 
-    // cleanup the queue
-    local_queue.erase(local_queue.begin(), local_queue.begin() + offset);
+  for (oid_t log_record_itr = 0; log_record_itr < offset; log_record_itr++) {
+    collected_lsn += local_queue[log_record_itr]->GetMessageLength();
   }
 
-  // let's wait for the frontend logger to flush !
-  // the frontend logger will call our Commit to reset it.
-  wait_for_flushing = true;
+  // cleanup the queue
+  local_queue.erase(local_queue.begin(), local_queue.begin() + offset);
 }
 
 /**
@@ -80,22 +92,6 @@ LogRecord *BackendLogger::GetLogRecord(oid_t offset) {
   }
 }
 
-/**
- * @brief if we still have log record in local queue or waiting for flushing
- * @return true otherwise false
- */
-bool BackendLogger::IsWaitingForFlushing(void) {
-  // Sometimes, the backend logger has some log records even if
-  // wait_for_flushing is false.
-  // For example, if backend logger enqueues the log record right after
-  // frontend logger collect data and not truncated yet.
-  if (wait_for_flushing || GetLocalQueueSize() > 0) {
-    return true;
-  } else {
-    return false;
-  }
-}
-
 bool BackendLogger::IsConnectedToFrontend(void) const {
   return connected_to_frontend;
 }
@@ -104,9 +100,15 @@ void BackendLogger::SetConnectedToFrontend(bool isConnected) {
   connected_to_frontend = isConnected;
 }
 
+/**
+ * @brief wait until the log records logged so far are flushed
+ * Log records logged later do not delay the wake up
+ */
 void BackendLogger::WaitForFlushing(void) {
+  auto flush_lsn = logged_lsn;
+
   std::unique_lock<std::mutex> wait_lock(flush_notify_mutex);
-  while (IsWaitingForFlushing()) {
+  while (persistent_lsn < flush_lsn) {
     flush_notify_cv.wait(wait_lock);
   }
 }
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <mutex>
 #include <condition_variable>
@@ -41,19 +42,29 @@ class BackendLogger : public Logger {
   // Get the log record in the local queue at given offset
   LogRecord *GetLogRecord(oid_t offset);
 
+  // The collected log records are flushed
   void Commit(void);
 
   bool IsConnectedToFrontend(void) const;
 
   void SetConnectedToFrontend(bool isConnected);
 
+  // Log stream (i.e. frontend logger) this backend logger is connected to
+  oid_t GetLogStreamId(void) const { return log_stream_id; }
+
+  void SetLogStreamId(oid_t log_stream_id_) { log_stream_id = log_stream_id_; }
+
   // Truncate the log file at given offset
   void TruncateLocalQueue(oid_t offset);
 
+  // Wait for the log records logged so far to be flushed
   void WaitForFlushing(void);
 
   size_t GetLocalQueueSize(void);
 
+  // Txn whose log records are being logged, INVALID_TXN_ID between txns
+  txn_id_t GetActiveTransactionId(void) const { return active_txn_id; }
+
   //===--------------------------------------------------------------------===//
   // Virtual Functions
   //===--------------------------------------------------------------------===//
@@ -73,22 +84,41 @@ class BackendLogger : public Logger {
                                     void *data = nullptr,
                                     oid_t db_oid = INVALID_OID) = 0;
 
- protected:
-  bool IsWaitingForFlushing(void);
+  // Log a tuple record, by default through GetTupleRecord and Log
+  virtual void LogTupleRecord(LogRecordType log_record_type, txn_id_t txn_id,
+                              oid_t table_oid, ItemPointer insert_location,
+                              ItemPointer delete_location,
+                              void *data = nullptr,
+                              oid_t db_oid = INVALID_OID);
 
+ protected:
   std::vector<LogRecord *> local_queue;
   std::mutex local_queue_mutex;
 
-  // wait for the frontend to flush
+  // Log sequence numbers, i.e. the number of bytes of the log records
+  // of this backend logger :
+  // logged by the backend, only used by the backend
+  lsn_t logged_lsn = 0;
+
+  // collected by the frontend logger, only used by the frontend logger
+  lsn_t collected_lsn = 0;
+
+  // flushed by the frontend logger
   // need to ensure synchronous commit
-  bool wait_for_flushing = false;
+  lsn_t persistent_lsn = 0;
 
-  // Used for notify any waiting thread that backend is flushed
+  // Used for notify the waiting thread that its log records are flushed
   std::mutex flush_notify_mutex;
   std::condition_variable flush_notify_cv;
 
   // is this backend connected to frontend ?
   bool connected_to_frontend = false;
+
+  oid_t log_stream_id = 0;
+
+  // Set before logging the BEGIN record of a txn and reset after its END
+  // record, so that checkpoints can wait for the txns being logged
+  std::atomic<txn_id_t> active_txn_id = ATOMIC_VAR_INIT(INVALID_TXN_ID);
 };
 
 }  // namespace logging
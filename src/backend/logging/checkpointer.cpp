@@ -0,0 +1,568 @@
+/*-------------------------------------------------------------------------
+ *
+ * checkpointer.cpp
+ * file description
+ *
+ * Copyright(c) 2015, CMU
+ *
+ * /peloton/src/backend/logging/checkpointer.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "backend/catalog/manager.h"
+#include "backend/catalog/schema.h"
+#include "backend/common/logger.h"
+#include "backend/common/pool.h"
+#include "backend/common/serializer.h"
+#include "backend/concurrency/transaction.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/logging/checkpointer.h"
+#include "backend/logging/log_manager.h"
+#include "backend/storage/database.h"
+#include "backend/storage/data_table.h"
+#include "backend/storage/tile_group.h"
+#include "backend/storage/tile_group_header.h"
+#include "backend/storage/tuple.h"
+
+namespace peloton {
+namespace logging {
+
+/**
+ * @brief Wait until the condition holds
+ * @return false if logging stopped meanwhile
+ */
+template <typename Condition>
+static bool WaitWhileLogging(Condition condition) {
+  auto &log_manager = LogManager::GetInstance();
+
+  while (condition() == false) {
+    if (log_manager.IsInLoggingMode() == false) {
+      return false;
+    }
+
+    std::this_thread::sleep_for(
+        std::chrono::microseconds(DEFAULT_CHECKPOINT_WAIT_TIMEOUT));
+  }
+
+  return true;
+}
+
+/**
+ * @brief Take a checkpoint every peloton_checkpoint_interval seconds
+ */
+void Checkpointer::MainLoop(void) {
+  auto &log_manager = LogManager::GetInstance();
+
+  // Wait for the recovery to be done
+  log_manager.WaitForMode(LOGGING_STATUS_TYPE_STANDBY, false);
+  log_manager.WaitForMode(LOGGING_STATUS_TYPE_RECOVERY, false);
+
+  auto last_checkpoint_time = std::chrono::steady_clock::now();
+  while (log_manager.IsInLoggingMode()) {
+    std::this_thread::sleep_for(
+        std::chrono::microseconds(DEFAULT_CHECKPOINT_WAIT_TIMEOUT));
+
+    if (std::chrono::steady_clock::now() - last_checkpoint_time >=
+        std::chrono::seconds(peloton_checkpoint_interval)) {
+      DoCheckpoint();
+      last_checkpoint_time = std::chrono::steady_clock::now();
+    }
+  }
+}
+
+/**
+ * @brief Take a checkpoint while the txns keep running
+ * The checkpoint id is the log segment it starts : the log records of the
+ * txns which commit after the checkpoint commit id are all in this segment
+ * or the later ones.
+ * @return false if the checkpoint could not be taken
+ */
+bool Checkpointer::DoCheckpoint(void) {
+  if (IsSimilarToARIES(peloton_logging_mode) == false) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(checkpoint_mutex);
+
+  auto &log_manager = LogManager::GetInstance();
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  if (log_manager.IsInLoggingMode() == false) {
+    return false;
+  }
+
+  auto checkpoint_start_time = std::chrono::steady_clock::now();
+
+  // (1) Start a new log segment in all the log streams
+  oid_t checkpoint_id = log_manager.GetLogSegmentId() + 1;
+  log_manager.SetLogSegmentId(checkpoint_id);
+
+  if (WaitWhileLogging([&log_manager, checkpoint_id] {
+        return log_manager.GetWrittenLogSegmentId() >= checkpoint_id;
+      }) == false) {
+    return false;
+  }
+
+  // (2) Wait for the txns which may have logged in the earlier segments,
+  // the later ones get larger txn ids
+  auto snapshot_txn_id = txn_manager.GetNextTransactionId();
+
+  if (WaitWhileLogging([&log_manager, snapshot_txn_id] {
+        return log_manager.GetOldestActiveTransactionId() >= snapshot_txn_id;
+      }) == false) {
+    return false;
+  }
+
+  // (3) The txns which did not get a commit id yet log in this segment,
+  // wait for the other ones to be visible
+  auto checkpoint_cid = txn_manager.GetMaxCommitId();
+
+  if (WaitWhileLogging([&txn_manager, checkpoint_cid] {
+        return txn_manager.GetLastCommitId() >= checkpoint_cid;
+      }) == false) {
+    return false;
+  }
+
+  // (4) Write the tuples visible at the checkpoint commit id, the writers
+  // keep going since the snapshot only reads the MVCC commit ids
+  auto checkpoint_file_name = log_manager.GetCheckpointFileName();
+  auto temp_checkpoint_file_name = checkpoint_file_name + ".tmp";
+
+  FILE *checkpoint_file = fopen(temp_checkpoint_file_name.c_str(), "wb");
+  if (checkpoint_file == NULL) {
+    LOG_ERROR("Could not create checkpoint file %s",
+              temp_checkpoint_file_name.c_str());
+    return false;
+  }
+
+  size_t tuple_count = 0;
+  bool written = WriteCheckpoint(checkpoint_file, checkpoint_id,
+                                 checkpoint_cid, snapshot_txn_id, tuple_count);
+
+  if (fflush(checkpoint_file) != 0 || fsync(fileno(checkpoint_file)) != 0) {
+    written = false;
+  }
+  if (fclose(checkpoint_file) != 0) {
+    written = false;
+  }
+
+  if (written == false) {
+    LOG_ERROR("Error occured while writing checkpoint %lu", checkpoint_id);
+    remove(temp_checkpoint_file_name.c_str());
+    return false;
+  }
+
+  // The checkpoint replaces the previous one at once
+  if (rename(temp_checkpoint_file_name.c_str(),
+             checkpoint_file_name.c_str()) != 0) {
+    LOG_ERROR("Could not rename checkpoint file %s",
+              temp_checkpoint_file_name.c_str());
+    return false;
+  }
+
+  // and the rename has to be durable before the log is truncated
+  auto separator_position = checkpoint_file_name.find_last_of('/');
+  std::string checkpoint_directory = ".";
+  if (separator_position != std::string::npos) {
+    checkpoint_directory = checkpoint_file_name.substr(0, separator_position);
+  }
+
+  int checkpoint_directory_fd = open(checkpoint_directory.c_str(), O_RDONLY);
+  if (checkpoint_directory_fd == -1 || fsync(checkpoint_directory_fd) != 0) {
+    LOG_ERROR("Could not sync checkpoint directory %s",
+              checkpoint_directory.c_str());
+    if (checkpoint_directory_fd != -1) {
+      close(checkpoint_directory_fd);
+    }
+    return false;
+  }
+  close(checkpoint_directory_fd);
+
+  last_checkpoint_id = checkpoint_id;
+
+  // (5) The log segments before the checkpoint are not needed anymore
+  TruncateLog(checkpoint_id);
+
+  std::chrono::duration<double> checkpoint_duration =
+      std::chrono::steady_clock::now() - checkpoint_start_time;
+
+  LOG_INFO("Checkpoint %lu at commit id %lu :: %lu tuples in %.3f s",
+           checkpoint_id, checkpoint_cid, tuple_count,
+           checkpoint_duration.count());
+
+  return true;
+}
+
+/**
+ * @brief Write the header and the tile group frames of a checkpoint
+ * @param checkpoint file
+ * @param checkpoint id
+ * @param checkpoint commit id
+ * @param txn id which does not own any tuple
+ * @param tuple_count set to the number of tuples written
+ * @return false if the file could not be written
+ */
+bool Checkpointer::WriteCheckpoint(FILE *checkpoint_file, oid_t checkpoint_id,
+                                   cid_t checkpoint_cid, txn_id_t txn_id,
+                                   size_t &tuple_count) {
+  auto &manager = catalog::Manager::GetInstance();
+  CopySerializeOutput output;
+
+  // Header frame
+  output.WriteInt(sizeof(int64_t) * 2);
+  output.WriteLong(checkpoint_id);
+  output.WriteLong(checkpoint_cid);
+  if (fwrite(output.Data(), 1, output.Size(), checkpoint_file) !=
+      output.Size()) {
+    return false;
+  }
+
+  std::vector<oid_t> position_list;
+
+  auto database_count = manager.GetDatabaseCount();
+  for (oid_t database_itr = 0; database_itr < database_count; database_itr++) {
+    auto database = manager.GetDatabase(database_itr);
+
+    auto table_count = database->GetTableCount();
+    for (oid_t table_itr = 0; table_itr < table_count; table_itr++) {
+      auto table = database->GetTable(table_itr);
+      auto schema = table->GetSchema();
+      auto column_count = schema->GetColumnCount();
+
+      // The tile groups added later only hold tuples of later commit ids
+      auto tile_group_count = table->GetTileGroupCount();
+      for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+           tile_group_itr++) {
+        auto tile_group = table->GetTileGroup(tile_group_itr);
+
+        position_list.clear();
+        tile_group->GetHeader()->GetVisiblePositionList(
+            txn_id, checkpoint_cid, START_OID, tile_group->GetNextTupleSlot(),
+            position_list);
+
+        if (position_list.empty()) {
+          continue;
+        }
+
+        // Tile group frame, its length is set once the values are written
+        output.Reset();
+        output.WriteInt(0);
+        output.WriteLong(database->GetOid());
+        output.WriteLong(table->GetOid());
+        output.WriteLong(tile_group->GetTileGroupId());
+
+        output.WriteInt(position_list.size());
+        for (auto tuple_slot : position_list) {
+          output.WriteInt(tuple_slot);
+        }
+
+        for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+          for (auto tuple_slot : position_list) {
+            tile_group->GetValue(tuple_slot, column_itr).SerializeTo(output);
+          }
+        }
+
+        output.WriteIntAt(0, output.Size() - sizeof(int32_t));
+
+        if (fwrite(output.Data(), 1, output.Size(), checkpoint_file) !=
+            output.Size()) {
+          return false;
+        }
+
+        tuple_count += position_list.size();
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Read the id and commit id of the checkpoint
+ * @return false if there is no checkpoint
+ */
+bool Checkpointer::ReadCheckpointHeader(oid_t &checkpoint_id,
+                                        cid_t &checkpoint_cid) {
+  auto &log_manager = LogManager::GetInstance();
+
+  FILE *checkpoint_file =
+      fopen(log_manager.GetCheckpointFileName().c_str(), "rb");
+  if (checkpoint_file == NULL) {
+    return false;
+  }
+
+  bool status =
+      ReadCheckpointHeader(checkpoint_file, checkpoint_id, checkpoint_cid);
+
+  fclose(checkpoint_file);
+
+  return status;
+}
+
+bool Checkpointer::ReadCheckpointHeader(FILE *checkpoint_file,
+                                        oid_t &checkpoint_id,
+                                        cid_t &checkpoint_cid) {
+  char header[sizeof(int32_t) + sizeof(int64_t) * 2];
+  if (fread(header, 1, sizeof(header), checkpoint_file) != sizeof(header)) {
+    LOG_ERROR("Checkpoint header is truncated");
+    return false;
+  }
+
+  ReferenceSerializeInputBE input(header, sizeof(header));
+  input.ReadInt();
+  checkpoint_id = input.ReadLong();
+  checkpoint_cid = input.ReadLong();
+
+  return true;
+}
+
+/**
+ * @brief Restore the tuples of the checkpoint in a recovery txn
+ * The tile group frames are spread over loader threads, which each own the
+ * tile groups of their frames. Missing tile groups are created beforehand
+ * so that the loaders never modify the tables.
+ * @param checkpoint_id set to the log segment to replay from
+ * @param checkpoint_cid set to the commit id of the checkpoint
+ * @param max_tile_group_id set to the largest tile group id restored
+ * @return false if there is no checkpoint
+ */
+bool Checkpointer::LoadCheckpoint(oid_t &checkpoint_id, cid_t &checkpoint_cid,
+                                  oid_t &max_tile_group_id) {
+  auto &log_manager = LogManager::GetInstance();
+  auto load_start_time = std::chrono::steady_clock::now();
+
+  FILE *checkpoint_file =
+      fopen(log_manager.GetCheckpointFileName().c_str(), "rb");
+  if (checkpoint_file == NULL) {
+    return false;
+  }
+
+  if (ReadCheckpointHeader(checkpoint_file, checkpoint_id, checkpoint_cid) ==
+      false) {
+    fclose(checkpoint_file);
+    return false;
+  }
+
+  struct stat checkpoint_stats;
+  fstat(fileno(checkpoint_file), &checkpoint_stats);
+  size_t checkpoint_file_size = checkpoint_stats.st_size;
+
+  // Go over the frame headers
+  auto &manager = catalog::Manager::GetInstance();
+  std::vector<TileGroupFrame> frames;
+
+  char frame_header[sizeof(int32_t) + sizeof(int64_t) * 3];
+  while (fread(frame_header, 1, sizeof(frame_header), checkpoint_file) ==
+         sizeof(frame_header)) {
+    ReferenceSerializeInputBE input(frame_header, sizeof(frame_header));
+    size_t frame_length = input.ReadInt();
+    oid_t database_oid = input.ReadLong();
+    oid_t table_oid = input.ReadLong();
+    oid_t tile_group_id = input.ReadLong();
+
+    // The frame starts after its length
+    off_t frame_offset = ftell(checkpoint_file) - sizeof(int64_t) * 3;
+    if (frame_offset + frame_length > checkpoint_file_size) {
+      LOG_ERROR("Checkpoint frame of tile group %lu is truncated",
+                tile_group_id);
+      break;
+    }
+    fseek(checkpoint_file, frame_offset + frame_length, SEEK_SET);
+
+    auto table = manager.GetTableWithOid(database_oid, table_oid);
+    if (table == nullptr) {
+      LOG_ERROR("Checkpoint of table %lu which does not exist", table_oid);
+      continue;
+    }
+
+    auto tile_group = manager.GetTileGroup(tile_group_id);
+    if (tile_group == nullptr) {
+      table->AddTileGroupWithOid(tile_group_id);
+      tile_group = manager.GetTileGroup(tile_group_id);
+    }
+    max_tile_group_id = std::max(max_tile_group_id, tile_group_id);
+
+    frames.push_back({frame_offset, frame_length, table, tile_group.get()});
+  }
+
+  // Continue after the commit ids of the checkpoint
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  txn_manager.RestoreLastCommitId(checkpoint_cid);
+
+  auto recovery_txn = txn_manager.BeginTransaction();
+
+  // Load the frames in parallel
+  size_t load_thread_count = std::max<size_t>(
+      std::min(log_manager.GetRecoveryThreadCount(), frames.size()), 1);
+  std::vector<LoadWorker> load_workers(load_thread_count);
+
+  std::vector<std::thread> load_threads;
+  for (size_t load_thread_itr = 0; load_thread_itr < load_thread_count;
+       load_thread_itr++) {
+    load_threads.emplace_back(&Checkpointer::LoadTileGroups,
+                              fileno(checkpoint_file), std::cref(frames),
+                              load_thread_itr, load_thread_count,
+                              recovery_txn->GetTransactionId(),
+                              std::ref(load_workers[load_thread_itr]));
+  }
+  for (auto &load_thread : load_threads) {
+    load_thread.join();
+  }
+
+  // Commit pass : hand the tuples of the loaders to the recovery txn
+  size_t tuple_count = 0;
+  for (auto &load_worker : load_workers) {
+    for (auto inserted_location : load_worker.inserted_locations) {
+      recovery_txn->RecordInsert(inserted_location);
+    }
+    for (auto &tuple_count_delta : load_worker.tuple_count_deltas) {
+      tuple_count_delta.first->IncreaseNumberOfTuplesBy(
+          tuple_count_delta.second);
+    }
+    tuple_count += load_worker.inserted_locations.size();
+
+    if (load_worker.failed) {
+      // TODO: We need to abort on failure !
+      recovery_txn->SetResult(Result::RESULT_FAILURE);
+    }
+  }
+
+  txn_manager.CommitTransaction();
+
+  fclose(checkpoint_file);
+
+  last_checkpoint_id = checkpoint_id;
+
+  // Report the load throughput
+  std::chrono::duration<double> load_duration =
+      std::chrono::steady_clock::now() - load_start_time;
+  double load_seconds =
+      std::max(load_duration.count(), std::numeric_limits<double>::min());
+
+  LOG_INFO(
+      "Loaded checkpoint %lu at commit id %lu :: %lu tuples (%lu bytes) of "
+      "%lu tile groups in %.3f s :: %.2f MB/s",
+      checkpoint_id, checkpoint_cid, tuple_count, checkpoint_file_size,
+      frames.size(), load_duration.count(),
+      checkpoint_file_size / load_seconds / (1024 * 1024));
+
+  return true;
+}
+
+/**
+ * @brief Restore the tile group frames of a loader in the recovery txn
+ * @param checkpoint file descriptor, only read with pread
+ * @param tile group frames
+ * @param first frame of the loader
+ * @param step between the frames of the loader
+ * @param recovery txn id
+ * @param load worker
+ */
+void Checkpointer::LoadTileGroups(int checkpoint_file_fd,
+                                  const std::vector<TileGroupFrame> &frames,
+                                  size_t first_frame, size_t frame_step,
+                                  txn_id_t txn_id, LoadWorker &load_worker) {
+  std::vector<char> frame_buffer;
+
+  for (size_t frame_itr = first_frame; frame_itr < frames.size();
+       frame_itr += frame_step) {
+    auto &frame = frames[frame_itr];
+
+    frame_buffer.resize(frame.length);
+    if (pread(checkpoint_file_fd, frame_buffer.data(), frame.length,
+              frame.offset) != static_cast<ssize_t>(frame.length)) {
+      LOG_ERROR("Error occured in pread");
+      load_worker.failed = true;
+      continue;
+    }
+
+    ReferenceSerializeInputBE input(frame_buffer.data(), frame.length);
+
+    // Skip the database, table and tile group ids
+    input.ReadLong();
+    input.ReadLong();
+    input.ReadLong();
+
+    size_t tuple_count = input.ReadInt();
+    std::vector<oid_t> tuple_slots(tuple_count);
+    for (auto &tuple_slot : tuple_slots) {
+      tuple_slot = input.ReadInt();
+    }
+
+    // Rebuild the tuples column by column, the tile group copies their
+    // non-inlined values so the pool only lives as long as the frame
+    auto schema = frame.table->GetSchema();
+    VarlenPool frame_pool(BACKEND_TYPE_MM);
+
+    std::vector<std::unique_ptr<storage::Tuple>> tuples;
+    for (size_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      tuples.emplace_back(new storage::Tuple(schema, true));
+    }
+
+    auto column_count = schema->GetColumnCount();
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      auto column_type = schema->GetType(column_itr);
+
+      for (auto &tuple : tuples) {
+        Value value;
+        value.DeserializeFromAllocateForStorage(column_type, input,
+                                                &frame_pool);
+        tuple->SetValue(column_itr, value, &frame_pool);
+      }
+    }
+
+    // Insert the tuples at their slots, the log tail refers to them
+    for (size_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      auto tuple_slot = tuple_slots[tuple_itr];
+      auto inserted_tuple_slot = frame.tile_group->InsertTuple(
+          txn_id, tuple_slot, tuples[tuple_itr].get());
+
+      if (inserted_tuple_slot == INVALID_OID) {
+        load_worker.failed = true;
+      } else {
+        load_worker.inserted_locations.emplace_back(
+            frame.tile_group->GetTileGroupId(), tuple_slot);
+        load_worker.tuple_count_deltas[frame.table]++;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Remove the log segments before the given checkpoint
+ * The segments of a checkpoint are only removed once the next checkpoint is
+ * durable, so the removal stops at the segments removed by an earlier one.
+ * @param checkpoint id
+ */
+void Checkpointer::TruncateLog(oid_t checkpoint_id) {
+  auto &log_manager = LogManager::GetInstance();
+
+  for (oid_t log_segment_id = checkpoint_id; log_segment_id-- > 0;) {
+    if (access(log_manager.GetLogSegmentFileName(0, log_segment_id).c_str(),
+               F_OK) != 0) {
+      break;
+    }
+
+    for (oid_t log_stream_id = 0;; log_stream_id++) {
+      auto log_segment_file_name =
+          log_manager.GetLogSegmentFileName(log_stream_id, log_segment_id);
+      if (remove(log_segment_file_name.c_str()) != 0) {
+        break;
+      }
+    }
+
+    LOG_TRACE("Removed log segment %lu", log_segment_id);
+  }
+}
+
+}  // namespace logging
+}  // namespace peloton
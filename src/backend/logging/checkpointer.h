@@ -0,0 +1,126 @@
+/*-------------------------------------------------------------------------
+ *
+ * checkpointer.h
+ * file description
+ *
+ * Copyright(c) 2015, CMU
+ *
+ * /peloton/src/backend/logging/checkpointer.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <map>
+#include <sys/types.h>
+#include <mutex>
+#include <vector>
+
+#include "backend/common/types.h"
+
+// Period with which the checkpointer checks what it waits for
+// (in microseconds)
+#define DEFAULT_CHECKPOINT_WAIT_TIMEOUT 1000
+
+namespace peloton {
+
+namespace storage {
+class DataTable;
+class TileGroup;
+}
+
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Checkpointer
+//===--------------------------------------------------------------------===//
+
+/**
+ * Checkpoints of the ARIES log, taken without blocking the writers.
+ *
+ * A checkpoint starts a new log segment and waits for the txns which were
+ * being logged, since they may have logged in the previous segments. Then,
+ * it writes the tuples visible at a commit id which covers all of them.
+ * Recovery loads the checkpoint and only replays the txns committed after
+ * its commit id, from its log segment on. So the older log segments are
+ * removed once the checkpoint is written.
+ *
+ * Checkpoint file (big endian, frame lengths do not count themselves) :
+ *  Header frame : length (int), checkpoint id (long), checkpoint cid (long)
+ *  then a frame per tile group with visible tuples :
+ *   length (int), database oid, table oid, tile group id (long),
+ *   tuple count (int), the tuple slots (int each),
+ *   and then the values of each column in turn, serialized as in tuples
+ */
+class Checkpointer {
+ public:
+  Checkpointer(const Checkpointer &) = delete;
+  Checkpointer &operator=(const Checkpointer &) = delete;
+  Checkpointer(Checkpointer &&) = delete;
+  Checkpointer &operator=(Checkpointer &&) = delete;
+
+  Checkpointer() {}
+
+  // Take a checkpoint periodically while logging
+  void MainLoop(void);
+
+  // Take a checkpoint now, return false if it could not be taken
+  bool DoCheckpoint(void);
+
+  // Read the id and commit id of the checkpoint, false if there is none
+  bool ReadCheckpointHeader(oid_t &checkpoint_id, cid_t &checkpoint_cid);
+
+  // Restore the tuples of the checkpoint, false if there is none
+  bool LoadCheckpoint(oid_t &checkpoint_id, cid_t &checkpoint_cid,
+                      oid_t &max_tile_group_id);
+
+  // Id of the last checkpoint taken or loaded, i.e. of its log segment
+  oid_t GetCheckpointId(void) const { return last_checkpoint_id; }
+
+ private:
+  // A tile group frame of the checkpoint file
+  struct TileGroupFrame {
+    off_t offset;
+
+    size_t length;
+
+    storage::DataTable *table;
+
+    storage::TileGroup *tile_group;
+  };
+
+  // A loader thread restores the tile groups of its frames and keeps its
+  // changes for the commit of the recovery txn
+  struct LoadWorker {
+    std::vector<ItemPointer> inserted_locations;
+
+    // Change of the number of tuples of each table
+    std::map<storage::DataTable *, int> tuple_count_deltas;
+
+    bool failed = false;
+  };
+
+  bool ReadCheckpointHeader(FILE *checkpoint_file, oid_t &checkpoint_id,
+                            cid_t &checkpoint_cid);
+
+  bool WriteCheckpoint(FILE *checkpoint_file, oid_t checkpoint_id,
+                       cid_t checkpoint_cid, txn_id_t txn_id,
+                       size_t &tuple_count);
+
+  static void LoadTileGroups(int checkpoint_file_fd,
+                             const std::vector<TileGroupFrame> &frames,
+                             size_t first_frame, size_t frame_step,
+                             txn_id_t txn_id, LoadWorker &load_worker);
+
+  void TruncateLog(oid_t checkpoint_id);
+
+  // One checkpoint at a time
+  std::mutex checkpoint_mutex;
+
+  oid_t last_checkpoint_id = 0;
+};
+
+}  // namespace logging
+}  // namespace peloton
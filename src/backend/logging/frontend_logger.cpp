@@ -24,7 +24,9 @@ int64_t peloton_wait_timeout = 0;
 namespace peloton {
 namespace logging {
 
-FrontendLogger::FrontendLogger() {
+FrontendLogger::FrontendLogger(oid_t log_stream_id)
+    : log_stream_id(log_stream_id),
+      log_segment_id(LogManager::GetInstance().GetLogSegmentId()) {
   logger_type = LOGGER_TYPE_FRONTEND;
 
   if (peloton_wait_timeout != 0) {
@@ -40,12 +42,14 @@ FrontendLogger::~FrontendLogger() {
 
 /** * @brief Return the frontend logger based on logging type
  * @param logging type can be stdout(debug), aries, peloton
+ * @param log stream written by the frontend logger
  */
-FrontendLogger *FrontendLogger::GetFrontendLogger(LoggingType logging_type) {
+FrontendLogger *FrontendLogger::GetFrontendLogger(LoggingType logging_type,
+                                                  oid_t log_stream_id) {
   FrontendLogger *frontendLogger = nullptr;
 
   if (IsSimilarToARIES(logging_type) == true) {
-    frontendLogger = new AriesFrontendLogger();
+    frontendLogger = new AriesFrontendLogger(log_stream_id);
   } else if (IsSimilarToPeloton(logging_type) == true) {
     frontendLogger = new PelotonFrontendLogger();
   } else {
@@ -79,6 +83,13 @@ void FrontendLogger::MainLoop(void) {
       // RECOVERY MODE
       /////////////////////////////////////////////////////////////////////
 
+      // The first log stream recovers all the streams at once,
+      // the other ones wait for it
+      if (log_stream_id != 0) {
+        log_manager.WaitForMode(LOGGING_STATUS_TYPE_RECOVERY, false);
+        break;
+      }
+
       // First, do recovery if needed
       DoRecovery();
 
@@ -105,8 +116,18 @@ void FrontendLogger::MainLoop(void) {
     // Collect LogRecords from all backend loggers
     CollectLogRecordsFromBackendLoggers();
 
-    // Flush the data to the file
-    FlushLogRecords();
+    // Flush the data to the file once the group is complete
+    if (IsGroupCommitReady()) {
+      GroupCommit();
+    }
+
+    // A checkpoint started a new log segment, the log records collected
+    // so far belong to the current one
+    auto next_log_segment_id = log_manager.GetLogSegmentId();
+    if (next_log_segment_id != log_segment_id) {
+      GroupCommit();
+      SwitchLogSegment(next_log_segment_id);
+    }
   }
 
   /////////////////////////////////////////////////////////////////////
@@ -118,16 +139,12 @@ void FrontendLogger::MainLoop(void) {
 
   // flush any remaining log records
   CollectLogRecordsFromBackendLoggers();
-  FlushLogRecords();
+  GroupCommit();
 
-  /////////////////////////////////////////////////////////////////////
-  // SLEEP MODE
-  /////////////////////////////////////////////////////////////////////
+  LOG_INFO("Log stream %lu :: %s", log_stream_id,
+           GetGroupCommitStats().GetInfo().c_str());
 
-  LOG_TRACE("Frontendlogger] Sleep Mode");
-
-  // Setting frontend logger status to sleep
-  log_manager.SetLoggingStatus(LOGGING_STATUS_TYPE_SLEEP);
+  // The log manager enters SLEEP mode once all the log streams are done
 }
 
 /**
@@ -146,28 +163,123 @@ void FrontendLogger::CollectLogRecordsFromBackendLoggers() {
     std::this_thread::sleep_for(sleep_period);
   }
 
+  auto previous_log_size = pending_log_size;
+
   {
     std::lock_guard<std::mutex> lock(backend_logger_mutex);
 
     // Look at the local queues of the backend loggers
     for (auto backend_logger : backend_loggers) {
-      auto local_queue_size = backend_logger->GetLocalQueueSize();
+      CollectLogRecordsFromBackendLogger(backend_logger);
+    }
+  }
 
-      // Skip current backend_logger, nothing to do
-      if (local_queue_size == 0) continue;
+  // A new group starts with its first log record
+  collected_new_log_records = (pending_log_size != previous_log_size);
+  if (previous_log_size == 0 && collected_new_log_records) {
+    group_start_time = std::chrono::steady_clock::now();
+  }
 
-      // Shallow copy the log record from backend_logger to here
-      for (oid_t log_record_itr = 0; log_record_itr < local_queue_size;
-           log_record_itr++) {
-        global_queue.push_back(backend_logger->GetLogRecord(log_record_itr));
-      }
+  need_to_collect_new_log_records = false;
+}
 
-      // truncate the local queue
-      backend_logger->TruncateLocalQueue(local_queue_size);
+/**
+ * @brief Collect the log records from the local queue of a BackendLogger
+ * @param backend logger
+ */
+void FrontendLogger::CollectLogRecordsFromBackendLogger(
+    BackendLogger *backend_logger) {
+  auto local_queue_size = backend_logger->GetLocalQueueSize();
+
+  // Skip current backend_logger, nothing to do
+  if (local_queue_size == 0) return;
+
+  // Shallow copy the log record from backend_logger to here
+  for (oid_t log_record_itr = 0; log_record_itr < local_queue_size;
+       log_record_itr++) {
+    auto log_record = backend_logger->GetLogRecord(log_record_itr);
+    global_queue.push_back(log_record);
+    pending_log_size += log_record->GetMessageLength();
+  }
+  pending_record_count += local_queue_size;
+
+  // truncate the local queue
+  backend_logger->TruncateLocalQueue(local_queue_size);
+}
+
+/**
+ * @brief Decide whether to flush the collected log records now
+ * A larger group amortizes the flush over more commits, but delays them.
+ * So the group is flushed once it is large enough, once it is old enough,
+ * or once it stops growing since waiting then only adds latency.
+ * @return true if the group should be flushed
+ */
+bool FrontendLogger::IsGroupCommitReady(void) {
+  if (pending_log_size == 0) {
+    return false;
+  }
+
+  if (collected_new_log_records == false ||
+      pending_log_size >= group_commit_size ||
+      pending_record_count >= group_commit_record_count) {
+    return true;
+  }
+
+  auto group_age = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - group_start_time);
+  return group_age.count() >= group_commit_timeout;
+}
+
+/**
+ * @brief Flush the collected log records and count the group commit
+ */
+void FrontendLogger::GroupCommit(void) {
+  auto start = std::chrono::steady_clock::now();
+
+  FlushLogRecords();
+
+  auto flush_latency = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+
+  if (pending_log_size > 0) {
+    std::lock_guard<std::mutex> lock(group_commit_stats_mutex);
+    group_commit_stats.RecordGroupCommit(pending_record_count, pending_log_size,
+                                         flush_latency.count());
+  }
+
+  pending_record_count = 0;
+  pending_log_size = 0;
+}
+
+GroupCommitStats FrontendLogger::GetGroupCommitStats(void) {
+  std::lock_guard<std::mutex> lock(group_commit_stats_mutex);
+  return group_commit_stats;
+}
+
+/**
+ * @brief Write the log records collected from now on to the given segment
+ * @param log segment
+ */
+void FrontendLogger::SwitchLogSegment(oid_t next_log_segment_id) {
+  log_segment_id = next_log_segment_id;
+}
+
+/**
+ * @brief Get the oldest txn being logged by the backend loggers
+ * @return its txn id, or MAX_TXN_ID if no txn is being logged
+ */
+txn_id_t FrontendLogger::GetOldestActiveTransactionId(void) {
+  txn_id_t oldest_txn_id = MAX_TXN_ID;
+
+  std::lock_guard<std::mutex> lock(backend_logger_mutex);
+  for (auto backend_logger : backend_loggers) {
+    auto active_txn_id = backend_logger->GetActiveTransactionId();
+    if (active_txn_id != INVALID_TXN_ID && active_txn_id < oldest_txn_id) {
+      oldest_txn_id = active_txn_id;
     }
   }
 
-  need_to_collect_new_log_records = false;
+  return oldest_txn_id;
 }
 
 /**
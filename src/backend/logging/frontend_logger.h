@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <mutex>
 #include <condition_variable>
@@ -21,6 +23,14 @@
 #include "backend/common/types.h"
 #include "backend/logging/logger.h"
 #include "backend/logging/backend_logger.h"
+#include "backend/logging/group_commit_stats.h"
+
+// Group commit thresholds : the collected log records are flushed once they
+// reach the size (in bytes) or the record count, or once the oldest one has
+// waited for the timeout (in microseconds)
+#define DEFAULT_GROUP_COMMIT_SIZE (1 << 20)
+#define DEFAULT_GROUP_COMMIT_RECORD_COUNT 10000
+#define DEFAULT_GROUP_COMMIT_TIMEOUT 1000
 
 namespace peloton {
 namespace logging {
@@ -31,16 +41,28 @@ namespace logging {
 
 class FrontendLogger : public Logger {
  public:
-  FrontendLogger();
+  FrontendLogger(oid_t log_stream_id = 0);
 
   ~FrontendLogger();
 
-  static FrontendLogger *GetFrontendLogger(LoggingType logging_type);
+  static FrontendLogger *GetFrontendLogger(LoggingType logging_type,
+                                           oid_t log_stream_id = 0);
 
   void MainLoop(void);
 
   void CollectLogRecordsFromBackendLoggers(void);
 
+  oid_t GetLogStreamId(void) const { return log_stream_id; }
+
+  // Log segment written by this frontend logger
+  oid_t GetLogSegmentId(void) const { return log_segment_id; }
+
+  // Oldest txn being logged by the backend loggers, MAX_TXN_ID if none
+  txn_id_t GetOldestActiveTransactionId(void);
+
+  // Get a copy of the group commit counters
+  GroupCommitStats GetGroupCommitStats(void);
+
   void AddBackendLogger(BackendLogger *backend_logger);
 
   bool RemoveBackendLogger(BackendLogger *backend_logger);
@@ -49,13 +71,27 @@ class FrontendLogger : public Logger {
   // Virtual Functions
   //===--------------------------------------------------------------------===//
 
+  // Collect the LogRecords of a backend logger
+  virtual void CollectLogRecordsFromBackendLogger(BackendLogger *backend_logger);
+
   // Flush collected LogRecords
   virtual void FlushLogRecords(void) = 0;
 
   // Restore database
   virtual void DoRecovery(void) = 0;
 
+  // Write the log records collected from now on to the given log segment
+  virtual void SwitchLogSegment(oid_t next_log_segment_id);
+
  protected:
+  // Log stream written by this frontend logger, the first stream also
+  // recovers the other ones
+  oid_t log_stream_id;
+
+  // Log segment written by this frontend logger, a checkpoint starts a new
+  // log segment and waits for all the frontend loggers to switch to it
+  std::atomic<oid_t> log_segment_id;
+
   // Associated backend loggers
   std::vector<BackendLogger *> backend_loggers;
 
@@ -72,6 +108,31 @@ class FrontendLogger : public Logger {
 
   // used to indicate if backend has new logs
   bool need_to_collect_new_log_records = false;
+
+  // Log records and bytes collected since the last flush
+  size_t pending_record_count = 0;
+  size_t pending_log_size = 0;
+
+ private:
+  // Whether the collected log records should be flushed as a group now
+  bool IsGroupCommitReady(void);
+
+  // Flush the collected log records and count the group commit
+  void GroupCommit(void);
+
+  // used to indicate if the last collection got new logs
+  bool collected_new_log_records = false;
+
+  // When the oldest pending log record was collected
+  std::chrono::time_point<std::chrono::steady_clock> group_start_time;
+
+  // Group commit thresholds
+  size_t group_commit_size = DEFAULT_GROUP_COMMIT_SIZE;
+  size_t group_commit_record_count = DEFAULT_GROUP_COMMIT_RECORD_COUNT;
+  int64_t group_commit_timeout = DEFAULT_GROUP_COMMIT_TIMEOUT;
+
+  GroupCommitStats group_commit_stats;
+  std::mutex group_commit_stats_mutex;
 };
 
 }  // namespace logging
@@ -0,0 +1,102 @@
+/*-------------------------------------------------------------------------
+ *
+ * groupcommitstats.cpp
+ * file description
+ *
+ * Copyright(c) 2015, CMU
+ *
+ * /peloton/src/backend/logging/groupcommitstats.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <limits>
+#include <sstream>
+
+#include "backend/logging/group_commit_stats.h"
+
+// Number of buckets of the histograms
+#define GROUP_COMMIT_STATS_BUCKET_COUNT 64
+
+namespace peloton {
+namespace logging {
+
+/**
+ * @brief Get the histogram bucket of a value
+ */
+static size_t GetBucket(uint64_t value) {
+  size_t bucket = 0;
+  while (value > 0) {
+    value >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+GroupCommitStats::GroupCommitStats()
+    : group_size_histogram(GROUP_COMMIT_STATS_BUCKET_COUNT + 1, 0),
+      flush_latency_histogram(GROUP_COMMIT_STATS_BUCKET_COUNT + 1, 0) {}
+
+/**
+ * @brief Count a group commit
+ * @param record_count number of log records in the group
+ * @param log_size number of bytes in the group
+ * @param flush_latency time to flush the group (in microseconds)
+ */
+void GroupCommitStats::RecordGroupCommit(size_t record_count, size_t log_size,
+                                         uint64_t flush_latency) {
+  group_commit_count++;
+  this->record_count += record_count;
+  this->log_size += log_size;
+
+  group_size_histogram[GetBucket(record_count)]++;
+  flush_latency_histogram[GetBucket(flush_latency)]++;
+}
+
+void GroupCommitStats::Merge(const GroupCommitStats &other) {
+  group_commit_count += other.group_commit_count;
+  record_count += other.record_count;
+  log_size += other.log_size;
+
+  for (size_t bucket = 0; bucket < group_size_histogram.size(); bucket++) {
+    group_size_histogram[bucket] += other.group_size_histogram[bucket];
+    flush_latency_histogram[bucket] += other.flush_latency_histogram[bucket];
+  }
+}
+
+/**
+ * @brief Print the counters and the non-empty histogram buckets
+ */
+std::string GroupCommitStats::GetInfo(void) const {
+  std::ostringstream os;
+
+  os << "Group commits : " << group_commit_count
+     << " Log records : " << record_count << " Log bytes : " << log_size;
+  if (group_commit_count > 0) {
+    os << " Avg group size : " << record_count / group_commit_count;
+  }
+  os << "\n";
+
+  auto print_histogram = [&os](const char *name,
+                               const std::vector<uint64_t> &histogram) {
+    os << name << " :";
+    for (size_t bucket = 0; bucket < histogram.size(); bucket++) {
+      if (histogram[bucket] == 0) continue;
+
+      uint64_t upper_bound = std::numeric_limits<uint64_t>::max();
+      if (bucket < GROUP_COMMIT_STATS_BUCKET_COUNT) {
+        upper_bound = (uint64_t(1) << bucket) - 1;
+      }
+      os << " [<=" << upper_bound << "] " << histogram[bucket];
+    }
+    os << "\n";
+  };
+
+  print_histogram("Group size (records)", group_size_histogram);
+  print_histogram("Flush latency (us)", flush_latency_histogram);
+
+  return os.str();
+}
+
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,73 @@
+/*-------------------------------------------------------------------------
+ *
+ * groupcommitstats.h
+ * file description
+ *
+ * Copyright(c) 2015, CMU
+ *
+ * /peloton/src/backend/logging/groupcommitstats.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Group Commit Stats
+//===--------------------------------------------------------------------===//
+
+/**
+ * Counters of the group commits of frontend loggers. Group sizes (in log
+ * records) and flush latencies (in microseconds) are kept in histograms
+ * whose bucket i holds the values in [2^(i-1), 2^i), bucket 0 holding 0.
+ */
+class GroupCommitStats {
+ public:
+  GroupCommitStats();
+
+  // Count a group commit
+  void RecordGroupCommit(size_t record_count, size_t log_size,
+                         uint64_t flush_latency);
+
+  // Add the counters of another frontend logger
+  void Merge(const GroupCommitStats &other);
+
+  uint64_t GetGroupCommitCount(void) const { return group_commit_count; }
+
+  uint64_t GetRecordCount(void) const { return record_count; }
+
+  uint64_t GetLogSize(void) const { return log_size; }
+
+  const std::vector<uint64_t> &GetGroupSizeHistogram(void) const {
+    return group_size_histogram;
+  }
+
+  const std::vector<uint64_t> &GetFlushLatencyHistogram(void) const {
+    return flush_latency_histogram;
+  }
+
+  std::string GetInfo(void) const;
+
+ private:
+  uint64_t group_commit_count = 0;
+
+  // log records and bytes flushed
+  uint64_t record_count = 0;
+
+  uint64_t log_size = 0;
+
+  std::vector<uint64_t> group_size_histogram;
+
+  std::vector<uint64_t> flush_latency_histogram;
+};
+
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,218 @@
+/*-------------------------------------------------------------------------
+ *
+ * logbuffer.cpp
+ * file description
+ *
+ * Copyright(c) 2015, CMU
+ *
+ * /peloton/src/backend/logging/logbuffer.cpp
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include "backend/logging/log_buffer.h"
+
+namespace peloton {
+namespace logging {
+
+/**
+ * @brief Round up the capacity to a power of two
+ */
+static size_t GetBufferCapacity(size_t capacity) {
+  size_t buffer_capacity = 1;
+  while (buffer_capacity < capacity) {
+    buffer_capacity <<= 1;
+  }
+  return buffer_capacity;
+}
+
+LogBuffer::LogBuffer(size_t capacity)
+    : capacity(GetBufferCapacity(capacity)),
+      head(0),
+      tail(0),
+      written_record_count(0),
+      read_record_count(0),
+      read_position(0),
+      reserved_length(0) {
+  data = new char[this->capacity];
+}
+
+LogBuffer::~LogBuffer() { delete[] data; }
+
+/**
+ * @brief Append a serialized record to the buffer
+ * The record is visible to the reader only once it is completely copied,
+ * so the reader never sees a partial record.
+ * @param record serialized record
+ * @param record_length its length
+ */
+void LogBuffer::WriteRecord(const char *record, size_t record_length) {
+  uint64_t write_position = WaitForRoom(record_length);
+
+  CopyRecord(write_position, record, record_length);
+
+  Publish(write_position + record_length);
+}
+
+/**
+ * @brief Reserve room for a record to be serialized in place
+ * The record is visible to the reader only once it is published.
+ * @param record_length length of the serialized record
+ * @return where to serialize it, valid until it is published
+ */
+char *LogBuffer::ReserveRecord(size_t record_length) {
+  uint64_t write_position = WaitForRoom(record_length);
+  reserved_length = record_length;
+
+  size_t offset = write_position & (capacity - 1);
+  if (offset + record_length <= capacity) {
+    return data + offset;
+  }
+
+  // The record wraps around the end of the buffer
+  wrap_record.resize(record_length);
+  return wrap_record.data();
+}
+
+/**
+ * @brief Publish the record serialized in the room reserved last
+ */
+void LogBuffer::PublishRecord(void) {
+  uint64_t write_position = tail.load(std::memory_order_relaxed);
+
+  size_t offset = write_position & (capacity - 1);
+  if (offset + reserved_length > capacity) {
+    CopyRecord(write_position, wrap_record.data(), reserved_length);
+  }
+
+  Publish(write_position + reserved_length);
+  reserved_length = 0;
+}
+
+/**
+ * @brief Read all the published records
+ * @param output the records are appended to it
+ * @param record_count set to the number of records read, a record published
+ * while reading may only be counted by the next read
+ * @return the number of bytes read
+ */
+size_t LogBuffer::ReadRecords(std::vector<char> &output,
+                              size_t &record_count) {
+  std::vector<struct iovec> regions;
+  size_t read_length = PeekRecords(regions, record_count);
+
+  for (auto region : regions) {
+    auto region_data = static_cast<char *>(region.iov_base);
+    output.insert(output.end(), region_data, region_data + region.iov_len);
+  }
+
+  ReleaseRecords(read_length);
+
+  return read_length;
+}
+
+/**
+ * @brief Peek at the published records which were not peeked yet
+ * The regions point into the buffer, they stay valid until their space
+ * is released.
+ * @param regions the (at most two) regions of the records are appended to it
+ * @param record_count set to the number of records peeked, a record published
+ * while peeking may only be counted by the next peek
+ * @return the number of bytes peeked
+ */
+size_t LogBuffer::PeekRecords(std::vector<struct iovec> &regions,
+                              size_t &record_count) {
+  // Load the record count before the tail, so it never counts a record
+  // which is not read
+  uint64_t write_record_count =
+      written_record_count.load(std::memory_order_acquire);
+  uint64_t write_position = tail.load(std::memory_order_acquire);
+
+  record_count = write_record_count - read_record_count;
+  read_record_count = write_record_count;
+
+  size_t read_length = write_position - read_position;
+  if (read_length == 0) {
+    return 0;
+  }
+
+  size_t offset = read_position & (capacity - 1);
+  size_t first_part_length = std::min(read_length, capacity - offset);
+  regions.push_back({data + offset, first_part_length});
+  if (read_length > first_part_length) {
+    regions.push_back({data, read_length - first_part_length});
+  }
+
+  read_position = write_position;
+
+  return read_length;
+}
+
+/**
+ * @brief Release the space of peeked records to the writer
+ * @param length bytes released, in the order they were peeked
+ */
+void LogBuffer::ReleaseRecords(size_t length) {
+  head.store(head.load(std::memory_order_relaxed) + length,
+             std::memory_order_release);
+}
+
+size_t LogBuffer::GetSize(void) const {
+  // Load the head first, the tail never falls behind it
+  uint64_t read_position = head.load(std::memory_order_acquire);
+  uint64_t write_position = tail.load(std::memory_order_acquire);
+  return write_position - read_position;
+}
+
+uint64_t LogBuffer::WaitForRoom(size_t record_length) {
+  uint64_t write_position = tail.load(std::memory_order_relaxed);
+
+  // A record larger than the whole buffer waits for the buffer to be empty,
+  // then the buffer is replaced by a larger one
+  if (record_length > capacity) {
+    while (head.load(std::memory_order_acquire) != write_position) {
+      std::this_thread::yield();
+    }
+    Grow(record_length);
+  }
+
+  // Wait for the reader to make room
+  while (write_position + record_length -
+             head.load(std::memory_order_acquire) >
+         capacity) {
+    std::this_thread::yield();
+  }
+
+  return write_position;
+}
+
+void LogBuffer::CopyRecord(uint64_t write_position, const char *record,
+                           size_t record_length) {
+  size_t offset = write_position & (capacity - 1);
+  size_t first_part_length = std::min(record_length, capacity - offset);
+  std::memcpy(data + offset, record, first_part_length);
+  std::memcpy(data, record + first_part_length,
+              record_length - first_part_length);
+}
+
+void LogBuffer::Publish(uint64_t write_position) {
+  tail.store(write_position, std::memory_order_release);
+  written_record_count.store(
+      written_record_count.load(std::memory_order_relaxed) + 1,
+      std::memory_order_release);
+}
+
+void LogBuffer::Grow(size_t record_length) {
+  // The reader only touches the data when the tail is ahead of the head,
+  // which is not the case until the next record is published
+  delete[] data;
+  capacity = GetBufferCapacity(record_length);
+  data = new char[capacity];
+}
+
+}  // namespace logging
+}  // namespace peloton
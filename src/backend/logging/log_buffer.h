@@ -0,0 +1,122 @@
+/*-------------------------------------------------------------------------
+ *
+ * logbuffer.h
+ * file description
+ *
+ * Copyright(c) 2015, CMU
+ *
+ * /peloton/src/backend/logging/logbuffer.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <sys/uio.h>
+
+#include "backend/common/types.h"
+
+// Default capacity of a backend logger's log buffer (in bytes)
+#define DEFAULT_LOG_BUFFER_CAPACITY (1 << 20)
+
+namespace peloton {
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Log Buffer
+//===--------------------------------------------------------------------===//
+
+/**
+ * Ring buffer of serialized log records between a backend logger, its only
+ * writer, and a frontend logger, its only reader. Neither side takes a lock:
+ * the writer publishes whole records by moving the tail and the reader
+ * releases the space it has read by moving the head.
+ *
+ * A record can also be serialized in place : the writer reserves it,
+ * serializes into it and publishes it. The reader can peek at the records
+ * where they are, write them out and only then release their space.
+ */
+class LogBuffer {
+ public:
+  LogBuffer(const LogBuffer &) = delete;
+  LogBuffer &operator=(const LogBuffer &) = delete;
+  LogBuffer(LogBuffer &&) = delete;
+  LogBuffer &operator=(LogBuffer &&) = delete;
+
+  explicit LogBuffer(size_t capacity = DEFAULT_LOG_BUFFER_CAPACITY);
+
+  ~LogBuffer();
+
+  // Append a serialized record, waiting for the reader to make room if needed
+  void WriteRecord(const char *record, size_t record_length);
+
+  // Reserve room for a record of the given length, waiting for the reader
+  // to make room if needed, and return where to serialize it
+  char *ReserveRecord(size_t record_length);
+
+  // Publish the record serialized in the room reserved last
+  void PublishRecord(void);
+
+  // Move the published records to the end of output, return the bytes read
+  // and set record_count to the number of records read
+  size_t ReadRecords(std::vector<char> &output, size_t &record_count);
+
+  // Append the regions of the published records not peeked yet to regions,
+  // return their bytes and set record_count to the number of records.
+  // Their space is kept until it is released.
+  size_t PeekRecords(std::vector<struct iovec> &regions, size_t &record_count);
+
+  // Release the space of the first peeked bytes to the writer
+  void ReleaseRecords(size_t length);
+
+  // Bytes written but not read yet
+  size_t GetSize(void) const;
+
+  size_t GetCapacity(void) const { return capacity; }
+
+ private:
+  // Wait for room for a record of the given length, return its position
+  uint64_t WaitForRoom(size_t record_length);
+
+  // Copy a record at the given position, wrapping around the end
+  void CopyRecord(uint64_t write_position, const char *record,
+                  size_t record_length);
+
+  // Make the record ending at the given position visible to the reader
+  void Publish(uint64_t write_position);
+
+  // Replace the (empty) buffer by one that can hold the given record
+  void Grow(size_t record_length);
+
+  char *data;
+
+  // always a power of two
+  size_t capacity;
+
+  // bytes read so far, only moved by the reader
+  std::atomic<uint64_t> head;
+
+  // bytes written so far, only moved by the writer
+  std::atomic<uint64_t> tail;
+
+  // records written so far, moved after the tail
+  std::atomic<uint64_t> written_record_count;
+
+  // records read so far, only used by the reader
+  uint64_t read_record_count;
+
+  // bytes peeked so far, only used by the reader
+  uint64_t read_position;
+
+  // length of the reserved record, only used by the writer
+  size_t reserved_length;
+
+  // A reserved record which wraps around the end of the buffer is
+  // serialized here and copied at once when it is published
+  std::vector<char> wrap_record;
+};
+
+}  // namespace logging
+}  // namespace peloton
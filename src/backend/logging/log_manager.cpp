@@ -10,6 +10,10 @@
  *-------------------------------------------------------------------------
  */
 
+#include <algorithm>
+#include <thread>
+#include <unistd.h>
+
 #include "backend/logging/log_manager.h"
 #include "backend/common/logger.h"
 
@@ -24,7 +28,7 @@ LogManager &LogManager::GetInstance() {
   return log_manager;
 }
 
-LogManager::LogManager() {}
+LogManager::LogManager() : next_log_stream_id(0), log_segment_id(0) {}
 
 LogManager::~LogManager() {}
 
@@ -34,22 +38,61 @@ LogManager::~LogManager() {}
  * @param logging type can be stdout(debug), aries, peloton
  */
 void LogManager::StartStandbyMode() {
-  // If frontend logger doesn't exist
-  if (frontend_logger == nullptr) {
-    frontend_logger = FrontendLogger::GetFrontendLogger(peloton_logging_mode);
-  }
+  // If frontend loggers don't exist
+  if (frontend_loggers.empty()) {
+    // Keep appending to the log segment written before the restart
+    if (IsSimilarToARIES(peloton_logging_mode)) {
+      log_segment_id = GetLastLogSegmentId();
+    }
+
+    auto log_stream_count = GetLogStreamCount();
+    for (oid_t log_stream_id = 0; log_stream_id < log_stream_count;
+         log_stream_id++) {
+      auto frontend_logger =
+          FrontendLogger::GetFrontendLogger(peloton_logging_mode, log_stream_id);
 
-  // If frontend logger still doesn't exist, then we disabled logging
-  if (frontend_logger == nullptr) {
-    LOG_INFO("We have disabled logging");
-    return;
+      // If frontend logger still doesn't exist, then we disabled logging
+      if (frontend_logger == nullptr) {
+        LOG_INFO("We have disabled logging");
+        return;
+      }
+
+      frontend_loggers.push_back(frontend_logger);
+    }
   }
 
   // Toggle status in log manager map
   SetLoggingStatus(LOGGING_STATUS_TYPE_STANDBY);
 
-  // Launch the frontend logger's main loop
-  frontend_logger->MainLoop();
+  // Launch the frontend loggers' main loops, the first one in this thread
+  std::vector<std::thread> log_stream_threads;
+  for (oid_t log_stream_id = 1; log_stream_id < frontend_loggers.size();
+       log_stream_id++) {
+    log_stream_threads.push_back(std::thread(
+        &FrontendLogger::MainLoop, frontend_loggers[log_stream_id]));
+  }
+
+  // and the background checkpointer if needed
+  std::thread checkpointer_thread;
+  if (IsSimilarToARIES(peloton_logging_mode) &&
+      peloton_checkpoint_interval > 0) {
+    checkpointer_thread = std::thread(&Checkpointer::MainLoop, &checkpointer);
+  }
+
+  frontend_loggers[0]->MainLoop();
+
+  for (auto &log_stream_thread : log_stream_threads) {
+    log_stream_thread.join();
+  }
+
+  if (checkpointer_thread.joinable()) {
+    checkpointer_thread.join();
+  }
+
+  LOG_TRACE("Frontendlogger] Sleep Mode");
+
+  // Setting frontend logger status to sleep
+  SetLoggingStatus(LOGGING_STATUS_TYPE_SLEEP);
 }
 
 void LogManager::StartRecoveryMode() {
@@ -126,15 +169,18 @@ BackendLogger *LogManager::GetBackendLogger() {
   // if so, create backend logger and store it in frontend logger
   {
     // If frontend logger exists
-    if (frontend_logger != nullptr) {
+    if (frontend_loggers.empty() == false) {
       backend_logger = BackendLogger::GetBackendLogger(peloton_logging_mode);
       if (!backend_logger->IsConnectedToFrontend()) {
-        frontend_logger->AddBackendLogger(backend_logger);
+        // Spread the backend loggers over the log streams
+        oid_t log_stream_id = next_log_stream_id++ % frontend_loggers.size();
+        backend_logger->SetLogStreamId(log_stream_id);
+        frontend_loggers[log_stream_id]->AddBackendLogger(backend_logger);
       }
     }
   }
 
-  if (frontend_logger == nullptr) {
+  if (frontend_loggers.empty()) {
     LOG_ERROR("Frontend logger doesn't exist!!");
   }
 
@@ -148,27 +194,110 @@ bool LogManager::RemoveBackendLogger(BackendLogger *backend_logger) {
   // if so, remove backend logger otherwise return false
   {
     // If frontend logger exists
-    if (frontend_logger != nullptr) {
-      status = frontend_logger->RemoveBackendLogger(backend_logger);
+    if (frontend_loggers.empty() == false) {
+      auto log_stream_id = backend_logger->GetLogStreamId();
+      assert(log_stream_id < frontend_loggers.size());
+      status = frontend_loggers[log_stream_id]->RemoveBackendLogger(
+          backend_logger);
     }
   }
 
   return status;
 }
 
+GroupCommitStats LogManager::GetGroupCommitStats(void) {
+  GroupCommitStats group_commit_stats;
+
+  for (auto frontend_logger : frontend_loggers) {
+    group_commit_stats.Merge(frontend_logger->GetGroupCommitStats());
+  }
+
+  return group_commit_stats;
+}
+
 /**
- * @brief Find Frontend Logger in Log Manager
- * @param logging type can be stdout(debug), aries, peloton
- * @return the frontend logger otherwise nullptr
+ * @brief Get the number of log streams
+ * Only ARIES logging writes several log streams
+ * @return the number of log streams
+ */
+size_t LogManager::GetLogStreamCount(void) const {
+  if (IsSimilarToARIES(peloton_logging_mode) && peloton_log_stream_count > 1) {
+    return peloton_log_stream_count;
+  }
+
+  return 1;
+}
+
+/**
+ * @brief Get the number of threads replaying the log during recovery
+ * @return the configured count, or else the number of cores
  */
-FrontendLogger *LogManager::GetFrontendLogger() { return frontend_logger; }
+size_t LogManager::GetRecoveryThreadCount(void) const {
+  if (peloton_recovery_thread_count > 0) {
+    return peloton_recovery_thread_count;
+  }
+
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/**
+ * @brief Get the oldest log segment still written by a frontend logger
+ * @return the log segment id
+ */
+oid_t LogManager::GetWrittenLogSegmentId(void) {
+  oid_t written_log_segment_id = log_segment_id;
+
+  for (auto frontend_logger : frontend_loggers) {
+    written_log_segment_id =
+        std::min(written_log_segment_id, frontend_logger->GetLogSegmentId());
+  }
+
+  return written_log_segment_id;
+}
+
+/**
+ * @brief Get the oldest txn being logged by a backend logger
+ * @return its txn id, or MAX_TXN_ID if no txn is being logged
+ */
+txn_id_t LogManager::GetOldestActiveTransactionId(void) {
+  txn_id_t oldest_txn_id = MAX_TXN_ID;
+
+  for (auto frontend_logger : frontend_loggers) {
+    oldest_txn_id = std::min(oldest_txn_id,
+                             frontend_logger->GetOldestActiveTransactionId());
+  }
+
+  return oldest_txn_id;
+}
+
+/**
+ * @brief Get the last log segment written before the restart
+ * The log segments from the one of the last checkpoint on are kept, and
+ * a later one may have been started by a checkpoint which did not finish.
+ * @return the log segment id
+ */
+oid_t LogManager::GetLastLogSegmentId(void) {
+  oid_t last_log_segment_id = 0;
+  cid_t checkpoint_cid = INVALID_CID;
+  checkpointer.ReadCheckpointHeader(last_log_segment_id, checkpoint_cid);
+
+  while (access(GetLogSegmentFileName(0, last_log_segment_id + 1).c_str(),
+                F_OK) == 0) {
+    last_log_segment_id++;
+  }
+
+  return last_log_segment_id;
+}
 
 bool LogManager::RemoveFrontendLogger() {
-  // Erase frontend logger
-  delete frontend_logger;
+  // Erase frontend loggers
+  for (auto frontend_logger : frontend_loggers) {
+    delete frontend_logger;
+  }
 
   // Reset
-  frontend_logger = nullptr;
+  frontend_loggers.clear();
+  next_log_stream_id = 0;
 
   return true;
 }
@@ -184,7 +313,7 @@ void LogManager::ResetLoggingStatusMap() {
 }
 
 size_t LogManager::ActiveFrontendLoggerCount(void) {
-  return (frontend_logger != nullptr);
+  return frontend_loggers.size();
 }
 
 /**
@@ -228,5 +357,27 @@ std::string LogManager::GetLogFileName(void) {
   return log_file_name;
 }
 
+std::string LogManager::GetLogStreamFileName(oid_t log_stream_id) {
+  if (log_stream_id == 0) {
+    return GetLogFileName();
+  }
+
+  return GetLogFileName() + "." + std::to_string(log_stream_id);
+}
+
+std::string LogManager::GetLogSegmentFileName(oid_t log_stream_id,
+                                              oid_t log_segment_id) {
+  if (log_segment_id == 0) {
+    return GetLogStreamFileName(log_stream_id);
+  }
+
+  return GetLogStreamFileName(log_stream_id) + "_" +
+         std::to_string(log_segment_id);
+}
+
+std::string LogManager::GetCheckpointFileName(void) {
+  return GetLogFileName() + ".checkpoint";
+}
+
 }  // namespace logging
 }  // namespace peloton
@@ -13,12 +13,14 @@
 #pragma once
 
 #include "backend/logging/logger.h"
+#include <atomic>
 #include <mutex>
 #include <map>
 #include <vector>
 #include <condition_variable>
 
 #include "backend_logger.h"
+#include "checkpointer.h"
 #include "frontend_logger.h"
 
 //===--------------------------------------------------------------------===//
@@ -30,6 +32,15 @@ extern LoggingType peloton_logging_mode;
 // Directory for peloton logs
 extern char *peloton_log_directory;
 
+// Number of log streams (i.e. log files) written in parallel
+extern int peloton_log_stream_count;
+
+// Number of threads replaying the log during recovery (0 : one per core)
+extern int peloton_recovery_thread_count;
+
+// Interval between checkpoints in seconds (0 : no background checkpoints)
+extern int peloton_checkpoint_interval;
+
 namespace peloton {
 namespace logging {
 
@@ -94,10 +105,40 @@ class LogManager {
 
   bool RemoveBackendLogger(BackendLogger *backend_logger);
 
+  // Group commit counters of all the log streams
+  GroupCommitStats GetGroupCommitStats(void);
+
   void SetLogFileName(std::string log_file);
 
   std::string GetLogFileName(void);
 
+  // Log file of the given log stream, the first stream uses the log file
+  std::string GetLogStreamFileName(oid_t log_stream_id);
+
+  // Number of threads replaying the log during recovery
+  size_t GetRecoveryThreadCount(void) const;
+
+  // Log file of the given log stream and log segment, the first segment
+  // uses the log file of the stream
+  std::string GetLogSegmentFileName(oid_t log_stream_id, oid_t log_segment_id);
+
+  // Log segment the frontend loggers switch to
+  oid_t GetLogSegmentId(void) const { return log_segment_id; }
+
+  void SetLogSegmentId(oid_t log_segment_id_) {
+    log_segment_id = log_segment_id_;
+  }
+
+  // Oldest log segment still written by a frontend logger
+  oid_t GetWrittenLogSegmentId(void);
+
+  // Oldest txn being logged, MAX_TXN_ID if none
+  txn_id_t GetOldestActiveTransactionId(void);
+
+  std::string GetCheckpointFileName(void);
+
+  Checkpointer &GetCheckpointer(void) { return checkpointer; }
+
   bool HasPelotonFrontendLogger() const {
     return (peloton_logging_mode == LOGGING_TYPE_NVM_NVM);
   }
@@ -110,7 +151,10 @@ class LogManager {
   // Utility Functions
   //===--------------------------------------------------------------------===//
 
-  FrontendLogger *GetFrontendLogger();
+  size_t GetLogStreamCount(void) const;
+
+  // Last log segment written before the restart
+  oid_t GetLastLogSegmentId(void);
 
   bool RemoveFrontendLogger();
 
@@ -118,8 +162,18 @@ class LogManager {
   // Data members
   //===--------------------------------------------------------------------===//
 
-  // There is only one frontend_logger of a given type -- stdout, aries, peloton
-  FrontendLogger *frontend_logger = nullptr;
+  // Frontend loggers of a given type -- stdout, aries, peloton
+  // one per log stream, backend loggers are spread over them
+  std::vector<FrontendLogger *> frontend_loggers;
+
+  // Log stream of the next backend logger
+  std::atomic<oid_t> next_log_stream_id;
+
+  // Log segment the frontend loggers write to
+  std::atomic<oid_t> log_segment_id;
+
+  // Takes the checkpoints of ARIES logging
+  Checkpointer checkpointer;
 
   LoggingStatus logging_status = LOGGING_STATUS_TYPE_INVALID;
 
@@ -19,6 +19,7 @@
  *     - HEADER
  *       - Header length         : int
  *       - Transaction Id        : txn_id_t
+ *       - Commit Id             : cid_t (ARIES commit records only)
  *
  *     Tuple Record :
  *       - LogRecordType         : enum
@@ -16,6 +16,7 @@
 #include "backend/logging/records/tuple_record.h"
 #include "backend/logging/log_manager.h"
 #include "backend/logging/frontend_logger.h"
+#include "backend/storage/tuple.h"
 
 namespace peloton {
 namespace logging {
@@ -30,13 +31,36 @@ AriesBackendLogger *AriesBackendLogger::GetInstance() {
  * @param log record
  */
 void AriesBackendLogger::Log(LogRecord *record) {
-  // Enqueue the serialized log record into the queue
+  // Track the txn before its first log record can be collected
+  if (record->GetType() == LOGRECORD_TYPE_TRANSACTION_BEGIN) {
+    active_txn_id = record->GetTransactionId();
+  }
+
+  // Enqueue the serialized log record into the log buffer
   record->Serialize(output_buffer);
+  log_buffer->WriteRecord(output_buffer.Data(), output_buffer.Size());
+  logged_lsn += output_buffer.Size();
 
-  {
-    std::lock_guard<std::mutex> lock(local_queue_mutex);
-    local_queue.push_back(record);
+  if (record->GetType() == LOGRECORD_TYPE_TRANSACTION_END) {
+    active_txn_id = INVALID_TXN_ID;
   }
+
+  delete record;
+}
+
+/**
+ * @brief Collect the serialized log records, the frontend logger will
+ * release them and call our Commit once they are flushed
+ * @param frontend_regions the regions of the log records are appended to it
+ * @param record_count set to the number of log records collected
+ * @return the number of bytes collected
+ */
+size_t AriesBackendLogger::CollectLogRecords(
+    std::vector<struct iovec> &frontend_regions, size_t &record_count) {
+  auto collected_size = log_buffer->PeekRecords(frontend_regions, record_count);
+  collected_lsn += collected_size;
+
+  return collected_size;
 }
 
 LogRecord *AriesBackendLogger::GetTupleRecord(LogRecordType log_record_type,
@@ -45,33 +69,69 @@ LogRecord *AriesBackendLogger::GetTupleRecord(LogRecordType log_record_type,
                                               ItemPointer delete_location,
                                               void *data, oid_t db_oid) {
   // Build the log record
-  switch (log_record_type) {
-    case LOGRECORD_TYPE_TUPLE_INSERT: {
-      log_record_type = LOGRECORD_TYPE_ARIES_TUPLE_INSERT;
-      break;
-    }
-
-    case LOGRECORD_TYPE_TUPLE_DELETE: {
-      log_record_type = LOGRECORD_TYPE_ARIES_TUPLE_DELETE;
-      break;
-    }
-
-    case LOGRECORD_TYPE_TUPLE_UPDATE: {
-      log_record_type = LOGRECORD_TYPE_ARIES_TUPLE_UPDATE;
-      break;
-    }
-
-    default: {
-      assert(false);
-      break;
-    }
+  LogRecord *record = new TupleRecord(GetAriesTupleRecordType(log_record_type),
+                                      txn_id, table_oid, insert_location,
+                                      delete_location, data, db_oid);
+
+  return record;
+}
+
+/**
+ * @brief Serialize a tuple record in place in the log buffer, it is the
+ * same as logging the record built by GetTupleRecord without building it
+ * nor copying its serialization
+ */
+void AriesBackendLogger::LogTupleRecord(LogRecordType log_record_type,
+                                        txn_id_t txn_id, oid_t table_oid,
+                                        ItemPointer insert_location,
+                                        ItemPointer delete_location,
+                                        void *data, oid_t db_oid) {
+  assert(txn_id);
+  assert(table_oid);
+
+  log_record_type = GetAriesTupleRecordType(log_record_type);
+  if (db_oid == INVALID_OID) {
+    db_oid = bridge::Bridge::GetCurrentDatabaseOid();
   }
+  assert(db_oid);
 
-  LogRecord *record =
-      new TupleRecord(log_record_type, txn_id, table_oid, insert_location,
-                      delete_location, data, db_oid);
+  // Deleted tuples are not serialized
+  storage::Tuple *tuple = nullptr;
+  size_t record_length = TupleRecord::GetTupleRecordSize();
+  if (log_record_type != LOGRECORD_TYPE_ARIES_TUPLE_DELETE) {
+    tuple = static_cast<storage::Tuple *>(data);
+    record_length += tuple->GetSerializedSize();
+  }
 
-  return record;
+  ReferenceSerializeOutput output(log_buffer->ReserveRecord(record_length),
+                                  record_length);
+  TupleRecord::SerializeHeader(output, log_record_type, db_oid, table_oid,
+                               txn_id, insert_location, delete_location);
+  if (tuple != nullptr) {
+    tuple->SerializeTo(output);
+  }
+  assert(output.Size() == record_length);
+
+  log_buffer->PublishRecord();
+  logged_lsn += record_length;
+}
+
+LogRecordType AriesBackendLogger::GetAriesTupleRecordType(
+    LogRecordType log_record_type) {
+  switch (log_record_type) {
+    case LOGRECORD_TYPE_TUPLE_INSERT:
+      return LOGRECORD_TYPE_ARIES_TUPLE_INSERT;
+
+    case LOGRECORD_TYPE_TUPLE_DELETE:
+      return LOGRECORD_TYPE_ARIES_TUPLE_DELETE;
+
+    case LOGRECORD_TYPE_TUPLE_UPDATE:
+      return LOGRECORD_TYPE_ARIES_TUPLE_UPDATE;
+
+    default:
+      assert(false);
+      return log_record_type;
+  }
 }
 
 }  // namespace logging
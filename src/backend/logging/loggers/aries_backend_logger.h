@@ -12,7 +12,11 @@
 
 #pragma once
 
+#include <memory>
+#include <sys/uio.h>
+
 #include "backend/logging/backend_logger.h"
+#include "backend/logging/log_buffer.h"
 
 namespace peloton {
 namespace logging {
@@ -32,17 +36,38 @@ class AriesBackendLogger : public BackendLogger {
 
   void Log(LogRecord *record);
 
-  void TruncateLocalQueue(oid_t offset);
+  // Append the regions of the serialized log records to the frontend
+  // logger's regions, their space is released once they are flushed
+  size_t CollectLogRecords(std::vector<struct iovec> &frontend_regions,
+                           size_t &record_count);
 
   LogRecord *GetTupleRecord(LogRecordType log_record_type, txn_id_t txn_id,
                             oid_t table_oid, ItemPointer insert_location,
                             ItemPointer delete_location, void *data = nullptr,
                             oid_t db_oid = INVALID_OID);
 
+  // Serialize the tuple record directly into the log buffer
+  void LogTupleRecord(LogRecordType log_record_type, txn_id_t txn_id,
+                      oid_t table_oid, ItemPointer insert_location,
+                      ItemPointer delete_location, void *data = nullptr,
+                      oid_t db_oid = INVALID_OID);
+
+  // The frontend logger keeps the log buffer while it holds collected
+  // regions, even if this backend goes away
+  std::shared_ptr<LogBuffer> GetLogBuffer(void) const { return log_buffer; }
+
  private:
-  AriesBackendLogger() { logging_type = LOGGING_TYPE_DRAM_NVM; }
+  AriesBackendLogger() : log_buffer(std::make_shared<LogBuffer>()) {
+    logging_type = LOGGING_TYPE_DRAM_NVM;
+  }
+
+  static LogRecordType GetAriesTupleRecordType(LogRecordType log_record_type);
 
   CopySerializeOutput output_buffer;
+
+  // Serialized log records, the frontend logger collects them without
+  // blocking this backend
+  std::shared_ptr<LogBuffer> log_buffer;
 };
 
 }  // namespace logging
@@ -10,8 +10,15 @@
  *-------------------------------------------------------------------------
  */
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <limits>
+#include <thread>
 #include <sys/stat.h>
 #include <sys/mman.h>
+#include <unistd.h>
 
 #include "backend/catalog/manager.h"
 #include "backend/catalog/schema.h"
@@ -37,6 +44,8 @@ namespace logging {
 
 size_t GetLogFileSize(int log_file_fd);
 
+bool WriteLogRecords(int log_file_fd, std::vector<struct iovec> &log_records);
+
 bool IsFileTruncated(FILE *log_file, size_t size_to_read, size_t log_file_size);
 
 size_t GetNextFrameSize(FILE *log_file, size_t log_file_size);
@@ -53,12 +62,14 @@ storage::Tuple *ReadTupleRecordBody(catalog::Schema *schema, VarlenPool *pool,
                                     FILE *log_file, size_t log_file_size);
 
 // Wrappers
-storage::DataTable *GetTable(TupleRecord tupleRecord);
+storage::DataTable *GetTable(const TupleRecord &tuple_record);
 
 /**
  * @brief Open logfile and file descriptor
+ * @param log stream written by this frontend logger
  */
-AriesFrontendLogger::AriesFrontendLogger() {
+AriesFrontendLogger::AriesFrontendLogger(oid_t log_stream_id)
+    : FrontendLogger(log_stream_id) {
   logging_type = LOGGING_TYPE_DRAM_NVM;
 
   LOG_INFO("Log File Name :: %s", GetLogFileName().c_str());
@@ -75,9 +86,6 @@ AriesFrontendLogger::AriesFrontendLogger() {
   if (log_file_fd == -1) {
     LOG_ERROR("log_file_fd is -1");
   }
-
-  // allocate pool
-  recovery_pool = new VarlenPool(BACKEND_TYPE_MM);
 }
 
 /**
@@ -93,38 +101,52 @@ AriesFrontendLogger::~AriesFrontendLogger() {
   if (ret != 0) {
     LOG_ERROR("Error occured while closing LogFile");
   }
+}
+
+/**
+ * @brief Collect the serialized log records of an ARIES backend logger
+ * @param backend logger
+ */
+void AriesFrontendLogger::CollectLogRecordsFromBackendLogger(
+    BackendLogger *backend_logger) {
+  auto aries_backend_logger = static_cast<AriesBackendLogger *>(backend_logger);
+
+  size_t record_count = 0;
+  auto collected_size =
+      aries_backend_logger->CollectLogRecords(log_records, record_count);
+  if (collected_size > 0) {
+    collected_log_buffers.emplace_back(aries_backend_logger->GetLogBuffer(),
+                                       collected_size);
+  }
 
-  // clean up pool
-  delete recovery_pool;
+  pending_log_size += collected_size;
+  pending_record_count += record_count;
 }
 
 /**
  * @brief flush all the log records to the file
  */
 void AriesFrontendLogger::FlushLogRecords(void) {
-  // First, write all the record in the queue
-  for (auto record : global_queue) {
-    fwrite(record->GetMessage(), sizeof(char), record->GetMessageLength(),
-           log_file);
-  }
-
-  // Then, flush
-  int ret = fflush(log_file);
-  if (ret != 0) {
-    LOG_ERROR("Error occured in fflush(%d)", ret);
-  }
+  // Nothing to flush, but the backend loggers may wait for an earlier flush
+  if (log_records.empty() == false) {
+    // First, write all the records at once, straight from the log buffers
+    if (WriteLogRecords(log_file_fd, log_records) == false) {
+      LOG_ERROR("Error occured in writev(%d)", errno);
+    }
 
-  // Finally, sync
-  ret = fsync(log_file_fd);
-  if (ret != 0) {
-    LOG_ERROR("Error occured in fsync(%d)", ret);
-  }
+    // The backend loggers can reuse the space of the written records
+    for (auto &collected_log_buffer : collected_log_buffers) {
+      collected_log_buffer.first->ReleaseRecords(collected_log_buffer.second);
+    }
+    collected_log_buffers.clear();
+    log_records.clear();
 
-  // Clean up the frontend logger's queue
-  for (auto record : global_queue) {
-    delete record;
+    // Finally, sync
+    int ret = fsync(log_file_fd);
+    if (ret != 0) {
+      LOG_ERROR("Error occured in fsync(%d)", ret);
+    }
   }
-  global_queue.clear();
 
   // Commit each backend logger
   {
@@ -139,122 +161,249 @@ void AriesFrontendLogger::FlushLogRecords(void) {
 // Recovery
 //===--------------------------------------------------------------------===//
 
+AriesFrontendLogger::RecoveryRecord::RecoveryRecord(
+    const TupleRecord &tuple_record, storage::Tuple *tuple)
+    : tuple_record(tuple_record), tuple(tuple) {}
+
+AriesFrontendLogger::RecoveryLogStream::RecoveryLogStream(
+    oid_t log_stream_id)
+    : recovery_pool(new VarlenPool(BACKEND_TYPE_MM)),
+      log_stream_id(log_stream_id) {}
+
 /**
- * @brief Recovery system based on log file
+ * @brief Recovery system based on the checkpoint and the log files of all
+ * the log streams
+ * The checkpoint is loaded first, then only the log segments from the one
+ * it started are read, and the txns it already holds are skipped.
+ * Each log stream holds the whole txns of its backend loggers, but the txns
+ * of different streams interleave. So, the streams are read in parallel and
+ * the committed txns are replayed in commit id order once all of them are
+ * read, by replay workers which own disjoint sets of tile groups.
  */
 void AriesFrontendLogger::DoRecovery() {
+  auto &log_manager = LogManager::GetInstance();
+  auto recovery_start_time = std::chrono::steady_clock::now();
+
+  // Load the checkpoint if any
+  oid_t checkpoint_id = 0;
+  cid_t checkpoint_cid = INVALID_CID;
+  oid_t max_tile_group_id = 0;
+  bool checkpoint_loaded = log_manager.GetCheckpointer().LoadCheckpoint(
+      checkpoint_id, checkpoint_cid, max_tile_group_id);
+  if (checkpoint_loaded) {
+    max_oid = std::max(max_oid, max_tile_group_id);
+  }
+
+  // Go over the streams until the next one has no log segment to read,
+  // which includes the streams of an earlier run with more streams
+  oid_t first_log_segment_id = checkpoint_loaded ? checkpoint_id : 0;
+
+  std::vector<std::unique_ptr<RecoveryLogStream>> log_streams;
+  for (oid_t log_stream_itr = 0;; log_stream_itr++) {
+    bool log_stream_exists = false;
+    for (oid_t log_segment_itr = first_log_segment_id;
+         log_segment_itr <= log_segment_id; log_segment_itr++) {
+      auto log_segment_file_name =
+          log_manager.GetLogSegmentFileName(log_stream_itr, log_segment_itr);
+      if (access(log_segment_file_name.c_str(), F_OK) == 0) {
+        log_stream_exists = true;
+        break;
+      }
+    }
+
+    if (log_stream_exists == false) {
+      break;
+    }
+
+    log_streams.emplace_back(new RecoveryLogStream(log_stream_itr));
+  }
+
+  // Parse the streams in parallel, one reader thread per stream
+  std::vector<std::thread> reader_threads;
+  for (auto &log_stream : log_streams) {
+    reader_threads.emplace_back(&AriesFrontendLogger::ReadLogStream, this,
+                                std::ref(*log_stream), first_log_segment_id);
+  }
+  for (auto &reader_thread : reader_threads) {
+    reader_thread.join();
+  }
+
+  // Merge the committed txns of the streams,
+  // declared after the streams so that it is dropped before their pools
+  CommittedTxnList committed_txn_list;
+  size_t recovered_log_size = 0;
+  size_t recovered_record_count = 0;
+
+  for (auto &log_stream : log_streams) {
+    // Abort ACTIVE transactions in the recovery txn table
+    AbortActiveTransactions(*log_stream);
+
+    // The txns committed up to the checkpoint are already restored
+    for (auto &committed_txn : log_stream->committed_txn_list) {
+      if (checkpoint_loaded && committed_txn.first <= checkpoint_cid) {
+        continue;
+      }
+      committed_txn_list.push_back(std::move(committed_txn));
+    }
+    log_stream->committed_txn_list.clear();
+
+    recovered_log_size += log_stream->log_size;
+    recovered_record_count += log_stream->record_count;
+  }
+
+  // Go over the committed transactions if needed
+  bool replayed = (committed_txn_list.empty() == false);
+  if (replayed) {
+    ReplayCommittedTransactions(committed_txn_list);
+  }
+
+  if (checkpoint_loaded || replayed) {
+    // After finishing recovery, set the next oid with maximum oid
+    // observed during the recovery
+    auto &manager = catalog::Manager::GetInstance();
+    manager.SetNextOid(max_oid);
+  }
+
+  // Report the recovery throughput
+  std::chrono::duration<double> recovery_duration =
+      std::chrono::steady_clock::now() - recovery_start_time;
+  double recovery_seconds =
+      std::max(recovery_duration.count(), std::numeric_limits<double>::min());
+
+  LOG_INFO(
+      "Recovered %lu log records (%lu bytes) of %lu log streams in %.3f s :: "
+      "%.2f MB/s %.2f records/s",
+      recovered_record_count, recovered_log_size, log_streams.size(),
+      recovery_duration.count(),
+      recovered_log_size / recovery_seconds / (1024 * 1024),
+      recovered_record_count / recovery_seconds);
+}
+
+/**
+ * @brief Read the log segments of a log stream into its recovery table
+ * Only touches the given stream, so that streams can be read in parallel.
+ * A txn may span consecutive segments of its stream.
+ * @param log stream
+ * @param first log segment to read
+ */
+void AriesFrontendLogger::ReadLogStream(RecoveryLogStream &log_stream,
+                                        oid_t first_log_segment_id) {
+  auto &log_manager = LogManager::GetInstance();
+
+  for (oid_t log_segment_itr = first_log_segment_id;
+       log_segment_itr <= log_segment_id; log_segment_itr++) {
+    auto log_segment_file_name = log_manager.GetLogSegmentFileName(
+        log_stream.log_stream_id, log_segment_itr);
+
+    // The stream may not have been written in every segment
+    log_stream.log_file = fopen(log_segment_file_name.c_str(), "rb");
+    if (log_stream.log_file == NULL) {
+      continue;
+    }
+
+    ReadLogSegment(log_stream);
+
+    fclose(log_stream.log_file);
+    log_stream.log_file = nullptr;
+  }
+}
+
+/**
+ * @brief Read the log records of the log segment being read
+ * @param log stream
+ */
+void AriesFrontendLogger::ReadLogSegment(RecoveryLogStream &log_stream) {
   // Set log file size
-  log_file_size = GetLogFileSize(log_file_fd);
+  log_stream.log_file_size = GetLogFileSize(fileno(log_stream.log_file));
+  log_stream.log_size += log_stream.log_file_size;
 
   // Go over the log size if needed
-  if (log_file_size > 0) {
+  if (log_stream.log_file_size > 0) {
     bool reached_end_of_file = false;
 
-    // Start the recovery transaction
-    auto &txn_manager = concurrency::TransactionManager::GetInstance();
-
-    // Although we call BeginTransaction here, recovery txn will not be
-    // recoreded in log file since we are in recovery mode
-    auto recovery_txn = txn_manager.BeginTransaction();
-
     // Go over each log record in the log file
     while (reached_end_of_file == false) {
       // Read the first byte to identify log record type
       // If that is not possible, then wrap up recovery
-      auto record_type = GetNextLogRecordType(log_file, log_file_size);
+      auto record_type = GetNextLogRecordType(log_stream.log_file,
+                                              log_stream.log_file_size);
 
       switch (record_type) {
         case LOGRECORD_TYPE_TRANSACTION_BEGIN:
-          AddTransactionToRecoveryTable();
+          AddTransactionToRecoveryTable(log_stream);
           break;
 
         case LOGRECORD_TYPE_TRANSACTION_END:
-          RemoveTransactionFromRecoveryTable();
+          RemoveTransactionFromRecoveryTable(log_stream);
           break;
 
         case LOGRECORD_TYPE_TRANSACTION_COMMIT:
-          MoveCommittedTuplesToRecoveryTxn(recovery_txn);
+          CommitTransactionInRecoveryTable(log_stream);
           break;
 
         case LOGRECORD_TYPE_TRANSACTION_ABORT:
-          AbortTuplesFromRecoveryTable();
+          AbortTransactionInRecoveryTable(log_stream);
           break;
 
         case LOGRECORD_TYPE_ARIES_TUPLE_INSERT:
-          InsertTuple(recovery_txn);
-          break;
-
         case LOGRECORD_TYPE_ARIES_TUPLE_DELETE:
-          DeleteTuple(recovery_txn);
-          break;
-
         case LOGRECORD_TYPE_ARIES_TUPLE_UPDATE:
-          UpdateTuple(recovery_txn);
+          AddTupleRecordToRecoveryTable(log_stream, record_type);
           break;
 
         default:
           reached_end_of_file = true;
           break;
       }
-    }
-
-    // Commit the recovery transaction
-    txn_manager.CommitTransaction();
-
-    // Finally, abort ACTIVE transactions in recovery_txn_table
-    AbortActiveTransactions();
 
-    // After finishing recovery, set the next oid with maximum oid
-    // observed during the recovery
-    auto &manager = catalog::Manager::GetInstance();
-    manager.SetNextOid(max_oid);
+      if (reached_end_of_file == false) {
+        log_stream.record_count++;
+      }
+    }
   }
 }
 
 /**
  * @brief Add new txn to recovery table
+ * @param log stream
  */
-void AriesFrontendLogger::AddTransactionToRecoveryTable() {
+void AriesFrontendLogger::AddTransactionToRecoveryTable(
+    RecoveryLogStream &log_stream) {
   // read transaction information from the log file
   TransactionRecord txn_record(LOGRECORD_TYPE_TRANSACTION_BEGIN);
 
   // Check for torn log write
-  if (ReadTransactionRecordHeader(txn_record, log_file, log_file_size) ==
-      false) {
+  if (ReadTransactionRecordHeader(txn_record, log_stream.log_file,
+                                  log_stream.log_file_size) == false) {
     return;
   }
 
   auto txn_id = txn_record.GetTransactionId();
 
-  // create the new txn object and added it into recovery recovery_txn_table
-  concurrency::Transaction *txn =
-      new concurrency::Transaction(txn_id, INVALID_CID);
-  recovery_txn_table.insert(std::make_pair(txn_id, txn));
+  // add an empty list of tuple records for the txn
+  log_stream.recovery_txn_table[txn_id];
   LOG_TRACE("Added txd id %d object in table", (int)txn_id);
 }
 
 /**
  * @brief Remove txn from recovery table
+ * @param log stream
  */
-void AriesFrontendLogger::RemoveTransactionFromRecoveryTable() {
+void AriesFrontendLogger::RemoveTransactionFromRecoveryTable(
+    RecoveryLogStream &log_stream) {
   // read transaction information from the log file
   TransactionRecord txn_record(LOGRECORD_TYPE_TRANSACTION_END);
 
   // Check for torn log write
-  if (ReadTransactionRecordHeader(txn_record, log_file, log_file_size) ==
-      false) {
+  if (ReadTransactionRecordHeader(txn_record, log_stream.log_file,
+                                  log_stream.log_file_size) == false) {
     return;
   }
 
   auto txn_id = txn_record.GetTransactionId();
 
-  // remove txn from recovery txn table
-  if (recovery_txn_table.find(txn_id) != recovery_txn_table.end()) {
-    auto txn = recovery_txn_table.at(txn_id);
-    recovery_txn_table.erase(txn_id);
-
-    // drop the txn as well
-    delete txn;
+  // remove txn from recovery txn table, committed txns are already gone
+  if (log_stream.recovery_txn_table.erase(txn_id) > 0) {
     LOG_TRACE("Erase txd id %d object in table", (int)txn_id);
   } else {
     LOG_TRACE("Erase txd id %d not found in recovery txn table", (int)txn_id);
@@ -262,27 +411,28 @@ void AriesFrontendLogger::RemoveTransactionFromRecoveryTable() {
 }
 
 /**
- * @brief move tuples from current txn to recovery txn so that we can commit
- * them later
- * @param recovery txn
+ * @brief move the tuple records of a committed txn to the committed txns,
+ * so that we can replay them later in commit order
+ * @param log stream
  */
-void AriesFrontendLogger::MoveCommittedTuplesToRecoveryTxn(
-    concurrency::Transaction *recovery_txn) {
+void AriesFrontendLogger::CommitTransactionInRecoveryTable(
+    RecoveryLogStream &log_stream) {
   // read transaction information from the log file
   TransactionRecord txn_record(LOGRECORD_TYPE_TRANSACTION_COMMIT);
 
   // Check for torn log write
-  if (ReadTransactionRecordHeader(txn_record, log_file, log_file_size) ==
-      false) {
+  if (ReadTransactionRecordHeader(txn_record, log_stream.log_file,
+                                  log_stream.log_file_size) == false) {
     return;
   }
 
   // Get info about the transaction from recovery table
   auto txn_id = txn_record.GetTransactionId();
-  if (recovery_txn_table.find(txn_id) != recovery_txn_table.end()) {
-    auto txn = recovery_txn_table.at(txn_id);
-    // Copy inserted/deleted tuples to recovery transaction
-    MoveTuples(recovery_txn, txn);
+  auto txn_entry = log_stream.recovery_txn_table.find(txn_id);
+  if (txn_entry != log_stream.recovery_txn_table.end()) {
+    log_stream.committed_txn_list.emplace_back(txn_record.GetCommitId(),
+                                               std::move(txn_entry->second));
+    log_stream.recovery_txn_table.erase(txn_entry);
 
     LOG_TRACE("Commit txd id %d object in table", (int)txn_id);
   } else {
@@ -291,55 +441,24 @@ void AriesFrontendLogger::MoveCommittedTuplesToRecoveryTxn(
 }
 
 /**
- * @brief Move Tuples from log record-based local transaction to recovery
- * transaction
- * @param destination
- * @param source
- */
-void AriesFrontendLogger::MoveTuples(concurrency::Transaction *destination,
-                                     concurrency::Transaction *source) {
-  // This is the local transaction
-  auto inserted_tuples = source->GetInsertedTuples();
-  // Record the inserts in recovery txn
-  for (auto entry : inserted_tuples) {
-    oid_t tile_group_id = entry.first;
-    for (auto tuple_slot : entry.second) {
-      destination->RecordInsert(ItemPointer(tile_group_id, tuple_slot));
-    }
-  }
-
-  // Record the deletes in recovery txn
-  auto deleted_tuples = source->GetDeletedTuples();
-  for (auto entry : deleted_tuples) {
-    oid_t tile_group_id = entry.first;
-    for (auto tuple_slot : entry.second) {
-      destination->RecordDelete(ItemPointer(tile_group_id, tuple_slot));
-    }
-  }
-
-  // Clear inserted/deleted tuples from txn, just in case
-  source->ResetState();
-}
-
-/**
- * @brief abort tuple
+ * @brief drop the tuple records of an aborted txn
+ * @param log stream
  */
-void AriesFrontendLogger::AbortTuplesFromRecoveryTable() {
+void AriesFrontendLogger::AbortTransactionInRecoveryTable(
+    RecoveryLogStream &log_stream) {
   // read transaction information from the log file
   TransactionRecord txn_record(LOGRECORD_TYPE_TRANSACTION_ABORT);
 
   // Check for torn log write
-  if (ReadTransactionRecordHeader(txn_record, log_file, log_file_size) ==
-      false) {
+  if (ReadTransactionRecordHeader(txn_record, log_stream.log_file,
+                                  log_stream.log_file_size) == false) {
     return;
   }
 
   auto txn_id = txn_record.GetTransactionId();
 
   // Get info about the transaction from recovery table
-  if (recovery_txn_table.find(txn_id) != recovery_txn_table.end()) {
-    auto txn = recovery_txn_table.at(txn_id);
-    AbortTuples(txn);
+  if (log_stream.recovery_txn_table.erase(txn_id) > 0) {
     LOG_INFO("Abort txd id %d object in table", (int)txn_id);
   } else {
     LOG_INFO("Abort txd id %d not found in recovery txn table", (int)txn_id);
@@ -347,94 +466,172 @@ void AriesFrontendLogger::AbortTuplesFromRecoveryTable() {
 }
 
 /**
- * @brief Abort tuples inside txn
- * @param txn
+ * @brief Drop the txns which were still active
+ * Their changes were never replayed, so there is nothing to undo
+ * @param log stream
  */
-void AriesFrontendLogger::AbortTuples(concurrency::Transaction *txn) {
-  LOG_INFO("Abort txd id %d object in table", (int)txn->GetTransactionId());
+void AriesFrontendLogger::AbortActiveTransactions(
+    RecoveryLogStream &log_stream) {
+  for (auto &active_txn_entry : log_stream.recovery_txn_table) {
+    LOG_INFO("Abort txd id %d object in table", (int)active_txn_entry.first);
+  }
 
-  auto &manager = catalog::Manager::GetInstance();
+  log_stream.recovery_txn_table.clear();
+}
 
-  // Record the aborted inserts in recovery txn
-  auto inserted_tuples = txn->GetInsertedTuples();
-  for (auto entry : inserted_tuples) {
-    oid_t tile_group_id = entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
+/**
+ * @brief read tuple record from log file and add it to its txn
+ * @param log stream
+ * @param log record type
+ */
+void AriesFrontendLogger::AddTupleRecordToRecoveryTable(
+    RecoveryLogStream &log_stream, LogRecordType log_record_type) {
+  TupleRecord tuple_record(log_record_type);
 
-    for (auto tuple_slot : entry.second) {
-      tile_group.get()->AbortInsertedTuple(tuple_slot);
-    }
+  // Check for torn log write
+  if (ReadTupleRecordHeader(tuple_record, log_stream.log_file,
+                            log_stream.log_file_size) == false) {
+    LOG_ERROR("Could not read tuple record header.");
+    return;
   }
 
-  // Record the aborted deletes in recovery txn
-  auto deleted_tuples = txn->GetDeletedTuples();
-  for (auto entry : txn->GetDeletedTuples()) {
-    oid_t tile_group_id = entry.first;
-    auto tile_group = manager.GetTileGroup(tile_group_id);
+  auto table = GetTable(tuple_record);
 
-    for (auto tuple_slot : entry.second) {
-      tile_group.get()->AbortDeletedTuple(tuple_slot, txn->GetTransactionId());
+  // Read off the tuple record body from the log
+  storage::Tuple *tuple = nullptr;
+  if (log_record_type != LOGRECORD_TYPE_ARIES_TUPLE_DELETE) {
+    tuple = ReadTupleRecordBody(table->GetSchema(),
+                                log_stream.recovery_pool.get(),
+                                log_stream.log_file, log_stream.log_file_size);
+
+    // Check for torn log write
+    if (tuple == nullptr) {
+      return;
     }
   }
 
-  // Clear inserted/deleted tuples from txn, just in case
-  txn->ResetState();
-}
-
-/**
- * @brief Abort tuples inside txn table
- */
-void AriesFrontendLogger::AbortActiveTransactions() {
-  // Clean up the recovery table to ignore active transactions
-  for (auto active_txn_entry : recovery_txn_table) {
-    // clean up the transaction
-    auto active_txn = active_txn_entry.second;
-    AbortTuples(active_txn);
-    delete active_txn;
+  auto txn_id = tuple_record.GetTransactionId();
+  auto txn_entry = log_stream.recovery_txn_table.find(txn_id);
+  if (txn_entry == log_stream.recovery_txn_table.end()) {
+    LOG_ERROR("Tuple record txd id %d not found in recovery txn table",
+              (int)txn_id);
+    delete tuple;
+    return;
   }
 
-  recovery_txn_table.clear();
+  txn_entry->second.emplace_back(tuple_record, tuple);
 }
 
 /**
- * @brief read tuple record from log file and add them tuples to recovery txn
- * @param recovery txn
+ * @brief Replay the committed txns in commit order in the recovery txn
+ * The tuple records are partitioned by tile group over the replay workers
+ * in commit order, so each tile group still sees its changes in commit
+ * order. The changes of the workers are then committed at once.
+ * @param committed txns of all the log streams
  */
-void AriesFrontendLogger::InsertTuple(concurrency::Transaction *recovery_txn) {
-  TupleRecord tuple_record(LOGRECORD_TYPE_ARIES_TUPLE_INSERT);
+void AriesFrontendLogger::ReplayCommittedTransactions(
+    CommittedTxnList &committed_txn_list) {
+  // Txns logged without commit id keep the order they were read in
+  std::stable_sort(committed_txn_list.begin(), committed_txn_list.end(),
+                   [](const std::pair<cid_t, RecoveryRecordList> &lhs,
+                      const std::pair<cid_t, RecoveryRecordList> &rhs) {
+                     return lhs.first < rhs.first;
+                   });
+
+  // Start the recovery transaction
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+
+  // The txns after recovery commit after the replayed ones
+  txn_manager.RestoreLastCommitId(committed_txn_list.back().first);
+
+  // Although we call BeginTransaction here, recovery txn will not be
+  // recoreded in log file since we are in recovery mode
+  auto recovery_txn = txn_manager.BeginTransaction();
+
+  // Partition the tuple records, missing tile groups are created here
+  // so that the workers never modify the tables
+  auto &log_manager = LogManager::GetInstance();
+  std::vector<ReplayWorker> replay_workers(
+      log_manager.GetRecoveryThreadCount());
+
+  for (auto &committed_txn : committed_txn_list) {
+    for (auto &recovery_record : committed_txn.second) {
+      auto &tuple_record = recovery_record.tuple_record;
+
+      switch (tuple_record.GetType()) {
+        case LOGRECORD_TYPE_ARIES_TUPLE_INSERT:
+          AddInsertOperation(replay_workers, tuple_record,
+                             recovery_record.tuple.get());
+          break;
 
-  // Check for torn log write
-  if (ReadTupleRecordHeader(tuple_record, log_file, log_file_size) == false) {
-    LOG_ERROR("Could not read tuple record header.");
-    return;
-  }
+        case LOGRECORD_TYPE_ARIES_TUPLE_DELETE:
+          AddDeleteOperation(replay_workers, tuple_record);
+          break;
 
-  auto txn_id = tuple_record.GetTransactionId();
-  if (recovery_txn_table.find(txn_id) == recovery_txn_table.end()) {
-    LOG_ERROR("Insert txd id %d not found in recovery txn table", (int)txn_id);
-    return;
+        case LOGRECORD_TYPE_ARIES_TUPLE_UPDATE:
+          AddDeleteOperation(replay_workers, tuple_record);
+          AddInsertOperation(replay_workers, tuple_record,
+                             recovery_record.tuple.get());
+          break;
+
+        default:
+          break;
+      }
+    }
   }
 
-  auto table = GetTable(tuple_record);
+  // Replay the partitions in parallel
+  std::vector<std::thread> replay_threads;
+  for (auto &replay_worker : replay_workers) {
+    replay_threads.emplace_back(&AriesFrontendLogger::ReplayOperations,
+                                recovery_txn, std::ref(replay_worker));
+  }
+  for (auto &replay_thread : replay_threads) {
+    replay_thread.join();
+  }
 
-  // Read off the tuple record body from the log
-  auto tuple = ReadTupleRecordBody(table->GetSchema(), recovery_pool, log_file,
-                                   log_file_size);
+  // Commit pass : hand the changes of the workers to the recovery txn
+  for (auto &replay_worker : replay_workers) {
+    for (auto inserted_location : replay_worker.inserted_locations) {
+      recovery_txn->RecordInsert(inserted_location);
+    }
+    for (auto deleted_location : replay_worker.deleted_locations) {
+      recovery_txn->RecordDelete(deleted_location);
+    }
+    for (auto &tuple_count_delta : replay_worker.tuple_count_deltas) {
+      tuple_count_delta.first->IncreaseNumberOfTuplesBy(
+          tuple_count_delta.second);
+    }
 
-  // Check for torn log write
-  if (tuple == nullptr) {
-    return;
+    if (replay_worker.failed) {
+      // TODO: We need to abort on failure !
+      recovery_txn->SetResult(Result::RESULT_FAILURE);
+    }
   }
 
+  // Commit the recovery transaction
+  txn_manager.CommitTransaction();
+
+  committed_txn_list.clear();
+}
+
+/**
+ * @brief Add the insert of a tuple record to the worker of its tile group
+ * @param replay workers
+ * @param tuple record
+ * @param tuple
+ */
+void AriesFrontendLogger::AddInsertOperation(
+    std::vector<ReplayWorker> &replay_workers, const TupleRecord &tuple_record,
+    storage::Tuple *tuple) {
+  auto table = GetTable(tuple_record);
+
   auto target_location = tuple_record.GetInsertLocation();
   auto tile_group_id = target_location.block;
-  auto tuple_slot = target_location.offset;
 
   auto &manager = catalog::Manager::GetInstance();
   auto tile_group = manager.GetTileGroup(tile_group_id);
 
-  auto txn = recovery_txn_table.at(txn_id);
-
   // Create new tile group if table doesn't already have that tile group
   if (tile_group == nullptr) {
     table->AddTileGroupWithOid(tile_group_id);
@@ -444,126 +641,126 @@ void AriesFrontendLogger::InsertTuple(concurrency::Transaction *recovery_txn) {
     }
   }
 
-  // Do the insert !
-  auto inserted_tuple_slot = tile_group->InsertTuple(
-      recovery_txn->GetTransactionId(), tuple_slot, tuple);
-
-  if (inserted_tuple_slot == INVALID_OID) {
-    // TODO: We need to abort on failure !
-    recovery_txn->SetResult(Result::RESULT_FAILURE);
-  } else {
-    txn->RecordInsert(target_location);
-    table->IncreaseNumberOfTuplesBy(1);
-  }
-
-  delete tuple;
+  auto &replay_worker = replay_workers[tile_group_id % replay_workers.size()];
+  replay_worker.replay_operations.push_back(
+      {LOGRECORD_TYPE_ARIES_TUPLE_INSERT, table, tile_group.get(),
+       target_location, tuple});
 }
 
 /**
- * @brief read tuple record from log file and add them tuples to recovery txn
- * @param recovery txn
+ * @brief Add the delete of a tuple record to the worker of its tile group
+ * @param replay workers
+ * @param tuple record
  */
-void AriesFrontendLogger::DeleteTuple(concurrency::Transaction *recovery_txn) {
-  TupleRecord tuple_record(LOGRECORD_TYPE_ARIES_TUPLE_DELETE);
-
-  // Check for torn log write
-  if (ReadTupleRecordHeader(tuple_record, log_file, log_file_size) == false) {
-    return;
-  }
-
-  auto txn_id = tuple_record.GetTransactionId();
-  if (recovery_txn_table.find(txn_id) == recovery_txn_table.end()) {
-    LOG_TRACE("Delete txd id %d not found in recovery txn table", (int)txn_id);
-    return;
-  }
-
+void AriesFrontendLogger::AddDeleteOperation(
+    std::vector<ReplayWorker> &replay_workers,
+    const TupleRecord &tuple_record) {
   auto table = GetTable(tuple_record);
 
   ItemPointer delete_location = tuple_record.GetDeleteLocation();
+  auto tile_group_id = delete_location.block;
+
+  auto &replay_worker = replay_workers[tile_group_id % replay_workers.size()];
 
-  // Try to delete the tuple
-  bool status = table->DeleteTuple(recovery_txn, delete_location);
-  if (status == false) {
-    // TODO: We need to abort on failure !
-    recovery_txn->SetResult(Result::RESULT_FAILURE);
+  auto &manager = catalog::Manager::GetInstance();
+  auto tile_group = manager.GetTileGroup(tile_group_id);
+  if (tile_group == nullptr) {
+    LOG_ERROR("Delete of a tuple in tile group %lu which does not exist",
+              tile_group_id);
+    replay_worker.failed = true;
     return;
   }
 
-  auto txn = recovery_txn_table.at(txn_id);
-  txn->RecordDelete(delete_location);
+  replay_worker.replay_operations.push_back(
+      {LOGRECORD_TYPE_ARIES_TUPLE_DELETE, table, tile_group.get(),
+       delete_location, nullptr});
 }
 
 /**
- * @brief read tuple record from log file and add them tuples to recovery txn
+ * @brief redo the inserts and deletes of a replay worker in recovery txn
+ * The recovery txn is only read, its changes are kept by the worker
  * @param recovery txn
+ * @param replay worker
  */
-void AriesFrontendLogger::UpdateTuple(concurrency::Transaction *recovery_txn) {
-  TupleRecord tuple_record(LOGRECORD_TYPE_ARIES_TUPLE_UPDATE);
-
-  // Check for torn log write
-  if (ReadTupleRecordHeader(tuple_record, log_file, log_file_size) == false) {
-    return;
-  }
-
-  auto txn_id = tuple_record.GetTransactionId();
-  if (recovery_txn_table.find(txn_id) == recovery_txn_table.end()) {
-    LOG_TRACE("Update txd id %d not found in recovery txn table", (int)txn_id);
-    return;
-  }
-
-  auto txn = recovery_txn_table.at(txn_id);
-
-  auto table = GetTable(tuple_record);
-
-  auto tuple = ReadTupleRecordBody(table->GetSchema(), recovery_pool, log_file,
-                                   log_file_size);
-
-  // Check for torn log write
-  if (tuple == nullptr) {
-    return;
+void AriesFrontendLogger::ReplayOperations(
+    const concurrency::Transaction *recovery_txn, ReplayWorker &replay_worker) {
+  auto txn_id = recovery_txn->GetTransactionId();
+  auto last_cid = recovery_txn->GetLastCommitId();
+
+  for (auto &replay_operation : replay_worker.replay_operations) {
+    auto &location = replay_operation.location;
+
+    if (replay_operation.type == LOGRECORD_TYPE_ARIES_TUPLE_INSERT) {
+      // Do the insert !
+      auto inserted_tuple_slot = replay_operation.tile_group->InsertTuple(
+          txn_id, location.offset, replay_operation.tuple);
+
+      if (inserted_tuple_slot == INVALID_OID) {
+        replay_worker.failed = true;
+      } else {
+        replay_worker.inserted_locations.push_back(location);
+        replay_worker.tuple_count_deltas[replay_operation.table]++;
+      }
+    } else {
+      // Try to delete the tuple
+      bool status = replay_operation.tile_group->DeleteTuple(
+          txn_id, location.offset, last_cid);
+
+      if (status == false) {
+        LOG_WARN("Failed to delete tuple from the tile group : %lu ",
+                 location.block);
+        replay_worker.failed = true;
+      } else {
+        replay_worker.deleted_locations.push_back(location);
+        replay_worker.tuple_count_deltas[replay_operation.table]--;
+      }
+    }
   }
+}
 
-  // First, redo the delete
-  ItemPointer delete_location = tuple_record.GetDeleteLocation();
-
-  bool status = table->DeleteTuple(recovery_txn, delete_location);
-  if (status == false) {
-    recovery_txn->SetResult(Result::RESULT_FAILURE);
-  } else {
-    txn->RecordDelete(delete_location);
+//===--------------------------------------------------------------------===//
+// Utility functions
+//===--------------------------------------------------------------------===//
 
-    auto target_location = tuple_record.GetInsertLocation();
-    auto tile_group_id = target_location.block;
-    auto tuple_slot = target_location.offset;
-    auto &manager = catalog::Manager::GetInstance();
-    auto tile_group = manager.GetTileGroup(tile_group_id);
-
-    // Create new tile group if table doesn't already have that tile group
-    if (tile_group == nullptr) {
-      table->AddTileGroupWithOid(tile_group_id);
-      tile_group = manager.GetTileGroup(tile_group_id);
-      if (max_oid < tile_group_id) {
-        max_oid = tile_group_id;
+/**
+ * @brief Write the log records to the end of the log file
+ * The log file is opened in append mode, so the regions are written
+ * with writev, as many at once as the system takes.
+ * @param log_file_fd
+ * @param log_records the regions of the log records, they are consumed
+ * @return false if the log records could not be written
+ */
+bool WriteLogRecords(int log_file_fd, std::vector<struct iovec> &log_records) {
+  size_t region_itr = 0;
+
+  while (region_itr < log_records.size()) {
+    int region_count = static_cast<int>(
+        std::min<size_t>(log_records.size() - region_itr, IOV_MAX));
+    ssize_t ret = writev(log_file_fd, &log_records[region_itr], region_count);
+    if (ret == -1) {
+      if (errno == EINTR) {
+        continue;
       }
+      return false;
     }
 
-    // Do the insert !
-    auto inserted_tuple_slot = tile_group->InsertTuple(
-        recovery_txn->GetTransactionId(), tuple_slot, tuple);
-    if (inserted_tuple_slot == INVALID_OID) {
-      recovery_txn->SetResult(Result::RESULT_FAILURE);
-    } else {
-      txn->RecordInsert(target_location);
+    // Skip the written regions, and the written part of the last one
+    size_t written_length = ret;
+    while (region_itr < log_records.size() &&
+           written_length >= log_records[region_itr].iov_len) {
+      written_length -= log_records[region_itr].iov_len;
+      region_itr++;
+    }
+    if (written_length > 0) {
+      auto &region = log_records[region_itr];
+      region.iov_base = static_cast<char *>(region.iov_base) + written_length;
+      region.iov_len -= written_length;
     }
   }
 
-  delete tuple;
+  return true;
 }
 
-//===--------------------------------------------------------------------===//
-// Utility functions
-//===--------------------------------------------------------------------===//
-
 /**
  * @brief Measure the size of log file
  * @return the size if the log file exists otherwise 0
@@ -745,7 +942,7 @@ storage::Tuple *ReadTupleRecordBody(catalog::Schema *schema, VarlenPool *pool,
  * @param tuple record
  * @return data table
  */
-storage::DataTable *GetTable(TupleRecord tuple_record) {
+storage::DataTable *GetTable(const TupleRecord &tuple_record) {
   // Get db, table, schema to insert tuple
   auto &manager = catalog::Manager::GetInstance();
   storage::Database *db =
@@ -758,9 +955,38 @@ storage::DataTable *GetTable(TupleRecord tuple_record) {
   return table;
 }
 
+/**
+ * @brief Append the log records to the log file of the given segment,
+ * the earlier records must be flushed already
+ * @param log segment
+ */
+void AriesFrontendLogger::SwitchLogSegment(oid_t next_log_segment_id) {
+  auto &log_manager = logging::LogManager::GetInstance();
+  auto next_log_file_name =
+      log_manager.GetLogSegmentFileName(log_stream_id, next_log_segment_id);
+
+  // Keep the current log file if the next one cannot be opened,
+  // the switch is tried again by the main loop
+  FILE *next_log_file = fopen(next_log_file_name.c_str(), "ab+");
+  if (next_log_file == NULL) {
+    LOG_ERROR("Could not open log segment %s", next_log_file_name.c_str());
+    return;
+  }
+
+  int ret = fclose(log_file);
+  if (ret != 0) {
+    LOG_ERROR("Error occured while closing LogFile");
+  }
+
+  log_file = next_log_file;
+  log_file_fd = fileno(log_file);
+
+  FrontendLogger::SwitchLogSegment(next_log_segment_id);
+}
+
 std::string AriesFrontendLogger::GetLogFileName(void) {
   auto &log_manager = logging::LogManager::GetInstance();
-  return log_manager.GetLogFileName();
+  return log_manager.GetLogSegmentFileName(log_stream_id, log_segment_id);
 }
 
 }  // namespace logging
@@ -12,7 +12,15 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <sys/uio.h>
+
 #include "backend/logging/frontend_logger.h"
+#include "backend/logging/log_buffer.h"
+#include "backend/logging/records/tuple_record.h"
 
 namespace peloton {
 
@@ -22,6 +30,12 @@ namespace concurrency {
 class Transaction;
 }
 
+namespace storage {
+class DataTable;
+class TileGroup;
+class Tuple;
+}
+
 namespace logging {
 
 //===--------------------------------------------------------------------===//
@@ -30,10 +44,12 @@ namespace logging {
 
 class AriesFrontendLogger : public FrontendLogger {
  public:
-  AriesFrontendLogger(void);
+  AriesFrontendLogger(oid_t log_stream_id = 0);
 
   ~AriesFrontendLogger(void);
 
+  void CollectLogRecordsFromBackendLogger(BackendLogger *backend_logger);
+
   void FlushLogRecords(void);
 
   //===--------------------------------------------------------------------===//
@@ -42,29 +58,109 @@ class AriesFrontendLogger : public FrontendLogger {
 
   void DoRecovery(void);
 
-  void AddTransactionToRecoveryTable(void);
+  void SwitchLogSegment(oid_t next_log_segment_id);
 
-  void RemoveTransactionFromRecoveryTable(void);
+ private:
+  std::string GetLogFileName(void);
 
-  void MoveCommittedTuplesToRecoveryTxn(concurrency::Transaction *recovery_txn);
+  // A tuple record read during recovery, with its tuple if any
+  struct RecoveryRecord {
+    RecoveryRecord(const TupleRecord &tuple_record, storage::Tuple *tuple);
 
-  void AbortTuplesFromRecoveryTable(void);
+    TupleRecord tuple_record;
 
-  void MoveTuples(concurrency::Transaction *destination,
-                  concurrency::Transaction *source);
+    std::unique_ptr<storage::Tuple> tuple;
+  };
 
-  void InsertTuple(concurrency::Transaction *recovery_txn);
+  // The tuple records of a txn in the order they were logged
+  typedef std::vector<RecoveryRecord> RecoveryRecordList;
 
-  void DeleteTuple(concurrency::Transaction *recovery_txn);
+  // Committed txns with their commit ids
+  typedef std::vector<std::pair<cid_t, RecoveryRecordList>> CommittedTxnList;
 
-  void UpdateTuple(concurrency::Transaction *recovery_txn);
+  // A log stream read by its own reader thread during recovery
+  struct RecoveryLogStream {
+    explicit RecoveryLogStream(oid_t log_stream_id);
 
-  void AbortActiveTransactions();
+    // pool for allocating non-inlined values,
+    // declared first so that it outlives the tuples
+    std::unique_ptr<VarlenPool> recovery_pool;
 
-  void AbortTuples(concurrency::Transaction *txn);
+    oid_t log_stream_id;
 
- private:
-  std::string GetLogFileName(void);
+    // Log segment being read and its size
+    FILE *log_file = nullptr;
+    size_t log_file_size = 0;
+
+    // Log records and bytes read
+    size_t record_count = 0;
+    size_t log_size = 0;
+
+    // Txn table of the stream
+    std::map<txn_id_t, RecoveryRecordList> recovery_txn_table;
+
+    // Committed txns of the stream
+    CommittedTxnList committed_txn_list;
+  };
+
+  // An insert or a delete of a tuple slot, an update is split in both
+  struct ReplayOperation {
+    LogRecordType type;
+
+    storage::DataTable *table;
+
+    storage::TileGroup *tile_group;
+
+    ItemPointer location;
+
+    // tuple to insert, owned by its recovery record
+    storage::Tuple *tuple;
+  };
+
+  // A replay worker owns a partition of the tile groups, so that it is the
+  // only one modifying them. It keeps its changes for the commit pass.
+  struct ReplayWorker {
+    std::vector<ReplayOperation> replay_operations;
+
+    std::vector<ItemPointer> inserted_locations;
+
+    std::vector<ItemPointer> deleted_locations;
+
+    // Change of the number of tuples of each table
+    std::map<storage::DataTable *, int> tuple_count_deltas;
+
+    bool failed = false;
+  };
+
+  void ReadLogStream(RecoveryLogStream &log_stream,
+                     oid_t first_log_segment_id);
+
+  void ReadLogSegment(RecoveryLogStream &log_stream);
+
+  void AddTransactionToRecoveryTable(RecoveryLogStream &log_stream);
+
+  void RemoveTransactionFromRecoveryTable(RecoveryLogStream &log_stream);
+
+  void CommitTransactionInRecoveryTable(RecoveryLogStream &log_stream);
+
+  void AbortTransactionInRecoveryTable(RecoveryLogStream &log_stream);
+
+  void AddTupleRecordToRecoveryTable(RecoveryLogStream &log_stream,
+                                     LogRecordType log_record_type);
+
+  void AbortActiveTransactions(RecoveryLogStream &log_stream);
+
+  void ReplayCommittedTransactions(CommittedTxnList &committed_txn_list);
+
+  void AddInsertOperation(std::vector<ReplayWorker> &replay_workers,
+                          const TupleRecord &tuple_record,
+                          storage::Tuple *tuple);
+
+  void AddDeleteOperation(std::vector<ReplayWorker> &replay_workers,
+                          const TupleRecord &tuple_record);
+
+  static void ReplayOperations(const concurrency::Transaction *recovery_txn,
+                               ReplayWorker &replay_worker);
 
   //===--------------------------------------------------------------------===//
   // Member Variables
@@ -74,18 +170,18 @@ class AriesFrontendLogger : public FrontendLogger {
   FILE *log_file;
   int log_file_fd;
 
-  // Size of the log file
-  size_t log_file_size;
+  // Regions of the serialized log records collected from the backend
+  // loggers, they are written from the log buffers of the backend loggers
+  std::vector<struct iovec> log_records;
 
-  // Txn table during recovery
-  std::map<txn_id_t, concurrency::Transaction *> recovery_txn_table;
+  // Log buffers the log records were collected from, with the bytes
+  // collected, their space is released once the log records are written
+  std::vector<std::pair<std::shared_ptr<LogBuffer>, size_t>>
+      collected_log_buffers;
 
   // Keep tracking max oid for setting next_oid in manager
   // For active processing after recovery
   oid_t max_oid = 0;
-
-  // pool for allocating non-inlined values
-  VarlenPool *recovery_pool;
 };
 
 }  // namespace logging
@@ -32,6 +32,7 @@ PelotonBackendLogger *PelotonBackendLogger::GetInstance() {
 void PelotonBackendLogger::Log(LogRecord *record) {
   // Enqueue the serialized log record into the queue
   record->Serialize(output_buffer);
+  logged_lsn += record->GetMessageLength();
 
   {
     std::lock_guard<std::mutex> lock(local_queue_mutex);
@@ -22,6 +22,11 @@ bool TransactionRecord::Serialize(CopySerializeOutput &output) {
   output.WriteInt(0);
   output.WriteLong(txn_id);
 
+  // Commit records let recovery order the txns of different log streams
+  if (cid != INVALID_CID) {
+    output.WriteLong(cid);
+  }
+
   // Write out the header now
   int32_t header_length =
       static_cast<int32_t>(output.Position() - start - sizeof(int32_t));
@@ -40,10 +45,15 @@ bool TransactionRecord::Serialize(CopySerializeOutput &output) {
  */
 void TransactionRecord::Deserialize(CopySerializeInputBE &input) {
   // Get the message length
-  input.ReadInt();
+  auto header_length = input.ReadInt();
 
   // Just grab the transaction id
   txn_id = (txn_id_t)(input.ReadLong());
+
+  // and the commit id if there is one
+  if (header_length > static_cast<int32_t>(sizeof(int64_t))) {
+    cid = (cid_t)(input.ReadLong());
+  }
 }
 
 // Used for peloton logging
@@ -55,6 +65,9 @@ size_t TransactionRecord::GetTransactionRecordSize(void) {
 void TransactionRecord::Print(void) {
   std::cout << "#LOG TYPE:" << LogRecordTypeToString(GetType()) << "\n";
   std::cout << " #Txn ID:" << GetTransactionId() << "\n";
+  if (cid != INVALID_CID) {
+    std::cout << " #Commit ID:" << cid << "\n";
+  }
   std::cout << "\n";
 }
 
@@ -13,8 +13,9 @@ namespace logging {
 class TransactionRecord : public LogRecord {
  public:
   TransactionRecord(LogRecordType log_record_type,
-                    const txn_id_t txn_id = INVALID_TXN_ID)
-      : LogRecord(log_record_type, txn_id) {}
+                    const txn_id_t txn_id = INVALID_TXN_ID,
+                    const cid_t cid = INVALID_CID)
+      : LogRecord(log_record_type, txn_id), cid(cid) {}
 
   ~TransactionRecord() {
     // Clean up the message
@@ -35,7 +36,13 @@ class TransactionRecord : public LogRecord {
   // Accessors
   //===--------------------------------------------------------------------===//
 
+  // Commit id of the txn, only recorded in ARIES commit records
+  cid_t GetCommitId(void) const { return cid; }
+
   void Print(void);
+
+ private:
+  cid_t cid;
 };
 
 }  // namespace logging
@@ -66,6 +66,20 @@ bool TupleRecord::Serialize(CopySerializeOutput &output) {
  * @param output
  */
 void TupleRecord::SerializeHeader(CopySerializeOutput &output) {
+  SerializeHeader(output, log_record_type, db_oid, table_oid, txn_id,
+                  insert_location, delete_location);
+}
+
+/**
+ * @brief Serialize the header of a tuple record
+ * The backend loggers serialize tuple records in place with it.
+ * @param output
+ */
+void TupleRecord::SerializeHeader(SerializeOutput &output,
+                                  LogRecordType log_record_type, oid_t db_oid,
+                                  oid_t table_oid, txn_id_t txn_id,
+                                  ItemPointer insert_location,
+                                  ItemPointer delete_location) {
   // Record LogRecordType first
   output.WriteEnumInSingleByte(log_record_type);
 
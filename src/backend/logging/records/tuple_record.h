@@ -64,6 +64,13 @@ class TupleRecord : public LogRecord {
 
   void SerializeHeader(CopySerializeOutput &output);
 
+  // Serialize the header of a tuple record without building the record
+  static void SerializeHeader(SerializeOutput &output,
+                              LogRecordType log_record_type, oid_t db_oid,
+                              oid_t table_oid, txn_id_t txn_id,
+                              ItemPointer insert_location,
+                              ItemPointer delete_location);
+
   void DeserializeHeader(CopySerializeInputBE &input);
 
   //===--------------------------------------------------------------------===//
@@ -93,6 +93,12 @@ class AggregatePlan : public AbstractPlan {
 
   const std::vector<oid_t> &GetColumnIds() const { return column_ids_; }
 
+  // Number of worker threads of a hash aggregation, more than 1 aggregates
+  // in two phases : partial per worker, then merged per partition of groups
+  void SetParallelism(oid_t parallelism) { parallelism_ = parallelism; }
+
+  oid_t GetParallelism() const { return parallelism_; }
+
  private:
   /* For projection */
   std::unique_ptr<const planner::ProjectInfo> project_info_;
@@ -114,6 +120,9 @@ class AggregatePlan : public AbstractPlan {
 
   /** @brief Columns involved */
   std::vector<oid_t> column_ids_;
+
+  /** @brief Degree of parallelism of a hash aggregation. */
+  oid_t parallelism_ = 1;
 };
 }
 }
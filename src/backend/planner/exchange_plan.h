@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// exchange_plan.h
+//
+// Identification: src/backend/planner/exchange_plan.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+
+#include "abstract_plan.h"
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace planner {
+
+/**
+ * @brief Exchange plan node.
+ *
+ * Runs several copies of its child subtree on worker threads and gathers
+ * their output tiles, in no particular order. The copies share the tile
+ * groups of the scan at the outer leaf of the subtree, so the subtree must
+ * be read-only and its outer leaf must be a sequential scan.
+ */
+class ExchangePlan : public AbstractPlan {
+ public:
+  ExchangePlan(const ExchangePlan &) = delete;
+  ExchangePlan &operator=(const ExchangePlan &) = delete;
+  ExchangePlan(ExchangePlan &&) = delete;
+  ExchangePlan &operator=(ExchangePlan &&) = delete;
+
+  // A queue capacity of 0 picks one based on the parallelism
+  explicit ExchangePlan(oid_t parallelism, size_t queue_capacity = 0)
+      : parallelism_(parallelism), queue_capacity_(queue_capacity) {}
+
+  // Accessors
+  oid_t GetParallelism() const { return parallelism_; }
+
+  size_t GetQueueCapacity() const { return queue_capacity_; }
+
+  inline PlanNodeType GetPlanNodeType() const {
+    return PLAN_NODE_TYPE_EXCHANGE;
+  }
+
+  inline std::string GetInfo() const { return "Exchange"; }
+
+ private:
+  /** @brief Number of copies of the child subtree. */
+  const oid_t parallelism_;
+
+  /** @brief Number of output tiles buffered before the workers block. */
+  const size_t queue_capacity_;
+};
+
+}  // namespace planner
+}  // namespace peloton
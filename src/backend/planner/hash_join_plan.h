@@ -42,7 +42,15 @@ class HashJoinPlan : public AbstractJoinPlan {
 
   inline std::string GetInfo() const { return "HashJoin"; }
 
+  // Number of worker threads joining the partitions of a partitioned hash
+  // join, more than 1 always partitions the inputs
+  void SetParallelism(oid_t parallelism) { parallelism_ = parallelism; }
+
+  oid_t GetParallelism() const { return parallelism_; }
+
  private:
+  /** @brief Degree of parallelism of the join. */
+  oid_t parallelism_ = 1;
 };
 
 }  // namespace planner
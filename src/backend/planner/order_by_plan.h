@@ -51,6 +51,12 @@ class OrderByPlan : public AbstractPlan {
 
   inline PlanNodeType GetPlanNodeType() const { return PLAN_NODE_TYPE_ORDERBY; }
 
+  // Bytes of input a sort may hold in memory, larger inputs are sorted in
+  // runs spilled to disk and merged
+  void SetMemoryBudget(size_t memory_budget) { memory_budget_ = memory_budget; }
+
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
   inline std::string GetInfo() const { return "OrderBy"; }
 
  private:
@@ -67,6 +73,9 @@ class OrderByPlan : public AbstractPlan {
    * Now we just output the same schema as input tiles.
    */
   const std::vector<oid_t> output_column_ids_;
+
+  /** @brief Memory budget of the sort in bytes, 0 for no limit. */
+  size_t memory_budget_ = 0;
 };
 }
 }
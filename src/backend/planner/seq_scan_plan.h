@@ -43,6 +43,15 @@ class SeqScanPlan : public AbstractScan {
   inline PlanNodeType GetPlanNodeType() const { return PLAN_NODE_TYPE_SEQSCAN; }
 
   inline std::string GetInfo() const { return "SeqScan"; }
+
+  // Number of worker threads scanning the table, 1 means a serial scan
+  void SetParallelism(oid_t parallelism) { parallelism_ = parallelism; }
+
+  oid_t GetParallelism() const { return parallelism_; }
+
+ private:
+  /** @brief Degree of parallelism of the scan. */
+  oid_t parallelism_ = 1;
 };
 
 }  // namespace planner
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// top_n_plan.h
+//
+// Identification: src/backend/planner/top_n_plan.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "abstract_plan.h"
+#include "backend/common/types.h"
+
+namespace peloton {
+namespace planner {
+
+/**
+ * @brief Order by with limit (and offset) in a single node, which only
+ * keeps the offset + limit first tuples while reading its input.
+ * IMPORTANT: all tiles got from child must have the same physical schema,
+ * and the output has the same schema as the input.
+ */
+class TopNPlan : public AbstractPlan {
+ public:
+  TopNPlan(const TopNPlan &) = delete;
+  TopNPlan &operator=(const TopNPlan &) = delete;
+  TopNPlan(TopNPlan &&) = delete;
+  TopNPlan &operator=(TopNPlan &&) = delete;
+
+  TopNPlan(const std::vector<oid_t> &sort_keys,
+           const std::vector<bool> &descend_flags, size_t limit,
+           size_t offset)
+      : sort_keys_(sort_keys),
+        descend_flags_(descend_flags),
+        limit_(limit),
+        offset_(offset) {}
+
+  const std::vector<oid_t> &GetSortKeys() const { return sort_keys_; }
+
+  const std::vector<bool> &GetDescendFlags() const { return descend_flags_; }
+
+  size_t GetLimit() const { return limit_; }
+
+  size_t GetOffset() const { return offset_; }
+
+  inline PlanNodeType GetPlanNodeType() const { return PLAN_NODE_TYPE_TOPN; }
+
+  inline std::string GetInfo() const { return "TopN"; }
+
+ private:
+  /** @brief Column Ids to sort keys w.r.t input tiles.
+   *  Primary sort key comes first, secondary comes next, etc.
+   */
+  const std::vector<oid_t> sort_keys_;
+
+  /** @brief Sort order flags. */
+  const std::vector<bool> descend_flags_;
+
+  const size_t limit_;   // as LIMIT in SQL standard
+  const size_t offset_;  // as OFFSET in SQL standard
+};
+
+}  // namespace planner
+}  // namespace peloton
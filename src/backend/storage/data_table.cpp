@@ -10,12 +10,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <mutex>
 #include <utility>
 
 #include "backend/brain/clusterer.h"
 #include "backend/storage/data_table.h"
 #include "backend/storage/database.h"
+#include "backend/common/epoch_manager.h"
 #include "backend/common/exception.h"
 #include "backend/common/logger.h"
 #include "backend/index/index.h"
@@ -41,6 +43,12 @@ bool peloton_fsm;
 namespace peloton {
 namespace storage {
 
+// Hands out insert lanes to backend threads in round-robin order
+static std::atomic<oid_t> insert_lane_counter(0);
+
+// Insert lane hint of this backend thread
+static thread_local oid_t insert_lane_hint = INVALID_OID;
+
 bool ContainsVisibleEntry(std::vector<ItemPointer> &locations,
                           const concurrency::Transaction *transaction);
 
@@ -50,6 +58,8 @@ DataTable::DataTable(catalog::Schema *schema, std::string table_name,
                      bool adapt_table)
     : AbstractTable(database_oid, table_oid, table_name, schema, own_schema),
       tuples_per_tilegroup(tuples_per_tilegroup),
+      insert_lane_count(std::max(peloton_insert_lane_count, 1)),
+      insert_lanes(insert_lane_count),
       adapt_table(adapt_table) {
   // Init default partition
   auto col_count = schema->GetColumnCount();
@@ -57,8 +67,11 @@ DataTable::DataTable(catalog::Schema *schema, std::string table_name,
     default_partition[col_itr] = std::make_pair(0, col_itr);
   }
 
-  // Create a tile group.
-  AddDefaultTileGroup();
+  // Create a tile group for every insert lane.
+  for (oid_t insert_lane_itr = 0; insert_lane_itr < insert_lane_count;
+       insert_lane_itr++) {
+    AddDefaultTileGroup(insert_lane_itr);
+  }
 }
 
 DataTable::~DataTable() {
@@ -89,12 +102,13 @@ DataTable::~DataTable() {
 bool ContainsVisibleEntry(std::vector<ItemPointer> &locations,
                           const concurrency::Transaction *transaction) {
   auto &manager = catalog::Manager::GetInstance();
+  EpochGuard epoch_guard;
 
   for (auto loc : locations) {
     oid_t tile_group_id = loc.block;
     oid_t tuple_offset = loc.offset;
 
-    auto tile_group = manager.GetTileGroup(tile_group_id);
+    auto tile_group = manager.LookupTileGroup(tile_group_id);
     auto header = tile_group->GetHeader();
 
     auto transaction_id = transaction->GetTransactionId();
@@ -148,35 +162,41 @@ ItemPointer DataTable::GetTupleSlot(const concurrency::Transaction *transaction,
 
   std::shared_ptr<storage::TileGroup> tile_group;
   oid_t tuple_slot = INVALID_OID;
-  oid_t tile_group_offset = INVALID_OID;
   oid_t tile_group_id = INVALID_OID;
   auto transaction_id = transaction->GetTransactionId();
+  auto insert_lane_offset = GetInsertLaneOffset();
+  auto &insert_lane = insert_lanes[insert_lane_offset];
 
   LOG_TRACE("DataTable :: transaction_id %lu \n", transaction_id);
 
   while (tuple_slot == INVALID_OID) {
-    // First, figure out last tile group
-    {
-      std::lock_guard<std::mutex> lock(table_mutex);
-      assert(GetTileGroupCount() > 0);
-      tile_group_offset = GetTileGroupCount() - 1;
-      LOG_TRACE("Tile group offset :: %lu ", tile_group_offset);
-    }
+    // First, figure out the tile group of our insert lane
+    // (no table lock needed)
+    tile_group_id = insert_lane.tile_group_id.load(std::memory_order_acquire);
+    assert(tile_group_id != INVALID_OID);
+    LOG_TRACE("Insert lane :: %lu Tile group id :: %lu ", insert_lane_offset,
+              tile_group_id);
 
     // Then, try to grab a slot in the tile group header
-    tile_group = GetTileGroup(tile_group_offset);
+    tile_group = GetTileGroupById(tile_group_id);
 
     tuple_slot = tile_group->InsertTuple(transaction_id, tuple);
-    tile_group_id = tile_group->GetTileGroupId();
 
+    // The tile group filled up before the next one was published.
+    // This is a no-op if some other thread already added it.
     if (tuple_slot == INVALID_OID) {
-      // XXX Should we put this in a critical section?
-      AddDefaultTileGroup();
+      AddDefaultTileGroup(insert_lane_offset);
     }
   }
 
-  LOG_INFO("tile group offset: %lu, tile group id: %lu, address: %p",
-           tile_group_offset, tile_group->GetTileGroupId(), tile_group.get());
+  // Whoever claims the last slot allocates the next tile group right away,
+  // so that the other inserters in the lane rarely find it without free slots
+  if (tuple_slot == tile_group->GetAllocatedTupleCount() - 1) {
+    AddDefaultTileGroup(insert_lane_offset);
+  }
+
+  LOG_INFO("tile group id: %lu, address: %p", tile_group_id,
+           tile_group.get());
 
   // Set tuple location
   ItemPointer location(tile_group_id, tuple_slot);
@@ -427,52 +447,59 @@ column_map_type DataTable::GetTileGroupLayout(LayoutType layout_type) {
   return column_map;
 }
 
-oid_t DataTable::AddDefaultTileGroup() {
-  column_map_type column_map;
-  oid_t tile_group_id = INVALID_OID;
+oid_t DataTable::GetInsertLaneOffset() const {
+  if (insert_lane_count == 1) return 0;
+
+  // Assign the calling thread its lane on its first insert
+  if (insert_lane_hint == INVALID_OID) {
+    insert_lane_hint = insert_lane_counter++;
+  }
 
-  // Figure out the partitioning for given tilegroup layout
-  column_map = GetTileGroupLayout((LayoutType)peloton_layout_mode);
+  return insert_lane_hint % insert_lane_count;
+}
 
-  // Create a tile group with that partitioning
-  std::shared_ptr<TileGroup> tile_group(GetTileGroupWithLayout(column_map));
-  assert(tile_group.get());
-  tile_group_id = tile_group.get()->GetTileGroupId();
+oid_t DataTable::AddDefaultTileGroup(oid_t insert_lane_offset) {
+  column_map_type column_map;
+  oid_t tile_group_id = INVALID_OID;
+  auto &insert_lane = insert_lanes[insert_lane_offset];
 
   LOG_TRACE("Trying to add a tile group ");
   {
     std::lock_guard<std::mutex> lock(table_mutex);
 
-    // Check if we actually need to allocate a tile group
-
-    // (A) no tile groups in table
-    if (tile_groups.empty()) {
-      LOG_TRACE("Added first tile group ");
-      tile_groups.push_back(tile_group->GetTileGroupId());
-      // add tile group metadata in locator
-      catalog::Manager::GetInstance().AddTileGroup(tile_group_id, tile_group);
-      LOG_TRACE("Recording tile group : %lu ", tile_group_id);
-      return tile_group_id;
+    // Check if we actually need to allocate a tile group.
+    // Concurrent inserters that found the same tile group full all end up
+    // here, but only the first one allocates.
+    oid_t last_tile_group_id = insert_lane.tile_group_id;
+    if (last_tile_group_id != INVALID_OID) {
+      auto last_tile_group = GetTileGroupById(last_tile_group_id);
+
+      oid_t active_tuple_count = last_tile_group->GetNextTupleSlot();
+      oid_t allocated_tuple_count = last_tile_group->GetAllocatedTupleCount();
+      if (active_tuple_count < allocated_tuple_count) {
+        LOG_TRACE("Slot exists in last tile group :: %lu %lu ",
+                  active_tuple_count, allocated_tuple_count);
+        return INVALID_OID;
+      }
     }
 
-    // (B) no slots in last tile group in table
-    auto last_tile_group_offset = GetTileGroupCount() - 1;
-    auto last_tile_group = GetTileGroup(last_tile_group_offset);
+    // Figure out the partitioning for given tilegroup layout
+    column_map = GetTileGroupLayout((LayoutType)peloton_layout_mode);
 
-    oid_t active_tuple_count = last_tile_group->GetNextTupleSlot();
-    oid_t allocated_tuple_count = last_tile_group->GetAllocatedTupleCount();
-    if (active_tuple_count < allocated_tuple_count) {
-      LOG_TRACE("Slot exists in last tile group :: %lu %lu ",
-                active_tuple_count, allocated_tuple_count);
-      return INVALID_OID;
-    }
+    // Create a tile group with that partitioning
+    std::shared_ptr<TileGroup> tile_group(GetTileGroupWithLayout(column_map));
+    assert(tile_group.get());
+    tile_group_id = tile_group.get()->GetTileGroupId();
 
     LOG_TRACE("Added a tile group ");
-    tile_groups.push_back(tile_group->GetTileGroupId());
+    tile_groups.push_back(tile_group_id);
 
     // add tile group metadata in locator
     catalog::Manager::GetInstance().AddTileGroup(tile_group_id, tile_group);
     LOG_TRACE("Recording tile group : %lu ", tile_group_id);
+
+    // publish it to the inserters in the lane
+    insert_lane.tile_group_id.store(tile_group_id, std::memory_order_release);
   }
 
   return tile_group_id;
@@ -505,6 +532,10 @@ oid_t DataTable::AddTileGroupWithOid(oid_t tile_group_id) {
     // add tile group metadata in locator
     catalog::Manager::GetInstance().AddTileGroup(tile_group_id, tile_group);
     LOG_TRACE("Recording tile group : %lu ", tile_group_id);
+
+    // inserts in the first lane continue in this tile group
+    insert_lanes[0].tile_group_id.store(tile_group_id,
+                                        std::memory_order_release);
   }
 
   return tile_group_id;
@@ -520,6 +551,10 @@ void DataTable::AddTileGroup(const std::shared_ptr<TileGroup> &tile_group) {
     // add tile group in catalog
     catalog::Manager::GetInstance().AddTileGroup(tile_group_id, tile_group);
     LOG_TRACE("Recording tile group : %lu ", tile_group_id);
+
+    // inserts in the first lane continue in this tile group
+    insert_lanes[0].tile_group_id.store(tile_group_id,
+                                        std::memory_order_release);
   }
 }
 
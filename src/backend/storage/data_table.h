@@ -46,6 +46,9 @@ extern int peloton_num_groups;
 // FSM or not ?
 extern bool peloton_fsm;
 
+// # of insert lanes per table
+extern int peloton_insert_lane_count;
+
 extern std::vector<peloton::oid_t> hyadapt_column_ids;
 
 namespace peloton {
@@ -61,6 +64,17 @@ namespace storage {
 class Tuple;
 class TileGroup;
 
+/**
+ * An insert lane owns the tile group that a subset of the backend threads
+ * are inserting into. Each lane takes up a whole cache line so that inserters
+ * in different lanes never share one.
+ */
+struct InsertLane {
+  std::atomic<oid_t> tile_group_id = ATOMIC_VAR_INIT(INVALID_OID);
+
+  char padding[CACHELINE_SIZE - sizeof(std::atomic<oid_t>)];
+};
+
 //===--------------------------------------------------------------------===//
 // DataTable
 //===--------------------------------------------------------------------===//
@@ -73,6 +87,10 @@ class TileGroup;
  * ...
  * <Tile Group n>
  *
+ * Inserts are spread over peloton_insert_lane_count insert lanes. Every
+ * backend thread sticks to one lane, and every lane has its own active tile
+ * group, so the lanes' tile groups are interleaved in the tile group list.
+ *
  */
 class DataTable : public AbstractTable {
   friend class TileGroup;
@@ -214,8 +232,12 @@ class DataTable : public AbstractTable {
   ItemPointer GetTupleSlot(const concurrency::Transaction *transaction,
                            const storage::Tuple *tuple);
 
-  // add a default unpartitioned tile group to table
-  oid_t AddDefaultTileGroup();
+  // add a default unpartitioned tile group to the given insert lane
+  // if the lane's tile group is full
+  oid_t AddDefaultTileGroup(oid_t insert_lane_offset);
+
+  // get the insert lane of the calling thread
+  oid_t GetInsertLaneOffset() const;
 
   // get a partitioning with given layout type
   column_map_type GetTileGroupLayout(LayoutType layout_type);
@@ -243,6 +265,13 @@ class DataTable : public AbstractTable {
   // set of tile groups
   std::vector<oid_t> tile_groups;
 
+  // # of insert lanes
+  oid_t insert_lane_count;
+
+  // tile groups that inserts currently go to, one per insert lane
+  // (published after the tile group is registered in the catalog)
+  std::vector<InsertLane> insert_lanes;
+
   // INDEXES
   std::vector<index::Index *> indexes;
 
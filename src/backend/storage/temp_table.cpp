@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// temp_table.cpp
+//
+// Identification: src/backend/storage/temp_table.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "backend/storage/temp_table.h"
+
+#include <cassert>
+
+#include "backend/catalog/schema.h"
+#include "backend/common/abstract_tuple.h"
+#include "backend/storage/tile.h"
+
+namespace peloton {
+namespace storage {
+
+TempTable::TempTable(catalog::Schema *schema, bool own_schema,
+                     oid_t tuples_per_tile)
+    : AbstractTable(INVALID_OID, INVALID_OID, "temp_table", schema,
+                    own_schema),
+      tuples_per_tile(tuples_per_tile) {
+  assert(tuples_per_tile > 0);
+}
+
+TempTable::~TempTable() {
+  // Tiles still wrapped in logical tiles stay alive
+}
+
+ItemPointer TempTable::InsertTuple(const AbstractTuple *tuple) {
+  oid_t tuple_offset = tuple_count % tuples_per_tile;
+
+  // Start a new tile
+  if (tuple_offset == 0) {
+    tiles.emplace_back(TileFactory::GetTempTile(*schema, tuples_per_tile));
+  }
+
+  Tile *tile = tiles.back().get();
+  oid_t column_count = schema->GetColumnCount();
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    Value value = tuple->GetValue(column_itr);
+
+    // Tiles store the values as they are
+    ValueType column_type = schema->GetType(column_itr);
+    if (value.GetValueType() != column_type) {
+      value = value.CastAs(column_type);
+    }
+
+    tile->SetValue(value, tuple_offset, column_itr);
+  }
+
+  tuple_count++;
+  return ItemPointer(tiles.size() - 1, tuple_offset);
+}
+
+oid_t TempTable::GetTileTupleCount(oid_t tile_offset) const {
+  assert(tile_offset < tiles.size());
+
+  if (tile_offset + 1 < tiles.size()) return tuples_per_tile;
+  return tuple_count - tile_offset * tuples_per_tile;
+}
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// temp_table.h
+//
+// Identification: src/backend/storage/temp_table.h
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "backend/common/types.h"
+#include "backend/storage/abstract_table.h"
+
+namespace peloton {
+
+class AbstractTuple;
+
+namespace storage {
+
+class Tile;
+
+//===--------------------------------------------------------------------===//
+// Temp Table
+//===--------------------------------------------------------------------===//
+
+/**
+ * Table for the intermediate results of a query.
+ *
+ * Tuples are appended to temp tiles, which have no tile group, no MVCC
+ * header and keep their uninlined values in a pool of their own. The table
+ * is not registered in the catalog, has no indexes and is not transactional;
+ * it is meant to be filled by a single executor and then wrapped in logical
+ * tiles, which share the tiles and may outlive the table.
+ */
+class TempTable : public AbstractTable {
+ public:
+  TempTable(const TempTable &) = delete;
+  TempTable &operator=(const TempTable &) = delete;
+
+  TempTable(catalog::Schema *schema, bool own_schema,
+            oid_t tuples_per_tile = DEFAULT_TUPLES_PER_TILEGROUP);
+
+  ~TempTable();
+
+  // Appends a copy of the tuple, location is < tile offset, tuple offset >
+  ItemPointer InsertTuple(const AbstractTuple *tuple);
+
+  size_t GetTileCount() const { return tiles.size(); }
+
+  std::shared_ptr<Tile> GetTile(oid_t tile_offset) const {
+    return tiles[tile_offset];
+  }
+
+  // Tuples in a tile, every tile but the last one is full
+  oid_t GetTileTupleCount(oid_t tile_offset) const;
+
+  size_t GetTupleCount() const { return tuple_count; }
+
+ private:
+  oid_t tuples_per_tile;
+
+  std::vector<std::shared_ptr<Tile>> tiles;
+
+  size_t tuple_count = 0;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
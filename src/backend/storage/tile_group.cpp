@@ -52,6 +52,26 @@ TileGroup::TileGroup(BackendType backend_type,
     // Add a reference to the tile in the tile group
     tiles.push_back(tile);
   }
+
+  // Resolve the column map once
+  if (column_map.empty() == false) {
+    column_locations.resize(column_map.rbegin()->first + 1,
+                            ColumnLocation{nullptr, INVALID_OID, INVALID_OID,
+                                           0, VALUE_TYPE_INVALID, false});
+  }
+
+  for (auto &entry : column_map) {
+    oid_t tile_offset = entry.second.first;
+    oid_t tile_column_offset = entry.second.second;
+    assert(tile_offset < tile_count);
+
+    auto &tile_schema = tile_schemas[tile_offset];
+    column_locations[entry.first] = ColumnLocation{
+        tiles[tile_offset].get(), tile_offset, tile_column_offset,
+        tile_schema.GetOffset(tile_column_offset),
+        tile_schema.GetType(tile_column_offset),
+        tile_schema.IsInlined(tile_column_offset)};
+  }
 }
 
 TileGroup::~TileGroup() {
@@ -256,18 +276,6 @@ void TileGroup::AbortDeletedTuple(oid_t tuple_slot_id,
   tile_group_header->ReleaseTupleSlot(tuple_slot_id, transaction_id);
 }
 
-// Sets the tile id and column id w.r.t that tile corresponding to
-// the specified tile group column id.
-void TileGroup::LocateTileAndColumn(oid_t column_offset, oid_t &tile_offset,
-                                    oid_t &tile_column_offset) {
-  assert(column_map.count(column_offset) != 0);
-
-  // get the entry in the column map
-  auto entry = column_map.at(column_offset);
-  tile_offset = entry.first;
-  tile_column_offset = entry.second;
-}
-
 oid_t TileGroup::GetTileIdFromColumnId(oid_t column_id) {
   oid_t tile_column_id, tile_offset;
   LocateTileAndColumn(column_id, tile_offset, tile_column_id);
@@ -282,9 +290,12 @@ oid_t TileGroup::GetTileColumnId(oid_t column_id) {
 
 Value TileGroup::GetValue(oid_t tuple_id, oid_t column_id) {
   assert(tuple_id < GetNextTupleSlot());
-  oid_t tile_column_id, tile_offset;
-  LocateTileAndColumn(column_id, tile_offset, tile_column_id);
-  return GetTile(tile_offset)->GetValue(tuple_id, tile_column_id);
+  auto &column_location = GetColumnLocation(column_id);
+  const char *field_location =
+      column_location.tile->GetTupleLocation(tuple_id) +
+      column_location.byte_offset;
+  return Value::InitFromTupleStorage(field_location, column_location.type,
+                                     column_location.is_inlined);
 }
 
 Tile *TileGroup::GetTile(const oid_t tile_offset) const {
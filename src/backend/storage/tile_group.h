@@ -61,6 +61,22 @@ class TileGroup {
   TileGroup(TileGroup const &) = delete;
 
  public:
+  /**
+   * @brief Everything needed to read a column, resolved from the column map
+   *        once when the tile group is built.
+   */
+  struct ColumnLocation {
+    Tile *tile;
+    oid_t tile_offset;
+    oid_t tile_column_offset;
+
+    // offset of the column in a tuple of the tile
+    size_t byte_offset;
+
+    ValueType type;
+    bool is_inlined;
+  };
+
   // Tile group constructor
   TileGroup(BackendType backend_type, TileGroupHeader *tile_group_header,
             AbstractTable *table, const std::vector<catalog::Schema> &schemas,
@@ -151,8 +167,18 @@ class TileGroup {
 
   size_t GetTileCount() const { return tile_count; }
 
-  void LocateTileAndColumn(oid_t column_offset, oid_t &tile_offset,
-                           oid_t &tile_column_offset);
+  inline const ColumnLocation &GetColumnLocation(oid_t column_offset) const {
+    assert(column_offset < column_locations.size());
+    assert(column_locations[column_offset].tile != nullptr);
+    return column_locations[column_offset];
+  }
+
+  inline void LocateTileAndColumn(oid_t column_offset, oid_t &tile_offset,
+                                  oid_t &tile_column_offset) const {
+    auto &column_location = GetColumnLocation(column_offset);
+    tile_offset = column_location.tile_offset;
+    tile_column_offset = column_location.tile_column_offset;
+  }
 
   oid_t GetTileIdFromColumnId(oid_t column_id);
 
@@ -201,6 +227,9 @@ class TileGroup {
   // column to tile mapping :
   // <column offset> to <tile offset, tile column offset>
   column_map_type column_map;
+
+  // column map flattened for attribute access, indexed by column offset
+  std::vector<ColumnLocation> column_locations;
 };
 
 }  // End storage namespace
@@ -18,11 +18,75 @@
 #include "backend/storage/storage_manager.h"
 #include "backend/storage/tile_group_header.h"
 
+//===--------------------------------------------------------------------===//
+// Configuration Variables
+//===--------------------------------------------------------------------===//
+
+peloton::HeaderLayoutType peloton_header_layout_mode =
+    DEFAULT_HEADER_LAYOUT_TYPE;
+
 namespace peloton {
 namespace storage {
 
+namespace {
+
+/**
+ * @brief Visibility check of four slots at a time over the column layout.
+ *
+ * Same logic as CheckVisibility without commit flags :
+ * visible = valid txn id && end cid > lcid && (own == (begin cid > lcid)).
+ * AVX2 only has signed 64-bit compares, so the cids are compared with
+ * their sign bits flipped.
+ *
+ * Returns the number of slots that were processed (a multiple of four).
+ */
+__attribute__((target("avx2"))) oid_t GetVisibilityBitmapAVX2(
+    const txn_id_t *txn_ids, const cid_t *begin_cids, const cid_t *end_cids,
+    oid_t slot_count, txn_id_t txn_id, cid_t at_lcid, uint64_t *bitmap) {
+  const __m256i sign_bits = _mm256_set1_epi64x(INT64_MIN);
+  const __m256i lcid_vector =
+      _mm256_xor_si256(_mm256_set1_epi64x(at_lcid), sign_bits);
+  const __m256i txn_id_vector = _mm256_set1_epi64x(txn_id);
+  const __m256i invalid_txn_id_vector = _mm256_set1_epi64x(INVALID_TXN_ID);
+
+  oid_t slot_itr = 0;
+  for (; slot_itr + 4 <= slot_count; slot_itr += 4) {
+    __m256i tuple_txn_ids =
+        _mm256_loadu_si256((const __m256i *)(txn_ids + slot_itr));
+    __m256i tuple_begin_cids = _mm256_xor_si256(
+        _mm256_loadu_si256((const __m256i *)(begin_cids + slot_itr)),
+        sign_bits);
+    __m256i tuple_end_cids = _mm256_xor_si256(
+        _mm256_loadu_si256((const __m256i *)(end_cids + slot_itr)),
+        sign_bits);
+
+    __m256i own = _mm256_cmpeq_epi64(tuple_txn_ids, txn_id_vector);
+    __m256i invalid = _mm256_cmpeq_epi64(tuple_txn_ids, invalid_txn_id_vector);
+    __m256i not_activated = _mm256_cmpgt_epi64(tuple_begin_cids, lcid_vector);
+    __m256i not_invalidated = _mm256_cmpgt_epi64(tuple_end_cids, lcid_vector);
+
+    // own and activated must differ, i.e. own == not activated
+    __m256i visible = _mm256_andnot_si256(
+        _mm256_xor_si256(own, not_activated), not_invalidated);
+    visible = _mm256_andnot_si256(invalid, visible);
+
+    uint64_t mask = _mm256_movemask_pd(_mm256_castsi256_pd(visible));
+    bitmap[slot_itr / 64] |= mask << (slot_itr % 64);
+  }
+
+  return slot_itr;
+}
+
+bool CPUSupportsAVX2() {
+  static const bool supports_avx2 = __builtin_cpu_supports("avx2");
+  return supports_avx2;
+}
+
+}  // namespace
+
 TileGroupHeader::TileGroupHeader(BackendType backend_type, int tuple_count)
     : backend_type(backend_type),
+      layout_type(peloton_header_layout_mode),
       data(nullptr),
       num_tuple_slots(tuple_count),
       next_tuple_slot(0) {
@@ -37,6 +101,9 @@ TileGroupHeader::TileGroupHeader(BackendType backend_type, int tuple_count)
   // zero out the data
   std::memset(data, 0, header_size);
 
+  // figure out where each field lives
+  InitHeaderFields();
+
   // Set MVCC Initial Value
   for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
        tuple_slot_id++) {
@@ -56,6 +123,57 @@ TileGroupHeader::~TileGroupHeader() {
   data = nullptr;
 }
 
+void TileGroupHeader::InitHeaderFields() {
+  // Field sizes in the order that they are laid out
+  const size_t field_sizes[] = {sizeof(txn_id_t), sizeof(cid_t),
+                                sizeof(cid_t),    sizeof(bool),
+                                sizeof(bool),     sizeof(ItemPointer)};
+  HeaderField *fields[] = {&txn_id_field,        &begin_cid_field,
+                           &end_cid_field,       &insert_commit_field,
+                           &delete_commit_field, &prev_pointer_field};
+  const oid_t field_count = sizeof(field_sizes) / sizeof(field_sizes[0]);
+
+  if (layout_type == HEADER_LAYOUT_TYPE_COLUMN) {
+    // Put the 8-byte aligned arrays first and the flags at the end
+    const oid_t column_order[] = {0, 1, 2, 5, 3, 4};
+    size_t column_offset = 0;
+
+    for (oid_t column_itr = 0; column_itr < field_count; column_itr++) {
+      auto field_itr = column_order[column_itr];
+      fields[field_itr]->base = data + column_offset;
+      fields[field_itr]->stride = field_sizes[field_itr];
+      column_offset += num_tuple_slots * field_sizes[field_itr];
+    }
+
+    assert(column_offset == header_size);
+  } else {
+    assert(layout_type == HEADER_LAYOUT_TYPE_ROW);
+    size_t entry_offset = 0;
+
+    for (oid_t field_itr = 0; field_itr < field_count; field_itr++) {
+      fields[field_itr]->base = data + entry_offset;
+      fields[field_itr]->stride = header_entry_size;
+      entry_offset += field_sizes[field_itr];
+    }
+
+    assert(entry_offset == header_entry_size);
+  }
+}
+
+void TileGroupHeader::CopyHeaderEntries(const TileGroupHeader &other) {
+  assert(num_tuple_slots == other.num_tuple_slots);
+
+  for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
+       tuple_slot_id++) {
+    SetTransactionId(tuple_slot_id, other.GetTransactionId(tuple_slot_id));
+    SetBeginCommitId(tuple_slot_id, other.GetBeginCommitId(tuple_slot_id));
+    SetEndCommitId(tuple_slot_id, other.GetEndCommitId(tuple_slot_id));
+    SetInsertCommit(tuple_slot_id, other.GetInsertCommit(tuple_slot_id));
+    SetDeleteCommit(tuple_slot_id, other.GetDeleteCommit(tuple_slot_id));
+    SetPrevItemPointer(tuple_slot_id, other.GetPrevItemPointer(tuple_slot_id));
+  }
+}
+
 //===--------------------------------------------------------------------===//
 // Tile Group Header
 //===--------------------------------------------------------------------===//
@@ -196,16 +314,71 @@ void TileGroupHeader::PrintVisibility(txn_id_t txn_id, cid_t at_cid) {
 }
 
 oid_t TileGroupHeader::GetActiveTupleCount(txn_id_t txn_id) {
-  oid_t active_tuple_slots = 0;
   auto &txn_manager = concurrency::TransactionManager::GetInstance();
   cid_t last_cid = txn_manager.GetLastCommitId();
-  for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
-       tuple_slot_id++) {
-    if (IsVisible(tuple_slot_id, txn_id, last_cid)) {
-      active_tuple_slots++;
+
+  std::vector<uint64_t> bitmap(GetBitmapWordCount(num_tuple_slots));
+  return GetVisibilityBitmap(txn_id, last_cid, START_OID, num_tuple_slots,
+                             bitmap.data());
+}
+
+oid_t TileGroupHeader::GetVisibilityBitmap(txn_id_t txn_id, cid_t at_lcid,
+                                           oid_t begin_slot, oid_t end_slot,
+                                           uint64_t *bitmap) const {
+  assert(begin_slot <= end_slot && end_slot <= num_tuple_slots);
+  oid_t slot_count = end_slot - begin_slot;
+  std::memset(bitmap, 0, GetBitmapWordCount(slot_count) * sizeof(uint64_t));
+
+  // Look up the logging mode once for the whole batch
+  bool use_commit_flags = UseCommitFlags();
+  oid_t slot_itr = 0;
+
+  // Vectorized pass over the dense cid arrays
+  if (layout_type == HEADER_LAYOUT_TYPE_COLUMN && use_commit_flags == false &&
+      CPUSupportsAVX2()) {
+    slot_itr = GetVisibilityBitmapAVX2(
+        (const txn_id_t *)txn_id_field.Locate(begin_slot),
+        (const cid_t *)begin_cid_field.Locate(begin_slot),
+        (const cid_t *)end_cid_field.Locate(begin_slot), slot_count, txn_id,
+        at_lcid, bitmap);
+  }
+
+  // Handle the rest one slot at a time
+  for (; slot_itr < slot_count; slot_itr++) {
+    if (CheckVisibility(begin_slot + slot_itr, txn_id, at_lcid,
+                        use_commit_flags)) {
+      bitmap[slot_itr / 64] |= (uint64_t(1) << (slot_itr % 64));
+    }
+  }
+
+  // Count the visible slots
+  oid_t visible_count = 0;
+  for (size_t word_itr = 0; word_itr < GetBitmapWordCount(slot_count);
+       word_itr++) {
+    visible_count += __builtin_popcountll(bitmap[word_itr]);
+  }
+
+  return visible_count;
+}
+
+void TileGroupHeader::GetVisiblePositionList(
+    txn_id_t txn_id, cid_t at_lcid, oid_t begin_slot, oid_t end_slot,
+    std::vector<oid_t> &position_list) const {
+  std::vector<uint64_t> bitmap(GetBitmapWordCount(end_slot - begin_slot));
+  auto visible_count =
+      GetVisibilityBitmap(txn_id, at_lcid, begin_slot, end_slot, bitmap.data());
+
+  position_list.reserve(position_list.size() + visible_count);
+
+  // Walk over the set bits
+  for (size_t word_itr = 0; word_itr < bitmap.size(); word_itr++) {
+    uint64_t word = bitmap[word_itr];
+    while (word != 0) {
+      oid_t bit_offset = __builtin_ctzll(word);
+      position_list.push_back(begin_slot + word_itr * 64 + bit_offset);
+      word &= (word - 1);
     }
   }
-  return active_tuple_slots;
 }
 
 }  // End storage namespace
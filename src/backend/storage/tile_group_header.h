@@ -14,14 +14,22 @@
 
 #include "backend/common/logger.h"
 #include "backend/common/platform.h"
+#include "backend/common/types.h"
 #include "backend/logging/log_manager.h"
 
 #include <atomic>
-#include <mutex>
 #include <iostream>
 #include <cassert>
 #include <queue>
 #include <cstring>
+#include <vector>
+
+//===--------------------------------------------------------------------===//
+// Configuration Variables
+//===--------------------------------------------------------------------===//
+
+// MVCC header layout used by new tile groups
+extern peloton::HeaderLayoutType peloton_header_layout_mode;
 
 namespace peloton {
 namespace storage {
@@ -35,15 +43,27 @@ namespace storage {
  * This contains information related to MVCC.
  * It is shared by all tiles in a tile group.
  *
- * Layout :
+ * Row Layout :
  *
  * 	-----------------------------------------------------------------------------
  *  | Txn ID (8 bytes)  | Begin TimeStamp (8 bytes) | End TimeStamp (8 bytes) |
  *--
- *  |InsertCommit (1 byte) | DeleteCommit (1 byte) | Prev ItemPointer (4 bytes)
+ *  |InsertCommit (1 byte) | DeleteCommit (1 byte) | Prev ItemPointer (16 bytes)
  *|
  * 	-----------------------------------------------------------------------------
  *
+ * Column Layout :
+ *
+ * 	-----------------------------------------------------------------------------
+ *  | Txn IDs | Begin TimeStamps | End TimeStamps | Prev ItemPointers |
+ *  | InsertCommits | DeleteCommits |
+ * 	-----------------------------------------------------------------------------
+ *
+ * In the column layout every field is a dense array over all tuple slots,
+ * so a visibility check over the tile group only touches the arrays it
+ * compares. The layout of new tile groups is picked by
+ * peloton_header_layout_mode.
+ *
  */
 
 class TileGroupHeader {
@@ -56,31 +76,39 @@ class TileGroupHeader {
     // check for self-assignment
     if (&other == this) return *this;
 
-    header_size = other.header_size;
+    assert(header_size == other.header_size);
 
     // copy over all the data
-    memcpy(data, other.data, header_size);
+    if (layout_type == other.layout_type) {
+      memcpy(data, other.data, header_size);
+    } else {
+      CopyHeaderEntries(other);
+    }
 
     num_tuple_slots = other.num_tuple_slots;
-    unsigned long long val = other.next_tuple_slot;
-    next_tuple_slot = val;
+    next_tuple_slot = other.next_tuple_slot.load();
 
     return *this;
   }
 
   ~TileGroupHeader();
 
+  /**
+   * Reserve the next free slot with a single atomic fetch-add.
+   * Returns INVALID_OID once the tile group is full.
+   */
   oid_t GetNextEmptyTupleSlot() {
-    oid_t tuple_slot_id = INVALID_OID;
+    // Don't keep bumping the counter once the tile group is full
+    if (next_tuple_slot.load(std::memory_order_relaxed) >= num_tuple_slots) {
+      return INVALID_OID;
+    }
 
-    {
-      std::lock_guard<std::mutex> tile_header_lock(tile_header_mutex);
+    oid_t tuple_slot_id =
+        next_tuple_slot.fetch_add(1, std::memory_order_relaxed);
 
-      // check tile group capacity
-      if (next_tuple_slot < num_tuple_slots) {
-        tuple_slot_id = next_tuple_slot;
-        next_tuple_slot++;
-      }
+    // check tile group capacity
+    if (tuple_slot_id >= num_tuple_slots) {
+      return INVALID_OID;
     }
 
     return tuple_slot_id;
@@ -90,24 +118,33 @@ class TileGroupHeader {
    * Used by logging
    */
   bool GetEmptyTupleSlot(oid_t tuple_slot_id) {
-    {
-      std::lock_guard<std::mutex> tile_header_lock(tile_header_mutex);
-
-      if (tuple_slot_id < num_tuple_slots) {
-        if (next_tuple_slot <= tuple_slot_id) {
-          next_tuple_slot = tuple_slot_id + 1;
-        }
-        return true;
-      } else {
-        return false;
+    if (tuple_slot_id >= num_tuple_slots) {
+      return false;
+    }
+
+    // Move the next slot past the given slot if it is not already there
+    oid_t next_slot = next_tuple_slot.load(std::memory_order_relaxed);
+    while (next_slot <= tuple_slot_id) {
+      if (next_tuple_slot.compare_exchange_weak(next_slot, tuple_slot_id + 1,
+                                                std::memory_order_relaxed)) {
+        break;
       }
     }
+
+    return true;
   }
 
-  oid_t GetNextTupleSlot() const { return next_tuple_slot; }
+  // The counter can run past the capacity when inserters race on a full
+  // tile group, so clamp it here
+  oid_t GetNextTupleSlot() const {
+    oid_t next_slot = next_tuple_slot.load(std::memory_order_relaxed);
+    return (next_slot < num_tuple_slots) ? next_slot : num_tuple_slots;
+  }
 
   oid_t GetActiveTupleCount(txn_id_t txn_id);
 
+  HeaderLayoutType GetLayoutType() const { return layout_type; }
+
   //===--------------------------------------------------------------------===//
   // MVCC utilities
   //===--------------------------------------------------------------------===//
@@ -115,45 +152,39 @@ class TileGroupHeader {
   // Getters
 
   inline txn_id_t GetTransactionId(const oid_t tuple_slot_id) const {
-    return *((txn_id_t *)(data + (tuple_slot_id * header_entry_size)));
+    return *((txn_id_t *)txn_id_field.Locate(tuple_slot_id));
   }
 
   inline cid_t GetBeginCommitId(const oid_t tuple_slot_id) const {
-    return *((cid_t *)(data + (tuple_slot_id * header_entry_size) +
-                       sizeof(txn_id_t)));
+    return *((cid_t *)begin_cid_field.Locate(tuple_slot_id));
   }
 
   inline cid_t GetEndCommitId(const oid_t tuple_slot_id) const {
-    return *((cid_t *)(data + (tuple_slot_id * header_entry_size) +
-                       sizeof(txn_id_t) + sizeof(cid_t)));
+    return *((cid_t *)end_cid_field.Locate(tuple_slot_id));
   }
 
   // Setters
   inline bool GetInsertCommit(const oid_t tuple_slot_id) const {
-    return *((bool *)(data + (tuple_slot_id * header_entry_size) +
-                      sizeof(txn_id_t) + 2 * sizeof(cid_t)));
+    return *((bool *)insert_commit_field.Locate(tuple_slot_id));
   }
 
   inline bool GetDeleteCommit(const oid_t tuple_slot_id) const {
-    return *((bool *)(data + (tuple_slot_id * header_entry_size) +
-                      sizeof(txn_id_t) + 2 * sizeof(cid_t) + sizeof(bool)));
+    return *((bool *)delete_commit_field.Locate(tuple_slot_id));
   }
 
   inline ItemPointer GetPrevItemPointer(const oid_t tuple_slot_id) const {
-    return *((ItemPointer *)(data + (tuple_slot_id * header_entry_size) +
-                             sizeof(txn_id_t) + 2 * sizeof(cid_t) +
-                             2 * sizeof(bool)));
+    return *((ItemPointer *)prev_pointer_field.Locate(tuple_slot_id));
   }
 
   // Getters for addresses
 
   inline txn_id_t *GetTransactionIdLocation(const oid_t tuple_slot_id) const {
-    return ((txn_id_t *)(data + (tuple_slot_id * header_entry_size)));
+    return ((txn_id_t *)txn_id_field.Locate(tuple_slot_id));
   }
 
   inline bool LatchTupleSlot(const oid_t tuple_slot_id,
                              txn_id_t transaction_id) {
-    txn_id_t *txn_id = (txn_id_t *)(data + (tuple_slot_id * header_entry_size));
+    txn_id_t *txn_id = (txn_id_t *)txn_id_field.Locate(tuple_slot_id);
     if (atomic_cas(txn_id, INITIAL_TXN_ID, transaction_id)) {
       return true;
     } else {
@@ -163,7 +194,7 @@ class TileGroupHeader {
 
   inline bool ReleaseTupleSlot(const oid_t tuple_slot_id,
                                txn_id_t transaction_id) {
-    txn_id_t *txn_id = (txn_id_t *)(data + (tuple_slot_id * header_entry_size));
+    txn_id_t *txn_id = (txn_id_t *)txn_id_field.Locate(tuple_slot_id);
     if (!atomic_cas(txn_id, transaction_id, INITIAL_TXN_ID)) {
       LOG_INFO("Release failed, expecting a deleted own insert: %lu",
                GetTransactionId(tuple_slot_id));
@@ -175,95 +206,68 @@ class TileGroupHeader {
 
   inline void SetTransactionId(const oid_t tuple_slot_id,
                                txn_id_t transaction_id) {
-    *((txn_id_t *)(data + (tuple_slot_id * header_entry_size))) =
-        transaction_id;
+    *((txn_id_t *)txn_id_field.Locate(tuple_slot_id)) = transaction_id;
   }
 
   inline void SetBeginCommitId(const oid_t tuple_slot_id, cid_t begin_cid) {
-    *((cid_t *)(data + (tuple_slot_id * header_entry_size) +
-                sizeof(txn_id_t))) = begin_cid;
+    *((cid_t *)begin_cid_field.Locate(tuple_slot_id)) = begin_cid;
   }
 
   inline void SetEndCommitId(const oid_t tuple_slot_id, cid_t end_cid) const {
-    *((cid_t *)(data + (tuple_slot_id * header_entry_size) + sizeof(txn_id_t) +
-                sizeof(cid_t))) = end_cid;
+    *((cid_t *)end_cid_field.Locate(tuple_slot_id)) = end_cid;
   }
 
   inline void SetInsertCommit(const oid_t tuple_slot_id, bool commit) const {
-    *((bool *)(data + (tuple_slot_id * header_entry_size) + sizeof(txn_id_t) +
-               2 * sizeof(cid_t))) = commit;
+    *((bool *)insert_commit_field.Locate(tuple_slot_id)) = commit;
   }
 
   inline void SetDeleteCommit(const oid_t tuple_slot_id, bool commit) const {
-    *((bool *)(data + (tuple_slot_id * header_entry_size) + sizeof(txn_id_t) +
-               2 * sizeof(cid_t) + sizeof(bool))) = commit;
+    *((bool *)delete_commit_field.Locate(tuple_slot_id)) = commit;
   }
 
   inline void SetPrevItemPointer(const oid_t tuple_slot_id,
                                  ItemPointer item) const {
-    *((ItemPointer *)(data + (tuple_slot_id * header_entry_size) +
-                      sizeof(txn_id_t) + 2 * sizeof(cid_t) +
-                      2 * sizeof(bool))) = item;
+    *((ItemPointer *)prev_pointer_field.Locate(tuple_slot_id)) = item;
   }
 
   // Visibility check
   bool IsVisible(const oid_t tuple_slot_id, txn_id_t txn_id, cid_t at_lcid) {
-    txn_id_t tuple_txn_id = GetTransactionId(tuple_slot_id);
-    cid_t tuple_begin_cid = GetBeginCommitId(tuple_slot_id);
-    cid_t tuple_end_cid = GetEndCommitId(tuple_slot_id);
-
-    bool own = (txn_id == tuple_txn_id);
-    bool activated = (at_lcid >= tuple_begin_cid);
-    bool invalidated = (at_lcid >= tuple_end_cid);
-
-    // Own
-    LOG_TRACE("Own :: %d txn id : %lu tuple txn id : %lu", own, txn_id,
-              tuple_txn_id);
-
-    // Activated
-    if (tuple_begin_cid == MAX_CID) {
-      LOG_TRACE("Activated :: %d cid : %lu tuple begin cid : MAX_CID",
-                activated, at_lcid);
-    } else {
-      LOG_TRACE("Activated :: %d , lcid : %lu , tuple begin cid : %lu",
-                activated, at_lcid, tuple_begin_cid);
-    }
-
-    // Invalidated
-    if (tuple_end_cid == MAX_CID) {
-      LOG_TRACE("Invalidated:: %d cid : %lu tuple end cid : MAX_CID",
-                invalidated, at_lcid);
-    } else {
-      LOG_TRACE("Invalidated:: %d cid : %lu tuple end cid : %lu", invalidated,
-                at_lcid, tuple_end_cid);
-    }
-
-    // overwrite activated/invalidated if using peloton logging
-    {
-      auto &log_manager = logging::LogManager::GetInstance();
-      if (log_manager.HasPelotonFrontendLogger() == LOGGING_TYPE_NVM_NVM) {
-        bool insert_commit = GetInsertCommit(tuple_slot_id);
-        bool delete_commit = GetDeleteCommit(tuple_slot_id);
-
-        activated = activated && insert_commit;
-        invalidated = invalidated && delete_commit;
-      }
-    }
-
-    // Visible iff past Insert || Own Insert
-    bool visible = !(tuple_txn_id == INVALID_TXN_ID) &&
-                   ((!own && activated && !invalidated) ||
-                    (own && !activated && !invalidated));
+    bool visible =
+        CheckVisibility(tuple_slot_id, txn_id, at_lcid, UseCommitFlags());
 
     LOG_INFO(
         "<%p, %lu> :(vtid, vbeg, vend) = (%lu, %lu, %lu), (tid, lcid) = (%lu, "
         "%lu), visible = %d",
-        this, tuple_slot_id, tuple_txn_id, tuple_begin_cid, tuple_end_cid,
+        this, tuple_slot_id, GetTransactionId(tuple_slot_id),
+        GetBeginCommitId(tuple_slot_id), GetEndCommitId(tuple_slot_id),
         txn_id, at_lcid, visible);
 
     return visible;
   }
 
+  /**
+   * Batch visibility check over the tuple slots in [begin_slot, end_slot).
+   *
+   * Sets bit (tuple slot - begin_slot) in the bitmap for every visible slot.
+   * The bitmap must have room for GetBitmapWordCount(end_slot - begin_slot)
+   * words. With the column layout, the cids are compared four slots at a
+   * time with AVX2 when the CPU supports it.
+   *
+   * Returns the number of visible tuple slots.
+   */
+  oid_t GetVisibilityBitmap(txn_id_t txn_id, cid_t at_lcid, oid_t begin_slot,
+                            oid_t end_slot, uint64_t *bitmap) const;
+
+  // Batch visibility check that appends the visible tuple slots
+  // in [begin_slot, end_slot) to the position list
+  void GetVisiblePositionList(txn_id_t txn_id, cid_t at_lcid,
+                              oid_t begin_slot, oid_t end_slot,
+                              std::vector<oid_t> &position_list) const;
+
+  static inline size_t GetBitmapWordCount(oid_t slot_count) {
+    return (slot_count + 63) / 64;
+  }
+
   /**
    * This is called after latching
    */
@@ -303,6 +307,51 @@ class TileGroupHeader {
                                           sizeof(ItemPointer) +
                                           2 * sizeof(bool);
 
+  // Location of one MVCC field in the header :
+  // the entry of a tuple slot lives at base + (tuple slot * stride).
+  // With the row layout, stride is the header entry size, and with the
+  // column layout, it is the size of the field.
+  struct HeaderField {
+    char *base;
+    size_t stride;
+
+    inline char *Locate(const oid_t tuple_slot_id) const {
+      return base + (tuple_slot_id * stride);
+    }
+  };
+
+  // Set up the field locations for the layout type
+  void InitHeaderFields();
+
+  // Only the peloton logger marks inserts/deletes as committed
+  static inline bool UseCommitFlags() {
+    auto &log_manager = logging::LogManager::GetInstance();
+    return (log_manager.HasPelotonFrontendLogger() == LOGGING_TYPE_NVM_NVM);
+  }
+
+  inline bool CheckVisibility(const oid_t tuple_slot_id, txn_id_t txn_id,
+                              cid_t at_lcid, bool use_commit_flags) const {
+    txn_id_t tuple_txn_id = GetTransactionId(tuple_slot_id);
+
+    bool own = (txn_id == tuple_txn_id);
+    bool activated = (at_lcid >= GetBeginCommitId(tuple_slot_id));
+    bool invalidated = (at_lcid >= GetEndCommitId(tuple_slot_id));
+
+    // overwrite activated/invalidated if using peloton logging
+    if (use_commit_flags) {
+      activated = activated && GetInsertCommit(tuple_slot_id);
+      invalidated = invalidated && GetDeleteCommit(tuple_slot_id);
+    }
+
+    // Visible iff past Insert || Own Insert
+    return !(tuple_txn_id == INVALID_TXN_ID) &&
+           ((!own && activated && !invalidated) ||
+            (own && !activated && !invalidated));
+  }
+
+  // Copy all entries from a header with a different layout
+  void CopyHeaderEntries(const TileGroupHeader &other);
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
@@ -310,19 +359,27 @@ class TileGroupHeader {
   // Backend
   BackendType backend_type;
 
+  // Layout of the header entries
+  HeaderLayoutType layout_type;
+
   size_t header_size;
 
   // set of fixed-length tuple slots
   char *data;
 
+  // field locations within data
+  HeaderField txn_id_field;
+  HeaderField begin_cid_field;
+  HeaderField end_cid_field;
+  HeaderField insert_commit_field;
+  HeaderField delete_commit_field;
+  HeaderField prev_pointer_field;
+
   // number of tuple slots allocated
   oid_t num_tuple_slots;
 
   // next free tuple slot
-  oid_t next_tuple_slot;
-
-  // synch helpers
-  std::mutex tile_header_mutex;
+  std::atomic<oid_t> next_tuple_slot;
 };
 
 }  // End storage namespace
@@ -277,6 +277,59 @@ void Tuple::SerializeWithHeaderTo(SerializeOutput &output) {
   output.WriteIntAt(start, serialized_size);
 }
 
+/**
+ * Determine the number of bytes written by SerializeTo, including
+ * the 32 bit length preceding the values.
+ */
+size_t Tuple::GetSerializedSize() const {
+  size_t bytes = sizeof(int32_t);
+  int column_count = GetColumnCount();
+
+  for (int column_itr = 0; column_itr < column_count; ++column_itr) {
+    switch (GetType(column_itr)) {
+      case VALUE_TYPE_TINYINT:
+        bytes += sizeof(int8_t);
+        break;
+
+      case VALUE_TYPE_SMALLINT:
+        bytes += sizeof(int16_t);
+        break;
+
+      case VALUE_TYPE_INTEGER:
+        bytes += sizeof(int32_t);
+        break;
+
+      case VALUE_TYPE_BIGINT:
+      case VALUE_TYPE_TIMESTAMP:
+      case VALUE_TYPE_DOUBLE:
+        bytes += sizeof(int64_t);
+        break;
+
+      case VALUE_TYPE_DECIMAL:
+        // two 64 bit halves
+        bytes += 2 * sizeof(int64_t);
+        break;
+
+      case VALUE_TYPE_VARCHAR:
+      case VALUE_TYPE_VARBINARY:
+        // 32 bit length preceding the data, only the length if null
+        bytes += sizeof(int32_t);
+        if (!GetValue(column_itr).IsNull()) {
+          bytes += ValuePeeker::PeekObjectLengthWithoutNull(
+              GetValue(column_itr));
+        }
+        break;
+
+      default:
+        throw UnknownTypeException(GetType(column_itr),
+                                   "Unknown ValueType found during "
+                                   "serialization.");
+        return (size_t)0;
+    }
+  }
+  return bytes;
+}
+
 void Tuple::SerializeTo(SerializeOutput &output) {
   size_t start = output.ReserveBytes(4);
   const int column_count = tuple_schema->GetColumnCount();
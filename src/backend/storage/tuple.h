@@ -170,6 +170,7 @@ class Tuple : public AbstractTuple {
   //===--------------------------------------------------------------------===//
 
   void SerializeTo(SerializeOutput &output);
+  size_t GetSerializedSize() const;
   void SerializeToExport(ExportSerializeOutput &output, int col_offset,
                          uint8_t *null_array);
   void SerializeWithHeaderTo(SerializeOutput &output);
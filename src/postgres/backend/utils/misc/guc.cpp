@@ -500,6 +500,18 @@ LoggingType     peloton_logging_mode;
 // Directory for peloton logs
 char    *peloton_log_directory;
 
+// Number of log streams
+int     peloton_log_stream_count;
+
+// Number of threads replaying the log during recovery
+int     peloton_recovery_thread_count;
+
+// Interval between checkpoints (in seconds)
+int     peloton_checkpoint_interval;
+
+// Number of insert lanes per table
+int     peloton_insert_lane_count;
+
 /*
  * This really belongs in pg_shmem.c, but is defined here so that it doesn't
  * need to be duplicated in all the different implementations of pg_shmem.c.
@@ -2719,6 +2731,53 @@ struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	// TODO: Peloton Changes
+	{
+		{"peloton_log_stream_count", PGC_POSTMASTER, PELOTON_LOGGING_OPTIONS,
+			gettext_noop("Sets the number of log files written in parallel by Peloton."),
+			gettext_noop("Backends are spread over the log streams, "
+						 "recovery merges them in commit order.")
+		},
+		&peloton_log_stream_count,
+		1, 1, 64,
+		NULL, NULL, NULL
+	},
+
+	// TODO: Peloton Changes
+	{
+		{"peloton_recovery_thread_count", PGC_POSTMASTER, PELOTON_LOGGING_OPTIONS,
+			gettext_noop("Sets the number of threads replaying the log during Peloton recovery."),
+			gettext_noop("Zero uses one thread per core.")
+		},
+		&peloton_recovery_thread_count,
+		0, 0, 64,
+		NULL, NULL, NULL
+	},
+
+	// TODO: Peloton Changes
+	{
+		{"peloton_checkpoint_interval", PGC_POSTMASTER, PELOTON_LOGGING_OPTIONS,
+			gettext_noop("Sets the interval between Peloton checkpoints."),
+			gettext_noop("Zero disables the background checkpointer."),
+			GUC_UNIT_S
+		},
+		&peloton_checkpoint_interval,
+		0, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
+	// TODO: Peloton Changes
+	{
+		{"peloton_insert_lane_count", PGC_POSTMASTER, PELOTON_LAYOUT_OPTIONS,
+			gettext_noop("Sets the number of insert lanes of each Peloton table."),
+			gettext_noop("Concurrent inserts go to the tile group of their "
+						 "lane, one lane keeps a single tile group.")
+		},
+		&peloton_insert_lane_count,
+		1, 1, 64,
+		NULL, NULL, NULL
+	},
+
 	/* End-of-list marker */
 	{
 		{NULL, static_cast<GucContext>(0), static_cast<config_group>(0), NULL, NULL}, NULL, 0, 0, 0, NULL, NULL, NULL
@@ -14,6 +14,7 @@
 
 #include "harness.h"
 #include "backend/catalog/manager.h"
+#include "backend/common/epoch_manager.h"
 #include "backend/catalog/schema.h"
 #include "backend/storage/tile_group.h"
 #include "backend/storage/tile_group_factory.h"
@@ -66,5 +67,63 @@ TEST(ManagerTests, TransactionTest) {
   EXPECT_EQ(catalog::Manager::GetInstance().GetCurrentOid(), 800);
 }
 
+TEST(ManagerTests, TileGroupDirectoryTest) {
+  auto &manager = catalog::Manager::GetInstance();
+
+  std::vector<catalog::Column> columns(
+      {catalog::Column(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER), "A",
+                       true)});
+  std::vector<catalog::Schema> schemas({catalog::Schema(columns)});
+  std::map<oid_t, std::pair<oid_t, oid_t>> column_map;
+  column_map[0] = std::make_pair(0, 0);
+
+  // Tile group oids in different directory segments
+  const oid_t tile_group_count = 8;
+  std::vector<oid_t> tile_group_ids;
+  for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    tile_group_ids.push_back((1 << 20) + tile_group_itr * 10000);
+  }
+
+  for (auto tile_group_id : tile_group_ids) {
+    std::shared_ptr<storage::TileGroup> tile_group(
+        storage::TileGroupFactory::GetTileGroup(INVALID_OID, INVALID_OID,
+                                                tile_group_id, nullptr,
+                                                schemas, column_map, 3));
+    manager.AddTileGroup(tile_group_id, tile_group);
+  }
+
+  // Concurrent lookups
+  LaunchParallelTest(8, [&]() {
+    for (int round_itr = 0; round_itr < 100; round_itr++) {
+      EpochGuard epoch_guard;
+      for (auto tile_group_id : tile_group_ids) {
+        auto tile_group = manager.LookupTileGroup(tile_group_id);
+        EXPECT_TRUE(tile_group != nullptr);
+        EXPECT_EQ(tile_group_id, tile_group->GetTileGroupId());
+      }
+    }
+  });
+
+  // Replacing a tile group keeps the old one alive for its holders
+  auto old_tile_group = manager.GetTileGroup(tile_group_ids[0]);
+  std::shared_ptr<storage::TileGroup> new_tile_group(
+      storage::TileGroupFactory::GetTileGroup(INVALID_OID, INVALID_OID,
+                                              tile_group_ids[0], nullptr,
+                                              schemas, column_map, 3));
+  manager.AddTileGroup(tile_group_ids[0], new_tile_group);
+  EXPECT_EQ(new_tile_group.get(), manager.LookupTileGroup(tile_group_ids[0]));
+  EXPECT_TRUE(old_tile_group.unique());
+
+  for (auto tile_group_id : tile_group_ids) {
+    manager.DropTileGroup(tile_group_id);
+    EXPECT_TRUE(manager.LookupTileGroup(tile_group_id) == nullptr);
+    EXPECT_TRUE(manager.GetTileGroup(tile_group_id) == nullptr);
+  }
+
+  // Never added
+  EXPECT_TRUE(manager.GetTileGroup(tile_group_ids.back() + 1) == nullptr);
+}
+
 }  // End test namespace
 }  // End peloton namespace
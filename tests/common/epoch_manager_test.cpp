@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// epoch_manager_test.cpp
+//
+// Identification: tests/common/epoch_manager_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "harness.h"
+
+#include "backend/common/epoch_manager.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Epoch Manager Tests
+//===--------------------------------------------------------------------===//
+
+TEST(EpochManagerTests, RetireTest) {
+  auto &epoch_manager = EpochManager::GetInstance();
+  epoch_manager.Reclaim();
+
+  std::atomic<int> freed_count(0);
+
+  // Nobody is reading, freed right away
+  epoch_manager.Retire([&freed_count]() { freed_count++; });
+  EXPECT_EQ(1, freed_count);
+
+  // A reader that entered before the retire holds it back
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool entered = false;
+  bool retired = false;
+
+  std::thread reader([&]() {
+    EpochGuard epoch_guard;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      entered = true;
+      condition.notify_all();
+      condition.wait(lock, [&retired]() { return retired; });
+    }
+  });
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&entered]() { return entered; });
+  }
+
+  epoch_manager.Retire([&freed_count]() { freed_count++; });
+  EXPECT_EQ(1, freed_count);
+  EXPECT_EQ(1, epoch_manager.GetRetiredCount());
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    retired = true;
+    condition.notify_all();
+  }
+  reader.join();
+
+  epoch_manager.Reclaim();
+  EXPECT_EQ(2, freed_count);
+  EXPECT_EQ(0, epoch_manager.GetRetiredCount());
+}
+
+TEST(EpochManagerTests, NestedEpochTest) {
+  auto &epoch_manager = EpochManager::GetInstance();
+  std::atomic<int> freed_count(0);
+
+  {
+    EpochGuard outer_guard;
+    {
+      EpochGuard inner_guard;
+    }
+
+    // Still inside the outer epoch
+    epoch_manager.Retire([&freed_count]() { freed_count++; });
+    EXPECT_EQ(0, freed_count);
+  }
+
+  epoch_manager.Reclaim();
+  EXPECT_EQ(1, freed_count);
+}
+
+}  // End test namespace
+}  // End peloton namespace
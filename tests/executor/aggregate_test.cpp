@@ -26,6 +26,7 @@
 #include "backend/executor/executor_context.h"
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/aggregate_executor.h"
+#include "backend/executor/aggregator.h"
 #include "backend/executor/logical_tile_factory.h"
 #include "backend/expression/expression_util.h"
 #include "backend/planner/abstract_plan.h"
@@ -762,5 +763,194 @@ TEST(AggregateTests, PlainSumCountDistinctTest) {
                   .IsTrue());
 }
 
+TEST(AggregateTests, AggregateArenaTest) {
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_SUM, nullptr);
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_AVG, nullptr);
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_MIN, nullptr);
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_MAX, nullptr);
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_COUNT, nullptr);
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_COUNT_STAR, nullptr);
+  EXPECT_TRUE(executor::AggregateArena::IsSupported(agg_terms));
+
+  executor::AggregateArena arena(agg_terms);
+
+  // Spread the groups over more than one block
+  const oid_t group_count = 10000;
+  const int tuples_per_group = 3;
+  for (oid_t group_itr = 0; group_itr < group_count; group_itr++) {
+    EXPECT_EQ(group_itr, arena.AddGroup());
+  }
+
+  std::vector<Value> values(agg_terms.size());
+  for (int tuple_itr = 0; tuple_itr < tuples_per_group; tuple_itr++) {
+    for (oid_t group_itr = 0; group_itr < group_count; group_itr++) {
+      Value value = ValueFactory::GetIntegerValue(group_itr + tuple_itr);
+      std::fill(values.begin(), values.end(), value);
+
+      // Nulls only count for COUNT(*)
+      if (tuple_itr == 0 && group_itr % 2 == 0) {
+        std::fill(values.begin(), values.end(),
+                  ValueFactory::GetNullValue());
+      }
+      EXPECT_TRUE(arena.Advance(group_itr, values));
+    }
+  }
+  EXPECT_EQ(group_count, arena.GetGroupCount());
+
+  for (oid_t group_itr = 0; group_itr < group_count; group_itr++) {
+    int group = static_cast<int>(group_itr);
+    int first = (group % 2 == 0) ? 1 : 0;
+    int count = tuples_per_group - first;
+    int sum = 0;
+    for (int tuple_itr = first; tuple_itr < tuples_per_group; tuple_itr++) {
+      sum += group + tuple_itr;
+    }
+
+    EXPECT_EQ(sum, ValuePeeker::PeekAsInteger(arena.Finalize(group_itr, 0)));
+    EXPECT_EQ(static_cast<double>(sum) / count,
+              ValuePeeker::PeekDouble(arena.Finalize(group_itr, 1)));
+    EXPECT_EQ(group + first,
+              ValuePeeker::PeekAsInteger(arena.Finalize(group_itr, 2)));
+    EXPECT_EQ(group + tuples_per_group - 1,
+              ValuePeeker::PeekAsInteger(arena.Finalize(group_itr, 3)));
+    EXPECT_EQ(count, ValuePeeker::PeekAsInteger(arena.Finalize(group_itr, 4)));
+    EXPECT_EQ(tuples_per_group,
+              ValuePeeker::PeekAsInteger(arena.Finalize(group_itr, 5)));
+
+    // The Agg objects built from the slots give the same results
+    for (oid_t agg_itr = 0; agg_itr < agg_terms.size(); agg_itr++) {
+      std::unique_ptr<executor::Agg> aggregate(
+          arena.GetAgg(group_itr, agg_itr));
+      EXPECT_TRUE(aggregate->Finalize()
+                      .OpEquals(arena.Finalize(group_itr, agg_itr))
+                      .IsTrue());
+    }
+  }
+
+  // A value of another type does not fit the bound slots
+  std::fill(values.begin(), values.end(), ValueFactory::GetDoubleValue(1.5));
+  EXPECT_FALSE(arena.Advance(0, values));
+  EXPECT_EQ(tuples_per_group,
+            ValuePeeker::PeekAsInteger(arena.Finalize(0, 5)));
+
+  // Distinct aggregates keep their values in Agg objects
+  agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_COUNT, nullptr, true);
+  EXPECT_FALSE(executor::AggregateArena::IsSupported(agg_terms));
+}
+
+TEST(AggregateTests, ParallelHashAggregateTest) {
+  /*
+   * SELECT a, SUM(b), MAX(c), COUNT([DISTINCT] b) from table GROUP BY a;
+   */
+  // Partial groups kept in arenas, and in Agg objects for DISTINCT
+  for (bool distinct : {false, true}) {
+    const int tile_group_size = TESTS_TUPLES_PER_TILEGROUP;
+    const int tile_group_count = 4;
+    const int tuple_count = tile_group_size * tile_group_count;
+
+    auto &txn_manager = concurrency::TransactionManager::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    auto txn_id = txn->GetTransactionId();
+    std::unique_ptr<storage::DataTable> data_table(
+        ExecutorTestsUtil::CreateTable(tile_group_size, false));
+    ExecutorTestsUtil::PopulateTable(txn, data_table.get(), tuple_count,
+                                     false, false, true);
+    txn_manager.CommitTransaction();
+
+    // 1) Set up group-by columns
+    std::vector<oid_t> group_by_columns = {0};
+
+    // 2) Set up project info
+    planner::ProjectInfo::DirectMapList direct_map_list = {
+        {0, {0, 0}}, {1, {1, 0}}, {2, {1, 1}}, {3, {1, 2}}};
+    auto proj_info = new planner::ProjectInfo(
+        planner::ProjectInfo::TargetList(), std::move(direct_map_list));
+
+    // 3) Set up unique aggregates
+    std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+    agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_SUM,
+                           expression::TupleValueFactory(0, 1));
+    agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_MAX,
+                           expression::TupleValueFactory(0, 2));
+    agg_terms.emplace_back(EXPRESSION_TYPE_AGGREGATE_COUNT,
+                           expression::TupleValueFactory(0, 1), distinct);
+
+    // 4) Create output table schema
+    auto data_table_schema = data_table.get()->GetSchema();
+    std::vector<catalog::Column> columns;
+    for (oid_t column_index : {0, 1, 2}) {
+      columns.push_back(data_table_schema->GetColumn(column_index));
+    }
+    columns.push_back(catalog::Column(
+        VALUE_TYPE_BIGINT, GetTypeSize(VALUE_TYPE_BIGINT), "COUNT", true));
+    auto output_table_schema = new catalog::Schema(columns);
+
+    planner::AggregatePlan node(proj_info, nullptr, std::move(agg_terms),
+                                std::move(group_by_columns),
+                                output_table_schema, AGGREGATE_TYPE_HASH);
+    node.SetParallelism(4);
+
+    // Create and set up executor
+    auto txn2 = txn_manager.BeginTransaction();
+    std::unique_ptr<executor::ExecutorContext> context(
+        new executor::ExecutorContext(txn2));
+
+    executor::AggregateExecutor executor(&node, context.get());
+    MockExecutor child_executor;
+    executor.AddChild(&child_executor);
+
+    EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+    EXPECT_CALL(child_executor, DExecute())
+        .WillOnce(Return(true))
+        .WillOnce(Return(true))
+        .WillOnce(Return(true))
+        .WillOnce(Return(true))
+        .WillOnce(Return(false));
+    EXPECT_CALL(child_executor, GetOutput())
+        .WillOnce(Return(executor::LogicalTileFactory::WrapTileGroup(
+            data_table->GetTileGroup(0), txn_id)))
+        .WillOnce(Return(executor::LogicalTileFactory::WrapTileGroup(
+            data_table->GetTileGroup(1), txn_id)))
+        .WillOnce(Return(executor::LogicalTileFactory::WrapTileGroup(
+            data_table->GetTileGroup(2), txn_id)))
+        .WillOnce(Return(executor::LogicalTileFactory::WrapTileGroup(
+            data_table->GetTileGroup(3), txn_id)));
+
+    EXPECT_TRUE(executor.Init());
+
+    // Two groups of half of the tuples each
+    const int group_size = tuple_count / 2;
+    std::set<int> groups;
+    while (executor.Execute()) {
+      std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+      for (oid_t tuple_id : *result_tile) {
+        int group = ValuePeeker::PeekAsInteger(
+                        result_tile->GetValue(tuple_id, 0)) /
+                    ExecutorTestsUtil::PopulatedValue(1, 0);
+        groups.insert(group);
+
+        int first = group * group_size;
+        int last = first + group_size - 1;
+        int sum = 0;
+        for (int row = first; row <= last; row++) {
+          sum += ExecutorTestsUtil::PopulatedValue(row, 1);
+        }
+
+        EXPECT_EQ(sum, ValuePeeker::PeekAsInteger(
+                           result_tile->GetValue(tuple_id, 1)));
+        EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(last, 2),
+                  ValuePeeker::PeekDouble(result_tile->GetValue(tuple_id, 2)));
+        EXPECT_EQ(group_size, ValuePeeker::PeekAsInteger(
+                                  result_tile->GetValue(tuple_id, 3)));
+      }
+    }
+
+    txn_manager.CommitTransaction();
+
+    EXPECT_EQ(std::set<int>({0, 1}), groups);
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
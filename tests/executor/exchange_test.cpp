@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// exchange_test.cpp
+//
+// Identification: tests/executor/exchange_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "backend/common/types.h"
+#include "backend/concurrency/transaction_manager.h"
+#include "backend/executor/executor_context.h"
+#include "backend/executor/exchange_executor.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/executor/seq_scan_executor.h"
+#include "backend/planner/exchange_plan.h"
+#include "backend/planner/seq_scan_plan.h"
+#include "backend/storage/data_table.h"
+
+#include "executor/executor_tests_util.h"
+#include "executor/mock_executor.h"
+#include "harness.h"
+
+using ::testing::Return;
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Exchange Tests
+//===--------------------------------------------------------------------===//
+
+namespace {
+
+const int tuple_count = 5;
+const int tile_group_count = 20;
+const oid_t parallelism = 4;
+
+}
+
+TEST(ExchangeTests, ParallelSeqScanTest) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuple_count, false));
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(),
+                                   tuple_count * tile_group_count, false,
+                                   false, false);
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  std::vector<oid_t> column_ids({0});
+  planner::SeqScanPlan scan_node(data_table.get(), nullptr, column_ids);
+  planner::ExchangePlan exchange_node(parallelism, 1);
+
+  // One copy of the scan per worker
+  std::vector<std::unique_ptr<executor::SeqScanExecutor>> scan_executors;
+  for (oid_t worker_itr = 0; worker_itr < parallelism; worker_itr++) {
+    scan_executors.emplace_back(
+        new executor::SeqScanExecutor(&scan_node, context.get()));
+  }
+
+  executor::ExchangeExecutor exchange_executor(&exchange_node, context.get());
+  for (auto &scan_executor : scan_executors) {
+    exchange_executor.AddChild(scan_executor.get());
+  }
+
+  EXPECT_TRUE(exchange_executor.Init());
+
+  // Every tuple shows up exactly once, no matter which worker scanned it
+  std::vector<int> values;
+  while (exchange_executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        exchange_executor.GetOutput());
+    for (oid_t tuple_id : *result_tile) {
+      values.push_back(
+          result_tile->GetValue(tuple_id, 0).GetIntegerForTestsOnly());
+    }
+  }
+
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ(tuple_count * tile_group_count, values.size());
+  for (oid_t value_itr = 0; value_itr < values.size(); value_itr++) {
+    EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(value_itr, 0),
+              values[value_itr]);
+  }
+
+  txn_manager.CommitTransaction();
+}
+
+TEST(ExchangeTests, CancelTest) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuple_count, false));
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(),
+                                   tuple_count * tile_group_count, false,
+                                   false, false);
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  std::vector<oid_t> column_ids({0});
+  planner::SeqScanPlan scan_node(data_table.get(), nullptr, column_ids);
+  planner::ExchangePlan exchange_node(parallelism, 1);
+
+  std::vector<std::unique_ptr<executor::SeqScanExecutor>> scan_executors;
+  for (oid_t worker_itr = 0; worker_itr < parallelism; worker_itr++) {
+    scan_executors.emplace_back(
+        new executor::SeqScanExecutor(&scan_node, context.get()));
+  }
+
+  {
+    executor::ExchangeExecutor exchange_executor(&exchange_node,
+                                                 context.get());
+    for (auto &scan_executor : scan_executors) {
+      exchange_executor.AddChild(scan_executor.get());
+    }
+
+    EXPECT_TRUE(exchange_executor.Init());
+
+    // Stop pulling while the workers are blocked on the full queue
+    EXPECT_TRUE(exchange_executor.Execute());
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        exchange_executor.GetOutput());
+    EXPECT_EQ(tuple_count, result_tile->GetTupleCount());
+
+    // Initializing again joins the blocked workers before the children
+    // are initialized, then the whole table is scanned again
+    EXPECT_TRUE(exchange_executor.Init());
+    size_t result_tuple_count = 0;
+    while (exchange_executor.Execute()) {
+      std::unique_ptr<executor::LogicalTile> tile(
+          exchange_executor.GetOutput());
+      result_tuple_count += tile->GetTupleCount();
+    }
+    EXPECT_EQ(tuple_count * tile_group_count, result_tuple_count);
+
+    // Destroying the exchange cancels and joins the workers
+  }
+
+  txn_manager.CommitTransaction();
+}
+
+TEST(ExchangeTests, UnsplittableChildTest) {
+  planner::ExchangePlan exchange_node(2);
+
+  MockExecutor child_executor1;
+  MockExecutor child_executor2;
+
+  EXPECT_CALL(child_executor1, DInit()).WillOnce(Return(true));
+  EXPECT_CALL(child_executor2, DInit()).WillOnce(Return(true));
+
+  // Mock executors have no scan to share
+  executor::ExchangeExecutor exchange_executor(&exchange_node, nullptr);
+  exchange_executor.AddChild(&child_executor1);
+  exchange_executor.AddChild(&child_executor2);
+
+  EXPECT_FALSE(exchange_executor.Init());
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include <memory>
+#include <set>
+#include <utility>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -21,10 +23,14 @@
 
 #include "backend/executor/hash_join_executor.h"
 #include "backend/executor/hash_executor.h"
+#include "backend/executor/join_bloom_filter.h"
+#include "backend/executor/join_hash_table.h"
 #include "backend/executor/merge_join_executor.h"
 #include "backend/executor/nested_loop_join_executor.h"
+#include "backend/executor/radix_partitioner.h"
 
 #include "backend/expression/abstract_expression.h"
+#include "backend/expression/container_tuple.h"
 #include "backend/expression/tuple_value_expression.h"
 #include "backend/expression/expression_util.h"
 
@@ -78,6 +84,214 @@ enum JOIN_TEST_TYPE {
   BASIC_TEST = 0
 };
 
+TEST(JoinTests, JoinHashTableTest) {
+  executor::JoinHashTable hash_table;
+  hash_table.Clear(1);
+
+  const oid_t key_count = 100;
+  const oid_t tile_count = 3;
+
+  // Every key shows up once per tile; keys share a handful of hash values
+  // so that probing has to compare keys and the table has to grow
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    for (oid_t key_itr = 0; key_itr < key_count; key_itr++) {
+      Value key = ValueFactory::GetIntegerValue(key_itr);
+      hash_table.Insert(key_itr % 7, &key, tile_itr, key_itr);
+    }
+  }
+
+  EXPECT_EQ(key_count, hash_table.GetKeyCount());
+  EXPECT_EQ(key_count * tile_count, hash_table.GetEntryCount());
+
+  for (oid_t key_itr = 0; key_itr < key_count; key_itr++) {
+    Value key = ValueFactory::GetIntegerValue(key_itr);
+    auto entry_itr = hash_table.Find(key_itr % 7, &key);
+
+    // The chain holds the tuple of every tile, in insertion order
+    for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+      ASSERT_NE(INVALID_OID, entry_itr);
+      auto &entry = hash_table.GetEntry(entry_itr);
+      EXPECT_EQ(tile_itr, entry.tile_offset);
+      EXPECT_EQ(key_itr, entry.tuple_offset);
+      entry_itr = entry.next_entry;
+    }
+    EXPECT_EQ(INVALID_OID, entry_itr);
+  }
+
+  Value missing_key = ValueFactory::GetIntegerValue(key_count);
+  EXPECT_EQ(INVALID_OID, hash_table.Find(key_count % 7, &missing_key));
+}
+
+TEST(JoinTests, JoinBloomFilterTest) {
+  const size_t key_count = 10000;
+  executor::JoinBloomFilter bloom_filter(key_count);
+
+  std::vector<size_t> hashes;
+  for (size_t key_itr = 0; key_itr < 2 * key_count; key_itr++) {
+    Value key = ValueFactory::GetIntegerValue(key_itr);
+    hashes.push_back(executor::JoinHashTable::GetHash(&key, 1));
+  }
+
+  for (size_t key_itr = 0; key_itr < key_count; key_itr++) {
+    bloom_filter.Insert(hashes[key_itr]);
+  }
+
+  // No false negatives
+  for (size_t key_itr = 0; key_itr < key_count; key_itr++) {
+    EXPECT_TRUE(bloom_filter.MayContain(hashes[key_itr]));
+  }
+
+  // Few false positives
+  size_t false_positive_count = 0;
+  for (size_t key_itr = key_count; key_itr < 2 * key_count; key_itr++) {
+    if (bloom_filter.MayContain(hashes[key_itr])) false_positive_count++;
+  }
+  EXPECT_LT(false_positive_count, key_count / 20);
+}
+
+TEST(JoinTests, RadixPartitionerTest) {
+  const size_t tile_group_count = 4;
+  const size_t tuple_count = TESTS_TUPLES_PER_TILEGROUP * tile_group_count;
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto txn_id = txn->GetTransactionId();
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP));
+  ExecutorTestsUtil::PopulateTable(txn, table.get(), tuple_count, false, false,
+                                   false);
+  txn_manager.CommitTransaction();
+
+  std::vector<std::unique_ptr<executor::LogicalTile>> tiles;
+  for (size_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    tiles.emplace_back(executor::LogicalTileFactory::WrapTileGroup(
+        table->GetTileGroup(tile_group_itr), txn_id));
+  }
+
+  // More bits than a single pass takes
+  const size_t partition_bits = executor::RadixPartitioner::max_bits_per_pass + 2;
+  std::vector<oid_t> column_ids = {0, 1};
+
+  executor::RadixPartitioner partitioner(partition_bits);
+  partitioner.Partition(tiles, column_ids, 3);
+  EXPECT_EQ(size_t(1) << partition_bits, partitioner.GetPartitionCount());
+
+  std::set<std::pair<oid_t, oid_t>> partitioned_tuples;
+  std::vector<Value> key(column_ids.size());
+  for (size_t partition = 0; partition < partitioner.GetPartitionCount();
+       partition++) {
+    const executor::RadixPartitioner::Tuple *previous = nullptr;
+    for (auto tuple = partitioner.GetPartitionBegin(partition);
+         tuple != partitioner.GetPartitionEnd(partition); tuple++) {
+      // Partitioned by the top bits of the key hash
+      auto hash = executor::JoinHashTable::GetKey(
+          tiles[tuple->tile_offset].get(), tuple->tuple_offset, column_ids,
+          key.data());
+      EXPECT_EQ(hash, tuple->hash);
+      EXPECT_EQ(partition, hash >> (sizeof(size_t) * 8 - partition_bits));
+
+      // In input order inside the partition
+      if (previous != nullptr) {
+        EXPECT_TRUE(std::make_pair(previous->tile_offset,
+                                   previous->tuple_offset) <
+                    std::make_pair(tuple->tile_offset, tuple->tuple_offset));
+      }
+      previous = tuple;
+
+      partitioned_tuples.emplace(tuple->tile_offset, tuple->tuple_offset);
+    }
+  }
+
+  EXPECT_EQ(tuple_count, partitioned_tuples.size());
+}
+
+TEST(JoinTests, PartitionedHashJoinTest) {
+  // Partitioned on worker threads, and serially with the single hash table
+  for (oid_t parallelism : {4, 1}) {
+    MockExecutor left_table_scan_executor, right_table_scan_executor;
+
+    size_t tile_group_size = TESTS_TUPLES_PER_TILEGROUP;
+    size_t left_table_tile_group_count = 3;
+    size_t right_table_tile_group_count = 2;
+
+    auto &txn_manager = concurrency::TransactionManager::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    auto txn_id = txn->GetTransactionId();
+
+    std::unique_ptr<storage::DataTable> left_table(
+        ExecutorTestsUtil::CreateTable(tile_group_size));
+    ExecutorTestsUtil::PopulateTable(
+        txn, left_table.get(), tile_group_size * left_table_tile_group_count,
+        false, false, false);
+
+    std::unique_ptr<storage::DataTable> right_table(
+        ExecutorTestsUtil::CreateTable(tile_group_size));
+    ExecutorTestsUtil::PopulateTable(
+        txn, right_table.get(), tile_group_size * right_table_tile_group_count,
+        false, false, false);
+
+    txn_manager.CommitTransaction();
+
+    EXPECT_CALL(left_table_scan_executor, DInit()).WillOnce(Return(true));
+    EXPECT_CALL(left_table_scan_executor, DExecute())
+        .WillOnce(Return(true))
+        .WillOnce(Return(true))
+        .WillOnce(Return(true))
+        .WillOnce(Return(false));
+    EXPECT_CALL(left_table_scan_executor, GetOutput())
+        .WillOnce(Return(executor::LogicalTileFactory::WrapTileGroup(
+            left_table->GetTileGroup(0), txn_id)))
+        .WillOnce(Return(executor::LogicalTileFactory::WrapTileGroup(
+            left_table->GetTileGroup(1), txn_id)))
+        .WillOnce(Return(executor::LogicalTileFactory::WrapTileGroup(
+            left_table->GetTileGroup(2), txn_id)));
+
+    EXPECT_CALL(right_table_scan_executor, DInit()).WillOnce(Return(true));
+    EXPECT_CALL(right_table_scan_executor, DExecute())
+        .WillOnce(Return(true))
+        .WillOnce(Return(true))
+        .WillOnce(Return(false));
+    EXPECT_CALL(right_table_scan_executor, GetOutput())
+        .WillOnce(Return(executor::LogicalTileFactory::WrapTileGroup(
+            right_table->GetTileGroup(0), txn_id)))
+        .WillOnce(Return(executor::LogicalTileFactory::WrapTileGroup(
+            right_table->GetTileGroup(1), txn_id)));
+
+    std::vector<std::unique_ptr<const expression::AbstractExpression>>
+        hash_keys;
+    hash_keys.emplace_back(new expression::TupleValueExpression(1, 1));
+    planner::HashPlan hash_plan_node(hash_keys);
+    executor::HashExecutor hash_executor(&hash_plan_node, nullptr);
+
+    planner::HashJoinPlan hash_join_plan_node(
+        JOIN_TYPE_INNER, JoinTestsUtil::CreateJoinPredicate(),
+        JoinTestsUtil::CreateProjection());
+    hash_join_plan_node.SetParallelism(parallelism);
+    executor::HashJoinExecutor hash_join_executor(&hash_join_plan_node,
+                                                  nullptr);
+
+    hash_join_executor.AddChild(&left_table_scan_executor);
+    hash_join_executor.AddChild(&hash_executor);
+    hash_executor.AddChild(&right_table_scan_executor);
+
+    EXPECT_TRUE(hash_join_executor.Init());
+
+    oid_t result_tuple_count = 0;
+    while (hash_join_executor.Execute() == true) {
+      std::unique_ptr<executor::LogicalTile> result_logical_tile(
+          hash_join_executor.GetOutput());
+      result_tuple_count += result_logical_tile->GetTupleCount();
+    }
+
+    EXPECT_EQ(parallelism > 1, hash_executor.IsPartitioned());
+
+    // Every right tuple matches one left tuple
+    EXPECT_EQ(tile_group_size * right_table_tile_group_count,
+              result_tuple_count);
+  }
+}
+
 TEST(JoinTests, JoinPredicateTest) {
 
   oid_t join_test_types = 1;
@@ -298,7 +298,8 @@ TEST(MutateTests, InsertTest) {
       ExecutorTestsUtil::CreateTable());
   const std::vector<storage::Tuple *> tuples;
 
-  EXPECT_EQ(source_data_table->GetTileGroupCount(), 3);
+  // Filling up the third tile group pre-allocates a fourth one
+  EXPECT_EQ(source_data_table->GetTileGroupCount(), 4);
   EXPECT_EQ(dest_data_table->GetTileGroupCount(), 1);
 
   auto txn = txn_manager.BeginTransaction();
@@ -340,8 +341,9 @@ TEST(MutateTests, InsertTest) {
 
   txn_manager.CommitTransaction();
 
-  // We have inserted all the tuples in this logical tile
-  EXPECT_EQ(dest_data_table->GetTileGroupCount(), 1);
+  // We have inserted all the tuples in this logical tile,
+  // which fills up the first tile group and pre-allocates the next one
+  EXPECT_EQ(dest_data_table->GetTileGroupCount(), 2);
 }
 
 }  // namespace test
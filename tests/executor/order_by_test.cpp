@@ -21,9 +21,11 @@
 #include "backend/planner/order_by_plan.h"
 #include "backend/common/types.h"
 #include "backend/common/value.h"
+#include "backend/common/value_peeker.h"
 #include "backend/executor/executor_context.h"
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/order_by_executor.h"
+#include "backend/executor/sort_key_encoder.h"
 #include "backend/executor/logical_tile_factory.h"
 #include "backend/storage/data_table.h"
 
@@ -325,6 +327,166 @@ TEST(OrderByTests, StringDescIntAscTest) {
 
   RunTest(executor, tile_size * 2, sort_keys, descend_flags);
 }
+
+TEST(OrderByTests, SortKeyEncoderTest) {
+  std::vector<Value> values;
+  values.push_back(ValueFactory::GetIntegerValue(0));
+  values.push_back(ValueFactory::GetIntegerValue(-1));
+  values.push_back(ValueFactory::GetIntegerValue(1));
+  values.push_back(ValueFactory::GetIntegerValue(PELOTON_INT32_MIN));
+  values.push_back(ValueFactory::GetIntegerValue(INT32_MAX));
+  values.push_back(ValueFactory::GetNullValueByType(VALUE_TYPE_INTEGER));
+
+  std::vector<Value> double_values;
+  double_values.push_back(ValueFactory::GetDoubleValue(0.0));
+  double_values.push_back(ValueFactory::GetDoubleValue(-0.0));
+  double_values.push_back(ValueFactory::GetDoubleValue(-2.5));
+  double_values.push_back(ValueFactory::GetDoubleValue(-1e300));
+  double_values.push_back(ValueFactory::GetDoubleValue(3.25));
+  double_values.push_back(ValueFactory::GetDoubleValue(1e-300));
+
+  std::vector<Value> string_values;
+  string_values.push_back(ValueFactory::GetStringValue(""));
+  string_values.push_back(ValueFactory::GetStringValue("a"));
+  string_values.push_back(ValueFactory::GetStringValue("ab"));
+  string_values.push_back(ValueFactory::GetStringValue("b"));
+  string_values.push_back(ValueFactory::GetStringValue("ba"));
+  string_values.push_back(ValueFactory::GetNullValueByType(VALUE_TYPE_VARCHAR));
+
+  // Keys compare as the values they encode, reversed when descending
+  for (auto value_list : {&values, &double_values, &string_values}) {
+    for (auto &lhs : *value_list) {
+      for (auto &rhs : *value_list) {
+        for (bool descend : {false, true}) {
+          std::vector<char> lhs_key, rhs_key;
+          executor::SortKeyEncoder::EncodeValue(lhs, descend, lhs_key);
+          executor::SortKeyEncoder::EncodeValue(rhs, descend, rhs_key);
+
+          int key_result = executor::SortKeyEncoder::Compare(
+              lhs_key.data(), lhs_key.size(), rhs_key.data(), rhs_key.size());
+          int value_result = descend ? rhs.Compare(lhs) : lhs.Compare(rhs);
+          EXPECT_EQ(value_result > 0, key_result > 0);
+          EXPECT_EQ(value_result < 0, key_result < 0);
+
+          // The prefix never contradicts the key
+          auto lhs_prefix = executor::SortKeyEncoder::GetPrefix(
+              lhs_key.data(), lhs_key.size());
+          auto rhs_prefix = executor::SortKeyEncoder::GetPrefix(
+              rhs_key.data(), rhs_key.size());
+          if (lhs_prefix != rhs_prefix) {
+            EXPECT_EQ(lhs_prefix < rhs_prefix, key_result < 0);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(OrderByTests, ExternalSortTest) {
+  // Create the plan node
+  std::vector<oid_t> sort_keys({1, 3, 0});
+  std::vector<bool> descend_flags({false, true, false});
+  std::vector<oid_t> output_columns({0, 1, 2, 3});
+  planner::OrderByPlan node(sort_keys, descend_flags, output_columns);
+
+  // Spill a sorted run for every input tile
+  node.SetMemoryBudget(1);
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(nullptr));
+
+  // Create and set up executor
+  executor::OrderByExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  // Create a table and wrap it in logical tiles
+  size_t tile_size = 20;
+  size_t tile_count = 5;
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto txn_id = txn->GetTransactionId();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tile_size));
+  bool random = true;
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(),
+                                   tile_size * tile_count, false, random,
+                                   false);
+  txn_manager.CommitTransaction();
+
+  // More runs than one merge takes
+  ::testing::Sequence execute_sequence, output_sequence;
+  for (size_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    EXPECT_CALL(child_executor, DExecute())
+        .InSequence(execute_sequence)
+        .WillOnce(Return(true));
+    EXPECT_CALL(child_executor, GetOutput())
+        .InSequence(output_sequence)
+        .WillOnce(Return(executor::LogicalTileFactory::WrapTileGroup(
+            data_table->GetTileGroup(tile_itr), txn_id)));
+  }
+  EXPECT_CALL(child_executor, DExecute())
+      .InSequence(execute_sequence)
+      .WillOnce(Return(false));
+
+  EXPECT_TRUE(executor.Init());
+
+  std::vector<std::unique_ptr<executor::LogicalTile>> result_tiles;
+  while (executor.Execute()) {
+    result_tiles.emplace_back(executor.GetOutput());
+  }
+
+  // Every tuple comes back once, in order
+  std::set<int> first_column_values;
+  std::vector<Value> previous_keys;
+  for (auto &tile : result_tiles) {
+    for (oid_t tuple_id : *tile) {
+      first_column_values.insert(
+          ValuePeeker::PeekAsInteger(tile->GetValue(tuple_id, 0)));
+
+      std::vector<Value> keys;
+      for (auto sort_key : sort_keys) {
+        keys.push_back(tile->GetValue(tuple_id, sort_key));
+      }
+
+      for (size_t key_itr = 0; key_itr < previous_keys.size(); key_itr++) {
+        int result = previous_keys[key_itr].Compare(keys[key_itr]);
+        if (descend_flags[key_itr]) result = -result;
+        EXPECT_LE(result, 0);
+        if (result != 0) break;
+      }
+      previous_keys = keys;
+    }
+  }
+
+  EXPECT_EQ(tile_size * tile_count, first_column_values.size());
+
+  // Initializing again drops the merged runs, an input fitting in memory
+  // is then sorted in memory
+  node.SetMemoryBudget(0);
+  ::testing::Sequence reinit_sequence;
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+  EXPECT_CALL(child_executor, DExecute())
+      .InSequence(reinit_sequence)
+      .WillOnce(Return(true));
+  EXPECT_CALL(child_executor, DExecute())
+      .InSequence(reinit_sequence)
+      .WillOnce(Return(false));
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(executor::LogicalTileFactory::WrapTileGroup(
+          data_table->GetTileGroup(0), txn_id)));
+
+  EXPECT_TRUE(executor.Init());
+
+  size_t result_tuple_count = 0;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    result_tuple_count += result_tile->GetTupleCount();
+  }
+  EXPECT_EQ(tile_size, result_tuple_count);
+}
 }
 
 }  // namespace test
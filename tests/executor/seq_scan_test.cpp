@@ -26,6 +26,8 @@
 #include "backend/common/value_factory.h"
 #include "backend/concurrency/transaction.h"
 #include "backend/executor/executor_context.h"
+#include "backend/executor/join_bloom_filter.h"
+#include "backend/executor/join_hash_table.h"
 #include "backend/executor/abstract_executor.h"
 #include "backend/executor/logical_tile.h"
 #include "backend/executor/logical_tile_factory.h"
@@ -311,6 +313,141 @@ TEST(SeqScanTests, NonLeafNodePredicateTest) {
 
   txn_manager.CommitTransaction();
 }
+
+// Sequential scan of table with predicate, split across worker threads.
+TEST(SeqScanTests, ParallelScanTest) {
+  // Create table.
+  std::unique_ptr<storage::DataTable> table(CreateTable());
+
+  // Column ids to be added to logical tile after scan.
+  std::vector<oid_t> column_ids({0, 1, 3});
+
+  // Create plan node.
+  planner::SeqScanPlan node(table.get(), CreatePredicate(g_tuple_ids),
+                            column_ids);
+  node.SetParallelism(4);
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  // Tiles can come out in any order, but RunTest doesn't depend on it
+  executor::SeqScanExecutor executor(&node, context.get());
+  RunTest(executor, table->GetTileGroupCount(), column_ids.size());
+
+  // Re-initializing restarts the scan
+  RunTest(executor, table->GetTileGroupCount(), column_ids.size());
+
+  txn_manager.CommitTransaction();
+}
+
+// Sequential scan with a predicate that is evaluated over the raw columns.
+// (COL_A >= 10 AND 32.0 > COL_C AND COL_B > COL_A) OR COL_B = 41
+TEST(SeqScanTests, VectorizedPredicateTest) {
+  // Create table.
+  std::unique_ptr<storage::DataTable> table(CreateTable());
+
+  auto range_expr = expression::ConjunctionFactory(
+      EXPRESSION_TYPE_CONJUNCTION_AND,
+      expression::ConjunctionFactory(
+          EXPRESSION_TYPE_CONJUNCTION_AND,
+          expression::ComparisonFactory(
+              EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+              expression::TupleValueFactory(0, 0),
+              expression::ConstantValueFactory(
+                  ValueFactory::GetIntegerValue(10))),
+          expression::ComparisonFactory(
+              EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+              expression::ConstantValueFactory(
+                  ValueFactory::GetDoubleValue(32.0)),
+              expression::TupleValueFactory(0, 2))),
+      expression::ComparisonFactory(EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                                    expression::TupleValueFactory(0, 1),
+                                    expression::TupleValueFactory(0, 0)));
+
+  auto predicate = expression::ConjunctionFactory(
+      EXPRESSION_TYPE_CONJUNCTION_OR, range_expr,
+      expression::ComparisonFactory(
+          EXPRESSION_TYPE_COMPARE_EQUAL, expression::TupleValueFactory(0, 1),
+          expression::ConstantValueFactory(
+              ValueFactory::GetBigIntValue(41))));
+
+  std::vector<oid_t> column_ids({0});
+  planner::SeqScanPlan node(table.get(), predicate, column_ids);
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::SeqScanExecutor executor(&node, context.get());
+  EXPECT_TRUE(executor.Init());
+
+  const std::vector<int> expected_tuple_ids({1, 2, 4});
+  oid_t tile_count = 0;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    tile_count++;
+
+    std::vector<int> tuple_ids;
+    for (oid_t tuple_id : *result_tile) {
+      tuple_ids.push_back(
+          result_tile->GetValue(tuple_id, 0).GetIntegerForTestsOnly() / 10);
+    }
+    EXPECT_EQ(expected_tuple_ids, tuple_ids);
+  }
+  EXPECT_EQ(table->GetTileGroupCount(), tile_count);
+
+  txn_manager.CommitTransaction();
+}
+
+TEST(SeqScanTests, BloomFilterTest) {
+  // Create table.
+  std::unique_ptr<storage::DataTable> table(CreateTable());
+
+  // Filter on the second output column, which is the second table column
+  std::vector<oid_t> column_ids({0, 1});
+  std::vector<oid_t> key_column_ids({1});
+
+  auto bloom_filter = std::make_shared<executor::JoinBloomFilter>(
+      g_tuple_ids.size());
+  for (auto tuple_id : g_tuple_ids) {
+    Value key = table->GetTileGroup(0)->GetValue(tuple_id, 1);
+    bloom_filter->Insert(executor::JoinHashTable::GetHash(&key, 1));
+  }
+
+  planner::SeqScanPlan node(table.get(), nullptr, column_ids);
+
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::SeqScanExecutor executor(&node, context.get());
+  EXPECT_TRUE(executor.Init());
+  EXPECT_TRUE(executor.SetBloomFilter(bloom_filter, key_column_ids));
+
+  // Every tuple in the filter comes out, few of the others do
+  oid_t result_tuple_count = 0;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+
+    std::set<oid_t> tuple_ids;
+    for (oid_t tuple_id : *result_tile) {
+      tuple_ids.insert(
+          result_tile->GetValue(tuple_id, 0).GetIntegerForTestsOnly() / 10);
+    }
+    for (auto tuple_id : g_tuple_ids) {
+      EXPECT_EQ(1, tuple_ids.count(tuple_id));
+    }
+    result_tuple_count += result_tile->GetTupleCount();
+  }
+  EXPECT_LT(result_tuple_count,
+            table->GetTileGroupCount() * TESTS_TUPLES_PER_TILEGROUP);
+
+  txn_manager.CommitTransaction();
+}
 }
 
 }  // namespace test
@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// top_n_test.cpp
+//
+// Identification: tests/executor/top_n_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "backend/planner/top_n_plan.h"
+
+#include "backend/common/types.h"
+#include "backend/common/value.h"
+#include "backend/common/value_peeker.h"
+#include "backend/executor/executor_context.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/executor/logical_tile_factory.h"
+#include "backend/executor/top_n_executor.h"
+#include "backend/storage/data_table.h"
+
+#include "executor/executor_tests_util.h"
+#include "executor/mock_executor.h"
+#include "harness.h"
+
+using ::testing::Return;
+
+namespace peloton {
+namespace test {
+
+namespace {
+
+/**
+ * Runs a top-n on the second column, then the first one, of a table with
+ * random duplicates in the second column, and checks it against a full
+ * sort of the table.
+ */
+void RunTest(bool descend, size_t limit, size_t offset) {
+  std::vector<oid_t> sort_keys({1, 0});
+  std::vector<bool> descend_flags({descend, false});
+  planner::TopNPlan node(sort_keys, descend_flags, limit, offset);
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(nullptr));
+
+  executor::TopNExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  // Create a table and wrap it in logical tiles
+  size_t tile_size = 20;
+  size_t tile_count = 5;
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto txn_id = txn->GetTransactionId();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tile_size));
+  bool random = true;
+  ExecutorTestsUtil::PopulateTable(txn, data_table.get(),
+                                   tile_size * tile_count, false, random,
+                                   false);
+  txn_manager.CommitTransaction();
+
+  // Expected result, from a full sort
+  std::vector<std::pair<int, int>> expected;
+  ::testing::Sequence execute_sequence, output_sequence;
+  for (size_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    std::unique_ptr<executor::LogicalTile> tile(
+        executor::LogicalTileFactory::WrapTileGroup(
+            data_table->GetTileGroup(tile_itr), txn_id));
+    for (oid_t tuple_id : *tile) {
+      int key = ValuePeeker::PeekAsInteger(tile->GetValue(tuple_id, 1));
+      expected.emplace_back(descend ? -key : key,
+                            ValuePeeker::PeekAsInteger(
+                                tile->GetValue(tuple_id, 0)));
+    }
+
+    EXPECT_CALL(child_executor, DExecute())
+        .InSequence(execute_sequence)
+        .WillOnce(Return(true));
+    EXPECT_CALL(child_executor, GetOutput())
+        .InSequence(output_sequence)
+        .WillOnce(Return(tile.release()));
+  }
+  EXPECT_CALL(child_executor, DExecute())
+      .InSequence(execute_sequence)
+      .WillOnce(Return(false));
+
+  std::sort(expected.begin(), expected.end());
+  size_t begin = std::min(offset, expected.size());
+  size_t end = std::min(offset + limit, expected.size());
+
+  EXPECT_TRUE(executor.Init());
+
+  std::vector<std::unique_ptr<executor::LogicalTile>> result_tiles;
+  while (executor.Execute()) {
+    result_tiles.emplace_back(executor.GetOutput());
+  }
+
+  size_t result_itr = begin;
+  for (auto &tile : result_tiles) {
+    for (oid_t tuple_id : *tile) {
+      ASSERT_LT(result_itr, end);
+
+      int key = ValuePeeker::PeekAsInteger(tile->GetValue(tuple_id, 1));
+      EXPECT_EQ(expected[result_itr].first, descend ? -key : key);
+      EXPECT_EQ(expected[result_itr].second,
+                ValuePeeker::PeekAsInteger(tile->GetValue(tuple_id, 0)));
+      result_itr++;
+    }
+  }
+
+  EXPECT_EQ(end, result_itr);
+}
+
+TEST(TopNTests, AscTest) { RunTest(false, 10, 0); }
+
+TEST(TopNTests, DescOffsetTest) { RunTest(true, 7, 3); }
+
+TEST(TopNTests, LimitBeyondInputTest) { RunTest(false, 150, 20); }
+}
+
+}  // namespace test
+}  // namespace peloton
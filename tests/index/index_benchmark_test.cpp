@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// index_benchmark_test.cpp
+//
+// Identification: tests/index/index_benchmark_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "harness.h"
+
+#include "backend/common/logger.h"
+#include "backend/index/btree_index.h"
+#include "backend/index/bwtree_index.h"
+#include "backend/index/index_factory.h"
+#include "backend/index/index_key.h"
+#include "backend/storage/tuple.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Index Benchmark Tests
+//===--------------------------------------------------------------------===//
+
+namespace {
+
+const size_t benchmark_key_count = 50000;
+
+index::IndexMetadata *BuildMetadata(IndexType index_type,
+                                    const catalog::Schema *tuple_schema) {
+  std::vector<catalog::Column> columns;
+  columns.push_back(catalog::Column(
+      VALUE_TYPE_BIGINT, GetTypeSize(VALUE_TYPE_BIGINT), "A", true));
+  catalog::Schema *key_schema = new catalog::Schema(columns);
+  key_schema->SetIndexedColumns({0});
+
+  return new index::IndexMetadata("benchmark_index", 127, index_type,
+                                  INDEX_CONSTRAINT_TYPE_DEFAULT, tuple_schema,
+                                  key_schema, false);
+}
+
+// Inserts then looks up random bigint keys, reporting the throughputs
+void RunBenchmark(index::Index *index, const std::string &key_path) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  std::chrono::duration<double, std::milli> elapsed_milliseconds;
+
+  std::vector<int64_t> keys(benchmark_key_count);
+  for (size_t key_itr = 0; key_itr < keys.size(); key_itr++) {
+    keys[key_itr] = static_cast<int64_t>(key_itr) -
+                    static_cast<int64_t>(keys.size() / 2);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+
+  storage::Tuple key(index->GetKeySchema(), true);
+
+  start = std::chrono::system_clock::now();
+  for (size_t key_itr = 0; key_itr < keys.size(); key_itr++) {
+    key.SetValue(0, ValueFactory::GetBigIntValue(keys[key_itr]), pool);
+    index->InsertEntry(&key, ItemPointer(key_itr, 0));
+  }
+  end = std::chrono::system_clock::now();
+  elapsed_milliseconds = end - start;
+  LOG_INFO("%s %s insert : %.0f keys/s", index->GetTypeName().c_str(),
+           key_path.c_str(), keys.size() * 1000 / elapsed_milliseconds.count());
+
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(1));
+
+  size_t found_count = 0;
+  start = std::chrono::system_clock::now();
+  for (auto key_value : keys) {
+    key.SetValue(0, ValueFactory::GetBigIntValue(key_value), pool);
+    found_count += index->ScanKey(&key).size();
+  }
+  end = std::chrono::system_clock::now();
+  elapsed_milliseconds = end - start;
+  LOG_INFO("%s %s point lookup : %.0f keys/s", index->GetTypeName().c_str(),
+           key_path.c_str(), keys.size() * 1000 / elapsed_milliseconds.count());
+
+  EXPECT_EQ(found_count, keys.size());
+}
+
+}  // namespace
+
+TEST(IndexBenchmarkTests, BTreeKeyPathTest) {
+  std::unique_ptr<catalog::Schema> tuple_schema(
+      new catalog::Schema({catalog::Column(
+          VALUE_TYPE_BIGINT, GetTypeSize(VALUE_TYPE_BIGINT), "A", true)}));
+
+  // The factory packs integer keys
+  std::unique_ptr<index::Index> ints_index(index::IndexFactory::GetInstance(
+      BuildMetadata(INDEX_TYPE_BTREE, tuple_schema.get())));
+  EXPECT_TRUE((dynamic_cast<index::BTreeIndex<
+                   index::IntsKey<1>, ItemPointer, index::IntsComparator<1>,
+                   index::IntsEqualityChecker<1>> *>(ints_index.get()) !=
+               nullptr));
+  RunBenchmark(ints_index.get(), "IntsKey");
+
+  std::unique_ptr<index::Index> generic_index(
+      new index::BTreeIndex<index::GenericKey<8>, ItemPointer,
+                            index::GenericComparator<8>,
+                            index::GenericEqualityChecker<8>>(
+          BuildMetadata(INDEX_TYPE_BTREE, tuple_schema.get())));
+  RunBenchmark(generic_index.get(), "GenericKey");
+}
+
+TEST(IndexBenchmarkTests, BWTreeKeyPathTest) {
+  std::unique_ptr<catalog::Schema> tuple_schema(
+      new catalog::Schema({catalog::Column(
+          VALUE_TYPE_BIGINT, GetTypeSize(VALUE_TYPE_BIGINT), "A", true)}));
+
+  std::unique_ptr<index::Index> ints_index(index::IndexFactory::GetInstance(
+      BuildMetadata(INDEX_TYPE_BWTREE, tuple_schema.get())));
+  EXPECT_TRUE((dynamic_cast<index::BWTreeIndex<
+                   index::IntsKey<1>, ItemPointer, index::IntsComparator<1>,
+                   index::IntsEqualityChecker<1>> *>(ints_index.get()) !=
+               nullptr));
+  RunBenchmark(ints_index.get(), "IntsKey");
+
+  std::unique_ptr<index::Index> generic_index(
+      new index::BWTreeIndex<index::GenericKey<8>, ItemPointer,
+                             index::GenericComparator<8>,
+                             index::GenericEqualityChecker<8>>(
+          BuildMetadata(INDEX_TYPE_BWTREE, tuple_schema.get())));
+  RunBenchmark(generic_index.get(), "GenericKey");
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -10,11 +10,18 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <limits>
+#include <set>
+#include <utility>
+
 #include "gtest/gtest.h"
 #include "harness.h"
 
 #include "backend/common/logger.h"
+#include "backend/index/btree_index.h"
+#include "backend/index/bwtree_index.h"
 #include "backend/index/index_factory.h"
+#include "backend/index/index_key.h"
 #include "backend/storage/tuple.h"
 
 namespace peloton {
@@ -31,14 +38,11 @@ ItemPointer item0(120, 5);
 ItemPointer item1(120, 7);
 ItemPointer item2(123, 19);
 
-index::Index *BuildIndex() {
+index::Index *BuildIndex(IndexType index_type = INDEX_TYPE_BWTREE) {
   // Build tuple and key schema
   std::vector<std::vector<std::string>> column_names;
   std::vector<catalog::Column> columns;
   std::vector<catalog::Schema *> schemas;
-  IndexType index_type = INDEX_TYPE_BTREE;
-  // TODO: Uncomment the line below
-  index_type = INDEX_TYPE_BWTREE;
 
   catalog::Column column1(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
                           "A", true);
@@ -291,5 +295,314 @@ TEST(IndexTests, MultiThreadedInsertTest) {
   delete tuple_schema;
 }
 
+TEST(IndexTests, RangeScanTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+
+  // INDEX
+  std::unique_ptr<index::Index> index(BuildIndex(INDEX_TYPE_BTREE));
+
+  // Keys {i, "a"} and {i, "b"} for i in [0, 10), located at (i, 0) and (i, 1)
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  for (int key_itr = 0; key_itr < 10; key_itr++) {
+    key->SetValue(0, ValueFactory::GetIntegerValue(key_itr), pool);
+    key->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+    index->InsertEntry(key.get(), ItemPointer(key_itr, 0));
+    key->SetValue(1, ValueFactory::GetStringValue("b"), pool);
+    index->InsertEntry(key.get(), ItemPointer(key_itr, 1));
+  }
+
+  // A BETWEEN 3 AND 6
+  std::vector<Value> values = {ValueFactory::GetIntegerValue(3),
+                               ValueFactory::GetIntegerValue(6)};
+  std::vector<oid_t> key_column_ids = {0, 0};
+  std::vector<ExpressionType> expr_types = {
+      EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+      EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO};
+
+  locations = index->Scan(values, key_column_ids, expr_types,
+                          SCAN_DIRECTION_TYPE_FORWARD);
+  ASSERT_EQ(locations.size(), 8);
+  for (size_t location_itr = 0; location_itr < locations.size();
+       location_itr++) {
+    EXPECT_EQ(locations[location_itr].block, 3 + location_itr / 2);
+    EXPECT_EQ(locations[location_itr].offset, location_itr % 2);
+  }
+
+  // Same range, largest key first
+  locations = index->Scan(values, key_column_ids, expr_types,
+                          SCAN_DIRECTION_TYPE_BACKWARD);
+  ASSERT_EQ(locations.size(), 8);
+  for (size_t location_itr = 0; location_itr < locations.size();
+       location_itr++) {
+    EXPECT_EQ(locations[location_itr].block, 6 - location_itr / 2);
+    EXPECT_EQ(locations[location_itr].offset, 1 - location_itr % 2);
+  }
+
+  // A > 7, backward, with no upper bound
+  values = {ValueFactory::GetIntegerValue(7)};
+  key_column_ids = {0};
+  expr_types = {EXPRESSION_TYPE_COMPARE_GREATERTHAN};
+
+  locations = index->Scan(values, key_column_ids, expr_types,
+                          SCAN_DIRECTION_TYPE_BACKWARD);
+  ASSERT_EQ(locations.size(), 4);
+  EXPECT_EQ(locations.front().block, 9);
+  EXPECT_EQ(locations.back().block, 8);
+
+  // A = 5 AND B > "a"
+  values = {ValueFactory::GetIntegerValue(5),
+            ValueFactory::GetStringValue("a")};
+  key_column_ids = {0, 1};
+  expr_types = {EXPRESSION_TYPE_COMPARE_EQUAL,
+                EXPRESSION_TYPE_COMPARE_GREATERTHAN};
+
+  locations = index->Scan(values, key_column_ids, expr_types,
+                          SCAN_DIRECTION_TYPE_FORWARD);
+  ASSERT_EQ(locations.size(), 1);
+  EXPECT_EQ(locations[0].block, 5);
+  EXPECT_EQ(locations[0].offset, 1);
+
+  locations = index->Scan(values, key_column_ids, expr_types,
+                          SCAN_DIRECTION_TYPE_BACKWARD);
+  ASSERT_EQ(locations.size(), 1);
+  EXPECT_EQ(locations[0].block, 5);
+  EXPECT_EQ(locations[0].offset, 1);
+
+  delete tuple_schema;
+}
+
+// The upper bound pads a trailing double column past infinite keys
+TEST(IndexTests, InfiniteDoubleBoundTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  std::vector<catalog::Column> columns;
+  columns.push_back(catalog::Column(
+      VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER), "A", true));
+  columns.push_back(catalog::Column(
+      VALUE_TYPE_DOUBLE, GetTypeSize(VALUE_TYPE_DOUBLE), "B", true));
+  catalog::Schema *double_key_schema = new catalog::Schema(columns);
+  double_key_schema->SetIndexedColumns({0, 1});
+  std::unique_ptr<catalog::Schema> double_tuple_schema(
+      new catalog::Schema(columns));
+
+  index::IndexMetadata *index_metadata = new index::IndexMetadata(
+      "double_index", 127, INDEX_TYPE_BTREE, INDEX_CONSTRAINT_TYPE_DEFAULT,
+      double_tuple_schema.get(), double_key_schema, false);
+  std::unique_ptr<index::Index> index(
+      index::IndexFactory::GetInstance(index_metadata));
+
+  std::unique_ptr<storage::Tuple> key(
+      new storage::Tuple(double_key_schema, true));
+  std::vector<double> doubles = {-1.0, 2.0,
+                                 std::numeric_limits<double>::infinity()};
+  for (oid_t double_itr = 0; double_itr < doubles.size(); double_itr++) {
+    key->SetValue(0, ValueFactory::GetIntegerValue(1), pool);
+    key->SetValue(1, ValueFactory::GetDoubleValue(doubles[double_itr]), pool);
+    index->InsertEntry(key.get(), ItemPointer(1, double_itr));
+  }
+
+  // A = 1, largest key first
+  std::vector<Value> values = {ValueFactory::GetIntegerValue(1)};
+  std::vector<oid_t> key_column_ids = {0};
+  std::vector<ExpressionType> expr_types = {EXPRESSION_TYPE_COMPARE_EQUAL};
+
+  auto locations = index->Scan(values, key_column_ids, expr_types,
+                               SCAN_DIRECTION_TYPE_BACKWARD);
+  ASSERT_EQ(locations.size(), 3);
+  EXPECT_EQ(locations[0].offset, 2);
+  EXPECT_EQ(locations[2].offset, 0);
+}
+
+// Reads a cursor in small batches, checking it against a full scan
+void CursorTest(IndexType index_type, ScanDirectionType scan_direction) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  // INDEX
+  std::unique_ptr<index::Index> index(BuildIndex(index_type));
+
+  // Three entries for each key, so that batches end within a key
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  for (int key_itr = 0; key_itr < 10; key_itr++) {
+    key->SetValue(0, ValueFactory::GetIntegerValue(key_itr), pool);
+    key->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+    for (oid_t entry_itr = 0; entry_itr < 3; entry_itr++) {
+      index->InsertEntry(key.get(), ItemPointer(key_itr, entry_itr));
+    }
+  }
+
+  // A > 2 AND A < 8
+  std::vector<Value> values = {ValueFactory::GetIntegerValue(2),
+                               ValueFactory::GetIntegerValue(8)};
+  std::vector<oid_t> key_column_ids = {0, 0};
+  std::vector<ExpressionType> expr_types = {
+      EXPRESSION_TYPE_COMPARE_GREATERTHAN, EXPRESSION_TYPE_COMPARE_LESSTHAN};
+
+  auto expected =
+      index->Scan(values, key_column_ids, expr_types, scan_direction);
+  EXPECT_EQ(expected.size(), 15);
+
+  std::unique_ptr<index::IndexCursor> cursor(
+      index->GetCursor(values, key_column_ids, expr_types, scan_direction));
+  std::vector<ItemPointer> locations;
+  while (cursor->NextBatch(locations, 4) > 0) {
+  }
+
+  ItemPointer location;
+  EXPECT_FALSE(cursor->Next(location));
+
+  ASSERT_EQ(locations.size(), expected.size());
+  std::set<std::pair<oid_t, oid_t>> distinct_locations;
+  for (size_t location_itr = 0; location_itr < locations.size();
+       location_itr++) {
+    EXPECT_EQ(locations[location_itr].block, expected[location_itr].block);
+    distinct_locations.insert(std::make_pair(locations[location_itr].block,
+                                             locations[location_itr].offset));
+  }
+  EXPECT_EQ(distinct_locations.size(), expected.size());
+
+  // Scan of all keys, one at a time
+  cursor.reset(index->GetCursor({}, {}, {}, scan_direction));
+  size_t location_count = 0;
+  while (cursor->Next(location)) {
+    location_count++;
+  }
+  EXPECT_EQ(location_count, 30);
+
+  delete tuple_schema;
+}
+
+TEST(IndexTests, BTreeCursorTest) {
+  CursorTest(INDEX_TYPE_BTREE, SCAN_DIRECTION_TYPE_FORWARD);
+  CursorTest(INDEX_TYPE_BTREE, SCAN_DIRECTION_TYPE_BACKWARD);
+}
+
+TEST(IndexTests, BWTreeCursorTest) {
+  CursorTest(INDEX_TYPE_BWTREE, SCAN_DIRECTION_TYPE_FORWARD);
+  CursorTest(INDEX_TYPE_BWTREE, SCAN_DIRECTION_TYPE_BACKWARD);
+}
+
+// Deletes a visited duplicate between batches, the cursor must still return
+// every other entry of the key once
+void CursorDeleteTest(ScanDirectionType scan_direction) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  // INDEX
+  std::unique_ptr<index::Index> index(BuildIndex(INDEX_TYPE_BTREE));
+
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  key->SetValue(0, ValueFactory::GetIntegerValue(1), pool);
+  key->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+  for (oid_t entry_itr = 0; entry_itr < 6; entry_itr++) {
+    index->InsertEntry(key.get(), ItemPointer(1, entry_itr));
+  }
+
+  std::vector<Value> values = {ValueFactory::GetIntegerValue(1)};
+  std::vector<oid_t> key_column_ids = {0};
+  std::vector<ExpressionType> expr_types = {EXPRESSION_TYPE_COMPARE_EQUAL};
+
+  std::unique_ptr<index::IndexCursor> cursor(
+      index->GetCursor(values, key_column_ids, expr_types, scan_direction));
+  std::vector<ItemPointer> locations;
+  EXPECT_EQ(cursor->NextBatch(locations, 2), 2);
+
+  index->DeleteEntry(key.get(), locations[0]);
+  while (cursor->NextBatch(locations, 2) > 0) {
+  }
+
+  std::set<std::pair<oid_t, oid_t>> distinct_locations;
+  for (auto location : locations) {
+    distinct_locations.insert(std::make_pair(location.block, location.offset));
+  }
+  EXPECT_EQ(locations.size(), 6);
+  EXPECT_EQ(distinct_locations.size(), 6);
+
+  delete tuple_schema;
+}
+
+TEST(IndexTests, BTreeCursorDeleteTest) {
+  CursorDeleteTest(SCAN_DIRECTION_TYPE_FORWARD);
+  CursorDeleteTest(SCAN_DIRECTION_TYPE_BACKWARD);
+}
+
+// Keys made of integers only take the packed IntsKey path
+void IntsKeyTest(IndexType index_type) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  std::vector<catalog::Column> columns;
+  columns.push_back(catalog::Column(VALUE_TYPE_INTEGER,
+                                    GetTypeSize(VALUE_TYPE_INTEGER), "A",
+                                    true));
+  columns.push_back(catalog::Column(
+      VALUE_TYPE_BIGINT, GetTypeSize(VALUE_TYPE_BIGINT), "B", true));
+  catalog::Schema *ints_key_schema = new catalog::Schema(columns);
+  ints_key_schema->SetIndexedColumns({0, 1});
+  std::unique_ptr<catalog::Schema> ints_tuple_schema(
+      new catalog::Schema(columns));
+
+  index::IndexMetadata *index_metadata = new index::IndexMetadata(
+      "ints_index", 126, index_type, INDEX_CONSTRAINT_TYPE_DEFAULT,
+      ints_tuple_schema.get(), ints_key_schema, false);
+  std::unique_ptr<index::Index> index(
+      index::IndexFactory::GetInstance(index_metadata));
+
+  // 4 + 8 bytes fit in two packed integers
+  if (index_type == INDEX_TYPE_BTREE) {
+    EXPECT_TRUE((dynamic_cast<index::BTreeIndex<
+                     index::IntsKey<2>, ItemPointer, index::IntsComparator<2>,
+                     index::IntsEqualityChecker<2>> *>(index.get()) !=
+                 nullptr));
+  } else {
+    EXPECT_TRUE((dynamic_cast<index::BWTreeIndex<
+                     index::IntsKey<2>, ItemPointer, index::IntsComparator<2>,
+                     index::IntsEqualityChecker<2>> *>(index.get()) !=
+                 nullptr));
+  }
+
+  // Keys {i, -i} for i in [-5, 5], located at (i + 5, 0)
+  std::unique_ptr<storage::Tuple> key(
+      new storage::Tuple(ints_key_schema, true));
+  for (int key_itr = 5; key_itr >= -5; key_itr--) {
+    key->SetValue(0, ValueFactory::GetIntegerValue(key_itr), pool);
+    key->SetValue(1, ValueFactory::GetBigIntValue(-key_itr), pool);
+    index->InsertEntry(key.get(), ItemPointer(key_itr + 5, 0));
+  }
+
+  key->SetValue(0, ValueFactory::GetIntegerValue(-3), pool);
+  key->SetValue(1, ValueFactory::GetBigIntValue(3), pool);
+  auto locations = index->ScanKey(key.get());
+  ASSERT_EQ(locations.size(), 1);
+  EXPECT_EQ(locations[0].block, 2);
+
+  // Negative keys sort first
+  locations = index->ScanAllKeys();
+  ASSERT_EQ(locations.size(), 11);
+  for (size_t location_itr = 0; location_itr < locations.size();
+       location_itr++) {
+    EXPECT_EQ(locations[location_itr].block, location_itr);
+  }
+
+  // A >= -2 AND B > -2, the keys are decoded for the comparison
+  std::vector<Value> values = {ValueFactory::GetIntegerValue(-2),
+                               ValueFactory::GetBigIntValue(-2)};
+  std::vector<oid_t> key_column_ids = {0, 1};
+  std::vector<ExpressionType> expr_types = {
+      EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+      EXPRESSION_TYPE_COMPARE_GREATERTHAN};
+
+  locations = index->Scan(values, key_column_ids, expr_types,
+                          SCAN_DIRECTION_TYPE_BACKWARD);
+  ASSERT_EQ(locations.size(), 4);
+  for (size_t location_itr = 0; location_itr < locations.size();
+       location_itr++) {
+    EXPECT_EQ(locations[location_itr].block, 6 - location_itr);
+  }
+}
+
+TEST(IndexTests, IntsKeyTest) {
+  IntsKeyTest(INDEX_TYPE_BTREE);
+  IntsKeyTest(INDEX_TYPE_BWTREE);
+}
+
 }  // End test namespace
 }  // End peloton namespace
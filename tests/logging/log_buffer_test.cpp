@@ -0,0 +1,182 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// log_buffer_test.cpp
+//
+// Identification: tests/logging/log_buffer_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <sys/uio.h>
+
+#include "gtest/gtest.h"
+#include "harness.h"
+
+#include "backend/logging/log_buffer.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Log Buffer Tests
+//===--------------------------------------------------------------------===//
+
+namespace {
+
+// Record of the given length filled with its sequence number
+std::vector<char> BuildRecord(size_t record_itr, size_t record_length) {
+  return std::vector<char>(record_length, static_cast<char>(record_itr));
+}
+
+// Checks the records read back in order, return the number of records seen
+size_t CheckRecords(const std::vector<char> &output, size_t record_length,
+                    size_t first_record_itr) {
+  EXPECT_EQ(0, output.size() % record_length);
+
+  size_t record_count = output.size() / record_length;
+  for (size_t record_itr = 0; record_itr < record_count; record_itr++) {
+    auto expected = BuildRecord(first_record_itr + record_itr, record_length);
+    EXPECT_EQ(0, std::memcmp(expected.data(),
+                             output.data() + record_itr * record_length,
+                             record_length));
+  }
+
+  return record_count;
+}
+
+}  // namespace
+
+TEST(LogBufferTests, WrapAroundTest) {
+  logging::LogBuffer log_buffer(64);
+  EXPECT_EQ(64, log_buffer.GetCapacity());
+
+  // Records of 24 bytes do not divide the capacity, they wrap around
+  const size_t record_length = 24;
+  size_t next_record_itr = 0;
+
+  for (size_t round_itr = 0; round_itr < 10; round_itr++) {
+    for (size_t record_itr = 0; record_itr < 2; record_itr++) {
+      auto record = BuildRecord(next_record_itr + record_itr, record_length);
+      log_buffer.WriteRecord(record.data(), record.size());
+    }
+    EXPECT_EQ(2 * record_length, log_buffer.GetSize());
+
+    std::vector<char> output;
+    size_t record_count = 0;
+    EXPECT_EQ(2 * record_length, log_buffer.ReadRecords(output, record_count));
+    EXPECT_EQ(2, record_count);
+    EXPECT_EQ(2, CheckRecords(output, record_length, next_record_itr));
+    EXPECT_EQ(0, log_buffer.GetSize());
+
+    next_record_itr += 2;
+  }
+}
+
+TEST(LogBufferTests, GrowTest) {
+  logging::LogBuffer log_buffer(64);
+
+  auto small_record = BuildRecord(1, 16);
+  log_buffer.WriteRecord(small_record.data(), small_record.size());
+
+  // A record larger than the buffer waits for it to be read
+  auto large_record = BuildRecord(2, 100);
+  std::thread writer([&] {
+    log_buffer.WriteRecord(large_record.data(), large_record.size());
+  });
+
+  std::vector<char> output;
+  size_t record_count = 0;
+  while (output.size() < small_record.size() + large_record.size()) {
+    log_buffer.ReadRecords(output, record_count);
+  }
+  writer.join();
+
+  EXPECT_EQ(128, log_buffer.GetCapacity());
+  EXPECT_EQ(0, std::memcmp(small_record.data(), output.data(), 16));
+  EXPECT_EQ(0, std::memcmp(large_record.data(), output.data() + 16, 100));
+}
+
+TEST(LogBufferTests, ReserveTest) {
+  logging::LogBuffer log_buffer(64);
+
+  // Records of 24 bytes do not divide the capacity, some are reserved
+  // across the end of the buffer
+  const size_t record_length = 24;
+  size_t next_record_itr = 0;
+
+  for (size_t round_itr = 0; round_itr < 10; round_itr++) {
+    for (size_t record_itr = 0; record_itr < 2; record_itr++) {
+      auto record = BuildRecord(next_record_itr + record_itr, record_length);
+      std::memcpy(log_buffer.ReserveRecord(record_length), record.data(),
+                  record_length);
+      log_buffer.PublishRecord();
+    }
+
+    std::vector<struct iovec> regions;
+    size_t record_count = 0;
+    EXPECT_EQ(2 * record_length, log_buffer.PeekRecords(regions, record_count));
+    EXPECT_EQ(2, record_count);
+    EXPECT_LE(regions.size(), 2);
+
+    // The peeked records are not peeked again, but keep their space
+    std::vector<struct iovec> next_regions;
+    EXPECT_EQ(0, log_buffer.PeekRecords(next_regions, record_count));
+    EXPECT_EQ(0, record_count);
+    EXPECT_EQ(2 * record_length, log_buffer.GetSize());
+
+    std::vector<char> output;
+    for (auto region : regions) {
+      auto region_data = static_cast<char *>(region.iov_base);
+      output.insert(output.end(), region_data, region_data + region.iov_len);
+    }
+    EXPECT_EQ(2, CheckRecords(output, record_length, next_record_itr));
+
+    log_buffer.ReleaseRecords(output.size());
+    EXPECT_EQ(0, log_buffer.GetSize());
+
+    next_record_itr += 2;
+  }
+}
+
+TEST(LogBufferTests, ConcurrentTest) {
+  logging::LogBuffer log_buffer(1024);
+
+  // The writer fills the buffer faster than the reader drains it
+  const size_t record_length = 40;
+  const size_t record_count = 10000;
+  std::thread writer([&] {
+    for (size_t record_itr = 0; record_itr < record_count; record_itr++) {
+      auto record = BuildRecord(record_itr, record_length);
+      log_buffer.WriteRecord(record.data(), record.size());
+    }
+  });
+
+  // Only whole records are ever read, and never counted before being read
+  size_t read_record_count = 0;
+  size_t counted_record_count = 0;
+  while (read_record_count < record_count) {
+    std::vector<char> output;
+    size_t output_record_count = 0;
+    log_buffer.ReadRecords(output, output_record_count);
+    read_record_count += CheckRecords(output, record_length, read_record_count);
+    counted_record_count += output_record_count;
+    EXPECT_LE(counted_record_count, read_record_count);
+  }
+  writer.join();
+
+  // The last records are counted by the next read
+  std::vector<char> output;
+  size_t output_record_count = 0;
+  EXPECT_EQ(0, log_buffer.ReadRecords(output, output_record_count));
+  EXPECT_EQ(record_count, counted_record_count + output_record_count);
+  EXPECT_EQ(0, log_buffer.GetSize());
+}
+
+}  // End test namespace
+}  // End peloton namespace
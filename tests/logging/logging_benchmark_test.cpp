@@ -0,0 +1,233 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// logging_benchmark_test.cpp
+//
+// Identification: tests/logging/logging_benchmark_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/uio.h>
+
+#include "gtest/gtest.h"
+#include "harness.h"
+
+#include "backend/catalog/schema.h"
+#include "backend/common/logger.h"
+#include "backend/common/value_factory.h"
+#include "backend/logging/log_buffer.h"
+#include "backend/logging/loggers/aries_backend_logger.h"
+#include "backend/storage/tuple.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Logging Benchmark Tests
+//===--------------------------------------------------------------------===//
+
+namespace {
+
+const size_t benchmark_record_count = 100000;
+
+const oid_t benchmark_database_oid = 20000;
+
+const oid_t benchmark_table_oid = 10000;
+
+const txn_id_t benchmark_txn_id = 1;
+
+catalog::Schema *BuildSchema() {
+  std::vector<catalog::Column> columns;
+  columns.push_back(catalog::Column(
+      VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER), "A", true));
+  columns.push_back(catalog::Column(
+      VALUE_TYPE_BIGINT, GetTypeSize(VALUE_TYPE_BIGINT), "B", true));
+  columns.push_back(catalog::Column(
+      VALUE_TYPE_DOUBLE, GetTypeSize(VALUE_TYPE_DOUBLE), "C", true));
+  columns.push_back(catalog::Column(VALUE_TYPE_VARCHAR, 64, "D", false));
+
+  return new catalog::Schema(columns);
+}
+
+storage::Tuple *BuildTuple(const catalog::Schema *schema, int tuple_itr,
+                           bool null_string) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  storage::Tuple *tuple = new storage::Tuple(schema, true);
+
+  tuple->SetValue(0, ValueFactory::GetIntegerValue(tuple_itr), pool);
+  tuple->SetValue(1, ValueFactory::GetBigIntValue(tuple_itr * 10), pool);
+  tuple->SetValue(2, ValueFactory::GetDoubleValue(tuple_itr * 1.5), pool);
+  if (null_string) {
+    tuple->SetValue(3, ValueFactory::GetNullValueByType(VALUE_TYPE_VARCHAR),
+                    pool);
+  } else {
+    std::string string_value(48, static_cast<char>('a' + tuple_itr));
+    tuple->SetValue(3, ValueFactory::GetStringValue(string_value, pool), pool);
+  }
+
+  return tuple;
+}
+
+// Log a tuple record either in place or through a TupleRecord
+void LogTupleRecord(logging::AriesBackendLogger *logger, bool in_place,
+                    LogRecordType log_record_type, size_t record_itr,
+                    storage::Tuple *tuple) {
+  ItemPointer location(record_itr, 0);
+  ItemPointer insert_location = (log_record_type == LOGRECORD_TYPE_TUPLE_DELETE)
+                                    ? INVALID_ITEMPOINTER
+                                    : location;
+  ItemPointer delete_location = (log_record_type == LOGRECORD_TYPE_TUPLE_INSERT)
+                                    ? INVALID_ITEMPOINTER
+                                    : location;
+
+  if (in_place) {
+    logger->LogTupleRecord(log_record_type, benchmark_txn_id,
+                           benchmark_table_oid, insert_location,
+                           delete_location, tuple, benchmark_database_oid);
+  } else {
+    logger->BackendLogger::LogTupleRecord(
+        log_record_type, benchmark_txn_id, benchmark_table_oid,
+        insert_location, delete_location, tuple, benchmark_database_oid);
+  }
+}
+
+// Each thread logs inserts, updates and deletes into its own log buffer
+// while another thread drains the log buffers as the frontend logger does,
+// reporting the throughput per thread. Return the number of bytes drained.
+size_t RunBenchmark(const std::string &log_path, bool in_place,
+                    size_t thread_count) {
+  std::unique_ptr<catalog::Schema> schema(BuildSchema());
+  std::vector<std::unique_ptr<storage::Tuple>> tuples;
+  for (size_t thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    tuples.emplace_back(BuildTuple(schema.get(), thread_itr, false));
+  }
+
+  std::vector<std::shared_ptr<logging::LogBuffer>> log_buffers(thread_count);
+  std::vector<double> throughputs(thread_count);
+  std::atomic<size_t> ready_count(0);
+  std::atomic<size_t> done_count(0);
+
+  std::vector<std::thread> workers;
+  for (size_t thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    workers.emplace_back([&, thread_itr] {
+      auto logger = logging::AriesBackendLogger::GetInstance();
+      log_buffers[thread_itr] = logger->GetLogBuffer();
+
+      ready_count++;
+      while (ready_count.load() != thread_count) {
+        std::this_thread::yield();
+      }
+
+      std::chrono::time_point<std::chrono::system_clock> start, end;
+      std::chrono::duration<double, std::milli> elapsed_milliseconds;
+      const LogRecordType log_record_types[] = {LOGRECORD_TYPE_TUPLE_INSERT,
+                                                LOGRECORD_TYPE_TUPLE_UPDATE,
+                                                LOGRECORD_TYPE_TUPLE_DELETE};
+
+      start = std::chrono::system_clock::now();
+      for (size_t record_itr = 0; record_itr < benchmark_record_count;
+           record_itr++) {
+        LogTupleRecord(logger, in_place, log_record_types[record_itr % 3],
+                       record_itr + 1, tuples[thread_itr].get());
+      }
+      end = std::chrono::system_clock::now();
+      elapsed_milliseconds = end - start;
+      throughputs[thread_itr] =
+          benchmark_record_count * 1000 / elapsed_milliseconds.count();
+
+      done_count++;
+    });
+  }
+
+  size_t drained_length = 0;
+  size_t drained_record_count = 0;
+  std::thread drainer([&] {
+    while (ready_count.load() != thread_count) {
+      std::this_thread::yield();
+    }
+
+    // The last pass starts once every record is published
+    bool done = false;
+    while (done == false) {
+      done = (done_count.load() == thread_count);
+      for (auto &log_buffer : log_buffers) {
+        std::vector<struct iovec> regions;
+        size_t record_count = 0;
+        auto length = log_buffer->PeekRecords(regions, record_count);
+        log_buffer->ReleaseRecords(length);
+
+        drained_length += length;
+        drained_record_count += record_count;
+      }
+    }
+  });
+
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  drainer.join();
+
+  double throughput = 0;
+  for (auto thread_throughput : throughputs) {
+    throughput += thread_throughput;
+  }
+  LOG_INFO("%s %lu threads : %.0f records/s per thread", log_path.c_str(),
+           thread_count, throughput / thread_count);
+
+  EXPECT_EQ(thread_count * benchmark_record_count, drained_record_count);
+
+  return drained_length;
+}
+
+}  // namespace
+
+TEST(LoggingBenchmarkTests, InPlaceSerializationTest) {
+  std::unique_ptr<catalog::Schema> schema(BuildSchema());
+  auto logger = logging::AriesBackendLogger::GetInstance();
+  auto log_buffer = logger->GetLogBuffer();
+
+  for (auto null_string : {false, true}) {
+    std::unique_ptr<storage::Tuple> tuple(
+        BuildTuple(schema.get(), 1, null_string));
+
+    for (auto log_record_type :
+         {LOGRECORD_TYPE_TUPLE_INSERT, LOGRECORD_TYPE_TUPLE_UPDATE,
+          LOGRECORD_TYPE_TUPLE_DELETE}) {
+      // Both paths serialize the same bytes
+      std::vector<char> built_record;
+      std::vector<char> in_place_record;
+      size_t record_count = 0;
+
+      LogTupleRecord(logger, false, log_record_type, 1, tuple.get());
+      log_buffer->ReadRecords(built_record, record_count);
+      EXPECT_EQ(1, record_count);
+
+      LogTupleRecord(logger, true, log_record_type, 1, tuple.get());
+      log_buffer->ReadRecords(in_place_record, record_count);
+      EXPECT_EQ(1, record_count);
+
+      EXPECT_EQ(built_record, in_place_record);
+    }
+  }
+}
+
+TEST(LoggingBenchmarkTests, TupleRecordPathTest) {
+  for (size_t thread_count : {1, 2, 4}) {
+    auto built_length = RunBenchmark("TupleRecord", false, thread_count);
+    auto in_place_length = RunBenchmark("In place", true, thread_count);
+
+    EXPECT_EQ(built_length, in_place_length);
+  }
+}
+
+}  // End test namespace
+}  // End peloton namespace
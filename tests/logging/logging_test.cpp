@@ -16,6 +16,9 @@ extern size_t peloton_data_file_size;
 
 extern int64_t peloton_wait_timeout;
 
+extern int peloton_log_stream_count;
+extern int peloton_recovery_thread_count;
+
 namespace peloton {
 namespace test {
 
@@ -27,6 +30,10 @@ std::string aries_log_file_name = "aries.log";
 
 std::string peloton_log_file_name = "peloton.log";
 
+std::string multi_stream_log_file_name = "aries_multi_stream.log";
+
+std::string checkpoint_log_file_name = "aries_checkpoint.log";
+
 /**
  * @brief writing a simple log with multiple threads and then do recovery
  */
@@ -63,6 +70,75 @@ TEST(LoggingTests, RecoveryTest) {
   }
 }
 
+/**
+ * @brief writing a log spread over several log streams and then do recovery
+ */
+TEST(LoggingTests, MultiStreamRecoveryTest) {
+  if (IsSimilarToARIES(state.logging_type) == false) return;
+
+  peloton_logging_mode = state.logging_type;
+  peloton_wait_timeout = state.wait_timeout;
+
+  if (state.experiment_type == LOGGING_EXPERIMENT_TYPE_INVALID)
+    state.experiment_type = LOGGING_EXPERIMENT_TYPE_ACTIVE;
+
+  // More backends than streams, so that streams are shared
+  auto backend_count = state.backend_count;
+  auto check_tuple_count = state.check_tuple_count;
+  state.backend_count = 4;
+  state.check_tuple_count = true;
+  peloton_log_stream_count = 2;
+
+  // Tile groups are spread over more replay workers than streams
+  peloton_recovery_thread_count = 3;
+
+  EXPECT_TRUE(LoggingTestsUtil::PrepareLogFile(multi_stream_log_file_name));
+
+  LoggingTestsUtil::ResetSystem();
+
+  // Recovery merges the streams in commit order and replays them in parallel
+  LoggingTestsUtil::DoRecovery(multi_stream_log_file_name);
+
+  peloton_log_stream_count = 1;
+  peloton_recovery_thread_count = 0;
+  state.backend_count = backend_count;
+  state.check_tuple_count = check_tuple_count;
+}
+
+/**
+ * @brief take checkpoints while writing a log and then recover from the
+ * last checkpoint and the log after it
+ */
+TEST(LoggingTests, CheckpointRecoveryTest) {
+  if (IsSimilarToARIES(state.logging_type) == false) return;
+
+  peloton_logging_mode = state.logging_type;
+  peloton_wait_timeout = state.wait_timeout;
+
+  if (state.experiment_type == LOGGING_EXPERIMENT_TYPE_INVALID)
+    state.experiment_type = LOGGING_EXPERIMENT_TYPE_ACTIVE;
+
+  auto backend_count = state.backend_count;
+  auto check_tuple_count = state.check_tuple_count;
+  state.backend_count = 4;
+  state.check_tuple_count = true;
+  state.checkpoint_count = 3;
+  peloton_log_stream_count = 2;
+
+  EXPECT_TRUE(LoggingTestsUtil::PrepareLogFile(checkpoint_log_file_name));
+
+  LoggingTestsUtil::ResetSystem();
+
+  // The log segments before the last checkpoint are gone, the deletes
+  // after it must find the tuples it restored
+  LoggingTestsUtil::DoRecovery(checkpoint_log_file_name);
+
+  peloton_log_stream_count = 1;
+  state.checkpoint_count = 0;
+  state.backend_count = backend_count;
+  state.check_tuple_count = check_tuple_count;
+}
+
 }  // End test namespace
 }  // End peloton namespace
 
@@ -4,6 +4,7 @@
 #include <thread>
 #include <chrono>
 #include <getopt.h>
+#include <glob.h>
 
 #include "logging/logging_tests_util.h"
 
@@ -87,6 +88,16 @@ bool LoggingTestsUtil::PrepareLogFile(std::string file_name) {
   }
   log_file.close();
 
+  // and the files of the other log streams, log segments and checkpoints
+  glob_t log_file_paths;
+  if (glob((file_path + "[._]*").c_str(), 0, nullptr, &log_file_paths) == 0) {
+    for (size_t log_file_itr = 0; log_file_itr < log_file_paths.gl_pathc;
+         log_file_itr++) {
+      std::remove(log_file_paths.gl_pathv[log_file_itr]);
+    }
+  }
+  globfree(&log_file_paths);
+
   // start a thread for logging
   auto& log_manager = logging::LogManager::GetInstance();
 
@@ -156,10 +167,12 @@ void LoggingTestsUtil::DoRecovery(std::string file_name) {
   auto file_path = GetFilePath(state.log_file_dir, file_name);
 
   std::ifstream log_file(file_path);
+  std::ifstream checkpoint_file(file_path + ".checkpoint");
 
-  // Reset the log file if exists
-  EXPECT_TRUE(log_file.good());
+  // The log file is removed once a checkpoint covers it
+  EXPECT_TRUE(log_file.good() || checkpoint_file.good());
   log_file.close();
+  checkpoint_file.close();
 
   LoggingTestsUtil::CreateDatabaseAndTable(LOGGING_TESTS_DATABASE_OID,
                                            LOGGING_TESTS_TABLE_OID);
@@ -271,12 +284,37 @@ void LoggingTestsUtil::BuildLog(oid_t db_oid, oid_t table_oid) {
 
   start = std::chrono::system_clock::now();
 
+  // Take the checkpoints while the backends run
+  auto& log_manager = logging::LogManager::GetInstance();
+  std::thread checkpoint_thread;
+  if (log_manager.IsInLoggingMode() &&
+      IsSimilarToARIES(peloton_logging_mode)) {
+    checkpoint_thread = std::thread([&log_manager] {
+      for (int checkpoint_itr = 0; checkpoint_itr < state.checkpoint_count;
+           checkpoint_itr++) {
+        EXPECT_TRUE(log_manager.GetCheckpointer().DoCheckpoint());
+      }
+    });
+  }
+
   // Execute the workload to build the log
   LaunchParallelTest(state.backend_count, RunBackends, table, tuples);
 
+  if (checkpoint_thread.joinable()) {
+    checkpoint_thread.join();
+  }
+
   end = std::chrono::system_clock::now();
   elapsed_milliseconds = end - start;
 
+  // The backends waited for their log records to be flushed
+  if (log_manager.IsInLoggingMode()) {
+    auto group_commit_stats = log_manager.GetGroupCommitStats();
+    EXPECT_GT(group_commit_stats.GetGroupCommitCount(), 0);
+    EXPECT_GT(group_commit_stats.GetRecordCount(), 0);
+    std::cout << group_commit_stats.GetInfo();
+  }
+
   // Build log time
   if (state.experiment_type == LOGGING_EXPERIMENT_TYPE_ACTIVE ||
       state.experiment_type == LOGGING_EXPERIMENT_TYPE_WAIT) {
@@ -357,11 +395,10 @@ std::vector<ItemPointer> LoggingTestsUtil::InsertTuples(
 
       if (log_manager.IsInLoggingMode()) {
         auto logger = log_manager.GetBackendLogger();
-        auto record = logger->GetTupleRecord(
+        logger->LogTupleRecord(
             LOGRECORD_TYPE_TUPLE_INSERT, txn->GetTransactionId(),
             table->GetOid(), location, INVALID_ITEMPOINTER, tuple,
             LOGGING_TESTS_DATABASE_OID);
-        logger->Log(record);
       }
     }
 
@@ -398,11 +435,10 @@ void LoggingTestsUtil::DeleteTuples(storage::DataTable* table,
 
       if (log_manager.IsInLoggingMode()) {
         auto logger = log_manager.GetBackendLogger();
-        auto record = logger->GetTupleRecord(
+        logger->LogTupleRecord(
             LOGRECORD_TYPE_TUPLE_DELETE, txn->GetTransactionId(),
             table->GetOid(), INVALID_ITEMPOINTER, delete_location, nullptr,
             LOGGING_TESTS_DATABASE_OID);
-        logger->Log(record);
       }
     }
 
@@ -453,11 +489,10 @@ std::vector<ItemPointer> LoggingTestsUtil::UpdateTuples(
       auto& log_manager = logging::LogManager::GetInstance();
       if (log_manager.IsInLoggingMode()) {
         auto logger = log_manager.GetBackendLogger();
-        auto record = logger->GetTupleRecord(
+        logger->LogTupleRecord(
             LOGRECORD_TYPE_TUPLE_UPDATE, txn->GetTransactionId(),
             table->GetOid(), insert_location, delete_location, tuple,
             LOGGING_TESTS_DATABASE_OID);
-        logger->Log(record);
       }
     }
 
@@ -755,6 +790,8 @@ void LoggingTestsUtil::ParseArguments(int argc, char* argv[]) {
   state.experiment_type = LOGGING_EXPERIMENT_TYPE_INVALID;
   state.wait_timeout = 0;
 
+  state.checkpoint_count = 0;
+
   // Parse args
   while (1) {
     int idx = 0;
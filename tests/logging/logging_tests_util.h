@@ -78,6 +78,9 @@ class LoggingTestsUtil {
 
     // frequency with which the logger flushes
     int64_t wait_timeout;
+
+    // # of checkpoints taken while building the log (ARIES only)
+    int checkpoint_count;
   };
 
  private:
@@ -11,9 +11,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "gtest/gtest.h"
+#include "harness.h"
 
+#include "backend/concurrency/transaction_manager.h"
 #include "backend/storage/data_table.h"
 #include "backend/storage/tile_group.h"
+#include "backend/storage/tuple.h"
 #include "executor/executor_tests_util.h"
 
 namespace peloton {
@@ -67,5 +70,83 @@ TEST(DataTableTests, TransformTileGroupTest) {
   data_table->TransformTileGroup(0, theta);
 }
 
+void InsertTuples(storage::DataTable *table, oid_t insert_count,
+                  std::atomic<oid_t> *inserted_count) {
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  for (oid_t insert_itr = 0; insert_itr < insert_count; insert_itr++) {
+    std::unique_ptr<storage::Tuple> tuple(
+        ExecutorTestsUtil::GetTuple(table, insert_itr, testing_pool));
+    ItemPointer location = table->InsertTuple(txn, tuple.get());
+    EXPECT_NE(location.block, INVALID_OID);
+    txn->RecordInsert(location);
+    (*inserted_count)++;
+  }
+
+  txn_manager.CommitTransaction();
+}
+
+TEST(DataTableTests, ConcurrentInsertTest) {
+  const oid_t thread_count = 4;
+  const oid_t insert_count = 10 * TESTS_TUPLES_PER_TILEGROUP + 1;
+
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+  std::atomic<oid_t> inserted_count(0);
+
+  LaunchParallelTest(thread_count, InsertTuples, data_table.get(),
+                     insert_count, &inserted_count);
+
+  EXPECT_EQ(thread_count * insert_count, inserted_count.load());
+
+  // Every slot is handed out exactly once, with no holes before the last
+  // tile group
+  oid_t tuple_count = 0;
+  oid_t tile_group_count = data_table->GetTileGroupCount();
+  for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto tile_group = data_table->GetTileGroup(tile_group_itr);
+    auto active_tuple_count = tile_group->GetNextTupleSlot();
+    if (tile_group_itr + 1 < tile_group_count) {
+      EXPECT_EQ(tile_group->GetAllocatedTupleCount(), active_tuple_count);
+    }
+    tuple_count += active_tuple_count;
+  }
+
+  EXPECT_EQ(thread_count * insert_count, tuple_count);
+}
+
+TEST(DataTableTests, InsertLaneTest) {
+  const oid_t thread_count = 4;
+  const oid_t insert_count = 10 * TESTS_TUPLES_PER_TILEGROUP + 1;
+
+  // Give every thread its own insert lane
+  peloton_insert_lane_count = thread_count;
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+  peloton_insert_lane_count = 1;
+
+  // Every lane starts out with its own tile group
+  EXPECT_EQ(thread_count, data_table->GetTileGroupCount());
+
+  std::atomic<oid_t> inserted_count(0);
+  LaunchParallelTest(thread_count, InsertTuples, data_table.get(),
+                     insert_count, &inserted_count);
+
+  EXPECT_EQ(thread_count * insert_count, inserted_count.load());
+
+  oid_t tuple_count = 0;
+  oid_t tile_group_count = data_table->GetTileGroupCount();
+  for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto tile_group = data_table->GetTileGroup(tile_group_itr);
+    tuple_count += tile_group->GetNextTupleSlot();
+  }
+
+  EXPECT_EQ(thread_count * insert_count, tuple_count);
+}
+
 }  // End test namespace
 }  // End peloton namespace
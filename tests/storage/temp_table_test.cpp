@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// temp_table_test.cpp
+//
+// Identification: tests/storage/temp_table_test.cpp
+//
+// Copyright (c) 2015, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+#include "harness.h"
+
+#include "backend/common/value_factory.h"
+#include "backend/executor/logical_tile.h"
+#include "backend/executor/logical_tile_factory.h"
+#include "backend/storage/temp_table.h"
+#include "backend/storage/tile.h"
+#include "backend/storage/tuple.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Temp Table Tests
+//===--------------------------------------------------------------------===//
+
+TEST(TempTableTests, InsertTest) {
+  std::vector<catalog::Column> columns;
+
+  catalog::Column column1(VALUE_TYPE_BIGINT, GetTypeSize(VALUE_TYPE_BIGINT),
+                          "A", true);
+  catalog::Column column2(VALUE_TYPE_VARCHAR, 25, "B", false);
+
+  columns.push_back(column1);
+  columns.push_back(column2);
+
+  catalog::Schema *schema = new catalog::Schema(columns);
+
+  // Three tuples per tile, the last tile is not full
+  const oid_t tuples_per_tile = 3;
+  const oid_t tuple_count = 7;
+  storage::TempTable temp_table(schema, true, tuples_per_tile);
+
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
+
+    // Integer values are cast to the column type
+    tuple->SetValue(0, ValueFactory::GetIntegerValue(tuple_itr), nullptr);
+    auto string_value =
+        ValueFactory::GetStringValue("tuple " + std::to_string(tuple_itr));
+    tuple->SetValue(1, string_value, nullptr);
+
+    auto location = temp_table.InsertTuple(tuple.get());
+    EXPECT_EQ(tuple_itr / tuples_per_tile, location.block);
+    EXPECT_EQ(tuple_itr % tuples_per_tile, location.offset);
+  }
+
+  EXPECT_EQ(tuple_count, temp_table.GetTupleCount());
+  EXPECT_EQ(3, temp_table.GetTileCount());
+  EXPECT_EQ(tuples_per_tile, temp_table.GetTileTupleCount(0));
+  EXPECT_EQ(1, temp_table.GetTileTupleCount(2));
+
+  // The logical tiles keep the tiles alive
+  std::vector<executor::LogicalTile *> result;
+  {
+    storage::TempTable other_table(schema, false, tuples_per_tile);
+    for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
+      tuple->SetValue(0, ValueFactory::GetBigIntValue(tuple_itr), nullptr);
+      auto string_value =
+          ValueFactory::GetStringValue("tuple " + std::to_string(tuple_itr));
+      tuple->SetValue(1, string_value, nullptr);
+      other_table.InsertTuple(tuple.get());
+    }
+    result = executor::LogicalTileFactory::WrapTempTable(&other_table);
+  }
+
+  EXPECT_EQ(3, result.size());
+
+  oid_t tuple_itr = 0;
+  for (auto logical_tile : result) {
+    for (auto tuple_id : *logical_tile) {
+      EXPECT_EQ(ValueFactory::GetBigIntValue(tuple_itr),
+                logical_tile->GetValue(tuple_id, 0));
+      auto string_value =
+          ValueFactory::GetStringValue("tuple " + std::to_string(tuple_itr));
+      EXPECT_EQ(string_value, logical_tile->GetValue(tuple_id, 1));
+      tuple_itr++;
+    }
+    delete logical_tile;
+  }
+
+  EXPECT_EQ(tuple_count, tuple_itr);
+
+  // Values in the tiles match the inserted ones
+  auto tile = temp_table.GetTile(2);
+  EXPECT_EQ(ValueFactory::GetBigIntValue(6), tile->GetValue(0, 0));
+}
+
+}  // End test namespace
+}  // End peloton namespace
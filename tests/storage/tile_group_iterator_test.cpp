@@ -50,7 +50,8 @@ TEST(TileGroupIteratorTests, BasicTest) {
     }
   }  // WHILE
 
-  EXPECT_EQ(expected_tilegroup_count, actual_tile_group_count);
+  // The insert that fills the last tile group also pre-allocates the next one
+  EXPECT_EQ(expected_tilegroup_count + 1, actual_tile_group_count);
 }
 
 }  // End test namespace
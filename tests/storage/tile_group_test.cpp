@@ -10,10 +10,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <chrono>
+#include <iostream>
+
 #include "gtest/gtest.h"
 #include "harness.h"
 
 #include "backend/common/value_factory.h"
+#include "backend/common/value_peeker.h"
 #include "backend/concurrency/transaction.h"
 #include "backend/storage/tile_group.h"
 #include "backend/storage/tile_group_factory.h"
@@ -518,5 +522,197 @@ TEST(TileGroupTests, TileCopyTest) {
   delete schema;
 }
 
+TEST(TileGroupTests, HeaderLayoutTest) {
+  const int tuple_count = 10;
+
+  peloton_header_layout_mode = HEADER_LAYOUT_TYPE_ROW;
+  storage::TileGroupHeader row_header(BACKEND_TYPE_MM, tuple_count);
+
+  peloton_header_layout_mode = HEADER_LAYOUT_TYPE_COLUMN;
+  storage::TileGroupHeader column_header(BACKEND_TYPE_MM, tuple_count);
+
+  peloton_header_layout_mode = DEFAULT_HEADER_LAYOUT_TYPE;
+
+  EXPECT_EQ(HEADER_LAYOUT_TYPE_ROW, row_header.GetLayoutType());
+  EXPECT_EQ(HEADER_LAYOUT_TYPE_COLUMN, column_header.GetLayoutType());
+
+  // Fill in the row header
+  for (oid_t tuple_slot_id = 0; tuple_slot_id < tuple_count; tuple_slot_id++) {
+    row_header.SetTransactionId(tuple_slot_id, tuple_slot_id + 100);
+    row_header.SetBeginCommitId(tuple_slot_id, tuple_slot_id + 200);
+    row_header.SetEndCommitId(tuple_slot_id, tuple_slot_id + 300);
+    row_header.SetInsertCommit(tuple_slot_id, tuple_slot_id % 2);
+    row_header.SetDeleteCommit(tuple_slot_id, tuple_slot_id % 3);
+    row_header.SetPrevItemPointer(tuple_slot_id,
+                                  ItemPointer(tuple_slot_id, tuple_slot_id));
+  }
+
+  // Copy it over into the column header and check every field
+  column_header = row_header;
+
+  for (oid_t tuple_slot_id = 0; tuple_slot_id < tuple_count; tuple_slot_id++) {
+    EXPECT_EQ(tuple_slot_id + 100,
+              column_header.GetTransactionId(tuple_slot_id));
+    EXPECT_EQ(tuple_slot_id + 200,
+              column_header.GetBeginCommitId(tuple_slot_id));
+    EXPECT_EQ(tuple_slot_id + 300, column_header.GetEndCommitId(tuple_slot_id));
+    EXPECT_EQ(tuple_slot_id % 2 != 0,
+              column_header.GetInsertCommit(tuple_slot_id));
+    EXPECT_EQ(tuple_slot_id % 3 != 0,
+              column_header.GetDeleteCommit(tuple_slot_id));
+    EXPECT_EQ(tuple_slot_id,
+              column_header.GetPrevItemPointer(tuple_slot_id).block);
+
+    // both layouts agree on visibility
+    EXPECT_EQ(row_header.IsVisible(tuple_slot_id, INITIAL_TXN_ID, 250),
+              column_header.IsVisible(tuple_slot_id, INITIAL_TXN_ID, 250));
+  }
+}
+
+TEST(TileGroupTests, VisibilityBitmapTest) {
+  const int tuple_count = 150;
+  const oid_t begin_slot = 5;
+  const txn_id_t txn_id = 7;
+  const cid_t at_lcid = 50;
+
+  for (auto layout_type : {HEADER_LAYOUT_TYPE_ROW, HEADER_LAYOUT_TYPE_COLUMN}) {
+    peloton_header_layout_mode = layout_type;
+    storage::TileGroupHeader header(BACKEND_TYPE_MM, tuple_count);
+    peloton_header_layout_mode = DEFAULT_HEADER_LAYOUT_TYPE;
+
+    // Mix of own inserts, own deletes, committed and in-flight versions
+    for (oid_t tuple_slot_id = 0; tuple_slot_id < tuple_count;
+         tuple_slot_id++) {
+      header.SetTransactionId(tuple_slot_id, (tuple_slot_id % 4 == 0)
+                                                 ? txn_id
+                                                 : tuple_slot_id % 3);
+      header.SetBeginCommitId(tuple_slot_id, (tuple_slot_id * 7) % 100);
+      header.SetEndCommitId(tuple_slot_id, (tuple_slot_id % 5 == 0)
+                                               ? MAX_CID
+                                               : (tuple_slot_id * 11) % 100);
+    }
+
+    std::vector<uint64_t> bitmap(storage::TileGroupHeader::GetBitmapWordCount(
+        tuple_count - begin_slot));
+    auto visible_count = header.GetVisibilityBitmap(
+        txn_id, at_lcid, begin_slot, tuple_count, bitmap.data());
+
+    std::vector<oid_t> position_list;
+    header.GetVisiblePositionList(txn_id, at_lcid, begin_slot, tuple_count,
+                                  position_list);
+    EXPECT_EQ(visible_count, position_list.size());
+
+    // The batch check must agree with the per-tuple check
+    oid_t expected_count = 0;
+    for (oid_t tuple_slot_id = begin_slot; tuple_slot_id < tuple_count;
+         tuple_slot_id++) {
+      oid_t bit_offset = tuple_slot_id - begin_slot;
+      bool bit = (bitmap[bit_offset / 64] >> (bit_offset % 64)) & 1;
+      bool visible = header.IsVisible(tuple_slot_id, txn_id, at_lcid);
+      EXPECT_EQ(visible, bit);
+      if (visible) {
+        EXPECT_EQ(tuple_slot_id, position_list[expected_count]);
+        expected_count++;
+      }
+    }
+    EXPECT_EQ(expected_count, visible_count);
+  }
+}
+
+TEST(TileGroupTests, ColumnAccessBenchmark) {
+  const oid_t tile_column_count = 4;
+  const oid_t tuple_count = 10000;
+  const int scan_count = 20;
+
+  // SCHEMA
+  std::vector<catalog::Column> columns;
+  for (oid_t column_itr = 0; column_itr < tile_column_count; column_itr++) {
+    columns.push_back(catalog::Column(VALUE_TYPE_INTEGER,
+                                      GetTypeSize(VALUE_TYPE_INTEGER),
+                                      std::to_string(column_itr), true));
+  }
+
+  catalog::Schema *tile_schema = new catalog::Schema(columns);
+  std::vector<catalog::Schema> schemas = {*tile_schema, *tile_schema};
+  catalog::Schema *schema =
+      catalog::Schema::AppendSchema(tile_schema, tile_schema);
+  oid_t column_count = schema->GetColumnCount();
+
+  // TILE GROUP
+  std::map<oid_t, std::pair<oid_t, oid_t>> column_map;
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    column_map[column_itr] = std::make_pair(column_itr / tile_column_count,
+                                            column_itr % tile_column_count);
+  }
+
+  storage::TileGroup *tile_group = storage::TileGroupFactory::GetTileGroup(
+      INVALID_OID, INVALID_OID, INVALID_OID, nullptr, schemas, column_map,
+      tuple_count);
+
+  // TUPLES
+  auto &txn_manager = concurrency::TransactionManager::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  const txn_id_t txn_id = txn->GetTransactionId();
+  const cid_t commit_id = txn->GetCommitId();
+
+  storage::Tuple *tuple = new storage::Tuple(schema, true);
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      tuple->SetValue(column_itr,
+                      ValueFactory::GetIntegerValue(tuple_itr + column_itr),
+                      nullptr);
+    }
+    auto tuple_slot = tile_group->InsertTuple(txn_id, tuple);
+    tile_group->CommitInsertedTuple(tuple_slot, txn_id, commit_id);
+  }
+
+  txn_manager.CommitTransaction();
+
+  // Scan through the column map
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  int64_t map_sum = 0;
+
+  start = std::chrono::system_clock::now();
+  for (int scan_itr = 0; scan_itr < scan_count; scan_itr++) {
+    for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+        auto &entry = tile_group->GetColumnMap().at(column_itr);
+        map_sum += ValuePeeker::PeekAsInteger(
+            tile_group->GetTile(entry.first)
+                ->GetValue(tuple_itr, entry.second));
+      }
+    }
+  }
+  end = std::chrono::system_clock::now();
+  std::chrono::duration<double> map_seconds = end - start;
+
+  // Scan through the flattened column map
+  int64_t flat_sum = 0;
+
+  start = std::chrono::system_clock::now();
+  for (int scan_itr = 0; scan_itr < scan_count; scan_itr++) {
+    for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+      for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+        flat_sum += ValuePeeker::PeekAsInteger(
+            tile_group->GetValue(tuple_itr, column_itr));
+      }
+    }
+  }
+  end = std::chrono::system_clock::now();
+  std::chrono::duration<double> flat_seconds = end - start;
+
+  EXPECT_EQ(map_sum, flat_sum);
+
+  std::cout << "column map duration :: " << map_seconds.count() << "s\n";
+  std::cout << "column array duration :: " << flat_seconds.count() << "s\n";
+  std::cout << "speedup :: " << map_seconds.count() / flat_seconds.count()
+            << "\n";
+
+  delete tuple;
+  delete tile_group;
+  delete schema;
+  delete tile_schema;
+}
+
 }  // End test namespace
 }  // End peloton namespace